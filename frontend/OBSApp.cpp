@@ -42,6 +42,7 @@
 #endif
 #endif
 #include <qt-wrappers.hpp>
+#include <util/threading.h>
 
 #include <QCheckBox>
 #include <QDesktopServices>
@@ -1203,6 +1204,73 @@ static bool StartupOBS(const char *locale, profiler_name_store_t *store)
 	return obs_startup(locale, path, store);
 }
 
+/* Parses a CPU list such as "0-3,8" into an affinity mask */
+static uint64_t ParseCPUList(const char *list)
+{
+	uint64_t mask = 0;
+	const char *pos = list;
+
+	while (*pos) {
+		char *end;
+		long first = strtol(pos, &end, 10);
+		long last = first;
+
+		if (end == pos)
+			break;
+		pos = end;
+
+		if (*pos == '-') {
+			last = strtol(pos + 1, &end, 10);
+			pos = end;
+		}
+
+		for (long cpu = first; cpu <= last && cpu < 64; cpu++) {
+			if (cpu >= 0)
+				mask |= 1ULL << cpu;
+		}
+
+		while (*pos == ',' || *pos == ' ')
+			pos++;
+	}
+
+	return mask;
+}
+
+static void LoadThreadConfig(config_t *config)
+{
+	static const struct {
+		const char *role;
+		const char *key;
+	} roles[] = {
+		{OBS_THREAD_ROLE_GRAPHICS, "Graphics"},     {OBS_THREAD_ROLE_VIDEO, "Video"},
+		{OBS_THREAD_ROLE_AUDIO, "Audio"},           {OBS_THREAD_ROLE_GPU_ENCODE, "GPUEncode"},
+		{OBS_THREAD_ROLE_OUTPUT_SEND, "OutputSend"},
+	};
+
+	for (const auto &role : roles) {
+		string policyKey = string(role.key) + "Policy";
+		string priorityKey = string(role.key) + "Priority";
+		string affinityKey = string(role.key) + "Affinity";
+
+		const char *policy = config_get_string(config, "ThreadScheduling", policyKey.c_str());
+		const char *affinity = config_get_string(config, "ThreadScheduling", affinityKey.c_str());
+		if ((!policy || !*policy) && (!affinity || !*affinity))
+			continue;
+
+		struct obs_thread_config threadConfig = {};
+		if (policy && astrcmpi(policy, "FIFO") == 0)
+			threadConfig.policy = OBS_THREAD_POLICY_FIFO;
+		else if (policy && astrcmpi(policy, "RR") == 0)
+			threadConfig.policy = OBS_THREAD_POLICY_RR;
+
+		threadConfig.priority = (int)config_get_int(config, "ThreadScheduling", priorityKey.c_str());
+		if (affinity)
+			threadConfig.affinity = ParseCPUList(affinity);
+
+		obs_set_thread_config(role.role, &threadConfig);
+	}
+}
+
 inline void OBSApp::ResetHotkeyState(bool inFocus)
 {
 	obs_hotkey_enable_background_press((inFocus && enableHotkeysInFocus) || (!inFocus && enableHotkeysOutOfFocus));
@@ -1299,6 +1367,7 @@ bool OBSApp::OBSInit()
 				QTStr("Startup.Splash.Step.OBSInit"));
 
 	obs_set_ui_task_handler(ui_task_handler);
+	LoadThreadConfig(appConfig);
 
 #if defined(_WIN32) || defined(__APPLE__) || defined(__linux__)
 	bool browserHWAccel = config_get_bool(appConfig, "General", "BrowserHWAccel");
@@ -2089,6 +2158,27 @@ void OBSApp::UpdateStartupModuleProgress(const char *moduleName, enum obs_module
 				    QTStr("Startup.Splash.Step.ModuleLoad"));
 }
 
+void OBSApp::UpdateStartupSourceProgress(enum obs_source_load_phase phase, size_t processed, size_t total,
+					 uint64_t elapsedNs)
+{
+	/* collections loaded after startup don't have a splash to update */
+	if (startupProgressModel_.Stage() > OBS::StartupProgressStage::SceneCollectionLoading)
+		return;
+
+	const bool creating = phase == OBS_SOURCE_LOAD_PHASE_CREATE;
+	startupProgressModel_.SetSourceProgress(creating ? OBS::StartupSourcePhase::Create
+							 : OBS::StartupSourcePhase::Load,
+						processed, total, elapsedNs);
+
+	const QString statusText = QTStr(creating ? "Startup.Splash.Status.CreatingSources"
+						  : "Startup.Splash.Status.LoadingSources")
+					   .arg(processed)
+					   .arg(total);
+
+	emit startupProgressUpdated(statusText, QString(), startupProgressModel_.Percent(),
+				    QTStr("Startup.Splash.Step.Scenes"));
+}
+
 void OBSApp::loadAppModules(struct obs_module_failure_info &mfi)
 {
 	size_t moduleCount = 0;
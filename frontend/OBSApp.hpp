@@ -242,6 +242,8 @@ public:
 				     const QString &stepText);
 	void UpdateStartupModuleProgress(const char *moduleName, enum obs_module_load_progress progress,
 					 enum obs_module_load_reason reason);
+	void UpdateStartupSourceProgress(enum obs_source_load_phase phase, size_t processed, size_t total,
+					 uint64_t elapsedNs);
 
 	inline OBS::StartupProgressModel &GetStartupProgressModel() { return startupProgressModel_; }
 	inline const OBS::StartupProgressModel &GetStartupProgressModel() const { return startupProgressModel_; }
@@ -553,6 +553,7 @@ void SourceTreeItem::ExpandClicked(bool checked)
 	OBSDataAutoRelease data = obs_sceneitem_get_private_settings(sceneitem);
 
 	obs_data_set_bool(data, "collapsed", checked);
+	obs_source_mark_changed(obs_scene_get_source(obs_sceneitem_get_scene(sceneitem)));
 
 	if (!checked)
 		tree->GetStm()->ExpandGroup(sceneitem);
@@ -552,6 +552,7 @@ void VolumeControl::setLocked(bool locked)
 	}
 	OBSDataAutoRelease priv_settings = obs_source_get_private_settings(source);
 	obs_data_set_bool(priv_settings, "volume_locked", locked);
+	obs_source_mark_changed(source);
 
 	enableSlider(!locked);
 	mixerStatus().set(VolumeControl::MixerStatus::Locked, locked);
@@ -947,6 +948,7 @@ void VolumeControl::setPinnedInMixer(bool pinned)
 		}
 		OBSDataAutoRelease priv_settings = obs_source_get_private_settings(source);
 		obs_data_set_bool(priv_settings, "mixer_pinned", pinned);
+		obs_source_mark_changed(source);
 
 		mixerStatus().set(VolumeControl::MixerStatus::Pinned, pinned);
 
@@ -969,6 +971,7 @@ void VolumeControl::setHiddenInMixer(bool hidden)
 		}
 		OBSDataAutoRelease priv_settings = obs_source_get_private_settings(source);
 		obs_data_set_bool(priv_settings, "mixer_hidden", hidden);
+		obs_source_mark_changed(source);
 
 		mixerStatus().set(VolumeControl::MixerStatus::Hidden, hidden);
 
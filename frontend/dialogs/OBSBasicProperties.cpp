@@ -335,10 +335,12 @@ void OBSBasicProperties::on_buttonBox_clicked(QAbstractButton *button)
 		OBSDataAutoRelease settings = obs_source_get_settings(source);
 		obs_data_clear(settings);
 
-		if (view->DeferUpdate())
+		if (view->DeferUpdate()) {
 			obs_data_apply(settings, oldSettings);
-		else
+			obs_source_mark_changed(source);
+		} else {
 			obs_source_update(source, oldSettings);
+		}
 
 		close();
 	}
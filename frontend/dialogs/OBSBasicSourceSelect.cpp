@@ -160,6 +160,7 @@ static void AddSource(void *_data, obs_scene_t *scene)
 	if (data->private_settings) {
 		OBSDataAutoRelease newPrivateSettings = obs_sceneitem_get_private_settings(sceneitem);
 		obs_data_apply(newPrivateSettings, data->private_settings);
+		obs_source_mark_changed(obs_scene_get_source(obs_sceneitem_get_scene(sceneitem)));
 	}
 
 	data->scene_item = sceneitem;
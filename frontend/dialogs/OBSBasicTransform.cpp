@@ -111,7 +111,7 @@ OBSBasicTransform::OBSBasicTransform(OBSSceneItem item, OBSBasic *parent)
 	setWindowTitle(QTStr("Basic.TransformWindow.Title").arg(name.c_str()));
 
 	OBSDataAutoRelease wrapper = obs_scene_save_transform_states(main->GetCurrentScene(), false);
-	undo_data = std::string(obs_data_get_json(wrapper));
+	undo_data = undo_stack::snapshot(wrapper);
 
 	adjustSize();
 	setMinimumSize(size());
@@ -123,13 +123,13 @@ OBSBasicTransform::~OBSBasicTransform()
 	OBSDataAutoRelease wrapper = obs_scene_save_transform_states(main->GetCurrentScene(), false);
 
 	auto undo_redo = [](const std::string &data) {
-		OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
+		OBSDataAutoRelease dat = undo_stack::restore(data);
 		OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
 		OBSBasic::Get()->SetCurrentScene(source.Get(), true);
-		obs_scene_load_transform_states(data.c_str());
+		obs_scene_load_transform_states_data(dat);
 	};
 
-	std::string redo_data(obs_data_get_json(wrapper));
+	std::string redo_data = undo_stack::snapshot(wrapper);
 	if (undo_data.compare(redo_data) != 0)
 		main->undo_s.add_action(
 			QTStr("Undo.Transform").arg(obs_source_get_name(obs_scene_get_source(main->GetCurrentScene()))),
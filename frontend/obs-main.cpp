@@ -84,6 +84,7 @@ bool opt_minimize_tray = false;
 bool opt_allow_opengl = false;
 bool opt_always_on_top = false;
 bool opt_disable_updater = false;
+bool opt_profiler_trace = false;
 bool opt_disable_missing_files_check = false;
 bool opt_disable_startup_splash = false;
 string opt_starting_collection;
@@ -477,6 +478,13 @@ static void SaveProfilerData(const ProfilerSnapshot &snap)
 	BPtr<char> path = GetAppConfigPathPtr(dst.str().c_str());
 	if (!profiler_snapshot_dump_csv_gz(snap.get(), path))
 		blog(LOG_WARNING, "Could not save profiler data to '%s'", static_cast<const char *>(path));
+
+	if (!path || !profiler_trace_active())
+		return;
+
+	string tracePath = string(path.Get(), strlen(path) - strlen(".csv.gz")) + ".trace.json";
+	if (!profiler_trace_dump_json(tracePath.c_str()))
+		blog(LOG_WARNING, "Could not save profiler trace to '%s'", tracePath.c_str());
 }
 
 static auto ProfilerFree = [](void *) {
@@ -538,6 +546,8 @@ static int run_program(fstream &logFile, int argc, char *argv[])
 	std::unique_ptr<void, decltype(ProfilerFree)> prof_release(static_cast<void *>(&ProfilerFree), ProfilerFree);
 
 	profiler_start();
+	if (opt_profiler_trace)
+		profiler_trace_start(0);
 	profile_register_root(run_program_init, 0);
 
 	ScopeProfiler prof{run_program_init};
@@ -1072,6 +1082,9 @@ int main(int argc, char *argv[])
 		} else if (arg_is(argv[i], "--disable-startup-splash", nullptr)) {
 			opt_disable_startup_splash = true;
 
+		} else if (arg_is(argv[i], "--profiler-trace", nullptr)) {
+			opt_profiler_trace = true;
+
 		} else if (arg_is(argv[i], "--steam", nullptr)) {
 			steam = true;
 
@@ -1101,7 +1114,9 @@ int main(int argc, char *argv[])
 				"--disable-updater: Disable built-in updater (Windows/Mac only)\n\n"
 				"--disable-missing-files-check: Disable the missing files dialog\n"
 				"which can appear on startup.\n"
-				"--disable-startup-splash: Disable startup splash and progress UI.\n\n";
+				"--disable-startup-splash: Disable startup splash and progress UI.\n"
+				"--profiler-trace: Record a timeline of profiled calls and save it\n"
+				"as Chrome trace JSON next to the profiler data on exit.\n\n";
 
 #ifdef _WIN32
 			MessageBoxA(NULL, help.c_str(), "Help", MB_OK | MB_ICONASTERISK);
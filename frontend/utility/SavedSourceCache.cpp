@@ -0,0 +1,140 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "SavedSourceCache.hpp"
+
+namespace {
+
+// Indentation of the elements of an array at the top level of the document, see json_write_indent in obs-data.c
+constexpr std::string_view kElementIndent{"\n        "};
+constexpr std::string_view kMemberIndent{"\n    "};
+
+std::string indentElement(std::string_view json)
+{
+	std::string result;
+	result.reserve(json.size() + json.size() / 8);
+
+	for (size_t pos = json.find('\n'); pos != std::string_view::npos; pos = json.find('\n')) {
+		result += json.substr(0, pos);
+		result += kElementIndent;
+		json.remove_prefix(pos + 1);
+	}
+
+	result += json;
+	return result;
+}
+
+} // namespace
+
+namespace OBS {
+
+void SavedSourceCache::BeginSave()
+{
+	for (auto &entry : entries) {
+		entry.second.used = false;
+	}
+}
+
+void SavedSourceCache::EndSave()
+{
+	for (auto it = entries.begin(); it != entries.end();) {
+		if (it->second.used) {
+			++it;
+		} else {
+			it = entries.erase(it);
+		}
+	}
+}
+
+void SavedSourceCache::Clear()
+{
+	entries.clear();
+}
+
+const std::string &SavedSourceCache::Get(const std::string &uuid, std::vector<long> revisions,
+					 const SaveFunction &save)
+{
+	Entry &entry = entries[uuid];
+	entry.used = true;
+
+	if (!entry.json.empty() && entry.revisions == revisions) {
+		return entry.json;
+	}
+
+	obs_data_t *data = save();
+	const char *json = obs_data_get_json_pretty(data);
+
+	entry.revisions = std::move(revisions);
+	entry.json = indentElement(json ? json : "null");
+
+	obs_data_release(data);
+	return entry.json;
+}
+
+std::string SavedSourceCache::MakeArray(const std::vector<const std::string *> &elements)
+{
+	if (elements.empty()) {
+		return "[]";
+	}
+
+	size_t size = 0;
+	for (const std::string *element : elements) {
+		size += element->size() + kElementIndent.size() + 1;
+	}
+
+	std::string array;
+	array.reserve(size + kMemberIndent.size() + 2);
+	array += '[';
+
+	for (size_t i = 0; i < elements.size(); i++) {
+		if (i) {
+			array += ',';
+		}
+		array += kElementIndent;
+		array += *elements[i];
+	}
+
+	array += kMemberIndent;
+	array += ']';
+	return array;
+}
+
+bool SavedSourceCache::AppendMember(std::string &object, std::string_view name, std::string_view value)
+{
+	std::string member;
+	member.reserve(kMemberIndent.size() + name.size() + value.size() + 4);
+	member += kMemberIndent;
+	member += '"';
+	member += name;
+	member += "\": ";
+	member += value;
+
+	if (object == "{}") {
+		object.insert(1, member + "\n");
+		return true;
+	}
+
+	if (object.size() < 4 || object.front() != '{' || object.compare(object.size() - 2, 2, "\n}") != 0) {
+		return false;
+	}
+
+	object.insert(object.size() - 2, "," + member);
+	return true;
+}
+
+} // namespace OBS
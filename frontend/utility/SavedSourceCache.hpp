@@ -0,0 +1,64 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <obs.h>
+
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace OBS {
+
+// Keeps the pretty JSON of the sources saved into a scene collection, so a source is only saved and formatted again
+// when its save revisions change.
+class SavedSourceCache {
+public:
+	// Returns a new reference to the saved data of a source.
+	using SaveFunction = std::function<obs_data_t *()>;
+
+	// Entries that aren't used between BeginSave and EndSave belong to sources that are gone and are dropped.
+	void BeginSave();
+	void EndSave();
+	void Clear();
+
+	// Returns the JSON of a source, formatted as an element of an array at the top level of the document. The
+	// reference stays valid until the next EndSave or Clear.
+	const std::string &Get(const std::string &uuid, std::vector<long> revisions, const SaveFunction &save);
+
+	// Formats elements returned by Get as the value of a member at the top level of the document.
+	static std::string MakeArray(const std::vector<const std::string *> &elements);
+
+	// Adds a member with an already formatted value to the pretty JSON of the document object. The name is used as
+	// it is and must not need escaping. Returns false if the object doesn't come from obs_data_get_json_pretty.
+	static bool AppendMember(std::string &object, std::string_view name, std::string_view value);
+
+private:
+	struct Entry {
+		std::vector<long> revisions;
+		std::string json;
+		bool used = false;
+	};
+
+	std::unordered_map<std::string, Entry> entries;
+};
+
+} // namespace OBS
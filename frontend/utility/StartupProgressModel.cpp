@@ -30,6 +30,7 @@ constexpr double kModuleLoadingStartPercent = 35.0;
 constexpr double kModuleLoadingWeight = 45.0;
 constexpr double kModulesLoadedPercent = 80.0;
 constexpr double kServiceInitializedPercent = 90.0;
+constexpr double kSceneCollectionLoadingWeight = 7.0;
 constexpr double kSceneCollectionLoadedPercent = 97.0;
 constexpr double kUiReadyPercent = 99.0;
 constexpr double kFinishedPercent = 100.0;
@@ -60,6 +61,11 @@ void StartupProgressModel::Reset()
 	totalModules = 0;
 	processedModules = 0;
 	progressPercent = 0.0;
+	sourcePhase = OBS::StartupSourcePhase::Create;
+	totalSources = 0;
+	processedSources = 0;
+	sourceCreateNs = 0;
+	sourceLoadNs = 0;
 	currentModuleName.clear();
 	finishedModules.clear();
 }
@@ -117,6 +123,29 @@ void StartupProgressModel::MarkModuleFinished(std::string_view moduleName)
 	UpdateProgress();
 }
 
+void StartupProgressModel::SetSourceProgress(StartupSourcePhase phase, size_t processed, size_t total,
+					     uint64_t elapsedNs)
+{
+	if (StageAfter(StartupProgressStage::SceneCollectionLoading, stage))
+		stage = StartupProgressStage::SceneCollectionLoading;
+
+	sourcePhase = phase;
+	totalSources = total;
+	processedSources = std::min(processed, total);
+
+	if (phase == StartupSourcePhase::Create)
+		sourceCreateNs = elapsedNs;
+	else
+		sourceLoadNs = elapsedNs;
+
+	UpdateProgress();
+}
+
+uint64_t StartupProgressModel::SourcePhaseDurationNs(StartupSourcePhase phase) const
+{
+	return phase == StartupSourcePhase::Create ? sourceCreateNs : sourceLoadNs;
+}
+
 double StartupProgressModel::CalculateRawPercent() const
 {
 	double moduleFraction = 0.0;
@@ -130,6 +159,16 @@ double StartupProgressModel::CalculateRawPercent() const
 		}
 	}
 
+	/* creating and loading the sources each take half of the scene
+	 * collection range */
+	double sourceFraction = 0.0;
+	if (totalSources != 0)
+		sourceFraction = static_cast<double>(processedSources) / static_cast<double>(totalSources);
+	if (sourcePhase == StartupSourcePhase::Load)
+		sourceFraction = 0.5 + sourceFraction * 0.5;
+	else
+		sourceFraction *= 0.5;
+
 	switch (stage) {
 	case StartupProgressStage::Boot:
 		return 0.0;
@@ -145,6 +184,8 @@ double StartupProgressModel::CalculateRawPercent() const
 		return kModulesLoadedPercent;
 	case StartupProgressStage::ServiceInitialized:
 		return kServiceInitializedPercent;
+	case StartupProgressStage::SceneCollectionLoading:
+		return kServiceInitializedPercent + (sourceFraction * kSceneCollectionLoadingWeight);
 	case StartupProgressStage::SceneCollectionLoaded:
 		return kSceneCollectionLoadedPercent;
 	case StartupProgressStage::UiReady:
@@ -19,6 +19,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 #include <string>
 #include <string_view>
 #include <unordered_set>
@@ -33,11 +34,17 @@ enum class StartupProgressStage {
 	ModuleLoading,
 	ModulesLoaded,
 	ServiceInitialized,
+	SceneCollectionLoading,
 	SceneCollectionLoaded,
 	UiReady,
 	Finished,
 };
 
+enum class StartupSourcePhase {
+	Create,
+	Load,
+};
+
 class StartupProgressModel {
 public:
 	StartupProgressModel();
@@ -48,6 +55,7 @@ public:
 	void SetModuleCount(size_t totalModules);
 	void MarkModuleStarted(std::string_view moduleName);
 	void MarkModuleFinished(std::string_view moduleName);
+	void SetSourceProgress(StartupSourcePhase phase, size_t processed, size_t total, uint64_t elapsedNs);
 
 	int Percent() const;
 	double PercentPrecise() const;
@@ -56,6 +64,10 @@ public:
 	const std::string &CurrentModuleName() const { return currentModuleName; }
 	size_t TotalModules() const { return totalModules; }
 	size_t ProcessedModules() const { return processedModules; }
+	StartupSourcePhase SourcePhase() const { return sourcePhase; }
+	size_t TotalSources() const { return totalSources; }
+	size_t ProcessedSources() const { return processedSources; }
+	uint64_t SourcePhaseDurationNs(StartupSourcePhase phase) const;
 
 private:
 	double CalculateRawPercent() const;
@@ -67,6 +79,12 @@ private:
 	size_t processedModules = 0;
 	double progressPercent = 0.0;
 
+	StartupSourcePhase sourcePhase = StartupSourcePhase::Create;
+	size_t totalSources = 0;
+	size_t processedSources = 0;
+	uint64_t sourceCreateNs = 0;
+	uint64_t sourceLoadNs = 0;
+
 	std::string currentModuleName;
 	std::unordered_set<std::string> finishedModules;
 };
@@ -160,3 +160,21 @@ void undo_stack::clear_redo()
 {
 	redo_items.clear();
 }
+
+std::string undo_stack::snapshot(obs_data_t *data)
+{
+	size_t size;
+	uint8_t *bin = obs_data_get_binary(data, &size);
+	if (!bin)
+		return std::string();
+
+	std::string str(reinterpret_cast<const char *>(bin), size);
+
+	bfree(bin);
+	return str;
+}
+
+obs_data_t *undo_stack::restore(const std::string &data)
+{
+	return obs_data_create_from_binary(data.data(), data.size());
+}
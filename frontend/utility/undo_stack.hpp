@@ -2,6 +2,8 @@
 
 #include "ui_OBSBasic.h"
 
+#include <obs.h>
+
 #include <QObject>
 #include <QString>
 #include <QTimer>
@@ -55,4 +57,9 @@ public:
 			const std::string &undo_data, const std::string &redo_data, bool repeatable = false);
 	void undo();
 	void redo();
+
+	/* compact copy of data to use as undo/redo data, the callbacks read
+	 * it back with restore */
+	static std::string snapshot(obs_data_t *data);
+	static obs_data_t *restore(const std::string &data);
 };
@@ -26,6 +26,7 @@
 #include <utility/BasicOutputHandler.hpp>
 #include <utility/OBSCanvas.hpp>
 #include <utility/PreviewProgramSizeObserver.hpp>
+#include <utility/SavedSourceCache.hpp>
 #include <utility/VCamConfig.hpp>
 #include <utility/platform.hpp>
 #include <utility/undo_stack.hpp>
@@ -1066,6 +1067,8 @@ private:
 
 	OBSSceneCollectionCache collections;
 
+	OBS::SavedSourceCache savedSources;
+
 	void DisableRelativeCoordinates(bool disable);
 	void CreateDefaultScene(bool firstStart);
 	void Save(SceneCollection &collection);
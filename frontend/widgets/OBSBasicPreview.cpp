@@ -779,16 +779,16 @@ void OBSBasicPreview::mouseReleaseEvent(QMouseEvent *event)
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(main->GetCurrentScene(), true);
 
 	auto undo_redo = [](const std::string &data) {
-		OBSDataAutoRelease dat = obs_data_create_from_json(data.c_str());
+		OBSDataAutoRelease dat = undo_stack::restore(data);
 		OBSSourceAutoRelease source = obs_get_source_by_uuid(obs_data_get_string(dat, "scene_uuid"));
 		OBSBasic::Get()->SetCurrentScene(source.Get(), true);
 
-		obs_scene_load_transform_states(data.c_str());
+		obs_scene_load_transform_states_data(dat);
 	};
 
 	if (wrapper && rwrapper) {
-		std::string undo_data(obs_data_get_json(wrapper));
-		std::string redo_data(obs_data_get_json(rwrapper));
+		std::string undo_data = undo_stack::snapshot(wrapper);
+		std::string redo_data = undo_stack::snapshot(rwrapper);
 		if (changed && undo_data.compare(redo_data) != 0)
 			main->undo_s.add_action(
 				QTStr("Undo.Transform").arg(obs_source_get_name(main->GetCurrentSceneSource())),
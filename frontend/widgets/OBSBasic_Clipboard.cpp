@@ -59,8 +59,8 @@ void OBSBasic::on_actionPasteTransform_triggered()
 
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
+	std::string undo_data = undo_stack::snapshot(wrapper);
+	std::string redo_data = undo_stack::snapshot(rwrapper);
 	undo_s.add_action(QTStr("Undo.Transform.Paste").arg(obs_source_get_name(GetCurrentSceneSource())), undo_redo,
 			  undo_redo, undo_data, redo_data);
 }
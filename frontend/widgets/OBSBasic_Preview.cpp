@@ -347,12 +347,12 @@ void OBSBasic::Nudge(int dist, MoveDir dir)
 	if (!recent_nudge) {
 		recent_nudge = true;
 		OBSDataAutoRelease wrapper = obs_scene_save_transform_states(GetCurrentScene(), true);
-		std::string undo_data(obs_data_get_json(wrapper));
+		std::string undo_data = undo_stack::snapshot(wrapper);
 
 		nudge_timer = new QTimer;
 		QObject::connect(nudge_timer, &QTimer::timeout, this, [this, &recent_nudge = recent_nudge, undo_data]() {
 			OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(GetCurrentScene(), true);
-			std::string redo_data(obs_data_get_json(rwrapper));
+			std::string redo_data = undo_stack::snapshot(rwrapper);
 
 			undo_s.add_action(QTStr("Undo.Transform").arg(obs_source_get_name(GetCurrentSceneSource())),
 					  undo_redo, undo_redo, undo_data, redo_data);
@@ -439,6 +439,7 @@ static void ConfirmColor(SourceTree *sources, const QColor &color, QModelIndexLi
 		OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
 		obs_data_set_int(privData, "color-preset", 1);
 		obs_data_set_string(privData, "color", QT_TO_UTF8(color.name(QColor::HexArgb)));
+		obs_source_mark_changed(obs_scene_get_source(obs_sceneitem_get_scene(sceneItem)));
 	}
 }
 
@@ -465,6 +466,7 @@ void OBSBasic::ColorChange()
 			OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
 			obs_data_set_int(privData, "color-preset", preset + 1);
 			obs_data_set_string(privData, "color", "");
+			obs_source_mark_changed(obs_scene_get_source(obs_sceneitem_get_scene(sceneItem)));
 		}
 
 		for (int i = 1; i < 9; i++) {
@@ -543,6 +545,7 @@ void OBSBasic::ColorChange()
 				OBSDataAutoRelease privData = obs_sceneitem_get_private_settings(sceneItem);
 				obs_data_set_int(privData, "color-preset", preset);
 				obs_data_set_string(privData, "color", "");
+				obs_source_mark_changed(obs_scene_get_source(obs_sceneitem_get_scene(sceneItem)));
 			}
 		}
 	}
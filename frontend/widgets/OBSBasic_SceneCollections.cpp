@@ -108,30 +108,24 @@ void updateRemigrationMenuItem(SceneCoordinateMode mode, QAction *menuItem)
 	menuItem->setEnabled(isAbsoluteCoordinateMode);
 }
 
-void removeRelativePositionData(obs_data_t *settings)
+void removeRelativePositionData(obs_data_t *sourceData)
 {
-	OBSDataArrayAutoRelease sources = obs_data_get_array(settings, "sources");
-
-	auto iterateCallback = [](obs_data_t *data, void *) {
-		const std::string_view id{obs_data_get_string(data, "id")};
-		if (id != "scene" && id != "group") {
-			return;
-		}
-
-		OBSDataAutoRelease settings = obs_data_get_obj(data, "settings");
-		OBSDataArrayAutoRelease items = obs_data_get_array(settings, "items");
+	const std::string_view id{obs_data_get_string(sourceData, "id")};
+	if (id != "scene" && id != "group") {
+		return;
+	}
 
-		auto cleanupCallback = [](obs_data_t *data, void *) {
-			obs_data_unset_user_value(data, "pos_rel");
-			obs_data_unset_user_value(data, "scale_rel");
-			obs_data_unset_user_value(data, "scale_ref");
-			obs_data_unset_user_value(data, "bounds_rel");
-		};
+	OBSDataAutoRelease settings = obs_data_get_obj(sourceData, "settings");
+	OBSDataArrayAutoRelease items = obs_data_get_array(settings, "items");
 
-		obs_data_array_enum(items, cleanupCallback, nullptr);
+	auto cleanupCallback = [](obs_data_t *data, void *) {
+		obs_data_unset_user_value(data, "pos_rel");
+		obs_data_unset_user_value(data, "scale_rel");
+		obs_data_unset_user_value(data, "scale_ref");
+		obs_data_unset_user_value(data, "bounds_rel");
 	};
 
-	obs_data_array_enum(sources, iterateCallback, nullptr);
+	obs_data_array_enum(items, cleanupCallback, nullptr);
 }
 
 } // namespace
@@ -800,6 +794,49 @@ constexpr std::string_view AUX_AUDIO_1{"AuxAudioDevice1"};
 constexpr std::string_view AUX_AUDIO_2{"AuxAudioDevice2"};
 constexpr std::string_view AUX_AUDIO_3{"AuxAudioDevice3"};
 constexpr std::string_view AUX_AUDIO_4{"AuxAudioDevice4"};
+
+// Everything the saved data of a source depends on. Scenes also save the items of their groups and the settings of
+// item transitions, and the absolute positions of items depend on the size of the canvas.
+std::vector<long> getSaveRevisions(obs_source_t *source)
+{
+	std::vector<long> revisions{obs_source_get_save_revision(source)};
+
+	obs_scene_t *scene = obs_group_or_scene_from_source(source);
+	if (!scene) {
+		return revisions;
+	}
+
+	obs_video_info ovi;
+	if (obs_get_video_info(&ovi)) {
+		revisions.push_back(ovi.base_width);
+		revisions.push_back(ovi.base_height);
+	}
+
+	OBSCanvasAutoRelease canvas = obs_source_get_canvas(source);
+	if (canvas && obs_canvas_get_video_info(canvas, &ovi)) {
+		revisions.push_back(ovi.base_width);
+		revisions.push_back(ovi.base_height);
+	}
+
+	auto addItemRevisions = [](obs_scene_t *, obs_sceneitem_t *item, void *param) {
+		auto &revisions = *static_cast<std::vector<long> *>(param);
+
+		if (obs_sceneitem_is_group(item)) {
+			revisions.push_back(obs_source_get_save_revision(obs_sceneitem_get_source(item)));
+		}
+
+		for (bool show : {true, false}) {
+			if (obs_source_t *transition = obs_sceneitem_get_transition(item, show)) {
+				revisions.push_back(obs_source_get_save_revision(transition));
+			}
+		}
+
+		return true;
+	};
+
+	obs_scene_enum_items(scene, addItemRevisions, &revisions);
+	return revisions;
+}
 } // namespace
 
 void OBSBasic::Save(SceneCollection &collection)
@@ -831,16 +868,19 @@ void OBSBasic::Save(SceneCollection &collection)
 
 	// Non-global sources
 
-	// Save all non-scene sources first
+	// Save all non-scene sources first. The filter only picks them, they're saved along with the scenes below.
+	vector<OBSSource> sources;
 	auto FilterAudioSources = [&](obs_source_t *source) {
 		if (obs_source_is_group(source) || obs_source_is_scene(source))
 			return false;
 
-		return std::find(begin(audioSources), end(audioSources), source) == end(audioSources);
+		if (std::find(begin(audioSources), end(audioSources), source) == end(audioSources))
+			sources.emplace_back(source);
+		return false;
 	};
 	using FilterAudioSources_t = decltype(FilterAudioSources);
 
-	OBSDataArrayAutoRelease sourcesArray = obs_save_sources_filtered(
+	OBSDataArrayAutoRelease emptyArray = obs_save_sources_filtered(
 		[](void *data, obs_source_t *source) {
 			auto &func = *static_cast<FilterAudioSources_t *>(data);
 			return func(source);
@@ -849,19 +889,18 @@ void OBSBasic::Save(SceneCollection &collection)
 
 	// Saving groups separately ensures they won't be loaded in older versions.
 	// TODO: Get rid of this at some point. Groups were introduced in 22.0
-	OBSDataArrayAutoRelease groupsArray = obs_data_array_create();
+	vector<OBSSource> groups;
 
-	auto sourcesAndGroups = std::make_pair(sourcesArray.Get(), groupsArray.Get());
+	auto sourcesAndGroups = std::make_pair(&sources, &groups);
 	using sourcesAndGroups_t = decltype(sourcesAndGroups);
 
 	auto exportSceneItemsCallback = [](void *param, obs_source_t *source) -> bool {
 		auto sourcesArrays = static_cast<sourcesAndGroups_t *>(param);
-		OBSDataAutoRelease source_data = obs_save_source(source);
 
 		if (obs_source_is_scene(source)) {
-			obs_data_array_push_back(sourcesArrays->first, source_data);
+			sourcesArrays->first->emplace_back(source);
 		} else {
-			obs_data_array_push_back(sourcesArrays->second, source_data);
+			sourcesArrays->second->emplace_back(source);
 		}
 		return true;
 	};
@@ -877,8 +916,38 @@ void OBSBasic::Save(SceneCollection &collection)
 		obs_canvas_enum_scenes(canvas, exportSceneItemsCallback, &sourcesAndGroups);
 	}
 
-	obs_data_set_array(saveData, "sources", sourcesArray);
-	obs_data_set_array(saveData, "groups", groupsArray);
+	// Only sources that changed since the last save are saved and formatted again, the JSON of the rest is reused.
+	SceneCoordinateMode coordinateMode = collection.getCoordinateMode();
+	bool absoluteCoordinates = coordinateMode == SceneCoordinateMode::Absolute;
+
+	savedSources.BeginSave();
+
+	auto SaveSources = [&](const vector<OBSSource> &list, bool removeRelative) {
+		vector<const string *> elements;
+		elements.reserve(list.size());
+
+		for (obs_source_t *source : list) {
+			vector<long> revisions = getSaveRevisions(source);
+			revisions.push_back(removeRelative);
+
+			auto save = [source, removeRelative]() {
+				obs_data_t *data = obs_save_source(source);
+				if (removeRelative) {
+					removeRelativePositionData(data);
+				}
+				return data;
+			};
+
+			elements.push_back(&savedSources.Get(obs_source_get_uuid(source), std::move(revisions), save));
+		}
+
+		return OBS::SavedSourceCache::MakeArray(elements);
+	};
+
+	string sourcesJson = SaveSources(sources, absoluteCoordinates);
+	string groupsJson = SaveSources(groups, false);
+
+	savedSources.EndSave();
 
 	// UI scene order
 	OBSDataArrayAutoRelease sceneOrder = SaveSceneListOrder();
@@ -957,11 +1026,6 @@ void OBSBasic::Save(SceneCollection &collection)
 	}
 
 	OBS::Rect migrationResolution = collection.getMigrationResolution();
-	SceneCoordinateMode coordinateMode = collection.getCoordinateMode();
-
-	if (coordinateMode == SceneCoordinateMode::Absolute) {
-		removeRelativePositionData(saveData);
-	}
 
 	if (!migrationResolution.isZero() && coordinateMode == SceneCoordinateMode::Relative) {
 		OBSDataAutoRelease resolutionData = obs_data_create();
@@ -976,8 +1040,17 @@ void OBSBasic::Save(SceneCollection &collection)
 	int sceneCollectionVersion = collection.getVersion();
 	obs_data_set_int(saveData, "version", sceneCollectionVersion);
 
+	// The sources are added to the end of the document
+	string json = obs_data_get_json_pretty(saveData);
+	if (!OBS::SavedSourceCache::AppendMember(json, "sources", sourcesJson) ||
+	    !OBS::SavedSourceCache::AppendMember(json, "groups", groupsJson)) {
+		blog(LOG_ERROR, "Could not add sources to scene data");
+		return;
+	}
+
 	const std::string collectionFileName = collection.getFilePathString();
-	bool success = obs_data_save_json_pretty_safe(saveData, collectionFileName.c_str(), "tmp", "bak");
+	bool success = os_quick_write_utf8_file_safe(collectionFileName.c_str(), json.c_str(), json.size(), false,
+						     "tmp", "bak");
 
 	if (!success) {
 		blog(LOG_ERROR, "Could not save scene data to %s", collectionFileName.c_str());
@@ -1166,6 +1239,12 @@ static inline void AddMissingFiles(void *data, obs_source_t *source)
 	obs_missing_files_destroy(sf);
 }
 
+static void SourceLoadProgress(void *, enum obs_source_load_phase phase, size_t processed, size_t total,
+			       uint64_t elapsed_ns)
+{
+	App()->UpdateStartupSourceProgress(phase, processed, total, elapsed_ns);
+}
+
 void OBSBasic::LoadData(obs_data_t *data, SceneCollection &collection)
 {
 	ClearSceneData();
@@ -1317,7 +1396,9 @@ void OBSBasic::LoadData(obs_data_t *data, SceneCollection &collection)
 	updateRemigrationMenuItem(collection.getCoordinateMode(), ui->actionRemigrateSceneCollection);
 
 	obs_missing_files_t *files = obs_missing_files_create();
+	obs_set_source_load_progress_callback(SourceLoadProgress, nullptr);
 	obs_load_sources(sources, AddMissingFiles, files);
+	obs_set_source_load_progress_callback(nullptr, nullptr);
 
 	if (resetVideo)
 		ResetVideo();
@@ -1544,6 +1625,7 @@ void OBSBasic::ClearSceneData()
 	}
 
 	collectionModuleData = nullptr;
+	savedSources.Clear();
 	lastScene = nullptr;
 	swapScene = nullptr;
 	programScene = nullptr;
@@ -595,13 +595,15 @@ void OBSBasic::on_scenes_customContextMenuRequested(const QPoint &pos)
 		multiviewAction->setCheckable(true);
 		multiviewAction->setChecked(show);
 
-		auto showInMultiview = [](OBSData data) {
+		auto showInMultiview = [](OBSSource source, OBSData data) {
 			bool show = obs_data_get_bool(data, "show_in_multiview");
 			obs_data_set_bool(data, "show_in_multiview", !show);
+			obs_source_mark_changed(source);
 			OBSProjector::UpdateMultiviewProjectors();
 		};
 
-		connect(multiviewAction, &QAction::triggered, multiviewAction, std::bind(showInMultiview, data.Get()));
+		connect(multiviewAction, &QAction::triggered, multiviewAction,
+			std::bind(showInMultiview, source, data.Get()));
 
 		copyFilters->setEnabled(obs_source_filter_count(source) > 0);
 	}
@@ -958,8 +960,8 @@ void OBSBasic::on_actionResetTransform_triggered()
 	obs_scene_enum_items(scene, reset_tr, nullptr);
 	OBSDataAutoRelease rwrapper = obs_scene_save_transform_states(scene, false);
 
-	std::string undo_data(obs_data_get_json(wrapper));
-	std::string redo_data(obs_data_get_json(rwrapper));
+	std::string undo_data = undo_stack::snapshot(wrapper);
+	std::string redo_data = undo_stack::snapshot(rwrapper);
 	undo_s.add_action(QTStr("Undo.Transform.Reset").arg(obs_source_get_name(obs_scene_get_source(scene))),
 			  undo_redo, undo_redo, undo_data, redo_data);
 
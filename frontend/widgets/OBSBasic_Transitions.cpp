@@ -822,6 +822,7 @@ QMenu *OBSBasic::CreatePerSceneTransitionMenu()
 
 		if (uuid.empty()) {
 			obs_data_set_string(data, "transition", "");
+			obs_source_mark_changed(scene);
 			return;
 		}
 
@@ -833,6 +834,7 @@ QMenu *OBSBasic::CreatePerSceneTransitionMenu()
 		if (transition) {
 			const char *name = obs_source_get_name(transition);
 			obs_data_set_string(data, "transition", name);
+			obs_source_mark_changed(scene);
 		}
 	};
 
@@ -841,6 +843,7 @@ QMenu *OBSBasic::CreatePerSceneTransitionMenu()
 		OBSDataAutoRelease data = obs_source_get_private_settings(scene);
 
 		obs_data_set_int(data, "transition_duration", duration);
+		obs_source_mark_changed(scene);
 	};
 
 	connect(duration, &QSpinBox::valueChanged, this, setDuration);
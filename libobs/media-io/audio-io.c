@@ -27,6 +27,7 @@
 
 #include "audio-io.h"
 #include "audio-resampler.h"
+#include "audio-mix.h"
 
 #ifdef _WIN32
 #define WIN32_LEAN_AND_MEAN
@@ -35,6 +36,7 @@
 #endif
 
 extern profiler_name_store_t *obs_get_profiler_name_store(void);
+extern void obs_apply_thread_config(const char *role);
 
 /* #define DEBUG_AUDIO */
 
@@ -142,17 +144,10 @@ static inline void clamp_audio_output(struct audio_output *audio, size_t bytes)
 
 		for (size_t plane = 0; plane < audio->planes; plane++) {
 			float *mix_data = mix->buffer[plane];
-			float *mix_end = &mix_data[float_size];
 			/* Unclamped mix is copied directly. */
 			memcpy(mix->buffer_unclamped[plane], mix_data, bytes);
 
-			while (mix_data < mix_end) {
-				float val = *mix_data;
-				val = (val == val) ? val : 0.0f;
-				val = (val > 1.0f) ? 1.0f : val;
-				val = (val < -1.0f) ? -1.0f : val;
-				*(mix_data++) = val;
-			}
+			audio_mix_clamp(mix_data, float_size);
 		}
 	}
 }
@@ -216,6 +211,7 @@ static void *audio_thread(void *param)
 	uint64_t prev_time = start_time;
 
 	os_set_thread_name("audio-io: audio thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_AUDIO);
 
 	const char *audio_thread_name =
 		profile_store_name(obs_get_profiler_name_store(), "audio_thread(%s)", audio->info.name);
@@ -0,0 +1,187 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "audio-mix.h"
+
+#include "../util/sse-intrin.h"
+
+#if (defined(_M_X64) && !defined(_M_ARM64EC)) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define USE_AVX_MIX
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX_FUNC
+#else
+#define AVX_FUNC __attribute__((target("avx")))
+#endif
+#endif
+
+/* The SSE versions go through sse-intrin.h, so on ARM they become NEON.
+ * Every kernel works element by element with separate multiplies and adds,
+ * which keeps the output bit-identical to the scalar loops. */
+
+static void audio_mix_add_sse(float *dst, const float *src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_loadu_ps(src + i);
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, s));
+	}
+
+	for (; i < count; i++)
+		dst[i] += src[i];
+}
+
+static void audio_mix_add_mul_sse(float *dst, const float *src, const float *mul, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 d = _mm_loadu_ps(dst + i);
+		__m128 s = _mm_mul_ps(_mm_loadu_ps(src + i), _mm_loadu_ps(mul + i));
+		_mm_storeu_ps(dst + i, _mm_add_ps(d, s));
+	}
+
+	for (; i < count; i++)
+		dst[i] += src[i] * mul[i];
+}
+
+static inline float clamp_sample(float val)
+{
+	val = (val == val) ? val : 0.0f;
+	val = (val > 1.0f) ? 1.0f : val;
+	val = (val < -1.0f) ? -1.0f : val;
+	return val;
+}
+
+static void audio_mix_clamp_sse(float *data, size_t count)
+{
+	const __m128 one = _mm_set1_ps(1.0f);
+	const __m128 neg_one = _mm_set1_ps(-1.0f);
+	size_t i = 0;
+
+	for (; i + 4 <= count; i += 4) {
+		__m128 val = _mm_loadu_ps(data + i);
+		/* zero NaNs first, min/max would otherwise pass them through */
+		val = _mm_and_ps(val, _mm_cmpord_ps(val, val));
+		val = _mm_max_ps(_mm_min_ps(val, one), neg_one);
+		_mm_storeu_ps(data + i, val);
+	}
+
+	for (; i < count; i++)
+		data[i] = clamp_sample(data[i]);
+}
+
+#ifdef USE_AVX_MIX
+
+static bool avx_supported(void)
+{
+	static int supported = -1;
+
+	if (supported == -1) {
+#ifdef _MSC_VER
+		int info[4];
+
+		__cpuid(info, 1);
+		supported = (info[2] & (1 << 27)) != 0 && (info[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+#else
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("avx") ? 1 : 0;
+#endif
+	}
+
+	return supported == 1;
+}
+
+AVX_FUNC static void audio_mix_add_avx(float *dst, const float *src, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256 d = _mm256_loadu_ps(dst + i);
+		__m256 s = _mm256_loadu_ps(src + i);
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(d, s));
+	}
+
+	for (; i < count; i++)
+		dst[i] += src[i];
+}
+
+AVX_FUNC static void audio_mix_add_mul_avx(float *dst, const float *src, const float *mul, size_t count)
+{
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256 d = _mm256_loadu_ps(dst + i);
+		__m256 s = _mm256_mul_ps(_mm256_loadu_ps(src + i), _mm256_loadu_ps(mul + i));
+		_mm256_storeu_ps(dst + i, _mm256_add_ps(d, s));
+	}
+
+	for (; i < count; i++)
+		dst[i] += src[i] * mul[i];
+}
+
+AVX_FUNC static void audio_mix_clamp_avx(float *data, size_t count)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 neg_one = _mm256_set1_ps(-1.0f);
+	size_t i = 0;
+
+	for (; i + 8 <= count; i += 8) {
+		__m256 val = _mm256_loadu_ps(data + i);
+		val = _mm256_and_ps(val, _mm256_cmp_ps(val, val, _CMP_ORD_Q));
+		val = _mm256_max_ps(_mm256_min_ps(val, one), neg_one);
+		_mm256_storeu_ps(data + i, val);
+	}
+
+	for (; i < count; i++)
+		data[i] = clamp_sample(data[i]);
+}
+
+#define DISPATCH(func, ...)                       \
+	do {                                      \
+		if (avx_supported())              \
+			func##_avx(__VA_ARGS__);  \
+		else                              \
+			func##_sse(__VA_ARGS__);  \
+	} while (false)
+
+#else
+
+#define DISPATCH(func, ...) func##_sse(__VA_ARGS__)
+
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+void audio_mix_add(float *dst, const float *src, size_t count)
+{
+	DISPATCH(audio_mix_add, dst, src, count);
+}
+
+void audio_mix_add_mul(float *dst, const float *src, const float *mul, size_t count)
+{
+	DISPATCH(audio_mix_add_mul, dst, src, mul, count);
+}
+
+void audio_mix_clamp(float *data, size_t count)
+{
+	DISPATCH(audio_mix_clamp, data, count);
+}
@@ -0,0 +1,44 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "../util/c99defs.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Float sample kernels used when mixing audio.  These pick the widest
+ * available SIMD path at runtime and produce the same results as the plain
+ * C loops they replace.
+ */
+
+/* dst[i] += src[i] */
+EXPORT void audio_mix_add(float *dst, const float *src, size_t count);
+
+/* dst[i] += src[i] * mul[i] */
+EXPORT void audio_mix_add_mul(float *dst, const float *src, const float *mul, size_t count);
+
+/* clamps data[i] to -1.0..1.0, NaNs become 0.0 */
+EXPORT void audio_mix_clamp(float *data, size_t count);
+
+#ifdef __cplusplus
+}
+#endif
@@ -19,6 +19,17 @@
 
 #include "../util/sse-intrin.h"
 
+#if (defined(_M_X64) && !defined(_M_ARM64EC)) || defined(_M_IX86) || defined(__x86_64__) || defined(__i386__)
+#define USE_AVX2_CONVERSION
+#include <immintrin.h>
+#ifdef _MSC_VER
+#include <intrin.h>
+#define AVX2_FUNC
+#else
+#define AVX2_FUNC __attribute__((target("avx2")))
+#endif
+#endif
+
 /* ...surprisingly, if I don't use a macro to force inlining, it causes the
  * CPU usage to boost by a tremendous amount in debug builds. */
 
@@ -77,8 +88,40 @@ static FORCE_INLINE uint32_t min_uint32(uint32_t a, uint32_t b)
 	return a < b ? a : b;
 }
 
-void compress_uyvx_to_i420(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
-			   uint8_t *output[], const uint32_t out_linesize[])
+/* uv holds eight 16-bit (u << 8 | v) values, each shared by two pixels */
+static FORCE_INLINE void decompress_420_16px(uint32_t *output, const uint8_t *lum, __m128i uv, __m128i zero)
+{
+	__m128i uv_lo = _mm_unpacklo_epi16(uv, uv);
+	__m128i uv_hi = _mm_unpackhi_epi16(uv, uv);
+	__m128i lum8 = _mm_loadu_si128((const __m128i *)lum);
+	__m128i lum_lo = _mm_unpacklo_epi8(lum8, zero);
+	__m128i lum_hi = _mm_unpackhi_epi8(lum8, zero);
+
+	_mm_storeu_si128((__m128i *)output, _mm_unpacklo_epi16(uv_lo, lum_lo));
+	_mm_storeu_si128((__m128i *)(output + 4), _mm_unpackhi_epi16(uv_lo, lum_lo));
+	_mm_storeu_si128((__m128i *)(output + 8), _mm_unpacklo_epi16(uv_hi, lum_hi));
+	_mm_storeu_si128((__m128i *)(output + 12), _mm_unpackhi_epi16(uv_hi, lum_hi));
+}
+
+/* uv holds eight 16-bit (v << 8 | u) values straight from the chroma plane */
+static FORCE_INLINE void decompress_nv12_16px(uint32_t *output, const uint8_t *lum, __m128i uv, __m128i zero)
+{
+	__m128i uv_lo = _mm_unpacklo_epi16(uv, uv);
+	__m128i uv_hi = _mm_unpackhi_epi16(uv, uv);
+	__m128i lum8 = _mm_loadu_si128((const __m128i *)lum);
+	__m128i yu_lo = _mm_or_si128(_mm_unpacklo_epi8(lum8, zero), _mm_slli_epi16(uv_lo, 8));
+	__m128i yu_hi = _mm_or_si128(_mm_unpackhi_epi8(lum8, zero), _mm_slli_epi16(uv_hi, 8));
+	__m128i v_lo = _mm_srli_epi16(uv_lo, 8);
+	__m128i v_hi = _mm_srli_epi16(uv_hi, 8);
+
+	_mm_storeu_si128((__m128i *)output, _mm_unpacklo_epi16(yu_lo, v_lo));
+	_mm_storeu_si128((__m128i *)(output + 4), _mm_unpackhi_epi16(yu_lo, v_lo));
+	_mm_storeu_si128((__m128i *)(output + 8), _mm_unpacklo_epi16(yu_hi, v_hi));
+	_mm_storeu_si128((__m128i *)(output + 12), _mm_unpackhi_epi16(yu_hi, v_hi));
+}
+
+static void compress_uyvx_to_i420_sse2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+				       uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
 {
 	uint8_t *lum_plane = output[0];
 	uint8_t *u_plane = output[1];
@@ -109,8 +152,8 @@ void compress_uyvx_to_i420(const uint8_t *input, uint32_t in_linesize, uint32_t
 	}
 }
 
-void compress_uyvx_to_nv12(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
-			   uint8_t *output[], const uint32_t out_linesize[])
+static void compress_uyvx_to_nv12_sse2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+				       uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
 {
 	uint8_t *lum_plane = output[0];
 	uint8_t *chroma_plane = output[1];
@@ -140,8 +183,8 @@ void compress_uyvx_to_nv12(const uint8_t *input, uint32_t in_linesize, uint32_t
 	}
 }
 
-void convert_uyvx_to_i444(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
-			  uint8_t *output[], const uint32_t out_linesize[])
+static void convert_uyvx_to_i444_sse2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+				      uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
 {
 	uint8_t *lum_plane = output[0];
 	uint8_t *u_plane = output[1];
@@ -173,14 +216,16 @@ void convert_uyvx_to_i444(const uint8_t *input, uint32_t in_linesize, uint32_t s
 	}
 }
 
-void decompress_420(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y, uint32_t end_y,
-		    uint8_t *output, uint32_t out_linesize)
+static void decompress_420_sse2(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y,
+				uint32_t end_y, uint8_t *output, uint32_t out_linesize)
 {
 	uint32_t start_y_d2 = start_y / 2;
 	uint32_t width_d2 = in_linesize[0] / 2;
 	uint32_t height_d2 = end_y / 2;
 	uint32_t y;
 
+	__m128i zero = _mm_setzero_si128();
+
 	for (y = start_y_d2; y < height_d2; y++) {
 		const uint8_t *chroma0 = input[1] + y * in_linesize[1];
 		const uint8_t *chroma1 = input[2] + y * in_linesize[2];
@@ -193,7 +238,23 @@ void decompress_420(const uint8_t *const input[], const uint32_t in_linesize[],
 		output0 = (uint32_t *)(output + y * 2 * out_linesize);
 		output1 = (uint32_t *)((uint8_t *)output0 + out_linesize);
 
-		for (x = 0; x < width_d2; x++) {
+		for (x = 0; x + 8 <= width_d2; x += 8) {
+			__m128i u = _mm_loadl_epi64((const __m128i *)chroma0);
+			__m128i v = _mm_loadl_epi64((const __m128i *)chroma1);
+			__m128i uv = _mm_unpacklo_epi8(v, u);
+
+			decompress_420_16px(output0, lum0, uv, zero);
+			decompress_420_16px(output1, lum1, uv, zero);
+
+			chroma0 += 8;
+			chroma1 += 8;
+			lum0 += 16;
+			lum1 += 16;
+			output0 += 16;
+			output1 += 16;
+		}
+
+		for (; x < width_d2; x++) {
 			uint32_t out;
 			out = (*(chroma0++) << 8) | *(chroma1++);
 
@@ -206,14 +267,16 @@ void decompress_420(const uint8_t *const input[], const uint32_t in_linesize[],
 	}
 }
 
-void decompress_nv12(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y, uint32_t end_y,
-		     uint8_t *output, uint32_t out_linesize)
+static void decompress_nv12_sse2(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y,
+				 uint32_t end_y, uint8_t *output, uint32_t out_linesize)
 {
 	uint32_t start_y_d2 = start_y / 2;
 	uint32_t width_d2 = min_uint32(in_linesize[0], out_linesize) / 2;
 	uint32_t height_d2 = end_y / 2;
 	uint32_t y;
 
+	__m128i zero = _mm_setzero_si128();
+
 	for (y = start_y_d2; y < height_d2; y++) {
 		const uint16_t *chroma;
 		register const uint8_t *lum0, *lum1;
@@ -226,7 +289,20 @@ void decompress_nv12(const uint8_t *const input[], const uint32_t in_linesize[],
 		output0 = (uint32_t *)(output + y * 2 * out_linesize);
 		output1 = (uint32_t *)((uint8_t *)output0 + out_linesize);
 
-		for (x = 0; x < width_d2; x++) {
+		for (x = 0; x + 8 <= width_d2; x += 8) {
+			__m128i uv = _mm_loadu_si128((const __m128i *)chroma);
+
+			decompress_nv12_16px(output0, lum0, uv, zero);
+			decompress_nv12_16px(output1, lum1, uv, zero);
+
+			chroma += 8;
+			lum0 += 16;
+			lum1 += 16;
+			output0 += 16;
+			output1 += 16;
+		}
+
+		for (; x < width_d2; x++) {
 			uint32_t out = *(chroma++) << 8;
 
 			*(output0++) = *(lum0++) | out;
@@ -238,51 +314,483 @@ void decompress_nv12(const uint8_t *const input[], const uint32_t in_linesize[],
 	}
 }
 
-void decompress_422(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y, uint8_t *output,
-		    uint32_t out_linesize, bool leading_lum)
+static FORCE_INLINE uint32_t dup_422_lum(uint32_t dw, bool leading_lum)
+{
+	if (leading_lum) {
+		dw &= 0xFFFFFF00;
+		dw |= (uint8_t)(dw >> 16);
+	} else {
+		dw &= 0xFFFF00FF;
+		dw |= (dw >> 16) & 0xFF00;
+	}
+
+	return dw;
+}
+
+static void decompress_422_sse2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
+				uint8_t *output, uint32_t out_linesize, bool leading_lum)
 {
 	uint32_t width_d2 = min_uint32(in_linesize, out_linesize) / 2;
 	uint32_t y;
 
-	register const uint32_t *input32;
-	register const uint32_t *input32_end;
-	register uint32_t *output32;
+	__m128i keep_mask = _mm_set1_epi32(leading_lum ? 0xFFFFFF00 : 0xFFFF00FF);
+	__m128i lum_mask = _mm_set1_epi32(leading_lum ? 0x000000FF : 0x0000FF00);
 
-	if (leading_lum) {
-		for (y = start_y; y < end_y; y++) {
-			input32 = (const uint32_t *)(input + y * in_linesize);
-			input32_end = input32 + width_d2;
-			output32 = (uint32_t *)(output + y * out_linesize);
-
-			while (input32 < input32_end) {
-				register uint32_t dw = *input32;
-
-				output32[0] = dw;
-				dw &= 0xFFFFFF00;
-				dw |= (uint8_t)(dw >> 16);
-				output32[1] = dw;
-
-				output32 += 2;
-				input32++;
-			}
+	for (y = start_y; y < end_y; y++) {
+		const uint32_t *input32 = (const uint32_t *)(input + y * in_linesize);
+		const uint32_t *input32_end = input32 + width_d2;
+		uint32_t *output32 = (uint32_t *)(output + y * out_linesize);
+
+		while (input32 + 4 <= input32_end) {
+			__m128i dw = _mm_loadu_si128((const __m128i *)input32);
+			__m128i dup = _mm_or_si128(_mm_and_si128(dw, keep_mask),
+						   _mm_and_si128(_mm_srli_epi32(dw, 16), lum_mask));
+
+			_mm_storeu_si128((__m128i *)output32, _mm_unpacklo_epi32(dw, dup));
+			_mm_storeu_si128((__m128i *)(output32 + 4), _mm_unpackhi_epi32(dw, dup));
+
+			output32 += 8;
+			input32 += 4;
 		}
-	} else {
-		for (y = start_y; y < end_y; y++) {
-			input32 = (const uint32_t *)(input + y * in_linesize);
-			input32_end = input32 + width_d2;
-			output32 = (uint32_t *)(output + y * out_linesize);
-
-			while (input32 < input32_end) {
-				register uint32_t dw = *input32;
-
-				output32[0] = dw;
-				dw &= 0xFFFF00FF;
-				dw |= (dw >> 16) & 0xFF00;
-				output32[1] = dw;
-
-				output32 += 2;
-				input32++;
-			}
+
+		while (input32 < input32_end) {
+			uint32_t dw = *input32;
+
+			output32[0] = dw;
+			output32[1] = dup_422_lum(dw, leading_lum);
+
+			output32 += 2;
+			input32++;
 		}
 	}
 }
+
+/* ------------------------------------------------------------------------- */
+/* AVX2 versions, only used when the CPU reports support at runtime          */
+
+#ifdef USE_AVX2_CONVERSION
+
+static bool avx2_supported(void)
+{
+	static int supported = -1;
+
+	if (supported == -1) {
+#ifdef _MSC_VER
+		int info[4];
+		bool os_saves_ymm = false;
+
+		__cpuid(info, 1);
+		if ((info[2] & (1 << 27)) != 0)
+			os_saves_ymm = (_xgetbv(0) & 6) == 6;
+
+		__cpuidex(info, 7, 0);
+		supported = os_saves_ymm && (info[1] & (1 << 5)) != 0;
+#else
+		__builtin_cpu_init();
+		supported = __builtin_cpu_supports("avx2") ? 1 : 0;
+#endif
+	}
+
+	return supported == 1;
+}
+
+#define pack_shift_avx2(lum_plane, lum_pos0, lum_pos1, line1, line2, mask, sh, perm)                     \
+	do {                                                                                              \
+		__m256i pack_val = _mm256_packs_epi32(_mm256_srli_si256(_mm256_and_si256(line1, mask), sh), \
+						      _mm256_srli_si256(_mm256_and_si256(line2, mask), sh)); \
+		pack_val = _mm256_packus_epi16(pack_val, pack_val);                                       \
+		pack_val = _mm256_permutevar8x32_epi32(pack_val, perm);                                   \
+                                                                                                          \
+		__m128i lines = _mm256_castsi256_si128(pack_val);                                         \
+		_mm_storel_epi64((__m128i *)(lum_plane + lum_pos0), lines);                               \
+		_mm_storel_epi64((__m128i *)(lum_plane + lum_pos1), _mm_srli_si128(lines, 8));            \
+	} while (false)
+
+#define pack_val_avx2(lum_plane, lum_pos0, lum_pos1, line1, line2, mask, perm)                                        \
+	do {                                                                                                          \
+		__m256i pack_val = _mm256_packs_epi32(_mm256_and_si256(line1, mask), _mm256_and_si256(line2, mask)); \
+		pack_val = _mm256_packus_epi16(pack_val, pack_val);                                                   \
+		pack_val = _mm256_permutevar8x32_epi32(pack_val, perm);                                               \
+                                                                                                                      \
+		__m128i lines = _mm256_castsi256_si128(pack_val);                                                     \
+		_mm_storel_epi64((__m128i *)(lum_plane + lum_pos0), lines);                                           \
+		_mm_storel_epi64((__m128i *)(lum_plane + lum_pos1), _mm_srli_si128(lines, 8));                        \
+	} while (false)
+
+/* averages the chroma of a 2x8 block into four UV pairs, packed per 128-bit
+ * lane, and moves both lanes' results into the low 64 bits */
+#define avg_ch_avx2(avg_val, line1, line2, uv_mask, perm)                                                       \
+	do {                                                                                                    \
+		__m256i add_val = _mm256_add_epi64(_mm256_and_si256(line1, uv_mask),                            \
+						   _mm256_and_si256(line2, uv_mask));                           \
+		avg_val = _mm256_add_epi64(add_val, _mm256_shuffle_epi32(add_val, _MM_SHUFFLE(2, 3, 0, 1)));    \
+		avg_val = _mm256_srai_epi16(avg_val, 2);                                                        \
+		avg_val = _mm256_shuffle_epi32(avg_val, _MM_SHUFFLE(3, 1, 2, 0));                               \
+		avg_val = _mm256_packus_epi16(avg_val, avg_val);                                                \
+		avg_val = _mm256_permutevar8x32_epi32(avg_val, perm);                                           \
+	} while (false)
+
+#define pack_ch_1plane_avx2(uv_plane, chroma_pos, line1, line2, uv_mask, perm)                  \
+	do {                                                                                    \
+		__m256i avg_val;                                                                \
+		avg_ch_avx2(avg_val, line1, line2, uv_mask, perm);                              \
+		_mm_storel_epi64((__m128i *)(uv_plane + chroma_pos), _mm256_castsi256_si128(avg_val)); \
+	} while (false)
+
+#define pack_ch_2plane_avx2(u_plane, v_plane, chroma_pos, line1, line2, uv_mask, perm, uv_split)     \
+	do {                                                                                          \
+		__m256i avg_val;                                                                      \
+		avg_ch_avx2(avg_val, line1, line2, uv_mask, perm);                                    \
+                                                                                                      \
+		__m128i split = _mm_shuffle_epi8(_mm256_castsi256_si128(avg_val), uv_split);          \
+		*(uint32_t *)(u_plane + chroma_pos) = (uint32_t)_mm_cvtsi128_si32(split);             \
+		*(uint32_t *)(v_plane + chroma_pos) = (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(split, 4)); \
+	} while (false)
+
+AVX2_FUNC static void compress_uyvx_to_i420_avx2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+						 uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
+{
+	uint8_t *lum_plane = output[0];
+	uint8_t *u_plane = output[1];
+	uint8_t *v_plane = output[2];
+	uint32_t width = min_uint32(in_linesize, out_linesize[0]);
+	uint32_t y;
+
+	__m128i lum_mask = _mm_set1_epi32(0x0000FF00);
+	__m128i uv_mask = _mm_set1_epi16(0x00FF);
+	__m256i lum_mask256 = _mm256_set1_epi32(0x0000FF00);
+	__m256i uv_mask256 = _mm256_set1_epi16(0x00FF);
+	__m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	__m128i uv_split = _mm_setr_epi8(0, 2, 4, 6, 1, 3, 5, 7, 8, 10, 12, 14, 9, 11, 13, 15);
+
+	for (y = start_y; y < end_y; y += 2) {
+		uint32_t y_pos = y * in_linesize;
+		uint32_t chroma_y_pos = (y >> 1) * out_linesize[1];
+		uint32_t lum_y_pos = y * out_linesize[0];
+		uint32_t x;
+
+		for (x = 0; x + 8 <= width; x += 8) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m256i line1 = _mm256_loadu_si256((const __m256i *)img);
+			__m256i line2 = _mm256_loadu_si256((const __m256i *)(img + in_linesize));
+
+			pack_shift_avx2(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask256, 1, perm);
+			pack_ch_2plane_avx2(u_plane, v_plane, chroma_y_pos + (x >> 1), line1, line2, uv_mask256, perm,
+					    uv_split);
+		}
+
+		for (; x < width; x += 4) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m128i line1 = _mm_load_si128((const __m128i *)img);
+			__m128i line2 = _mm_load_si128((const __m128i *)(img + in_linesize));
+
+			pack_shift(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask, 1);
+			pack_ch_2plane(u_plane, v_plane, chroma_y_pos + (x >> 1), line1, line2, uv_mask);
+		}
+	}
+}
+
+AVX2_FUNC static void compress_uyvx_to_nv12_avx2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+						 uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
+{
+	uint8_t *lum_plane = output[0];
+	uint8_t *chroma_plane = output[1];
+	uint32_t width = min_uint32(in_linesize, out_linesize[0]);
+	uint32_t y;
+
+	__m128i lum_mask = _mm_set1_epi32(0x0000FF00);
+	__m128i uv_mask = _mm_set1_epi16(0x00FF);
+	__m256i lum_mask256 = _mm256_set1_epi32(0x0000FF00);
+	__m256i uv_mask256 = _mm256_set1_epi16(0x00FF);
+	__m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	for (y = start_y; y < end_y; y += 2) {
+		uint32_t y_pos = y * in_linesize;
+		uint32_t chroma_y_pos = (y >> 1) * out_linesize[1];
+		uint32_t lum_y_pos = y * out_linesize[0];
+		uint32_t x;
+
+		for (x = 0; x + 8 <= width; x += 8) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m256i line1 = _mm256_loadu_si256((const __m256i *)img);
+			__m256i line2 = _mm256_loadu_si256((const __m256i *)(img + in_linesize));
+
+			pack_shift_avx2(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask256, 1, perm);
+			pack_ch_1plane_avx2(chroma_plane, chroma_y_pos + x, line1, line2, uv_mask256, perm);
+		}
+
+		for (; x < width; x += 4) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m128i line1 = _mm_load_si128((const __m128i *)img);
+			__m128i line2 = _mm_load_si128((const __m128i *)(img + in_linesize));
+
+			pack_shift(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask, 1);
+			pack_ch_1plane(chroma_plane, chroma_y_pos + x, line1, line2, uv_mask);
+		}
+	}
+}
+
+AVX2_FUNC static void convert_uyvx_to_i444_avx2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+						uint32_t end_y, uint8_t *output[], const uint32_t out_linesize[])
+{
+	uint8_t *lum_plane = output[0];
+	uint8_t *u_plane = output[1];
+	uint8_t *v_plane = output[2];
+	uint32_t width = min_uint32(in_linesize, out_linesize[0]);
+	uint32_t y;
+
+	__m128i lum_mask = _mm_set1_epi32(0x0000FF00);
+	__m128i u_mask = _mm_set1_epi32(0x000000FF);
+	__m128i v_mask = _mm_set1_epi32(0x00FF0000);
+	__m256i lum_mask256 = _mm256_set1_epi32(0x0000FF00);
+	__m256i u_mask256 = _mm256_set1_epi32(0x000000FF);
+	__m256i v_mask256 = _mm256_set1_epi32(0x00FF0000);
+	__m256i perm = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+
+	for (y = start_y; y < end_y; y += 2) {
+		uint32_t y_pos = y * in_linesize;
+		uint32_t lum_y_pos = y * out_linesize[0];
+		uint32_t x;
+
+		for (x = 0; x + 8 <= width; x += 8) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m256i line1 = _mm256_loadu_si256((const __m256i *)img);
+			__m256i line2 = _mm256_loadu_si256((const __m256i *)(img + in_linesize));
+
+			pack_shift_avx2(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask256, 1, perm);
+			pack_val_avx2(u_plane, lum_pos0, lum_pos1, line1, line2, u_mask256, perm);
+			pack_shift_avx2(v_plane, lum_pos0, lum_pos1, line1, line2, v_mask256, 2, perm);
+		}
+
+		for (; x < width; x += 4) {
+			const uint8_t *img = input + y_pos + x * 4;
+			uint32_t lum_pos0 = lum_y_pos + x;
+			uint32_t lum_pos1 = lum_pos0 + out_linesize[0];
+
+			__m128i line1 = _mm_load_si128((const __m128i *)img);
+			__m128i line2 = _mm_load_si128((const __m128i *)(img + in_linesize));
+
+			pack_shift(lum_plane, lum_pos0, lum_pos1, line1, line2, lum_mask, 1);
+			pack_val(u_plane, lum_pos0, lum_pos1, line1, line2, u_mask);
+			pack_shift(v_plane, lum_pos0, lum_pos1, line1, line2, v_mask, 2);
+		}
+	}
+}
+
+/* 128-bit unpacks operate per lane, so the low halves of both results hold
+ * pixels 0-7 and the high halves hold pixels 8-15 */
+#define store_16px_avx2(output, lo, hi)                                                                \
+	do {                                                                                           \
+		_mm256_storeu_si256((__m256i *)(output), _mm256_permute2x128_si256(lo, hi, 0x20));     \
+		_mm256_storeu_si256((__m256i *)((output) + 8), _mm256_permute2x128_si256(lo, hi, 0x31)); \
+	} while (false)
+
+AVX2_FUNC static void decompress_420_avx2(const uint8_t *const input[], const uint32_t in_linesize[],
+					  uint32_t start_y, uint32_t end_y, uint8_t *output, uint32_t out_linesize)
+{
+	uint32_t start_y_d2 = start_y / 2;
+	uint32_t width_d2 = in_linesize[0] / 2;
+	uint32_t height_d2 = end_y / 2;
+	uint32_t y;
+
+	for (y = start_y_d2; y < height_d2; y++) {
+		const uint8_t *chroma0 = input[1] + y * in_linesize[1];
+		const uint8_t *chroma1 = input[2] + y * in_linesize[2];
+		const uint8_t *lum0, *lum1;
+		uint32_t *output0, *output1;
+		uint32_t x;
+
+		lum0 = input[0] + y * 2 * in_linesize[0];
+		lum1 = lum0 + in_linesize[0];
+		output0 = (uint32_t *)(output + y * 2 * out_linesize);
+		output1 = (uint32_t *)((uint8_t *)output0 + out_linesize);
+
+		for (x = 0; x + 8 <= width_d2; x += 8) {
+			__m128i u = _mm_loadl_epi64((const __m128i *)chroma0);
+			__m128i v = _mm_loadl_epi64((const __m128i *)chroma1);
+			__m128i uv = _mm_unpacklo_epi8(v, u);
+			__m256i uv_dup = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(uv, uv)),
+								 _mm_unpackhi_epi16(uv, uv), 1);
+
+			__m256i l0 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)lum0));
+			__m256i l1 = _mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)lum1));
+
+			store_16px_avx2(output0, _mm256_unpacklo_epi16(uv_dup, l0), _mm256_unpackhi_epi16(uv_dup, l0));
+			store_16px_avx2(output1, _mm256_unpacklo_epi16(uv_dup, l1), _mm256_unpackhi_epi16(uv_dup, l1));
+
+			chroma0 += 8;
+			chroma1 += 8;
+			lum0 += 16;
+			lum1 += 16;
+			output0 += 16;
+			output1 += 16;
+		}
+
+		for (; x < width_d2; x++) {
+			uint32_t out;
+			out = (*(chroma0++) << 8) | *(chroma1++);
+
+			*(output0++) = (*(lum0++) << 16) | out;
+			*(output0++) = (*(lum0++) << 16) | out;
+
+			*(output1++) = (*(lum1++) << 16) | out;
+			*(output1++) = (*(lum1++) << 16) | out;
+		}
+	}
+}
+
+AVX2_FUNC static void decompress_nv12_avx2(const uint8_t *const input[], const uint32_t in_linesize[],
+					   uint32_t start_y, uint32_t end_y, uint8_t *output, uint32_t out_linesize)
+{
+	uint32_t start_y_d2 = start_y / 2;
+	uint32_t width_d2 = min_uint32(in_linesize[0], out_linesize) / 2;
+	uint32_t height_d2 = end_y / 2;
+	uint32_t y;
+
+	for (y = start_y_d2; y < height_d2; y++) {
+		const uint16_t *chroma;
+		const uint8_t *lum0, *lum1;
+		uint32_t *output0, *output1;
+		uint32_t x;
+
+		chroma = (const uint16_t *)(input[1] + y * in_linesize[1]);
+		lum0 = input[0] + y * 2 * in_linesize[0];
+		lum1 = lum0 + in_linesize[0];
+		output0 = (uint32_t *)(output + y * 2 * out_linesize);
+		output1 = (uint32_t *)((uint8_t *)output0 + out_linesize);
+
+		for (x = 0; x + 8 <= width_d2; x += 8) {
+			__m128i uv = _mm_loadu_si128((const __m128i *)chroma);
+			__m256i uv_dup = _mm256_inserti128_si256(_mm256_castsi128_si256(_mm_unpacklo_epi16(uv, uv)),
+								 _mm_unpackhi_epi16(uv, uv), 1);
+			__m256i u_shl = _mm256_slli_epi16(uv_dup, 8);
+			__m256i v = _mm256_srli_epi16(uv_dup, 8);
+
+			__m256i yu0 = _mm256_or_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)lum0)), u_shl);
+			__m256i yu1 = _mm256_or_si256(_mm256_cvtepu8_epi16(_mm_loadu_si128((const __m128i *)lum1)), u_shl);
+
+			store_16px_avx2(output0, _mm256_unpacklo_epi16(yu0, v), _mm256_unpackhi_epi16(yu0, v));
+			store_16px_avx2(output1, _mm256_unpacklo_epi16(yu1, v), _mm256_unpackhi_epi16(yu1, v));
+
+			chroma += 8;
+			lum0 += 16;
+			lum1 += 16;
+			output0 += 16;
+			output1 += 16;
+		}
+
+		for (; x < width_d2; x++) {
+			uint32_t out = *(chroma++) << 8;
+
+			*(output0++) = *(lum0++) | out;
+			*(output0++) = *(lum0++) | out;
+
+			*(output1++) = *(lum1++) | out;
+			*(output1++) = *(lum1++) | out;
+		}
+	}
+}
+
+AVX2_FUNC static void decompress_422_avx2(const uint8_t *input, uint32_t in_linesize, uint32_t start_y,
+					  uint32_t end_y, uint8_t *output, uint32_t out_linesize, bool leading_lum)
+{
+	uint32_t width_d2 = min_uint32(in_linesize, out_linesize) / 2;
+	uint32_t y;
+
+	__m256i keep_mask = _mm256_set1_epi32(leading_lum ? 0xFFFFFF00 : 0xFFFF00FF);
+	__m256i lum_mask = _mm256_set1_epi32(leading_lum ? 0x000000FF : 0x0000FF00);
+
+	for (y = start_y; y < end_y; y++) {
+		const uint32_t *input32 = (const uint32_t *)(input + y * in_linesize);
+		const uint32_t *input32_end = input32 + width_d2;
+		uint32_t *output32 = (uint32_t *)(output + y * out_linesize);
+
+		while (input32 + 8 <= input32_end) {
+			__m256i dw = _mm256_loadu_si256((const __m256i *)input32);
+			__m256i dup = _mm256_or_si256(_mm256_and_si256(dw, keep_mask),
+						      _mm256_and_si256(_mm256_srli_epi32(dw, 16), lum_mask));
+
+			store_16px_avx2(output32, _mm256_unpacklo_epi32(dw, dup), _mm256_unpackhi_epi32(dw, dup));
+
+			output32 += 16;
+			input32 += 8;
+		}
+
+		while (input32 < input32_end) {
+			uint32_t dw = *input32;
+
+			output32[0] = dw;
+			output32[1] = dup_422_lum(dw, leading_lum);
+
+			output32 += 2;
+			input32++;
+		}
+	}
+}
+
+#define DISPATCH(func, ...)                        \
+	do {                                       \
+		if (avx2_supported())              \
+			func##_avx2(__VA_ARGS__);  \
+		else                               \
+			func##_sse2(__VA_ARGS__);  \
+	} while (false)
+
+#else
+
+#define DISPATCH(func, ...) func##_sse2(__VA_ARGS__)
+
+#endif
+
+/* ------------------------------------------------------------------------- */
+
+void compress_uyvx_to_i420(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
+			   uint8_t *output[], const uint32_t out_linesize[])
+{
+	DISPATCH(compress_uyvx_to_i420, input, in_linesize, start_y, end_y, output, out_linesize);
+}
+
+void compress_uyvx_to_nv12(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
+			   uint8_t *output[], const uint32_t out_linesize[])
+{
+	DISPATCH(compress_uyvx_to_nv12, input, in_linesize, start_y, end_y, output, out_linesize);
+}
+
+void convert_uyvx_to_i444(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y,
+			  uint8_t *output[], const uint32_t out_linesize[])
+{
+	DISPATCH(convert_uyvx_to_i444, input, in_linesize, start_y, end_y, output, out_linesize);
+}
+
+void decompress_420(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y, uint32_t end_y,
+		    uint8_t *output, uint32_t out_linesize)
+{
+	DISPATCH(decompress_420, input, in_linesize, start_y, end_y, output, out_linesize);
+}
+
+void decompress_nv12(const uint8_t *const input[], const uint32_t in_linesize[], uint32_t start_y, uint32_t end_y,
+		     uint8_t *output, uint32_t out_linesize)
+{
+	DISPATCH(decompress_nv12, input, in_linesize, start_y, end_y, output, out_linesize);
+}
+
+void decompress_422(const uint8_t *input, uint32_t in_linesize, uint32_t start_y, uint32_t end_y, uint8_t *output,
+		    uint32_t out_linesize, bool leading_lum)
+{
+	DISPATCH(decompress_422, input, in_linesize, start_y, end_y, output, out_linesize, leading_lum);
+}
@@ -187,21 +187,16 @@ void video_frame_get_plane_heights(uint32_t heights[MAX_AV_PLANES], enum video_f
 	}
 }
 
-void video_frame_init(struct video_frame *frame, enum video_format format, uint32_t width, uint32_t height)
+static size_t get_plane_offsets(size_t offsets[MAX_AV_PLANES], uint32_t linesizes[MAX_AV_PLANES],
+				enum video_format format, uint32_t width, uint32_t height)
 {
 	size_t size = 0;
-	uint32_t linesizes[MAX_AV_PLANES];
 	uint32_t heights[MAX_AV_PLANES];
-	size_t offsets[MAX_AV_PLANES];
 	int alignment = base_get_alignment();
 
-	if (!frame)
-		return;
-
-	memset(frame, 0, sizeof(struct video_frame));
-	memset(linesizes, 0, sizeof(linesizes));
+	memset(linesizes, 0, sizeof(uint32_t) * MAX_AV_PLANES);
 	memset(heights, 0, sizeof(heights));
-	memset(offsets, 0, sizeof(offsets));
+	memset(offsets, 0, sizeof(size_t) * MAX_AV_PLANES);
 
 	/* determine linesizes for each plane */
 	video_frame_get_linesizes(linesizes, format, width);
@@ -219,19 +214,50 @@ void video_frame_init(struct video_frame *frame, enum video_format format, uint3
 		offsets[i] = size;
 	}
 
-	/* allocate memory */
-	frame->data[0] = bmalloc(size);
+	return size;
+}
+
+size_t video_frame_get_buffer_size(enum video_format format, uint32_t width, uint32_t height)
+{
+	uint32_t linesizes[MAX_AV_PLANES];
+	size_t offsets[MAX_AV_PLANES];
+
+	return get_plane_offsets(offsets, linesizes, format, width, height);
+}
+
+void video_frame_init_buffer(struct video_frame *frame, uint8_t *buffer, enum video_format format, uint32_t width,
+			     uint32_t height)
+{
+	uint32_t linesizes[MAX_AV_PLANES];
+	size_t offsets[MAX_AV_PLANES];
+
+	if (!frame)
+		return;
+
+	get_plane_offsets(offsets, linesizes, format, width, height);
+
+	memset(frame, 0, sizeof(struct video_frame));
+	frame->data[0] = buffer;
 	frame->linesize[0] = linesizes[0];
 
 	/* apply plane data pointers according to offsets */
 	for (uint32_t i = 1; i < MAX_AV_PLANES; i++) {
-		if (!linesizes[i] || !heights[i])
+		if (!linesizes[i] || !offsets[i])
 			continue;
-		frame->data[i] = frame->data[0] + offsets[i - 1];
+		frame->data[i] = buffer + offsets[i - 1];
 		frame->linesize[i] = linesizes[i];
 	}
 }
 
+void video_frame_init(struct video_frame *frame, enum video_format format, uint32_t width, uint32_t height)
+{
+	if (!frame)
+		return;
+
+	size_t size = video_frame_get_buffer_size(format, width, height);
+	video_frame_init_buffer(frame, bmalloc(size), format, width, height);
+}
+
 void video_frame_copy(struct video_frame *dst, const struct video_frame *src, enum video_format format, uint32_t cy)
 {
 	uint32_t heights[MAX_AV_PLANES];
@@ -31,6 +31,14 @@ struct video_frame {
 
 EXPORT void video_frame_init(struct video_frame *frame, enum video_format format, uint32_t width, uint32_t height);
 
+/** Returns the size of the single buffer video_frame_init allocates */
+EXPORT size_t video_frame_get_buffer_size(enum video_format format, uint32_t width, uint32_t height);
+
+/** Points the planes of *frame* into *buffer*, which must hold at least
+ * video_frame_get_buffer_size() bytes and be aligned like bmalloc memory */
+EXPORT void video_frame_init_buffer(struct video_frame *frame, uint8_t *buffer, enum video_format format,
+				    uint32_t width, uint32_t height);
+
 static inline void video_frame_free(struct video_frame *frame)
 {
 	if (frame) {
@@ -21,6 +21,7 @@
 #include "../util/platform.h"
 #include "../util/profiler.h"
 #include "../util/threading.h"
+#include "../util/task.h"
 #include "../util/darray.h"
 #include "../util/util_uint64.h"
 
@@ -30,21 +31,41 @@
 #include "video-scaler.h"
 
 extern profiler_name_store_t *obs_get_profiler_name_store(void);
+extern void obs_apply_thread_config(const char *role);
 
 #define MAX_CONVERT_BUFFERS 3
 #define MAX_CACHE_SIZE 16
+#define MAX_SCALE_THREADS 4
 
+/* count and skipped may still be raised by the graphics thread while the
+ * video thread is working through the frame, so both are atomics */
 struct cached_frame_info {
 	struct video_data frame;
-	int skipped;
-	int count;
+	volatile long skipped;
+	volatile long count;
+	uint64_t queued_ts;
 };
 
-struct video_input {
-	struct video_scale_info conversion;
+/* Conversion output shared by every input that asked for the same scale
+ * info, so the frame is only converted (and stored) once per frame no
+ * matter how many raw consumers want it. */
+struct video_conversion {
+	struct video_scale_info info;
 	video_scaler_t *scaler;
 	struct video_frame frame[MAX_CONVERT_BUFFERS];
 	int cur_frame;
+	long refs;
+
+	uint64_t frame_serial;
+	struct video_data output;
+	bool success;
+
+	const char *profile_name;
+};
+
+struct video_input {
+	struct video_scale_info conversion;
+	struct video_conversion *shared;
 
 	// allow outputting at fractions of main composition FPS,
 	// e.g. 60 FPS with frame_rate_divisor = 1 turns into 30 FPS
@@ -60,18 +81,10 @@ struct video_input {
 	void *param;
 };
 
-static inline void video_input_free(struct video_input *input)
-{
-	for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
-		video_frame_free(&input->frame[i]);
-	video_scaler_destroy(input->scaler);
-}
-
 struct video_output {
 	struct video_output_info info;
 
 	pthread_t thread;
-	pthread_mutex_t data_mutex;
 	bool stop;
 
 	os_sem_t *update_semaphore;
@@ -81,69 +94,141 @@ struct video_output {
 
 	pthread_mutex_t input_mutex;
 	DARRAY(struct video_input) inputs;
-
-	size_t available_frames;
-	size_t first_added;
-	size_t last_added;
+	DARRAY(struct video_conversion *) conversions;
+	uint64_t frame_serial;
+
+	/* single-producer/single-consumer ring: write_idx is only advanced by
+	 * the graphics thread, read_idx only by the video thread.  Both count
+	 * frames ever queued/completed; the slot is the index modulo
+	 * info.cache_size. */
+	volatile long write_idx;
+	volatile long read_idx;
+	long latency_idx;
 	struct cached_frame_info cache[MAX_CACHE_SIZE];
+	volatile long queue_latency[VIDEO_OUTPUT_LATENCY_BUCKETS];
 
 	struct video_output *parent;
 
 	volatile bool raw_active;
 	volatile long gpu_refs;
+
+	/* distinct conversions are spread across this pool (plus the video
+	 * thread itself) so that several raw consumers at different
+	 * resolutions don't serialize on one thread */
+	os_task_pool_t *scale_pool;
+	DARRAY(struct video_conversion *) scale_jobs;
 };
 
 /* ------------------------------------------------------------------------- */
 
-static inline bool scale_video_output(struct video_input *input, struct video_data *data)
+static inline void scale_video_output(struct video_conversion *conv)
 {
-	bool success = true;
-
-	if (input->scaler) {
-		struct video_frame *frame;
+	struct video_frame *frame;
 
-		if (++input->cur_frame == MAX_CONVERT_BUFFERS)
-			input->cur_frame = 0;
+	if (++conv->cur_frame == MAX_CONVERT_BUFFERS)
+		conv->cur_frame = 0;
 
-		frame = &input->frame[input->cur_frame];
+	frame = &conv->frame[conv->cur_frame];
 
-		success = video_scaler_scale(input->scaler, frame->data, frame->linesize,
-					     (const uint8_t *const *)data->data, data->linesize);
+	conv->success = video_scaler_scale(conv->scaler, frame->data, frame->linesize,
+					   (const uint8_t *const *)conv->output.data, conv->output.linesize);
 
-		if (success) {
-			for (size_t i = 0; i < MAX_AV_PLANES; i++) {
-				data->data[i] = frame->data[i];
-				data->linesize[i] = frame->linesize[i];
-			}
-		} else {
-			blog(LOG_WARNING, "video-io: Could not scale frame!");
+	if (conv->success) {
+		for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+			conv->output.data[i] = frame->data[i];
+			conv->output.linesize[i] = frame->linesize[i];
 		}
+	} else {
+		blog(LOG_WARNING, "video-io: Could not scale frame!");
 	}
+}
 
-	return success;
+static void scale_job(void *param, size_t idx)
+{
+	struct video_output *video = param;
+	struct video_conversion *conv = video->scale_jobs.array[idx];
+
+	profile_start(conv->profile_name);
+	scale_video_output(conv);
+	profile_end(conv->profile_name);
+
+	profile_reenable_thread();
+}
+
+static inline void scale_inputs(struct video_output *video)
+{
+	os_task_pool_run(video->scale_pool, scale_job, video, video->scale_jobs.num);
+}
+
+static inline struct cached_frame_info *get_cache_slot(struct video_output *video, long idx)
+{
+	return &video->cache[(unsigned long)idx % video->info.cache_size];
+}
+
+static inline size_t queued_frames(const struct video_output *video)
+{
+	return (size_t)((unsigned long)os_atomic_load_long(&video->write_idx) -
+			(unsigned long)os_atomic_load_long(&video->read_idx));
+}
+
+static void record_queue_latency(struct video_output *video, const struct cached_frame_info *frame_info)
+{
+	uint64_t usec = (os_gettime_ns() - frame_info->queued_ts) / 1000;
+	size_t bucket = 0;
+
+	while (bucket < VIDEO_OUTPUT_LATENCY_BUCKETS - 1 && usec >= (1ULL << bucket))
+		bucket++;
+
+	os_atomic_inc_long(&video->queue_latency[bucket]);
 }
 
 static inline bool video_output_cur_frame(struct video_output *video)
 {
 	struct cached_frame_info *frame_info;
+	long read_idx;
 	bool complete;
-	bool skipped;
 
 	/* -------------------------------- */
 
-	pthread_mutex_lock(&video->data_mutex);
-
-	frame_info = &video->cache[video->first_added];
+	read_idx = os_atomic_load_long(&video->read_idx);
+	frame_info = get_cache_slot(video, read_idx);
 
-	pthread_mutex_unlock(&video->data_mutex);
+	if (video->latency_idx != read_idx) {
+		video->latency_idx = read_idx;
+		record_queue_latency(video, frame_info);
+	}
 
 	/* -------------------------------- */
 
 	pthread_mutex_lock(&video->input_mutex);
 
+	da_resize(video->scale_jobs, 0);
+	video->frame_serial++;
+
+	for (size_t i = 0; i < video->inputs.num; i++) {
+		struct video_input *input = video->inputs.array + i;
+		struct video_conversion *conv = input->shared;
+
+		if (!conv || conv->frame_serial == video->frame_serial)
+			continue;
+
+		/* only convert if at least one input using this conversion
+		 * actually outputs this frame */
+		if (input->frame_rate_divisor_counter != 0)
+			continue;
+
+		conv->frame_serial = video->frame_serial;
+		conv->output = frame_info->frame;
+		da_push_back(video->scale_jobs, &conv);
+	}
+
+	scale_inputs(video);
+
+	/* callbacks are still issued serially and in connection order */
 	for (size_t i = 0; i < video->inputs.num; i++) {
 		struct video_input *input = video->inputs.array + i;
-		struct video_data frame = frame_info->frame;
+		struct video_conversion *conv = input->shared;
+		struct video_data frame;
 
 		// an explicit counter is used instead of remainder calculation
 		// to allow multiple encoders started at the same time to start on
@@ -155,33 +240,34 @@ static inline bool video_output_cur_frame(struct video_output *video)
 		if (skip)
 			continue;
 
-		if (scale_video_output(input, &frame))
-			input->callback(input->param, &frame);
+		if (!conv) {
+			frame = frame_info->frame;
+		} else if (conv->success) {
+			frame = conv->output;
+			frame.timestamp = frame_info->frame.timestamp;
+		} else {
+			continue;
+		}
+
+		input->callback(input->param, &frame);
 	}
 
 	pthread_mutex_unlock(&video->input_mutex);
 
 	/* -------------------------------- */
 
-	pthread_mutex_lock(&video->data_mutex);
-
 	frame_info->frame.timestamp += video->frame_time;
-	complete = --frame_info->count == 0;
-	skipped = frame_info->skipped > 0;
+	complete = os_atomic_dec_long(&frame_info->count) == 0;
 
 	if (complete) {
-		if (++video->first_added == video->info.cache_size)
-			video->first_added = 0;
+		/* hands the slot back to the graphics thread */
+		os_atomic_store_long(&video->read_idx, read_idx + 1);
 
-		if (++video->available_frames == video->info.cache_size)
-			video->last_added = video->first_added;
-	} else if (skipped) {
-		--frame_info->skipped;
+	} else if (os_atomic_load_long(&frame_info->skipped) > 0) {
+		os_atomic_dec_long(&frame_info->skipped);
 		os_atomic_inc_long(&video->skipped_frames);
 	}
 
-	pthread_mutex_unlock(&video->data_mutex);
-
 	/* -------------------------------- */
 
 	return complete;
@@ -192,6 +278,7 @@ static void *video_thread(void *param)
 	struct video_output *video = param;
 
 	os_set_thread_name("video-io: video thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_VIDEO);
 
 	const char *video_thread_name =
 		profile_store_name(obs_get_profiler_name_store(), "video_thread(%s)", video->info.name);
@@ -233,7 +320,7 @@ static inline void init_cache(struct video_output *video)
 		video_frame_init(frame, video->info.format, video->info.width, video->info.height);
 	}
 
-	video->available_frames = video->info.cache_size;
+	video->latency_idx = -1;
 }
 
 int video_output_open(video_t **video, struct video_output_info *info)
@@ -250,31 +337,34 @@ int video_output_open(video_t **video, struct video_output_info *info)
 	memcpy(&out->info, info, sizeof(struct video_output_info));
 	out->frame_time = util_mul_div64(1000000000ULL, info->fps_den, info->fps_num);
 
-	if (pthread_mutex_init_recursive(&out->data_mutex) != 0)
-		goto fail0;
+	if (out->info.cache_size == 0)
+		out->info.cache_size = 1;
+
+	init_cache(out);
+
 	if (pthread_mutex_init_recursive(&out->input_mutex) != 0)
-		goto fail1;
+		goto fail0;
 	if (os_sem_init(&out->update_semaphore, 0) != 0)
-		goto fail2;
+		goto fail1;
 	if (pthread_create(&out->thread, NULL, video_thread, out) != 0)
-		goto fail3;
-
-	init_cache(out);
+		goto fail2;
 
 	*video = out;
 	return VIDEO_OUTPUT_SUCCESS;
 
-fail3:
-	os_sem_destroy(out->update_semaphore);
 fail2:
-	pthread_mutex_destroy(&out->input_mutex);
+	os_sem_destroy(out->update_semaphore);
 fail1:
-	pthread_mutex_destroy(&out->data_mutex);
+	pthread_mutex_destroy(&out->input_mutex);
 fail0:
+	for (size_t i = 0; i < out->info.cache_size; i++)
+		video_frame_free((struct video_frame *)&out->cache[i]);
 	bfree(out);
 	return VIDEO_OUTPUT_FAIL;
 }
 
+static void video_input_free(struct video_output *video, struct video_input *input);
+
 void video_output_close(video_t *video)
 {
 	if (!video)
@@ -285,15 +375,17 @@ void video_output_close(video_t *video)
 	pthread_mutex_lock(&video->input_mutex);
 
 	for (size_t i = 0; i < video->inputs.num; i++)
-		video_input_free(&video->inputs.array[i]);
+		video_input_free(video, &video->inputs.array[i]);
 	da_free(video->inputs);
+	da_free(video->conversions);
 
 	for (size_t i = 0; i < video->info.cache_size; i++)
 		video_frame_free((struct video_frame *)&video->cache[i]);
 
+	da_free(video->scale_jobs);
+
 	pthread_mutex_unlock(&video->input_mutex);
 	os_sem_destroy(video->update_semaphore);
-	pthread_mutex_destroy(&video->data_mutex);
 	pthread_mutex_destroy(&video->input_mutex);
 
 	bfree(video);
@@ -337,42 +429,149 @@ static bool match_space(enum video_colorspace a, enum video_colorspace b)
 	return (a == VIDEO_CS_DEFAULT) || (b == VIDEO_CS_DEFAULT) || (collapse_space(a) == collapse_space(b));
 }
 
+static bool conversion_matches(const struct video_scale_info *a, const struct video_scale_info *b)
+{
+	return a->format == b->format && a->width == b->width && a->height == b->height &&
+	       match_range(a->range, b->range) && a->colorspace == b->colorspace;
+}
+
+static void video_conversion_destroy(struct video_conversion *conv)
+{
+	for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
+		video_frame_free(&conv->frame[i]);
+	video_scaler_destroy(conv->scaler);
+	bfree(conv);
+}
+
+static struct video_conversion *video_conversion_create(struct video_output *video,
+							 const struct video_scale_info *info)
+{
+	struct video_scale_info from = {.format = video->info.format,
+					.width = video->info.width,
+					.height = video->info.height,
+					.range = video->info.range,
+					.colorspace = video->info.colorspace};
+	struct video_conversion *conv = bzalloc(sizeof(*conv));
+
+	conv->info = *info;
+
+	int ret = video_scaler_create(&conv->scaler, &conv->info, &from, VIDEO_SCALE_FAST_BILINEAR);
+	if (ret != VIDEO_SCALER_SUCCESS) {
+		if (ret == VIDEO_SCALER_BAD_CONVERSION)
+			blog(LOG_ERROR, "video_input_init: Bad "
+					"scale conversion type");
+		else
+			blog(LOG_ERROR, "video_input_init: Failed to "
+					"create scaler");
+
+		bfree(conv);
+		return NULL;
+	}
+
+	for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
+		video_frame_init(&conv->frame[i], info->format, info->width, info->height);
+
+	conv->profile_name = profile_store_name(obs_get_profiler_name_store(), "scale_video_output(%s: %s %ux%u)",
+						video->info.name, get_video_format_name(info->format), info->width,
+						info->height);
+	return conv;
+}
+
+static struct video_conversion *get_conversion(struct video_output *video, const struct video_scale_info *info)
+{
+	for (size_t i = 0; i < video->conversions.num; i++) {
+		struct video_conversion *conv = video->conversions.array[i];
+		if (conversion_matches(&conv->info, info)) {
+			conv->refs++;
+			return conv;
+		}
+	}
+
+	struct video_conversion *conv = video_conversion_create(video, info);
+	if (conv) {
+		conv->refs = 1;
+		da_push_back(video->conversions, &conv);
+	}
+
+	return conv;
+}
+
+static void release_conversion(struct video_output *video, struct video_conversion *conv)
+{
+	if (!conv || --conv->refs > 0)
+		return;
+
+	da_erase_item(video->conversions, &conv);
+	video_conversion_destroy(conv);
+}
+
 static inline bool video_input_init(struct video_input *input, struct video_output *video)
 {
 	if (input->conversion.width != video->info.width || input->conversion.height != video->info.height ||
 	    input->conversion.format != video->info.format ||
 	    !match_range(input->conversion.range, video->info.range) ||
 	    !match_space(input->conversion.colorspace, video->info.colorspace)) {
-		struct video_scale_info from = {.format = video->info.format,
-						.width = video->info.width,
-						.height = video->info.height,
-						.range = video->info.range,
-						.colorspace = video->info.colorspace};
-
-		int ret = video_scaler_create(&input->scaler, &input->conversion, &from, VIDEO_SCALE_FAST_BILINEAR);
-		if (ret != VIDEO_SCALER_SUCCESS) {
-			if (ret == VIDEO_SCALER_BAD_CONVERSION)
-				blog(LOG_ERROR, "video_input_init: Bad "
-						"scale conversion type");
-			else
-				blog(LOG_ERROR, "video_input_init: Failed to "
-						"create scaler");
-
+		input->shared = get_conversion(video, &input->conversion);
+		if (!input->shared)
 			return false;
-		}
-
-		for (size_t i = 0; i < MAX_CONVERT_BUFFERS; i++)
-			video_frame_init(&input->frame[i], input->conversion.format, input->conversion.width,
-					 input->conversion.height);
 	}
 
 	return true;
 }
 
+static void video_input_free(struct video_output *video, struct video_input *input)
+{
+	release_conversion(video, input->shared);
+	input->shared = NULL;
+}
+
+static size_t get_max_scale_threads(void)
+{
+	int cores = os_get_physical_cores() - 1;
+	if (cores <= 0)
+		return 0;
+
+	return (size_t)cores < MAX_SCALE_THREADS ? (size_t)cores : MAX_SCALE_THREADS;
+}
+
+/* The scale pool is only created once more than one distinct conversion is
+ * needed, and only with as many threads as could be used at the same time.
+ * It is only ever used by the video thread with input_mutex held, so it can
+ * be replaced by a larger one here. */
+static void update_scale_threads(struct video_output *video)
+{
+	size_t num_scaled = video->conversions.num;
+
+	if (video->stop)
+		return;
+
+	size_t wanted = num_scaled ? num_scaled - 1 : 0;
+	size_t max_threads = get_max_scale_threads();
+	if (wanted > max_threads)
+		wanted = max_threads;
+
+	if (wanted <= os_task_pool_threads(video->scale_pool))
+		return;
+
+	os_task_pool_destroy(video->scale_pool);
+	video->scale_pool = os_task_pool_create(wanted, "video-io: scale thread");
+	if (os_task_pool_threads(video->scale_pool) < wanted)
+		blog(LOG_WARNING, "video-io: Failed to create scale thread");
+}
+
+static void stop_scale_threads(struct video_output *video)
+{
+	os_task_pool_destroy(video->scale_pool);
+	video->scale_pool = NULL;
+}
+
 static inline void reset_frames(video_t *video)
 {
 	os_atomic_set_long(&video->skipped_frames, 0);
 	os_atomic_set_long(&video->total_frames, 0);
+
+	for (size_t i = 0; i < VIDEO_OUTPUT_LATENCY_BUCKETS; i++)
+		os_atomic_set_long(&video->queue_latency[i], 0);
 }
 
 static const video_t *get_const_root(const video_t *video)
@@ -440,6 +639,7 @@ bool video_output_connect2(video_t *video, const struct video_scale_info *conver
 				os_atomic_set_bool(&video->raw_active, true);
 			}
 			da_push_back(video->inputs, &input);
+			update_scale_threads(video);
 		}
 	}
 
@@ -460,6 +660,27 @@ static void log_skipped(video_t *video)
 		     "to encoding lag: "
 		     "%ld/%ld (%0.1f%%)",
 		     video->skipped_frames, video->total_frames, percentage_skipped);
+
+	uint32_t latency[VIDEO_OUTPUT_LATENCY_BUCKETS];
+	uint64_t total = 0;
+	video_output_get_queue_latency(video, latency);
+	for (size_t i = 0; i < VIDEO_OUTPUT_LATENCY_BUCKETS; i++)
+		total += latency[i];
+
+	if (!total)
+		return;
+
+	uint64_t median = 0, p99 = 0, accu = 0;
+	for (size_t i = 0; i < VIDEO_OUTPUT_LATENCY_BUCKETS; i++) {
+		accu += latency[i];
+		if (!median && accu * 2 >= total)
+			median = 1ULL << i;
+		if (!p99 && accu * 100 >= total * 99)
+			p99 = 1ULL << i;
+	}
+
+	blog(LOG_INFO, "Video frame queue latency: median < %" PRIu64 " us, 99th percentile < %" PRIu64 " us",
+	     median, p99);
 }
 
 void video_output_disconnect(video_t *video, void (*callback)(void *param, struct video_data *frame), void *param)
@@ -478,7 +699,7 @@ bool video_output_disconnect2(video_t *video, void (*callback)(void *param, stru
 
 	size_t idx = video_get_input_idx(video, callback, param);
 	if (idx != DARRAY_INVALID) {
-		video_input_free(video->inputs.array + idx);
+		video_input_free(video, video->inputs.array + idx);
 		da_erase(video->inputs, idx);
 
 		if (video->inputs.num == 0) {
@@ -506,57 +727,67 @@ const struct video_output_info *video_output_get_info(const video_t *video)
 	return video ? &video->info : NULL;
 }
 
+/* Adds repeats of the most recently queued frame when every slot is still in
+ * use.  Fails if the video thread finished that frame in the meantime, in
+ * which case a slot has just become free. */
+static bool add_frame_repeats(struct video_output *video, long write_idx, int count)
+{
+	struct cached_frame_info *cfi = get_cache_slot(video, write_idx - 1);
+	long cur = os_atomic_load_long(&cfi->count);
+
+	while (cur > 0) {
+		if (os_atomic_compare_exchange_long(&cfi->count, &cur, cur + count)) {
+			for (int i = 0; i < count; i++)
+				os_atomic_inc_long(&cfi->skipped);
+			return true;
+		}
+	}
+
+	return false;
+}
+
 bool video_output_lock_frame(video_t *video, struct video_frame *frame, int count, uint64_t timestamp)
 {
 	struct cached_frame_info *cfi;
-	bool locked;
+	long write_idx;
 
 	if (!video)
 		return false;
 
 	video = get_root(video);
+	write_idx = os_atomic_load_long(&video->write_idx);
 
-	pthread_mutex_lock(&video->data_mutex);
-
-	if (video->available_frames == 0) {
-		video->cache[video->last_added].count += count;
-		video->cache[video->last_added].skipped += count;
-		locked = false;
-
-	} else {
-		if (video->available_frames != video->info.cache_size) {
-			if (++video->last_added == video->info.cache_size)
-				video->last_added = 0;
-		}
-
-		cfi = &video->cache[video->last_added];
-		cfi->frame.timestamp = timestamp;
-		cfi->count = count;
-		cfi->skipped = 0;
-
-		memcpy(frame, &cfi->frame, sizeof(*frame));
-
-		locked = true;
+	while (queued_frames(video) == video->info.cache_size) {
+		if (add_frame_repeats(video, write_idx, count))
+			return false;
 	}
 
-	pthread_mutex_unlock(&video->data_mutex);
+	cfi = get_cache_slot(video, write_idx);
+	cfi->frame.timestamp = timestamp;
+	os_atomic_store_long(&cfi->count, count);
+	os_atomic_store_long(&cfi->skipped, 0);
 
-	return locked;
+	memcpy(frame, &cfi->frame, sizeof(*frame));
+	return true;
 }
 
 void video_output_unlock_frame(video_t *video)
 {
+	struct cached_frame_info *cfi;
+	long write_idx;
+
 	if (!video)
 		return;
 
 	video = get_root(video);
+	write_idx = os_atomic_load_long(&video->write_idx);
 
-	pthread_mutex_lock(&video->data_mutex);
+	cfi = get_cache_slot(video, write_idx);
+	cfi->queued_ts = os_gettime_ns();
 
-	video->available_frames--;
+	/* publishes the slot to the video thread */
+	os_atomic_store_long(&video->write_idx, write_idx + 1);
 	os_sem_post(video->update_semaphore);
-
-	pthread_mutex_unlock(&video->data_mutex);
 }
 
 uint64_t video_output_get_frame_time(const video_t *video)
@@ -577,6 +808,10 @@ void video_output_stop(video_t *video)
 		video->stop = true;
 		os_sem_post(video->update_semaphore);
 		pthread_join(video->thread, &thread_ret);
+
+		pthread_mutex_lock(&video->input_mutex);
+		stop_scale_threads(video);
+		pthread_mutex_unlock(&video->input_mutex);
 	}
 }
 
@@ -623,6 +858,14 @@ uint32_t video_output_get_total_frames(const video_t *video)
 	return (uint32_t)os_atomic_load_long(&get_const_root(video)->total_frames);
 }
 
+void video_output_get_queue_latency(const video_t *video, uint32_t buckets[VIDEO_OUTPUT_LATENCY_BUCKETS])
+{
+	video = get_const_root(video);
+
+	for (size_t i = 0; i < VIDEO_OUTPUT_LATENCY_BUCKETS; i++)
+		buckets[i] = (uint32_t)os_atomic_load_long(&video->queue_latency[i]);
+}
+
 /* Note: These four functions below are a very slight bit of a hack.  If the
  * texture encoder thread is active while the raw encoder thread is active, the
  * total frame count will just be doubled while they're both active.  Which is
@@ -325,6 +325,15 @@ EXPORT double video_output_get_frame_rate(const video_t *video);
 EXPORT uint32_t video_output_get_skipped_frames(const video_t *video);
 EXPORT uint32_t video_output_get_total_frames(const video_t *video);
 
+#define VIDEO_OUTPUT_LATENCY_BUCKETS 20
+
+/**
+ * Histogram of how long frames wait between video_output_unlock_frame and
+ * the video thread picking them up.  Bucket i counts waits shorter than 2^i
+ * microseconds; the last bucket also counts anything longer.
+ */
+EXPORT void video_output_get_queue_latency(const video_t *video, uint32_t buckets[VIDEO_OUTPUT_LATENCY_BUCKETS]);
+
 extern void video_output_inc_texture_encoders(video_t *video);
 extern void video_output_dec_texture_encoders(video_t *video);
 extern void video_output_inc_texture_frames(video_t *video);
@@ -18,6 +18,7 @@
 #include <inttypes.h>
 #include "obs-internal.h"
 #include "util/util_uint64.h"
+#include "media-io/audio-mix.h"
 
 struct ts_info {
 	uint64_t start;
@@ -87,36 +88,44 @@ static inline size_t convert_time_to_frames(size_t sample_rate, uint64_t t)
 	return (size_t)util_mul_div64(t, sample_rate, 1000000000ULL);
 }
 
-static inline void mix_audio(struct audio_output_data *mixes, obs_source_t *source, size_t channels, size_t sample_rate,
-			     struct ts_info *ts)
+static inline bool get_mix_range(obs_source_t *source, size_t sample_rate, const struct ts_info *ts,
+				 size_t *start_point, size_t *total_floats)
 {
-	size_t total_floats = AUDIO_OUTPUT_FRAMES;
-	size_t start_point = 0;
+	*total_floats = AUDIO_OUTPUT_FRAMES;
+	*start_point = 0;
 
 	if (source->audio_ts < ts->start || ts->end <= source->audio_ts)
-		return;
+		return false;
 
 	if (source->audio_ts != ts->start) {
-		start_point = convert_time_to_frames(sample_rate, source->audio_ts - ts->start);
-		if (start_point == AUDIO_OUTPUT_FRAMES)
-			return;
+		*start_point = convert_time_to_frames(sample_rate, source->audio_ts - ts->start);
+		if (*start_point == AUDIO_OUTPUT_FRAMES)
+			return false;
 
-		total_floats -= start_point;
+		*total_floats -= *start_point;
 	}
 
-	for (size_t mix_idx = 0; mix_idx < MAX_AUDIO_MIXES; mix_idx++) {
-		for (size_t ch = 0; ch < channels; ch++) {
-			register float *mix = mixes[mix_idx].data[ch];
-			register float *aud = source->audio_output_buf[mix_idx][ch];
-			register float *end;
+	return true;
+}
+
+static inline void mix_audio_single(struct audio_output_data *mix_data, obs_source_t *source, size_t mix_idx,
+				    size_t channels, size_t start_point, size_t total_floats)
+{
+	for (size_t ch = 0; ch < channels; ch++)
+		audio_mix_add(mix_data->data[ch] + start_point, source->audio_output_buf[mix_idx][ch], total_floats);
+}
+
+static inline void mix_audio(struct audio_output_data *mixes, obs_source_t *source, size_t channels, size_t sample_rate,
+			     struct ts_info *ts)
+{
+	size_t total_floats;
+	size_t start_point;
 
-			mix += start_point;
-			end = aud + total_floats;
+	if (!get_mix_range(source, sample_rate, ts, &start_point, &total_floats))
+		return;
 
-			while (aud < end)
-				*(mix++) += *(aud++);
-		}
-	}
+	for (size_t mix_idx = 0; mix_idx < MAX_AUDIO_MIXES; mix_idx++)
+		mix_audio_single(&mixes[mix_idx], source, mix_idx, channels, start_point, total_floats);
 }
 
 static bool ignore_audio(obs_source_t *source, size_t channels, size_t sample_rate, uint64_t start_ts)
@@ -549,6 +558,194 @@ static inline void clear_audio_output_buf(obs_source_t *source, struct obs_core_
 	}
 }
 
+struct audio_render_info {
+	struct obs_core_audio *audio;
+	uint32_t mixers;
+	size_t channels;
+	size_t sample_rate;
+	size_t audio_size;
+	uint64_t start_ts;
+};
+
+static void render_audio_source(struct audio_render_info *info, obs_source_t *source)
+{
+	struct obs_core_audio *audio = info->audio;
+
+	obs_source_audio_render(source, info->mixers, info->channels, info->sample_rate, info->audio_size);
+	if (should_silence_monitored_source(source, audio))
+		clear_audio_output_buf(source, audio);
+
+	/* if a source has gone backward in time and we can no
+	 * longer buffer, drop some or all of its audio */
+	if (audio_buffering_maxed(audio) && source->audio_ts != 0 && source->audio_ts < info->start_ts) {
+		if (source->info.audio_render) {
+			blog(LOG_DEBUG,
+			     "render audio source %s timestamp has "
+			     "gone backwards",
+			     obs_source_get_name(source));
+
+			/* just avoid further damage */
+			source->audio_pending = true;
+#if DEBUG_AUDIO == 1
+			/* this should really be fixed */
+			assert(false);
+#endif
+		} else {
+			pthread_mutex_lock(&source->audio_buf_mutex);
+			bool rerender = ignore_audio(source, info->channels, info->sample_rate, info->start_ts);
+			pthread_mutex_unlock(&source->audio_buf_mutex);
+
+			/* if we (potentially) recovered, re-render */
+			if (rerender)
+				obs_source_audio_render(source, info->mixers, info->channels, info->sample_rate,
+							info->audio_size);
+		}
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* parallel mixing                                                           */
+
+static const char *render_parallel_name = "audio_render_parallel";
+static const char *mix_parallel_name = "audio_mix_parallel";
+
+#define MAX_MIX_THREADS 8
+
+/* Sources that neither render nor mix in other sources only touch their own
+ * buffers, so they can be rendered in any order and on any thread.  Everything
+ * else reads the output of its children and stays serial. */
+static inline bool is_leaf_audio_source(obs_source_t *source)
+{
+	return !source->info.audio_render && !source->info.audio_mix;
+}
+
+static void render_leaf_task(void *param, size_t idx)
+{
+	struct audio_render_info *info = param;
+	render_audio_source(info, info->audio->parallel_sources.array[idx]);
+}
+
+static void render_audio_parallel(struct audio_render_info *info)
+{
+	struct obs_core_audio *audio = info->audio;
+
+	da_resize(audio->parallel_sources, 0);
+	for (size_t i = 0; i < audio->render_order.num; i++) {
+		obs_source_t *source = audio->render_order.array[i];
+		if (is_leaf_audio_source(source))
+			da_push_back(audio->parallel_sources, &source);
+	}
+
+	os_task_pool_run(audio->mix_pool, render_leaf_task, info, audio->parallel_sources.num);
+
+	/* render_order lists children before their parents, so composite
+	 * sources still see fully rendered inputs */
+	for (size_t i = 0; i < audio->render_order.num; i++) {
+		obs_source_t *source = audio->render_order.array[i];
+		if (!is_leaf_audio_source(source))
+			render_audio_source(info, source);
+	}
+}
+
+struct audio_mix_info {
+	struct obs_core_audio *audio;
+	struct audio_output_data *mixes;
+	size_t channels;
+};
+
+static void mix_task(void *param, size_t mix_idx)
+{
+	struct audio_mix_info *info = param;
+	struct obs_core_audio *audio = info->audio;
+
+	for (size_t i = 0; i < audio->mix_jobs.num; i++) {
+		struct audio_mix_job *job = &audio->mix_jobs.array[i];
+		mix_audio_single(&info->mixes[mix_idx], job->source, mix_idx, info->channels, job->start_point,
+				 job->total_floats);
+	}
+}
+
+/* Each mix is summed by a single task in root node order, so the floating
+ * point result is the same as the serial path.  Output buffers are only
+ * written by the audio thread, which is blocked in os_task_pool_run, so only
+ * the timestamps need the source lock. */
+static void mix_audio_parallel(struct obs_core_audio *audio, struct audio_output_data *mixes, size_t channels,
+			       size_t sample_rate, struct ts_info *ts)
+{
+	struct audio_mix_info info = {audio, mixes, channels};
+
+	da_resize(audio->mix_jobs, 0);
+	for (size_t i = 0; i < audio->root_nodes.num; i++) {
+		obs_source_t *source = audio->root_nodes.array[i];
+		struct audio_mix_job job = {source};
+
+		if (source->audio_pending)
+			continue;
+
+		pthread_mutex_lock(&source->audio_buf_mutex);
+		if (source->audio_output_buf[0][0] && source->audio_ts &&
+		    get_mix_range(source, sample_rate, ts, &job.start_point, &job.total_floats))
+			da_push_back(audio->mix_jobs, &job);
+		pthread_mutex_unlock(&source->audio_buf_mutex);
+	}
+
+	if (audio->mix_jobs.num)
+		os_task_pool_run(audio->mix_pool, mix_task, &info, MAX_AUDIO_MIXES);
+}
+
+static bool update_parallel_mixing(struct obs_core_audio *audio)
+{
+	bool parallel = os_atomic_load_bool(&obs->parallel_audio_mixing);
+
+	if (parallel && !audio->mix_pool) {
+		int cores = os_get_physical_cores();
+		size_t threads = cores > 1 ? (size_t)cores - 1 : 1;
+		if (threads > MAX_MIX_THREADS)
+			threads = MAX_MIX_THREADS;
+
+		audio->mix_pool = os_task_pool_create(threads, "libobs: audio mix thread");
+		if (!audio->mix_pool) {
+			blog(LOG_WARNING, "Failed to create audio mix threads, mixing serially");
+			os_atomic_set_bool(&obs->parallel_audio_mixing, false);
+			parallel = false;
+		} else {
+			blog(LOG_INFO, "Created %zu audio mix threads", os_task_pool_threads(audio->mix_pool));
+		}
+	}
+
+	if (parallel != audio->parallel_active) {
+		log_audio_tick_stats(audio);
+		audio->parallel_active = parallel;
+	}
+
+	return parallel;
+}
+
+static inline void add_tick_time(struct obs_core_audio *audio, uint64_t tick_ns)
+{
+	audio->tick_count++;
+	audio->tick_total_ns += tick_ns;
+	if (tick_ns > audio->tick_max_ns)
+		audio->tick_max_ns = tick_ns;
+}
+
+void log_audio_tick_stats(struct obs_core_audio *audio)
+{
+	if (!audio->tick_count)
+		return;
+
+	blog(LOG_INFO,
+	     "Audio mixing (%s): %" PRIu64 " ticks, "
+	     "average %.3f ms, max %.3f ms per tick",
+	     audio->parallel_active ? "parallel" : "serial", audio->tick_count,
+	     (double)audio->tick_total_ns / (double)audio->tick_count / 1000000.0,
+	     (double)audio->tick_max_ns / 1000000.0);
+
+	audio->tick_count = 0;
+	audio->tick_total_ns = 0;
+	audio->tick_max_ns = 0;
+}
+
 bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint64_t *out_ts, uint32_t mixers,
 		    struct audio_output_data *mixes)
 {
@@ -560,6 +757,8 @@ bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint6
 	struct ts_info ts = {start_ts_in, end_ts_in};
 	size_t audio_size;
 	uint64_t min_ts;
+	uint64_t tick_start = os_gettime_ns();
+	bool parallel = update_parallel_mixing(audio);
 
 	da_resize(audio->render_order, 0);
 	da_resize(audio->root_nodes, 0);
@@ -623,37 +822,15 @@ bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint6
 
 	/* ------------------------------------------------ */
 	/* render audio data */
-	for (size_t i = 0; i < audio->render_order.num; i++) {
-		obs_source_t *source = audio->render_order.array[i];
-		obs_source_audio_render(source, mixers, channels, sample_rate, audio_size);
-		if (should_silence_monitored_source(source, audio))
-			clear_audio_output_buf(source, audio);
-
-		/* if a source has gone backward in time and we can no
-		 * longer buffer, drop some or all of its audio */
-		if (audio_buffering_maxed(audio) && source->audio_ts != 0 && source->audio_ts < ts.start) {
-			if (source->info.audio_render) {
-				blog(LOG_DEBUG,
-				     "render audio source %s timestamp has "
-				     "gone backwards",
-				     obs_source_get_name(source));
-
-				/* just avoid further damage */
-				source->audio_pending = true;
-#if DEBUG_AUDIO == 1
-				/* this should really be fixed */
-				assert(false);
-#endif
-			} else {
-				pthread_mutex_lock(&source->audio_buf_mutex);
-				bool rerender = ignore_audio(source, channels, sample_rate, ts.start);
-				pthread_mutex_unlock(&source->audio_buf_mutex);
-
-				/* if we (potentially) recovered, re-render */
-				if (rerender)
-					obs_source_audio_render(source, mixers, channels, sample_rate, audio_size);
-			}
-		}
+	struct audio_render_info render_info = {audio, mixers, channels, sample_rate, audio_size, ts.start};
+
+	if (parallel) {
+		profile_start(render_parallel_name);
+		render_audio_parallel(&render_info);
+		profile_end(render_parallel_name);
+	} else {
+		for (size_t i = 0; i < audio->render_order.num; i++)
+			render_audio_source(&render_info, audio->render_order.array[i]);
 	}
 
 	/* ------------------------------------------------ */
@@ -674,7 +851,11 @@ bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint6
 
 	/* ------------------------------------------------ */
 	/* mix audio */
-	if (!audio->buffering_wait_ticks) {
+	if (!audio->buffering_wait_ticks && parallel) {
+		profile_start(mix_parallel_name);
+		mix_audio_parallel(audio, mixes, channels, sample_rate, &ts);
+		profile_end(mix_parallel_name);
+	} else if (!audio->buffering_wait_ticks) {
 		for (size_t i = 0; i < audio->root_nodes.num; i++) {
 			obs_source_t *source = audio->root_nodes.array[i];
 
@@ -713,6 +894,8 @@ bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint6
 
 	*out_ts = ts.start;
 
+	add_tick_time(audio, os_gettime_ns() - tick_start);
+
 	if (audio->buffering_wait_ticks) {
 		audio->buffering_wait_ticks--;
 		return false;
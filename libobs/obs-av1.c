@@ -178,6 +178,27 @@ bool obs_av1_keyframe(const uint8_t *data, size_t size)
 	return false;
 }
 
+/* returns the temporal layer of the frame, 0 for the base layer */
+int obs_av1_temporal_id(const uint8_t *data, size_t size)
+{
+	const uint8_t *start = data, *end = data + size;
+
+	while (start < end) {
+		size_t obu_start, obu_size;
+		int obu_type;
+		parse_obu_header(start, end - start, &obu_start, &obu_size, &obu_type);
+
+		/* obu_extension_flag, temporal_id is the top 3 bits of the
+		 * extension header */
+		if (obu_type == OBS_OBU_FRAME || obu_type == OBS_OBU_FRAME_HEADER)
+			return (get_bits(*start, 5, 1) && end - start >= 2) ? start[1] >> 5 : 0;
+
+		start += obu_start + obu_size;
+	}
+
+	return 0;
+}
+
 void obs_extract_av1_headers(const uint8_t *packet, size_t size, uint8_t **new_packet_data, size_t *new_packet_size,
 			     uint8_t **header_data, size_t *header_size)
 {
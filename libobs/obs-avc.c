@@ -47,6 +47,35 @@ bool obs_avc_keyframe(const uint8_t *data, size_t size)
 	return false;
 }
 
+/* returns the SVC temporal layer of the picture, 0 for the base layer */
+int obs_avc_temporal_id(const uint8_t *data, size_t size)
+{
+	const uint8_t *nal_start;
+	const uint8_t *end = data + size;
+
+	nal_start = obs_nal_find_startcode(data, end);
+	while (true) {
+		while (nal_start < end && !*(nal_start++))
+			;
+
+		if (nal_start == end)
+			break;
+
+		const uint8_t type = nal_start[0] & 0x1F;
+
+		/* svc_extension_flag, then temporal_id is the top 3 bits of
+		 * the third byte of the extension header */
+		if (type == OBS_NAL_PREFIX || type == OBS_NAL_SLICE_EXT)
+			return (end - nal_start >= 4 && (nal_start[1] & 0x80)) ? nal_start[3] >> 5 : 0;
+		if (type == OBS_NAL_SLICE_IDR || type == OBS_NAL_SLICE)
+			return 0;
+
+		nal_start = obs_nal_find_startcode(nal_start, end);
+	}
+
+	return 0;
+}
+
 const uint8_t *obs_avc_find_startcode(const uint8_t *p, const uint8_t *end)
 {
 	return obs_nal_find_startcode(p, end);
@@ -37,11 +37,14 @@ enum {
 	OBS_NAL_PPS = 8,
 	OBS_NAL_AUD = 9,
 	OBS_NAL_FILLER = 12,
+	OBS_NAL_PREFIX = 14,
+	OBS_NAL_SLICE_EXT = 20,
 };
 
 /* Helpers for parsing AVC NAL units.  */
 
 EXPORT bool obs_avc_keyframe(const uint8_t *data, size_t size);
+EXPORT int obs_avc_temporal_id(const uint8_t *data, size_t size);
 EXPORT const uint8_t *obs_avc_find_startcode(const uint8_t *p, const uint8_t *end);
 EXPORT void obs_parse_avc_packet(struct encoder_packet *avc_packet, const struct encoder_packet *src);
 EXPORT int obs_parse_avc_packet_priority(const struct encoder_packet *packet);
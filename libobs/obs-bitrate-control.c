@@ -0,0 +1,447 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <inttypes.h>
+
+#include "util/deque.h"
+#include "obs-internal.h"
+
+#define MSEC_TO_NSEC 1000000ULL
+#define MIN_ESTIMATE_DURATION_MS 1000
+#define MAX_ESTIMATE_DURATION_MS 2000
+#define MIN_BITRATE 50
+
+#define do_log(level, format, ...) blog(level, "[bitrate control: '%s'] " format, ctrl->info.id, ##__VA_ARGS__)
+
+struct obs_bitrate_controller {
+	pthread_mutex_t mutex;
+
+	struct obs_bitrate_policy_info info;
+	void *data;
+
+	struct deque frames;
+	size_t data_size;
+
+	long est_bitrate;
+	long cur_bitrate;
+	long max_bitrate;
+	long audio_bitrate;
+};
+
+/* ------------------------------------------------------------------------- */
+/* AIMD: drops straight to the measured throughput once data starts piling
+ * up, then climbs back in steps of a tenth of the configured bitrate.  This
+ * is the heuristic the RTMP output has always used. */
+
+#define AIMD_INC_TIMER (4000ULL * MSEC_TO_NSEC)
+#define AIMD_TRIGGER_USEC 200000LL
+
+struct aimd_policy {
+	long prev_bitrate;
+	long inc_bitrate;
+	uint64_t inc_timeout;
+};
+
+static void *aimd_create(const struct obs_bitrate_state *state, void *type_data)
+{
+	struct aimd_policy *aimd = bzalloc(sizeof(*aimd));
+	aimd->inc_bitrate = state->max_bitrate / 10;
+
+	UNUSED_PARAMETER(type_data);
+	return aimd;
+}
+
+static void aimd_destroy(void *data)
+{
+	bfree(data);
+}
+
+static long aimd_update(void *data, const struct obs_bitrate_state *state)
+{
+	struct aimd_policy *aimd = data;
+	long new_bitrate;
+
+	if (aimd->inc_timeout && state->now_ns >= aimd->inc_timeout) {
+		aimd->inc_timeout = 0;
+		aimd->prev_bitrate = state->cur_bitrate;
+
+		new_bitrate = state->cur_bitrate + aimd->inc_bitrate;
+		if (new_bitrate < state->max_bitrate)
+			aimd->inc_timeout = state->now_ns + AIMD_INC_TIMER;
+		return new_bitrate;
+	}
+
+	if (state->queue_usec < AIMD_TRIGGER_USEC)
+		return state->cur_bitrate;
+
+	if (state->est_bitrate && state->est_bitrate < state->cur_bitrate) {
+		new_bitrate = state->est_bitrate / 100 * 100;
+		if (new_bitrate < MIN_BITRATE)
+			new_bitrate = MIN_BITRATE;
+
+	} else if (aimd->prev_bitrate) {
+		new_bitrate = aimd->prev_bitrate;
+
+	} else {
+		return state->cur_bitrate;
+	}
+
+	if (new_bitrate == state->cur_bitrate)
+		return state->cur_bitrate;
+
+	aimd->prev_bitrate = 0;
+	aimd->inc_timeout = state->now_ns + AIMD_INC_TIMER;
+	return new_bitrate;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Delay gradient: modeled on the GCC rate controller.  Rather than waiting
+ * for a fixed amount of data to pile up, it fits a trend line through the
+ * recent queue durations and backs off as soon as the queue keeps growing,
+ * then probes upwards multiplicatively while the queue is stable. */
+
+#define TRENDLINE_SAMPLES 20
+#define TRENDLINE_SMOOTHING 0.9
+#define OVERUSE_SLOPE 0.05 /* queue growing by 50ms per second */
+#define OVERUSE_MIN_QUEUE_USEC 50000LL
+#define DECREASE_FACTOR 0.85
+#define INCREASE_FACTOR 1.08
+#define DECREASE_INTERVAL_NS (1200ULL * MSEC_TO_NSEC)
+#define INCREASE_INTERVAL_NS (1000ULL * MSEC_TO_NSEC)
+
+struct delay_gradient_policy {
+	double times[TRENDLINE_SAMPLES];
+	double queues[TRENDLINE_SAMPLES];
+	size_t num_samples;
+	size_t next_sample;
+
+	double smoothed_queue;
+	double decrease_queue;
+	uint64_t first_time;
+	uint64_t last_change;
+};
+
+static void *delay_gradient_create(const struct obs_bitrate_state *state, void *type_data)
+{
+	struct delay_gradient_policy *dg = bzalloc(sizeof(*dg));
+	dg->first_time = state->now_ns;
+
+	UNUSED_PARAMETER(type_data);
+	return dg;
+}
+
+static void delay_gradient_destroy(void *data)
+{
+	bfree(data);
+}
+
+static double delay_gradient_slope(struct delay_gradient_policy *dg)
+{
+	double avg_t = 0.0, avg_q = 0.0;
+	double num = 0.0, den = 0.0;
+	size_t n = dg->num_samples;
+
+	for (size_t i = 0; i < n; i++) {
+		avg_t += dg->times[i];
+		avg_q += dg->queues[i];
+	}
+	avg_t /= (double)n;
+	avg_q /= (double)n;
+
+	for (size_t i = 0; i < n; i++) {
+		double dt = dg->times[i] - avg_t;
+		num += dt * (dg->queues[i] - avg_q);
+		den += dt * dt;
+	}
+
+	return den > 0.0 ? num / den : 0.0;
+}
+
+static long delay_gradient_update(void *data, const struct obs_bitrate_state *state)
+{
+	struct delay_gradient_policy *dg = data;
+	double queue_ms = (double)state->queue_usec / 1000.0;
+
+	dg->smoothed_queue = TRENDLINE_SMOOTHING * dg->smoothed_queue + (1.0 - TRENDLINE_SMOOTHING) * queue_ms;
+	dg->times[dg->next_sample] = (double)(state->now_ns - dg->first_time) / 1000000.0;
+	dg->queues[dg->next_sample] = dg->smoothed_queue;
+	dg->next_sample = (dg->next_sample + 1) % TRENDLINE_SAMPLES;
+	if (dg->num_samples < TRENDLINE_SAMPLES)
+		dg->num_samples++;
+
+	if (dg->num_samples < TRENDLINE_SAMPLES)
+		return state->cur_bitrate;
+
+	double slope = delay_gradient_slope(dg);
+	uint64_t since_change = state->now_ns - dg->last_change;
+
+	if (slope > OVERUSE_SLOPE && state->queue_usec > OVERUSE_MIN_QUEUE_USEC) {
+		/* give the last decrease a chance to take effect before
+		 * backing off further */
+		if (since_change < DECREASE_INTERVAL_NS || dg->smoothed_queue <= dg->decrease_queue)
+			return state->cur_bitrate;
+
+		long base = state->est_bitrate && state->est_bitrate < state->cur_bitrate ? state->est_bitrate
+											 : state->cur_bitrate;
+		dg->last_change = state->now_ns;
+		dg->decrease_queue = dg->smoothed_queue;
+		return (long)(base * DECREASE_FACTOR);
+	}
+
+	/* hold while the queue drains, increase once it's stable */
+	if (slope < -OVERUSE_SLOPE || state->queue_usec > OVERUSE_MIN_QUEUE_USEC ||
+	    since_change < INCREASE_INTERVAL_NS || state->cur_bitrate >= state->max_bitrate)
+		return state->cur_bitrate;
+
+	long new_bitrate = (long)(state->cur_bitrate * INCREASE_FACTOR);
+	if (new_bitrate <= state->cur_bitrate)
+		new_bitrate = state->cur_bitrate + 1;
+
+	/* don't probe far beyond what the link has been shown to carry */
+	if (state->est_bitrate && new_bitrate > state->est_bitrate * 3 / 2)
+		new_bitrate = state->est_bitrate * 3 / 2;
+
+	if (new_bitrate > state->cur_bitrate) {
+		dg->last_change = state->now_ns;
+		dg->decrease_queue = 0.0;
+	}
+	return new_bitrate;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static const struct obs_bitrate_policy_info builtin_policies[] = {
+	{
+		.id = OBS_BITRATE_POLICY_AIMD,
+		.create = aimd_create,
+		.destroy = aimd_destroy,
+		.update = aimd_update,
+	},
+	{
+		.id = OBS_BITRATE_POLICY_DELAY_GRADIENT,
+		.create = delay_gradient_create,
+		.destroy = delay_gradient_destroy,
+		.update = delay_gradient_update,
+	},
+};
+
+const struct obs_bitrate_policy_info *find_bitrate_policy(const char *id)
+{
+	for (size_t i = 0; i < sizeof(builtin_policies) / sizeof(builtin_policies[0]); i++) {
+		if (strcmp(builtin_policies[i].id, id) == 0)
+			return &builtin_policies[i];
+	}
+
+	if (!obs)
+		return NULL;
+
+	for (size_t i = 0; i < obs->bitrate_policy_types.num; i++) {
+		const struct obs_bitrate_policy_info *info = &obs->bitrate_policy_types.array[i];
+		if (strcmp(info->id, id) == 0)
+			return info;
+	}
+
+	return NULL;
+}
+
+static inline void fill_state(const struct obs_bitrate_controller *ctrl, struct obs_bitrate_state *state,
+			      uint64_t now_ns, int64_t queue_usec)
+{
+	state->now_ns = now_ns;
+	state->queue_usec = queue_usec;
+	state->est_bitrate = ctrl->est_bitrate;
+	state->cur_bitrate = ctrl->cur_bitrate;
+	state->max_bitrate = ctrl->max_bitrate;
+	state->audio_bitrate = ctrl->audio_bitrate;
+}
+
+static inline void clear_estimate(struct obs_bitrate_controller *ctrl)
+{
+	deque_pop_front(&ctrl->frames, NULL, ctrl->frames.size);
+	ctrl->data_size = 0;
+	ctrl->est_bitrate = 0;
+}
+
+obs_bitrate_controller_t *obs_bitrate_controller_create(const char *policy, long max_bitrate, long audio_bitrate)
+{
+	const struct obs_bitrate_policy_info *info;
+	struct obs_bitrate_controller *ctrl;
+	struct obs_bitrate_state state;
+
+	if (!policy || !*policy)
+		policy = OBS_BITRATE_POLICY_AIMD;
+
+	info = find_bitrate_policy(policy);
+	if (!info) {
+		blog(LOG_WARNING, "Bitrate policy '%s' not found", policy);
+		return NULL;
+	}
+
+	ctrl = bzalloc(sizeof(*ctrl));
+	ctrl->info = *info;
+	ctrl->max_bitrate = max_bitrate;
+	ctrl->cur_bitrate = max_bitrate;
+	ctrl->audio_bitrate = audio_bitrate;
+
+	if (pthread_mutex_init(&ctrl->mutex, NULL) != 0)
+		goto fail;
+
+	fill_state(ctrl, &state, os_gettime_ns(), 0);
+	ctrl->data = info->create(&state, info->type_data);
+	if (!ctrl->data)
+		goto fail_policy;
+
+	return ctrl;
+
+fail_policy:
+	pthread_mutex_destroy(&ctrl->mutex);
+fail:
+	bfree(ctrl);
+	return NULL;
+}
+
+void obs_bitrate_controller_destroy(obs_bitrate_controller_t *ctrl)
+{
+	if (!ctrl)
+		return;
+
+	ctrl->info.destroy(ctrl->data);
+	deque_free(&ctrl->frames);
+	pthread_mutex_destroy(&ctrl->mutex);
+	bfree(ctrl);
+}
+
+void obs_bitrate_controller_frame_sent(obs_bitrate_controller_t *ctrl, const struct obs_bitrate_sample *sample)
+{
+	struct obs_bitrate_sample front;
+	uint64_t dur;
+
+	pthread_mutex_lock(&ctrl->mutex);
+
+	if (ctrl->info.frame_sent)
+		ctrl->info.frame_sent(ctrl->data, sample);
+
+	deque_push_back(&ctrl->frames, sample, sizeof(*sample));
+	deque_peek_front(&ctrl->frames, &front, sizeof(front));
+
+	ctrl->data_size += sample->size;
+
+	dur = (sample->send_end_ns - front.send_beg_ns) / MSEC_TO_NSEC;
+
+	if (dur >= MAX_ESTIMATE_DURATION_MS) {
+		ctrl->data_size -= front.size;
+		deque_pop_front(&ctrl->frames, NULL, sizeof(front));
+	}
+
+	ctrl->est_bitrate = (dur >= MIN_ESTIMATE_DURATION_MS) ? (long)(ctrl->data_size * 1000 / dur) : 0;
+	ctrl->est_bitrate *= 8;
+	ctrl->est_bitrate /= 1000;
+
+	if (ctrl->est_bitrate) {
+		ctrl->est_bitrate -= ctrl->audio_bitrate;
+		if (ctrl->est_bitrate < MIN_BITRATE)
+			ctrl->est_bitrate = MIN_BITRATE;
+	}
+
+	pthread_mutex_unlock(&ctrl->mutex);
+}
+
+bool obs_bitrate_controller_update(obs_bitrate_controller_t *ctrl, uint64_t now_ns, int64_t queue_usec)
+{
+	struct obs_bitrate_state state;
+	long new_bitrate;
+
+	pthread_mutex_lock(&ctrl->mutex);
+
+	fill_state(ctrl, &state, now_ns, queue_usec);
+	new_bitrate = ctrl->info.update(ctrl->data, &state);
+
+	if (new_bitrate > ctrl->max_bitrate)
+		new_bitrate = ctrl->max_bitrate;
+	if (new_bitrate < MIN_BITRATE)
+		new_bitrate = MIN_BITRATE;
+
+	if (new_bitrate == ctrl->cur_bitrate) {
+		pthread_mutex_unlock(&ctrl->mutex);
+		return false;
+	}
+
+	/* an estimate below the old bitrate was what the policy backed off
+	 * to, start over so it doesn't hold the policy back.  Falling back to
+	 * a previous bitrate keeps the estimate, as the RTMP output always
+	 * did. */
+	if (new_bitrate < ctrl->cur_bitrate) {
+		if (state.est_bitrate && state.est_bitrate < state.cur_bitrate)
+			clear_estimate(ctrl);
+		do_log(LOG_INFO, "bitrate decreased to: %ld (queue: %" PRId64 " ms)", new_bitrate, queue_usec / 1000);
+	} else {
+		do_log(LOG_INFO, "bitrate increased to: %ld%s", new_bitrate,
+		       new_bitrate == ctrl->max_bitrate ? ", done" : "");
+	}
+
+	ctrl->cur_bitrate = new_bitrate;
+	pthread_mutex_unlock(&ctrl->mutex);
+	return true;
+}
+
+long obs_bitrate_controller_get_bitrate(obs_bitrate_controller_t *ctrl)
+{
+	long bitrate;
+
+	if (!ctrl)
+		return 0;
+
+	pthread_mutex_lock(&ctrl->mutex);
+	bitrate = ctrl->cur_bitrate;
+	pthread_mutex_unlock(&ctrl->mutex);
+
+	return bitrate;
+}
+
+void obs_bitrate_controller_reset(obs_bitrate_controller_t *ctrl)
+{
+	struct obs_bitrate_state state;
+	void *data;
+
+	pthread_mutex_lock(&ctrl->mutex);
+
+	clear_estimate(ctrl);
+	ctrl->cur_bitrate = ctrl->max_bitrate;
+
+	fill_state(ctrl, &state, os_gettime_ns(), 0);
+	data = ctrl->info.create(&state, ctrl->info.type_data);
+	if (data) {
+		ctrl->info.destroy(ctrl->data);
+		ctrl->data = data;
+	}
+
+	pthread_mutex_unlock(&ctrl->mutex);
+}
+
+void obs_bitrate_controller_apply(obs_bitrate_controller_t *ctrl, obs_encoder_t *encoder)
+{
+	obs_data_t *settings;
+
+	if (!ctrl || !encoder)
+		return;
+
+	settings = obs_encoder_get_settings(encoder);
+	obs_data_set_int(settings, "bitrate", obs_bitrate_controller_get_bitrate(ctrl));
+	obs_encoder_update(encoder, settings);
+	obs_data_release(settings);
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+/**
+ * @file
+ * @brief header for dynamic bitrate control.
+ *
+ * A bitrate controller estimates the throughput of a network output from
+ * the send times of the frames it writes and the amount of data waiting to
+ * be sent, and asks a policy what the video encoder bitrate should be.
+ * Outputs feed it events, the controller keeps the estimate and applies
+ * the policy's decision to the encoder.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OBS_BITRATE_POLICY_AIMD "aimd"
+#define OBS_BITRATE_POLICY_DELAY_GRADIENT "delay_gradient"
+
+/** A frame finished sending */
+struct obs_bitrate_sample {
+	uint64_t send_beg_ns; /**< when the frame was handed to the transport */
+	uint64_t send_end_ns; /**< when the transport accepted or acknowledged it */
+	size_t size;
+};
+
+/** Link state handed to the policy on every update */
+struct obs_bitrate_state {
+	uint64_t now_ns;
+
+	/** duration of the data waiting to be sent, in microseconds */
+	int64_t queue_usec;
+
+	/** video bitrate the link sustained recently, 0 if not known yet */
+	long est_bitrate;
+
+	long cur_bitrate;
+	long max_bitrate;
+	long audio_bitrate;
+};
+
+struct obs_bitrate_policy_info {
+	/* required */
+	const char *id;
+
+	void *(*create)(const struct obs_bitrate_state *state, void *type_data);
+	void (*destroy)(void *data);
+
+	/**
+	 * Decides the video bitrate for the current link state
+	 *
+	 * @param  data   Internal policy data
+	 * @param  state  Current link state
+	 * @return        The new video bitrate in kbps, or state->cur_bitrate
+	 *                to keep it
+	 */
+	long (*update)(void *data, const struct obs_bitrate_state *state);
+
+	/* optional */
+
+	/** Called for every frame sample before it is added to the estimate */
+	void (*frame_sent)(void *data, const struct obs_bitrate_sample *sample);
+
+	void *type_data;
+	void (*free_type_data)(void *type_data);
+};
+
+EXPORT void obs_register_bitrate_policy_s(const struct obs_bitrate_policy_info *info, size_t size);
+
+#define obs_register_bitrate_policy(info) \
+	obs_register_bitrate_policy_s(info, sizeof(struct obs_bitrate_policy_info))
+
+typedef struct obs_bitrate_controller obs_bitrate_controller_t;
+
+/**
+ * Creates a bitrate controller
+ *
+ * @param  policy         Policy id, NULL for the default (AIMD) policy
+ * @param  max_bitrate    Configured video bitrate in kbps, the controller
+ *                        never goes above it
+ * @param  audio_bitrate  Total audio bitrate in kbps, subtracted from the
+ *                        throughput estimate
+ */
+EXPORT obs_bitrate_controller_t *obs_bitrate_controller_create(const char *policy, long max_bitrate,
+							       long audio_bitrate);
+EXPORT void obs_bitrate_controller_destroy(obs_bitrate_controller_t *ctrl);
+
+/** Records a sent frame, can be called from the send thread */
+EXPORT void obs_bitrate_controller_frame_sent(obs_bitrate_controller_t *ctrl, const struct obs_bitrate_sample *sample);
+
+/**
+ * Runs the policy against the amount of queued data
+ *
+ * @return  true if the target bitrate changed
+ */
+EXPORT bool obs_bitrate_controller_update(obs_bitrate_controller_t *ctrl, uint64_t now_ns, int64_t queue_usec);
+
+EXPORT long obs_bitrate_controller_get_bitrate(obs_bitrate_controller_t *ctrl);
+
+/** Goes back to the maximum bitrate and clears the throughput estimate */
+EXPORT void obs_bitrate_controller_reset(obs_bitrate_controller_t *ctrl);
+
+/** Sets the encoder's bitrate to the controller's target */
+EXPORT void obs_bitrate_controller_apply(obs_bitrate_controller_t *ctrl, obs_encoder_t *encoder);
+
+#ifdef __cplusplus
+}
+#endif
@@ -27,7 +27,23 @@
 #include "graphics/quat.h"
 #include "obs-data.h"
 
-#include <jansson.h>
+#include <errno.h>
+#include <math.h>
+#include <stdarg.h>
+
+struct obs_data_value {
+	uint8_t *buf;
+	size_t capacity;
+	size_t size;
+
+	/* small values are stored here instead of buf */
+	union {
+		long long int_val;
+		double double_val;
+		void *ptr;
+		uint8_t data[16];
+	} local;
+};
 
 struct obs_data_item {
 	volatile long ref;
@@ -35,13 +51,9 @@ struct obs_data_item {
 	struct obs_data *parent;
 	UT_hash_handle hh;
 	enum obs_data_type type;
-	size_t name_len;
-	size_t data_len;
-	size_t data_size;
-	size_t default_len;
-	size_t default_size;
-	size_t autoselect_size;
-	size_t capacity;
+	struct obs_data_value user_val;
+	struct obs_data_value default_val;
+	struct obs_data_value autoselect_val;
 };
 
 struct obs_data {
@@ -64,25 +76,38 @@ struct obs_data_number {
 };
 
 /* ------------------------------------------------------------------------- */
-/* Item structure, designed to be one allocation only */
+/* Item structure
+ *
+ * The item and its name are one allocation that never moves once the item
+ * is in the hash table.  Each of the three values is stored in the item if
+ * it's small enough, larger ones use a separate buffer that's only grown,
+ * so changing a value doesn't reallocate the item or touch the others. */
 
-static inline size_t get_align_size(size_t size)
+static inline void *value_ptr(struct obs_data_value *val)
 {
-	const size_t alignment = base_get_alignment();
-	return (size + alignment - 1) & ~(alignment - 1);
+	return val->size > sizeof(val->local) ? val->buf : val->local.data;
 }
 
-/* ensures data after the name has alignment (in case of SSE) */
-static inline size_t get_name_align_size(const char *name)
+static void value_set(struct obs_data_value *val, const void *data, size_t size)
 {
-	size_t name_size = strlen(name) + 1;
-	size_t alignment = base_get_alignment();
-	size_t total_size;
+	if (size > sizeof(val->local) && size > val->capacity) {
+		/* strings tend to be set again with a slightly different
+		 * length, leave some room for that */
+		size_t capacity = size + size / 2;
+		uint8_t *buf = bmalloc(capacity);
+
+		memcpy(buf, data, size);
+		bfree(val->buf);
 
-	total_size = sizeof(struct obs_data_item) + (name_size + alignment - 1);
-	total_size &= ~(alignment - 1);
+		val->buf = buf;
+		val->capacity = capacity;
+		val->size = size;
+		return;
+	}
 
-	return total_size - sizeof(struct obs_data_item);
+	val->size = size;
+	if (size)
+		memmove(value_ptr(val), data, size);
 }
 
 static inline char *get_item_name(struct obs_data_item *item)
@@ -90,42 +115,27 @@ static inline char *get_item_name(struct obs_data_item *item)
 	return (char *)item + sizeof(struct obs_data_item);
 }
 
-static inline void *get_data_ptr(obs_data_item_t *item)
-{
-	return (uint8_t *)get_item_name(item) + item->name_len;
-}
-
+/* without a user value, the default value is used, then the autoselect
+ * value */
 static inline void *get_item_data(struct obs_data_item *item)
 {
-	if (!item->data_size && !item->default_size && !item->autoselect_size)
-		return NULL;
-	return get_data_ptr(item);
-}
-
-static inline void *get_default_data_ptr(obs_data_item_t *item)
-{
-	return (uint8_t *)get_data_ptr(item) + item->data_len;
+	if (item->user_val.size)
+		return value_ptr(&item->user_val);
+	if (item->default_val.size)
+		return value_ptr(&item->default_val);
+	if (item->autoselect_val.size)
+		return value_ptr(&item->autoselect_val);
+	return NULL;
 }
 
 static inline void *get_item_default_data(struct obs_data_item *item)
 {
-	return item->default_size ? get_default_data_ptr(item) : NULL;
-}
-
-static inline void *get_autoselect_data_ptr(obs_data_item_t *item)
-{
-	return (uint8_t *)get_default_data_ptr(item) + item->default_len;
+	return item->default_val.size ? value_ptr(&item->default_val) : NULL;
 }
 
 static inline void *get_item_autoselect_data(struct obs_data_item *item)
 {
-	return item->autoselect_size ? get_autoselect_data_ptr(item) : NULL;
-}
-
-static inline size_t obs_data_item_total_size(struct obs_data_item *item)
-{
-	return sizeof(struct obs_data_item) + item->name_len + item->data_len + item->default_len +
-	       item->autoselect_size;
+	return item->autoselect_val.size ? value_ptr(&item->autoselect_val) : NULL;
 }
 
 static inline obs_data_t *get_item_obj(struct obs_data_item *item)
@@ -142,18 +152,18 @@ static inline obs_data_t *get_item_obj(struct obs_data_item *item)
 
 static inline obs_data_t *get_item_default_obj(struct obs_data_item *item)
 {
-	if (!item || !item->default_size)
+	if (!item || !item->default_val.size)
 		return NULL;
 
-	return *(obs_data_t **)get_default_data_ptr(item);
+	return *(obs_data_t **)value_ptr(&item->default_val);
 }
 
 static inline obs_data_t *get_item_autoselect_obj(struct obs_data_item *item)
 {
-	if (!item || !item->autoselect_size)
+	if (!item || !item->autoselect_val.size)
 		return NULL;
 
-	return *(obs_data_t **)get_autoselect_data_ptr(item);
+	return *(obs_data_t **)value_ptr(&item->autoselect_val);
 }
 
 static inline obs_data_array_t *get_item_array(struct obs_data_item *item)
@@ -169,428 +179,1231 @@ static inline obs_data_array_t *get_item_array(struct obs_data_item *item)
 
 static inline obs_data_array_t *get_item_default_array(struct obs_data_item *item)
 {
-	if (!item || !item->default_size)
+	if (!item || !item->default_val.size)
 		return NULL;
 
-	return *(obs_data_array_t **)get_default_data_ptr(item);
+	return *(obs_data_array_t **)value_ptr(&item->default_val);
 }
 
 static inline obs_data_array_t *get_item_autoselect_array(struct obs_data_item *item)
 {
-	if (!item || !item->autoselect_size)
+	if (!item || !item->autoselect_val.size)
 		return NULL;
 
-	return *(obs_data_array_t **)get_autoselect_data_ptr(item);
+	return *(obs_data_array_t **)value_ptr(&item->autoselect_val);
 }
 
-static inline void item_data_release(struct obs_data_item *item)
+static inline void value_release(struct obs_data_item *item, struct obs_data_value *val)
 {
-	if (!obs_data_item_has_user_value(item))
+	if (!val->size)
 		return;
 
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_obj(item);
-		obs_data_release(obj);
+	if (item->type == OBS_DATA_OBJECT)
+		obs_data_release(*(obs_data_t **)value_ptr(val));
+	else if (item->type == OBS_DATA_ARRAY)
+		obs_data_array_release(*(obs_data_array_t **)value_ptr(val));
+}
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_array(item);
-		obs_data_array_release(array);
+static inline void value_addref(struct obs_data_item *item, struct obs_data_value *val)
+{
+	if (!val->size)
+		return;
+
+	if (item->type == OBS_DATA_OBJECT)
+		obs_data_addref(*(obs_data_t **)value_ptr(val));
+	else if (item->type == OBS_DATA_ARRAY)
+		obs_data_array_addref(*(obs_data_array_t **)value_ptr(val));
+}
+
+static struct obs_data_item *obs_data_item_create(const char *name, const void *data, size_t size,
+						  enum obs_data_type type, bool default_data, bool autoselect_data)
+{
+	struct obs_data_item *item;
+	struct obs_data_value *val;
+	size_t name_size;
+
+	if (!name || !data)
+		return NULL;
+
+	name_size = strlen(name) + 1;
+	item = bzalloc(sizeof(struct obs_data_item) + name_size);
+	item->type = type;
+	item->ref = 1;
+
+	char *name_ptr = get_item_name(item);
+	item->name = name_ptr;
+	memcpy(name_ptr, name, name_size);
+
+	if (default_data)
+		val = &item->default_val;
+	else if (autoselect_data)
+		val = &item->autoselect_val;
+	else
+		val = &item->user_val;
+
+	value_set(val, data, size);
+	value_addref(item, val);
+	return item;
+}
+
+static inline void obs_data_item_detach(struct obs_data_item *item)
+{
+	if (item->parent) {
+		HASH_DEL(item->parent->items, item);
+		item->parent = NULL;
 	}
 }
 
-static inline void item_default_data_release(struct obs_data_item *item)
+static inline void obs_data_item_destroy(struct obs_data_item *item)
 {
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_default_obj(item);
-		obs_data_release(obj);
+	value_release(item, &item->user_val);
+	value_release(item, &item->default_val);
+	value_release(item, &item->autoselect_val);
+	obs_data_item_detach(item);
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_default_array(item);
-		obs_data_array_release(array);
+	bfree(item->user_val.buf);
+	bfree(item->default_val.buf);
+	bfree(item->autoselect_val.buf);
+	bfree(item);
+}
+
+static inline void obs_data_item_set_value(struct obs_data_item *item, struct obs_data_value *val, const void *data,
+					   size_t size, enum obs_data_type type)
+{
+	value_release(item, val);
+
+	item->type = type;
+	value_set(val, data, size);
+	value_addref(item, val);
+}
+
+static inline void obs_data_item_setdata(struct obs_data_item **p_item, const void *data, size_t size,
+					 enum obs_data_type type)
+{
+	if (p_item && *p_item)
+		obs_data_item_set_value(*p_item, &(*p_item)->user_val, data, size, type);
+}
+
+static inline void obs_data_item_set_default_data(struct obs_data_item **p_item, const void *data, size_t size,
+						  enum obs_data_type type)
+{
+	if (p_item && *p_item)
+		obs_data_item_set_value(*p_item, &(*p_item)->default_val, data, size, type);
+}
+
+static inline void obs_data_item_set_autoselect_data(struct obs_data_item **p_item, const void *data, size_t size,
+						     enum obs_data_type type)
+{
+	if (p_item && *p_item)
+		obs_data_item_set_value(*p_item, &(*p_item)->autoselect_val, data, size, type);
+}
+
+/* ------------------------------------------------------------------------- */
+/* JSON reader, builds the obs_data directly while scanning the text */
+
+#define JSON_MAX_DEPTH 2048
+
+struct json_reader {
+	const char *pos;
+	int line;
+	int depth;
+
+	struct dstr key;
+	struct dstr str;
+	char error[160];
+};
+
+static struct obs_data_item *get_item(struct obs_data *data, const char *name);
+static inline void set_item(struct obs_data *data, obs_data_item_t **item, const char *name, const void *ptr,
+			    size_t size, enum obs_data_type type);
+
+static bool json_error(struct json_reader *r, const char *format, ...)
+{
+	va_list args;
+
+	if (!*r->error) {
+		va_start(args, format);
+		vsnprintf(r->error, sizeof(r->error), format, args);
+		va_end(args);
 	}
+	return false;
 }
 
-static inline void item_autoselect_data_release(struct obs_data_item *item)
+static inline bool json_is_digit(char ch)
 {
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_autoselect_obj(item);
-		obs_data_release(obj);
+	return ch >= '0' && ch <= '9';
+}
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_autoselect_array(item);
-		obs_data_array_release(array);
+static inline void json_skip_whitespace(struct json_reader *r)
+{
+	for (;;) {
+		char ch = *r->pos;
+		if (ch == '\n')
+			r->line++;
+		else if (ch != ' ' && ch != '\t' && ch != '\r')
+			return;
+		r->pos++;
 	}
 }
 
-static inline void item_data_addref(struct obs_data_item *item)
+static inline void json_str_clear(struct dstr *str)
 {
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_obj(item);
-		obs_data_addref(obj);
+	str->len = 0;
+	if (str->array)
+		*str->array = 0;
+}
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_array(item);
-		obs_data_array_addref(array);
+/* returns the length of the UTF-8 sequence at str, or 0 if it's invalid */
+static size_t json_utf8_len(const unsigned char *str)
+{
+	uint32_t cp;
+	size_t len;
+
+	if (str[0] < 0x80)
+		return 1;
+	else if (str[0] >= 0xC2 && str[0] <= 0xDF)
+		len = 2, cp = str[0] & 0x1F;
+	else if ((str[0] & 0xF0) == 0xE0)
+		len = 3, cp = str[0] & 0x0F;
+	else if (str[0] >= 0xF0 && str[0] <= 0xF4)
+		len = 4, cp = str[0] & 0x07;
+	else
+		return 0;
+
+	for (size_t i = 1; i < len; i++) {
+		if ((str[i] & 0xC0) != 0x80)
+			return 0;
+		cp = (cp << 6) | (str[i] & 0x3F);
 	}
+
+	if ((len == 3 && cp < 0x800) || (len == 4 && cp < 0x10000) || cp > 0x10FFFF || (cp >= 0xD800 && cp <= 0xDFFF))
+		return 0;
+	return len;
+}
+
+static void json_cat_utf8(struct dstr *str, uint32_t cp)
+{
+	char buf[4];
+	size_t len;
+
+	if (cp < 0x80) {
+		buf[0] = (char)cp;
+		len = 1;
+	} else if (cp < 0x800) {
+		buf[0] = (char)(0xC0 | (cp >> 6));
+		buf[1] = (char)(0x80 | (cp & 0x3F));
+		len = 2;
+	} else if (cp < 0x10000) {
+		buf[0] = (char)(0xE0 | (cp >> 12));
+		buf[1] = (char)(0x80 | ((cp >> 6) & 0x3F));
+		buf[2] = (char)(0x80 | (cp & 0x3F));
+		len = 3;
+	} else {
+		buf[0] = (char)(0xF0 | (cp >> 18));
+		buf[1] = (char)(0x80 | ((cp >> 12) & 0x3F));
+		buf[2] = (char)(0x80 | ((cp >> 6) & 0x3F));
+		buf[3] = (char)(0x80 | (cp & 0x3F));
+		len = 4;
+	}
+
+	dstr_ncat(str, buf, len);
 }
 
-static inline void item_default_data_addref(struct obs_data_item *item)
+static bool json_read_hex4(struct json_reader *r, uint32_t *val)
 {
-	if (!item->data_size)
-		return;
+	*val = 0;
 
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_default_obj(item);
-		obs_data_addref(obj);
+	for (int i = 0; i < 4; i++) {
+		char ch = *r->pos++;
+		*val <<= 4;
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_default_array(item);
-		obs_data_array_addref(array);
+		if (json_is_digit(ch))
+			*val |= (uint32_t)(ch - '0');
+		else if (ch >= 'a' && ch <= 'f')
+			*val |= (uint32_t)(ch - 'a' + 10);
+		else if (ch >= 'A' && ch <= 'F')
+			*val |= (uint32_t)(ch - 'A' + 10);
+		else
+			return json_error(r, "invalid escape");
 	}
+
+	return true;
 }
 
-static inline void item_autoselect_data_addref(struct obs_data_item *item)
+static bool json_read_escape(struct json_reader *r, struct dstr *str)
 {
-	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t *obj = get_item_autoselect_obj(item);
-		obs_data_addref(obj);
+	uint32_t cp, low;
+	char ch = *r->pos++;
 
-	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t *array = get_item_autoselect_array(item);
-		obs_data_array_addref(array);
+	switch (ch) {
+	case '"':
+	case '\\':
+	case '/':
+		dstr_cat_ch(str, ch);
+		return true;
+	case 'b':
+		dstr_cat_ch(str, '\b');
+		return true;
+	case 'f':
+		dstr_cat_ch(str, '\f');
+		return true;
+	case 'n':
+		dstr_cat_ch(str, '\n');
+		return true;
+	case 'r':
+		dstr_cat_ch(str, '\r');
+		return true;
+	case 't':
+		dstr_cat_ch(str, '\t');
+		return true;
+	case 'u':
+		break;
+	default:
+		return json_error(r, "invalid escape");
+	}
+
+	if (!json_read_hex4(r, &cp))
+		return false;
+
+	if (cp >= 0xD800 && cp <= 0xDBFF) {
+		if (r->pos[0] != '\\' || r->pos[1] != 'u')
+			return json_error(r, "invalid Unicode '\\u%04X'", cp);
+
+		r->pos += 2;
+		if (!json_read_hex4(r, &low))
+			return false;
+		if (low < 0xDC00 || low > 0xDFFF)
+			return json_error(r, "invalid Unicode '\\u%04X\\u%04X'", cp, low);
+
+		cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+
+	} else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+		return json_error(r, "invalid Unicode '\\u%04X'", cp);
+
+	} else if (cp == 0) {
+		return json_error(r, "\\u0000 is not allowed");
 	}
+
+	json_cat_utf8(str, cp);
+	return true;
 }
 
-static struct obs_data_item *obs_data_item_create(const char *name, const void *data, size_t size,
-						  enum obs_data_type type, bool default_data, bool autoselect_data)
+/* unescapes the string at the current position into str */
+static bool json_read_string(struct json_reader *r, struct dstr *str)
 {
-	struct obs_data_item *item;
-	size_t name_size, total_size;
+	const char *run;
 
-	if (!name || !data)
-		return NULL;
+	json_str_clear(str);
+	run = ++r->pos;
 
-	name_size = get_name_align_size(name);
-	total_size = name_size + sizeof(struct obs_data_item) + size;
+	for (;;) {
+		unsigned char ch = (unsigned char)*r->pos;
 
-	item = bzalloc(total_size);
+		if (ch == '"' || ch == '\\') {
+			dstr_ncat(str, run, r->pos - run);
+			r->pos++;
 
-	item->capacity = total_size;
-	item->type = type;
-	item->name_len = name_size;
-	item->ref = 1;
+			if (ch == '"')
+				return true;
+			if (!json_read_escape(r, str))
+				return false;
 
-	if (default_data) {
-		item->default_len = size;
-		item->default_size = size;
+			run = r->pos;
 
-	} else if (autoselect_data) {
-		item->autoselect_size = size;
+		} else if (ch == 0) {
+			return json_error(r, "premature end of input");
 
+		} else if (ch < 0x20) {
+			return json_error(r, "control character 0x%x", ch);
+
+		} else {
+			size_t len = json_utf8_len((const unsigned char *)r->pos);
+			if (!len)
+				return json_error(r, "unable to decode byte 0x%x", ch);
+			r->pos += len;
+		}
+	}
+}
+
+static bool json_read_number(struct json_reader *r, struct obs_data_number *num)
+{
+	const char *start = r->pos;
+	const char *p = start;
+	bool real = false;
+
+	if (*p == '-')
+		p++;
+
+	if (*p == '0') {
+		p++;
+		if (json_is_digit(*p))
+			return json_error(r, "invalid token");
+	} else if (json_is_digit(*p)) {
+		while (json_is_digit(*p))
+			p++;
 	} else {
-		item->data_len = size;
-		item->data_size = size;
+		return json_error(r, "invalid token");
 	}
 
-	char *name_ptr = get_item_name(item);
-	item->name = name_ptr;
+	if (*p == '.') {
+		p++;
+		if (!json_is_digit(*p))
+			return json_error(r, "invalid token");
+		while (json_is_digit(*p))
+			p++;
+		real = true;
+	}
 
-	strcpy(name_ptr, name);
-	memcpy(get_item_data(item), data, size);
+	if (*p == 'e' || *p == 'E') {
+		p++;
+		if (*p == '+' || *p == '-')
+			p++;
+		if (!json_is_digit(*p))
+			return json_error(r, "invalid token");
+		while (json_is_digit(*p))
+			p++;
+		real = true;
+	}
 
-	item_data_addref(item);
-	return item;
+	r->pos = p;
+	errno = 0;
+
+	if (!real) {
+		num->type = OBS_DATA_NUM_INT;
+		num->int_val = strtoll(start, NULL, 10);
+		if (errno == ERANGE)
+			return json_error(r, "too big integer");
+		return true;
+	}
+
+	json_str_clear(&r->str);
+	dstr_ncat(&r->str, start, p - start);
+
+	num->type = OBS_DATA_NUM_DOUBLE;
+	num->double_val = os_strtod(r->str.array);
+	if (errno == ERANGE && (num->double_val == HUGE_VAL || num->double_val == -HUGE_VAL))
+		return json_error(r, "real number overflow");
+	return true;
 }
 
-static inline void obs_data_item_detach(struct obs_data_item *item)
+static bool json_read_literal(struct json_reader *r, const char *literal)
 {
-	if (item->parent) {
-		HASH_DEL(item->parent->items, item);
-		item->parent = NULL;
+	size_t len = strlen(literal);
+
+	if (strncmp(r->pos, literal, len) != 0)
+		return json_error(r, "invalid token");
+
+	r->pos += len;
+	return true;
+}
+
+static bool json_read_object(struct json_reader *r, obs_data_t *data);
+static bool json_read_array(struct json_reader *r, obs_data_array_t *array);
+
+/* reads the value at the current position and sets it as key of data.
+ * without data the value is only validated (array items that aren't
+ * objects can't be represented) */
+static bool json_read_value(struct json_reader *r, obs_data_t *data, const char *key, obs_data_array_t *parent_array)
+{
+	obs_data_item_t *item = NULL;
+	struct obs_data_number num;
+	obs_data_t *obj;
+	obs_data_array_t *array;
+	bool val;
+	bool success;
+
+	switch (*r->pos) {
+	case '{':
+		obj = obs_data_create();
+		if (data)
+			set_item(data, &item, key, &obj, sizeof(obs_data_t *), OBS_DATA_OBJECT);
+		else if (parent_array)
+			obs_data_array_push_back(parent_array, obj);
+
+		success = json_read_object(r, obj);
+		obs_data_release(obj);
+		return success;
+
+	case '[':
+		array = obs_data_array_create();
+		if (data)
+			set_item(data, &item, key, &array, sizeof(obs_data_array_t *), OBS_DATA_ARRAY);
+
+		success = json_read_array(r, array);
+		obs_data_array_release(array);
+		return success;
+
+	case '"':
+		if (!json_read_string(r, &r->str))
+			return false;
+		if (data)
+			set_item(data, &item, key, r->str.array ? r->str.array : "", r->str.len + 1, OBS_DATA_STRING);
+		return true;
+
+	case 't':
+	case 'f':
+		val = *r->pos == 't';
+		if (!json_read_literal(r, val ? "true" : "false"))
+			return false;
+		if (data)
+			set_item(data, &item, key, &val, sizeof(bool), OBS_DATA_BOOLEAN);
+		return true;
+
+	case 'n':
+		obj = NULL;
+		if (!json_read_literal(r, "null"))
+			return false;
+		if (data)
+			set_item(data, &item, key, &obj, sizeof(obs_data_t *), OBS_DATA_OBJECT);
+		return true;
+
+	default:
+		if (!json_read_number(r, &num))
+			return false;
+		if (data)
+			set_item(data, &item, key, &num, sizeof(struct obs_data_number), OBS_DATA_NUMBER);
+		return true;
 	}
 }
 
-static inline void obs_data_item_reattach(struct obs_data *parent, struct obs_data_item *item)
+static bool json_read_object(struct json_reader *r, obs_data_t *data)
 {
-	if (parent) {
-		HASH_ADD_STR(parent->items, name, item);
-		item->parent = parent;
+	if (++r->depth > JSON_MAX_DEPTH)
+		return json_error(r, "maximum parsing depth reached");
+
+	r->pos++;
+	json_skip_whitespace(r);
+
+	if (*r->pos == '}') {
+		r->pos++;
+		r->depth--;
+		return true;
+	}
+
+	for (;;) {
+		if (*r->pos != '"')
+			return json_error(r, "string or '}' expected");
+		if (!json_read_string(r, &r->key))
+			return false;
+
+		const char *key = r->key.array ? r->key.array : "";
+		if (get_item(data, key))
+			return json_error(r, "duplicate object key");
+
+		json_skip_whitespace(r);
+		if (*r->pos != ':')
+			return json_error(r, "':' expected");
+
+		r->pos++;
+		json_skip_whitespace(r);
+
+		/* the key buffer is reused by nested objects, so containers
+		 * are added to data before they're filled */
+		if (!json_read_value(r, data, key, NULL))
+			return false;
+
+		json_skip_whitespace(r);
+		if (*r->pos == '}')
+			break;
+		if (*r->pos != ',')
+			return json_error(r, "'}' expected");
+
+		r->pos++;
+		json_skip_whitespace(r);
 	}
+
+	r->pos++;
+	r->depth--;
+	return true;
 }
 
-static struct obs_data_item *obs_data_item_ensure_capacity(struct obs_data_item *item)
+static bool json_read_array(struct json_reader *r, obs_data_array_t *array)
 {
-	size_t new_size = obs_data_item_total_size(item);
-	struct obs_data_item *new_item;
+	if (++r->depth > JSON_MAX_DEPTH)
+		return json_error(r, "maximum parsing depth reached");
 
-	if (item->capacity >= new_size)
-		return item;
+	r->pos++;
+	json_skip_whitespace(r);
 
-	struct obs_data *parent = item->parent;
-	obs_data_item_detach(item);
+	if (*r->pos == ']') {
+		r->pos++;
+		r->depth--;
+		return true;
+	}
+
+	for (;;) {
+		if (!json_read_value(r, NULL, NULL, array))
+			return false;
 
-	new_item = brealloc(item, new_size);
-	new_item->capacity = new_size;
-	new_item->name = get_item_name(new_item);
+		json_skip_whitespace(r);
+		if (*r->pos == ']')
+			break;
+		if (*r->pos != ',')
+			return json_error(r, "']' expected");
 
-	obs_data_item_reattach(parent, new_item);
+		r->pos++;
+		json_skip_whitespace(r);
+	}
 
-	return new_item;
+	r->pos++;
+	r->depth--;
+	return true;
 }
 
-static inline void obs_data_item_destroy(struct obs_data_item *item)
+static bool json_read_root(struct json_reader *r, obs_data_t *data)
 {
-	if (item->parent)
-		HASH_DEL(item->parent->items, item);
+	json_skip_whitespace(r);
 
-	item_data_release(item);
-	item_default_data_release(item);
-	item_autoselect_data_release(item);
-	obs_data_item_detach(item);
-	bfree(item);
+	if (*r->pos == '{') {
+		if (!json_read_object(r, data))
+			return false;
+
+	} else if (*r->pos == '[') {
+		/* valid json, but there's nothing to add to the object */
+		obs_data_array_t *array = obs_data_array_create();
+		bool success = json_read_array(r, array);
+		obs_data_array_release(array);
+		if (!success)
+			return false;
+
+	} else {
+		return json_error(r, "'[' or '{' expected");
+	}
+
+	json_skip_whitespace(r);
+	if (*r->pos)
+		return json_error(r, "end of file expected");
+
+	return true;
 }
 
-static inline void move_data(obs_data_item_t *old_item, void *old_data, obs_data_item_t *item, void *data, size_t len)
+/* ------------------------------------------------------------------------- */
+/* JSON writer, same output as jansson with JSON_PRESERVE_ORDER */
+
+struct json_writer {
+	struct dstr out;
+	bool pretty;
+	bool with_defaults;
+};
+
+static inline void json_truncate(struct dstr *out, size_t len)
 {
-	ptrdiff_t old_offset = (uint8_t *)old_data - (uint8_t *)old_item;
-	ptrdiff_t new_offset = (uint8_t *)data - (uint8_t *)item;
+	out->len = len;
+	if (out->array)
+		out->array[len] = 0;
+}
 
-	if (!old_data)
+static inline void json_write_indent(struct json_writer *w, int depth)
+{
+	if (!w->pretty)
 		return;
 
-	memmove((uint8_t *)item + new_offset, (uint8_t *)item + old_offset, len);
+	dstr_ensure_capacity(&w->out, w->out.len + (size_t)depth * 4 + 2);
+	w->out.array[w->out.len++] = '\n';
+	for (int i = 0; i < depth * 4; i++)
+		w->out.array[w->out.len++] = ' ';
+	w->out.array[w->out.len] = 0;
 }
 
-static inline void obs_data_item_setdata(struct obs_data_item **p_item, const void *data, size_t size,
-					 enum obs_data_type type)
+/* strings that aren't valid UTF-8 are rejected, like jansson does */
+static bool json_write_string(struct json_writer *w, const char *str)
 {
-	if (!p_item || !*p_item)
-		return;
+	const char *run = str;
+	const char *p = str;
 
-	struct obs_data_item *item = *p_item;
-	ptrdiff_t old_default_data_pos = (uint8_t *)get_default_data_ptr(item) - (uint8_t *)item;
-	item_data_release(item);
+	dstr_cat_ch(&w->out, '"');
 
-	item->data_size = size;
-	item->type = type;
-	item->data_len = (item->default_size || item->autoselect_size) ? get_align_size(size) : size;
-	item = obs_data_item_ensure_capacity(item);
+	for (;;) {
+		unsigned char ch = (unsigned char)*p;
+		const char *seq = NULL;
 
-	if (item->default_size || item->autoselect_size)
-		memmove(get_default_data_ptr(item), (uint8_t *)item + old_default_data_pos,
-			item->default_len + item->autoselect_size);
+		if (ch == 0)
+			break;
 
-	if (size) {
-		memcpy(get_item_data(item), data, size);
-		item_data_addref(item);
+		if (ch >= 0x80) {
+			size_t len = json_utf8_len((const unsigned char *)p);
+			if (!len)
+				return false;
+			p += len;
+			continue;
+		}
+
+		if (ch == '"')
+			seq = "\\\"";
+		else if (ch == '\\')
+			seq = "\\\\";
+		else if (ch == '\b')
+			seq = "\\b";
+		else if (ch == '\f')
+			seq = "\\f";
+		else if (ch == '\n')
+			seq = "\\n";
+		else if (ch == '\r')
+			seq = "\\r";
+		else if (ch == '\t')
+			seq = "\\t";
+
+		if (!seq && ch >= 0x20) {
+			p++;
+			continue;
+		}
+
+		dstr_ncat(&w->out, run, p - run);
+		if (seq)
+			dstr_cat(&w->out, seq);
+		else
+			dstr_catf(&w->out, "\\u%04X", ch);
+		run = ++p;
 	}
 
-	*p_item = item;
+	dstr_ncat(&w->out, run, p - run);
+	dstr_cat_ch(&w->out, '"');
+	return true;
 }
 
-static inline void obs_data_item_set_default_data(struct obs_data_item **p_item, const void *data, size_t size,
-						  enum obs_data_type type)
+static bool json_write_double(struct json_writer *w, double val)
 {
-	if (!p_item || !*p_item)
-		return;
+	char buf[64];
+	int len;
 
-	struct obs_data_item *item = *p_item;
-	void *old_autoselect_data = get_autoselect_data_ptr(item);
-	item_default_data_release(item);
+	if (!isfinite(val))
+		return false;
 
-	item->type = type;
-	item->default_size = size;
-	item->default_len = item->autoselect_size ? get_align_size(size) : size;
-	item->data_len = item->data_size ? get_align_size(item->data_size) : 0;
-	item = obs_data_item_ensure_capacity(item);
+	len = os_dtostr(val, buf, sizeof(buf));
+	if (len < 0)
+		return false;
+
+	dstr_ncat(&w->out, buf, (size_t)len);
+	return true;
+}
+
+static void json_write_int(struct json_writer *w, long long val)
+{
+	char buf[24];
+	char *p = buf + sizeof(buf);
+	unsigned long long uval = val < 0 ? 0ULL - (unsigned long long)val : (unsigned long long)val;
+
+	do {
+		*--p = (char)('0' + uval % 10);
+		uval /= 10;
+	} while (uval);
+
+	if (val < 0)
+		*--p = '-';
+
+	dstr_ncat(&w->out, p, buf + sizeof(buf) - p);
+}
 
-	if (item->autoselect_size)
-		move_data(*p_item, old_autoselect_data, item, get_autoselect_data_ptr(item), item->autoselect_size);
+static void json_write_object(struct json_writer *w, obs_data_t *data, int depth);
 
-	if (size) {
-		memcpy(get_item_default_data(item), data, size);
-		item_default_data_addref(item);
+static bool json_write_item(struct json_writer *w, obs_data_item_t *item, int depth)
+{
+	obs_data_array_t *array;
+
+	switch (item->type) {
+	case OBS_DATA_STRING:
+		return json_write_string(w, obs_data_item_get_string(item));
+
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			json_write_int(w, obs_data_item_get_int(item));
+			return true;
+		}
+		return json_write_double(w, obs_data_item_get_double(item));
+
+	case OBS_DATA_BOOLEAN:
+		dstr_cat(&w->out, obs_data_item_get_bool(item) ? "true" : "false");
+		return true;
+
+	case OBS_DATA_OBJECT:
+		json_write_object(w, get_item_obj(item), depth);
+		return true;
+
+	case OBS_DATA_ARRAY:
+		array = get_item_array(item);
+		if (!array || !array->objects.num) {
+			dstr_cat(&w->out, "[]");
+			return true;
+		}
+
+		dstr_cat_ch(&w->out, '[');
+		for (size_t i = 0; i < array->objects.num; i++) {
+			if (i)
+				dstr_cat_ch(&w->out, ',');
+			json_write_indent(w, depth + 1);
+			json_write_object(w, array->objects.array[i], depth + 1);
+		}
+		json_write_indent(w, depth);
+		dstr_cat_ch(&w->out, ']');
+		return true;
+
+	case OBS_DATA_NULL:
+		break;
 	}
 
-	*p_item = item;
+	return false;
 }
 
-static inline void obs_data_item_set_autoselect_data(struct obs_data_item **p_item, const void *data, size_t size,
-						     enum obs_data_type type)
+static void json_write_object(struct json_writer *w, obs_data_t *data, int depth)
 {
-	if (!p_item || !*p_item)
+	obs_data_item_t *item, *temp;
+	size_t count = 0;
+
+	if (!data) {
+		dstr_cat(&w->out, "null");
 		return;
+	}
 
-	struct obs_data_item *item = *p_item;
-	item_autoselect_data_release(item);
+	dstr_cat_ch(&w->out, '{');
 
-	item->autoselect_size = size;
-	item->type = type;
-	item->data_len = item->data_size ? get_align_size(item->data_size) : 0;
-	item->default_len = item->default_size ? get_align_size(item->default_size) : 0;
-	item = obs_data_item_ensure_capacity(item);
+	HASH_ITER (hh, data->items, item, temp) {
+		size_t start = w->out.len;
+
+		if (!w->with_defaults && !obs_data_item_has_user_value(item))
+			continue;
+
+		if (count)
+			dstr_cat_ch(&w->out, ',');
+		json_write_indent(w, depth + 1);
+
+		if (!json_write_string(w, get_item_name(item))) {
+			json_truncate(&w->out, start);
+			continue;
+		}
+
+		dstr_cat(&w->out, w->pretty ? ": " : ":");
+
+		/* items that can't be represented are left out */
+		if (!json_write_item(w, item, depth + 1)) {
+			json_truncate(&w->out, start);
+			continue;
+		}
 
-	if (size) {
-		memcpy(get_item_autoselect_data(item), data, size);
-		item_autoselect_data_addref(item);
+		count++;
 	}
 
-	*p_item = item;
+	if (count)
+		json_write_indent(w, depth);
+	dstr_cat_ch(&w->out, '}');
 }
 
 /* ------------------------------------------------------------------------- */
+/* Binary format
+ *
+ * Everything is little-endian.  The header is the magic, a version byte,
+ * three reserved bytes, then the total size, the number of keys and the
+ * offset of the key table as u32.  The root object follows the header, the
+ * key table comes last since keys are only known once everything has been
+ * written.
+ *
+ * An object is a u32 item count, then for every item a u32 index into the
+ * key table, a u8 value type and the value.  Integers are i64, doubles are
+ * f64, strings and keys are a u32 length followed by the bytes and a
+ * terminating zero so they can be used in place, arrays are a u32 count
+ * followed by that many objects.  Booleans and null have no payload. */
+
+#define BIN_MAGIC "\x89OBD"
+#define BIN_VERSION 1
+#define BIN_HEADER_SIZE 20
+
+enum bin_type {
+	BIN_NULL,
+	BIN_FALSE,
+	BIN_TRUE,
+	BIN_INT,
+	BIN_DOUBLE,
+	BIN_STRING,
+	BIN_OBJECT,
+	BIN_ARRAY,
+};
+
+static inline void bin_put_u32(uint8_t *p, uint32_t val)
+{
+	p[0] = (uint8_t)val;
+	p[1] = (uint8_t)(val >> 8);
+	p[2] = (uint8_t)(val >> 16);
+	p[3] = (uint8_t)(val >> 24);
+}
+
+static inline uint32_t bin_get_u32(const uint8_t *p)
+{
+	return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+}
+
+static inline uint64_t bin_get_u64(const uint8_t *p)
+{
+	return (uint64_t)bin_get_u32(p) | ((uint64_t)bin_get_u32(p + 4) << 32);
+}
+
+/* 0x89 can't start a JSON document or UTF-8 text.  compared byte by byte so
+ * a shorter string is never read past its end */
+static inline bool is_binary(const char *str)
+{
+	return str[0] == BIN_MAGIC[0] && str[1] == BIN_MAGIC[1] && str[2] == BIN_MAGIC[2] && str[3] == BIN_MAGIC[3];
+}
+
+struct bin_key {
+	const char *name;
+	uint32_t index;
+	UT_hash_handle hh;
+};
+
+struct bin_writer {
+	DARRAY(uint8_t) out;
+	struct bin_key *keys;
+	uint32_t key_count;
+};
+
+static inline void bin_write_u8(struct bin_writer *w, uint8_t val)
+{
+	da_push_back(w->out, &val);
+}
+
+static inline void bin_write_u32(struct bin_writer *w, uint32_t val)
+{
+	uint8_t buf[4];
+	bin_put_u32(buf, val);
+	da_push_back_array(w->out, buf, sizeof(buf));
+}
+
+static inline void bin_write_u64(struct bin_writer *w, uint64_t val)
+{
+	uint8_t buf[8];
+	bin_put_u32(buf, (uint32_t)val);
+	bin_put_u32(buf + 4, (uint32_t)(val >> 32));
+	da_push_back_array(w->out, buf, sizeof(buf));
+}
 
-static void obs_data_add_json_item(obs_data_t *data, const char *key, json_t *json);
+static inline void bin_write_string(struct bin_writer *w, const char *str)
+{
+	size_t len = strlen(str);
+	bin_write_u32(w, (uint32_t)len);
+	da_push_back_array(w->out, (const uint8_t *)str, len + 1);
+}
 
-static inline void obs_data_add_json_object_data(obs_data_t *data, json_t *jobj)
+/* each key is stored once, items refer to it by index */
+static void bin_write_key(struct bin_writer *w, const char *name)
 {
-	const char *item_key;
-	json_t *jitem;
+	struct bin_key *key;
 
-	json_object_foreach (jobj, item_key, jitem) {
-		obs_data_add_json_item(data, item_key, jitem);
+	HASH_FIND_STR(w->keys, name, key);
+	if (!key) {
+		key = bmalloc(sizeof(*key));
+		key->name = name;
+		key->index = w->key_count++;
+		HASH_ADD_STR(w->keys, name, key);
 	}
+
+	bin_write_u32(w, key->index);
 }
 
-static inline void obs_data_add_json_object(obs_data_t *data, const char *key, json_t *jobj)
+static void bin_write_object(struct bin_writer *w, obs_data_t *data);
+
+static void bin_write_item(struct bin_writer *w, obs_data_item_t *item)
 {
-	obs_data_t *sub_obj = obs_data_create();
+	obs_data_array_t *array;
+	obs_data_t *obj;
+	double val;
+	uint64_t bits;
 
-	obs_data_add_json_object_data(sub_obj, jobj);
-	obs_data_set_obj(data, key, sub_obj);
-	obs_data_release(sub_obj);
+	switch (item->type) {
+	case OBS_DATA_STRING:
+		bin_write_u8(w, BIN_STRING);
+		bin_write_string(w, obs_data_item_get_string(item));
+		break;
+
+	case OBS_DATA_NUMBER:
+		if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT) {
+			bin_write_u8(w, BIN_INT);
+			bin_write_u64(w, (uint64_t)obs_data_item_get_int(item));
+		} else {
+			val = obs_data_item_get_double(item);
+			memcpy(&bits, &val, sizeof(bits));
+			bin_write_u8(w, BIN_DOUBLE);
+			bin_write_u64(w, bits);
+		}
+		break;
+
+	case OBS_DATA_BOOLEAN:
+		bin_write_u8(w, obs_data_item_get_bool(item) ? BIN_TRUE : BIN_FALSE);
+		break;
+
+	case OBS_DATA_OBJECT:
+		obj = get_item_obj(item);
+		bin_write_u8(w, obj ? BIN_OBJECT : BIN_NULL);
+		if (obj)
+			bin_write_object(w, obj);
+		break;
+
+	case OBS_DATA_ARRAY:
+		array = get_item_array(item);
+		bin_write_u8(w, BIN_ARRAY);
+		bin_write_u32(w, array ? (uint32_t)array->objects.num : 0);
+		for (size_t i = 0; array && i < array->objects.num; i++)
+			bin_write_object(w, array->objects.array[i]);
+		break;
+
+	case OBS_DATA_NULL:
+		break;
+	}
 }
 
-static void obs_data_add_json_array(obs_data_t *data, const char *key, json_t *jarray)
+static void bin_write_object(struct bin_writer *w, obs_data_t *data)
 {
-	obs_data_array_t *array = obs_data_array_create();
-	size_t idx;
-	json_t *jitem;
+	obs_data_item_t *item, *temp;
+	size_t count_pos = w->out.num;
+	uint32_t count = 0;
 
-	json_array_foreach (jarray, idx, jitem) {
-		obs_data_t *item;
+	/* the count is filled in afterwards, items without a user value are
+	 * left out like they are in the JSON */
+	bin_write_u32(w, 0);
 
-		if (!json_is_object(jitem))
+	HASH_ITER (hh, data->items, item, temp) {
+		if (item->type == OBS_DATA_NULL || !obs_data_item_has_user_value(item))
 			continue;
 
-		item = obs_data_create();
-		obs_data_add_json_object_data(item, jitem);
-		obs_data_array_push_back(array, item);
-		obs_data_release(item);
+		bin_write_key(w, get_item_name(item));
+		bin_write_item(w, item);
+		count++;
 	}
 
-	obs_data_set_array(data, key, array);
-	obs_data_array_release(array);
+	bin_put_u32(w->out.array + count_pos, count);
 }
 
-static inline void obs_data_add_json_null(obs_data_t *data, const char *key)
+struct bin_reader {
+	const uint8_t *pos;
+	const uint8_t *end;
+	const char **keys;
+	uint32_t key_count;
+	int depth;
+	const char *error;
+};
+
+static inline bool bin_error(struct bin_reader *r, const char *error)
 {
-	obs_data_set_obj(data, key, NULL);
+	r->error = error;
+	return false;
 }
 
-static void obs_data_add_json_item(obs_data_t *data, const char *key, json_t *json)
+static inline bool bin_read_u8(struct bin_reader *r, uint8_t *val)
 {
-	if (json_is_object(json))
-		obs_data_add_json_object(data, key, json);
-	else if (json_is_array(json))
-		obs_data_add_json_array(data, key, json);
-	else if (json_is_string(json))
-		obs_data_set_string(data, key, json_string_value(json));
-	else if (json_is_integer(json))
-		obs_data_set_int(data, key, json_integer_value(json));
-	else if (json_is_real(json))
-		obs_data_set_double(data, key, json_real_value(json));
-	else if (json_is_true(json))
-		obs_data_set_bool(data, key, true);
-	else if (json_is_false(json))
-		obs_data_set_bool(data, key, false);
-	else if (json_is_null(json))
-		obs_data_add_json_null(data, key);
-}
+	if (r->end - r->pos < 1)
+		return bin_error(r, "unexpected end of data");
 
-/* ------------------------------------------------------------------------- */
+	*val = *r->pos++;
+	return true;
+}
 
-static inline void set_json_string(json_t *json, const char *name, obs_data_item_t *item)
+static inline bool bin_read_u32(struct bin_reader *r, uint32_t *val)
 {
-	const char *val = obs_data_item_get_string(item);
-	json_object_set_new(json, name, json_string(val));
+	if (r->end - r->pos < 4)
+		return bin_error(r, "unexpected end of data");
+
+	*val = bin_get_u32(r->pos);
+	r->pos += 4;
+	return true;
 }
 
-static inline void set_json_number(json_t *json, const char *name, obs_data_item_t *item)
+static inline bool bin_read_u64(struct bin_reader *r, uint64_t *val)
 {
-	enum obs_data_number_type type = obs_data_item_numtype(item);
+	if (r->end - r->pos < 8)
+		return bin_error(r, "unexpected end of data");
 
-	if (type == OBS_DATA_NUM_INT) {
-		long long val = obs_data_item_get_int(item);
-		json_object_set_new(json, name, json_integer(val));
-	} else {
-		double val = obs_data_item_get_double(item);
-		json_object_set_new(json, name, json_real(val));
-	}
+	*val = bin_get_u64(r->pos);
+	r->pos += 8;
+	return true;
 }
 
-static inline void set_json_bool(json_t *json, const char *name, obs_data_item_t *item)
+/* strings point into the buffer, the terminator is checked so they can be
+ * used as they are */
+static bool bin_read_string(struct bin_reader *r, const char **str, size_t *len)
 {
-	bool val = obs_data_item_get_bool(item);
-	json_object_set_new(json, name, val ? json_true() : json_false());
+	uint32_t size;
+
+	if (!bin_read_u32(r, &size))
+		return false;
+	if ((size_t)(r->end - r->pos) <= size || r->pos[size] != 0)
+		return bin_error(r, "invalid string");
+
+	*str = (const char *)r->pos;
+	*len = size;
+	r->pos += (size_t)size + 1;
+	return true;
 }
 
-static json_t *obs_data_to_json(obs_data_t *data, bool with_defaults);
+static bool bin_read_object(struct bin_reader *r, obs_data_t *data);
 
-static inline void set_json_obj(json_t *json, const char *name, obs_data_item_t *item, bool with_defaults)
+static bool bin_read_array(struct bin_reader *r, obs_data_array_t *array)
 {
-	obs_data_t *obj = obs_data_item_get_obj(item);
-	json_object_set_new(json, name, obs_data_to_json(obj, with_defaults));
-	obs_data_release(obj);
+	uint32_t count;
+
+	if (!bin_read_u32(r, &count))
+		return false;
+
+	/* every object takes at least four bytes */
+	if (count > (size_t)(r->end - r->pos) / 4)
+		return bin_error(r, "invalid array size");
+
+	da_reserve(array->objects, count);
+
+	for (uint32_t i = 0; i < count; i++) {
+		obs_data_t *obj = obs_data_create();
+		bool success;
+
+		obs_data_array_push_back(array, obj);
+		success = bin_read_object(r, obj);
+		obs_data_release(obj);
+
+		if (!success)
+			return false;
+	}
+
+	return true;
 }
 
-static inline void set_json_array(json_t *json, const char *name, obs_data_item_t *item, bool with_defaults)
+static bool bin_read_value(struct bin_reader *r, obs_data_t *data, const char *key)
 {
-	json_t *jarray = json_array();
-	obs_data_array_t *array = obs_data_item_get_array(item);
-	size_t count = obs_data_array_count(array);
+	obs_data_item_t *item = NULL;
+	struct obs_data_number num;
+	obs_data_array_t *array;
+	obs_data_t *obj;
+	const char *str;
+	size_t len;
+	uint64_t bits;
+	uint8_t type;
+	bool val;
+	bool success;
+
+	if (!bin_read_u8(r, &type))
+		return false;
+
+	switch (type) {
+	case BIN_NULL:
+		obj = NULL;
+		set_item(data, &item, key, &obj, sizeof(obs_data_t *), OBS_DATA_OBJECT);
+		return true;
+
+	case BIN_FALSE:
+	case BIN_TRUE:
+		val = type == BIN_TRUE;
+		set_item(data, &item, key, &val, sizeof(bool), OBS_DATA_BOOLEAN);
+		return true;
+
+	case BIN_INT:
+	case BIN_DOUBLE:
+		if (!bin_read_u64(r, &bits))
+			return false;
+
+		if (type == BIN_INT) {
+			num.type = OBS_DATA_NUM_INT;
+			num.int_val = (long long)bits;
+		} else {
+			num.type = OBS_DATA_NUM_DOUBLE;
+			memcpy(&num.double_val, &bits, sizeof(bits));
+		}
+		set_item(data, &item, key, &num, sizeof(struct obs_data_number), OBS_DATA_NUMBER);
+		return true;
+
+	case BIN_STRING:
+		if (!bin_read_string(r, &str, &len))
+			return false;
+		set_item(data, &item, key, str, len + 1, OBS_DATA_STRING);
+		return true;
+
+	case BIN_OBJECT:
+		obj = obs_data_create();
+		set_item(data, &item, key, &obj, sizeof(obs_data_t *), OBS_DATA_OBJECT);
+		success = bin_read_object(r, obj);
+		obs_data_release(obj);
+		return success;
 
-	for (size_t idx = 0; idx < count; idx++) {
-		obs_data_t *sub_item = obs_data_array_item(array, idx);
-		json_t *jitem = obs_data_to_json(sub_item, with_defaults);
-		json_array_append_new(jarray, jitem);
-		obs_data_release(sub_item);
+	case BIN_ARRAY:
+		array = obs_data_array_create();
+		set_item(data, &item, key, &array, sizeof(obs_data_array_t *), OBS_DATA_ARRAY);
+		success = bin_read_array(r, array);
+		obs_data_array_release(array);
+		return success;
 	}
 
-	json_object_set_new(json, name, jarray);
-	obs_data_array_release(array);
+	return bin_error(r, "invalid value type");
 }
 
-static json_t *obs_data_to_json(obs_data_t *data, bool with_defaults)
+static bool bin_read_object(struct bin_reader *r, obs_data_t *data)
 {
-	if (!data)
-		return json_null();
+	uint32_t count;
 
-	json_t *json = json_object();
+	if (++r->depth > JSON_MAX_DEPTH)
+		return bin_error(r, "maximum parsing depth reached");
+	if (!bin_read_u32(r, &count))
+		return false;
 
-	obs_data_item_t *item = NULL;
-	obs_data_item_t *temp = NULL;
+	for (uint32_t i = 0; i < count; i++) {
+		uint32_t index;
+
+		if (!bin_read_u32(r, &index))
+			return false;
+		if (index >= r->key_count)
+			return bin_error(r, "invalid key index");
+		if (get_item(data, r->keys[index]))
+			return bin_error(r, "duplicate object key");
+		if (!bin_read_value(r, data, r->keys[index]))
+			return false;
+	}
 
-	HASH_ITER (hh, data->items, item, temp) {
-		enum obs_data_type type = obs_data_item_gettype(item);
-		const char *name = get_item_name(item);
+	r->depth--;
+	return true;
+}
 
-		if (!with_defaults && !obs_data_item_has_user_value(item))
-			continue;
+static bool bin_read_keys(struct bin_reader *r)
+{
+	/* every key takes at least five bytes */
+	if (r->key_count > (size_t)(r->end - r->pos) / 5)
+		return bin_error(r, "invalid key count");
 
-		if (type == OBS_DATA_STRING)
-			set_json_string(json, name, item);
-		else if (type == OBS_DATA_NUMBER)
-			set_json_number(json, name, item);
-		else if (type == OBS_DATA_BOOLEAN)
-			set_json_bool(json, name, item);
-		else if (type == OBS_DATA_OBJECT)
-			set_json_obj(json, name, item, with_defaults);
-		else if (type == OBS_DATA_ARRAY)
-			set_json_array(json, name, item, with_defaults);
+	r->keys = bmalloc(sizeof(const char *) * (r->key_count ? r->key_count : 1));
+
+	for (uint32_t i = 0; i < r->key_count; i++) {
+		size_t len;
+		if (!bin_read_string(r, &r->keys[i], &len))
+			return false;
 	}
 
-	return json;
+	if (r->pos != r->end)
+		return bin_error(r, "invalid key table");
+
+	return true;
+}
+
+static bool bin_read_root(struct bin_reader *r, obs_data_t *data, const uint8_t *buf, size_t size)
+{
+	uint32_t keys_offset;
+
+	if (size < BIN_HEADER_SIZE || memcmp(buf, BIN_MAGIC, 4) != 0)
+		return bin_error(r, "invalid header");
+	if (buf[4] != BIN_VERSION)
+		return bin_error(r, "unsupported version");
+	if (bin_get_u32(buf + 8) != size)
+		return bin_error(r, "size mismatch");
+
+	keys_offset = bin_get_u32(buf + 16);
+	if (keys_offset < BIN_HEADER_SIZE || keys_offset > size)
+		return bin_error(r, "invalid key table");
+
+	r->key_count = bin_get_u32(buf + 12);
+	r->pos = buf + keys_offset;
+	r->end = buf + size;
+	if (!bin_read_keys(r))
+		return false;
+
+	r->pos = buf + BIN_HEADER_SIZE;
+	r->end = buf + keys_offset;
+	if (!bin_read_object(r, data))
+		return false;
+
+	if (r->pos != r->end)
+		return bin_error(r, "end of object expected");
+
+	return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -606,32 +1419,63 @@ obs_data_t *obs_data_create()
 obs_data_t *obs_data_create_from_json(const char *json_string)
 {
 	obs_data_t *data = obs_data_create();
+	struct json_reader reader = {0};
+	bool success;
 
-	json_error_t error;
-	json_t *root = json_loads(json_string, JSON_REJECT_DUPLICATES, &error);
+	reader.pos = json_string ? json_string : "";
+	reader.line = 1;
 
-	if (root) {
-		obs_data_add_json_object_data(data, root);
-		json_decref(root);
-	} else {
+	success = json_read_root(&reader, data);
+	if (!success) {
 		blog(LOG_ERROR,
 		     "obs-data.c: [obs_data_create_from_json] "
 		     "Failed reading json string (%d): %s",
-		     error.line, error.text);
+		     reader.line, reader.error);
+		obs_data_release(data);
+		data = NULL;
+	}
+
+	dstr_free(&reader.key);
+	dstr_free(&reader.str);
+	return data;
+}
+
+obs_data_t *obs_data_create_from_binary(const void *buf, size_t size)
+{
+	obs_data_t *data = obs_data_create();
+	struct bin_reader reader = {0};
+
+	if (!buf || !bin_read_root(&reader, data, buf, size)) {
+		blog(LOG_ERROR,
+		     "obs-data.c: [obs_data_create_from_binary] "
+		     "Failed reading binary data: %s",
+		     reader.error ? reader.error : "no data");
 		obs_data_release(data);
 		data = NULL;
 	}
 
+	bfree(reader.keys);
 	return data;
 }
 
 obs_data_t *obs_data_create_from_json_file(const char *json_file)
 {
-	char *file_data = os_quick_read_utf8_file(json_file);
+	FILE *file = os_fopen(json_file, "rb");
+	char *file_data = NULL;
 	obs_data_t *data = NULL;
+	size_t size;
+
+	if (!file)
+		return NULL;
+
+	size = os_fread_utf8(file, &file_data);
+	fclose(file);
 
 	if (file_data) {
-		data = obs_data_create_from_json(file_data);
+		if (is_binary(file_data))
+			data = obs_data_create_from_binary(file_data, size);
+		else
+			data = obs_data_create_from_json(file_data);
 		bfree(file_data);
 	}
 
@@ -682,8 +1526,7 @@ static inline void obs_data_destroy(struct obs_data *data)
 		obs_data_item_release(&item);
 	}
 
-	/* NOTE: don't use bfree for json text, allocated by json */
-	free(data->json);
+	bfree(data->json);
 	bfree(data);
 }
 
@@ -701,21 +1544,18 @@ static const char *obs_data_get_json_internal(obs_data_t *data, bool pretty, boo
 	if (!data)
 		return NULL;
 
-	size_t flags = JSON_PRESERVE_ORDER;
+	struct json_writer writer = {0};
+	writer.pretty = pretty;
+	writer.with_defaults = with_defaults;
 
-	if (pretty)
-		flags |= JSON_INDENT(4);
-	else
-		flags |= JSON_COMPACT;
+	/* the previous text is a good estimate for the size of this one */
+	if (data->json)
+		dstr_ensure_capacity(&writer.out, strlen(data->json) + 1);
 
-	/* NOTE: don't use libobs bfree for json text */
-	free(data->json);
-	data->json = NULL;
-
-	json_t *root = obs_data_to_json(data, with_defaults);
-	data->json = json_dumps(root, flags);
-	json_decref(root);
+	json_write_object(&writer, data, 0);
 
+	bfree(data->json);
+	data->json = writer.out.array;
 	return data->json;
 }
 
@@ -777,6 +1617,72 @@ bool obs_data_save_json_pretty_safe(obs_data_t *data, const char *file, const ch
 	return false;
 }
 
+uint8_t *obs_data_get_binary(obs_data_t *data, size_t *size)
+{
+	struct bin_writer writer = {0};
+	struct bin_key *key, *temp;
+	uint8_t header[BIN_HEADER_SIZE] = {0};
+	size_t keys_offset;
+
+	*size = 0;
+	if (!data)
+		return NULL;
+
+	da_push_back_array(writer.out, header, sizeof(header));
+	bin_write_object(&writer, data);
+
+	keys_offset = writer.out.num;
+	HASH_ITER (hh, writer.keys, key, temp) {
+		bin_write_string(&writer, key->name);
+		HASH_DEL(writer.keys, key);
+		bfree(key);
+	}
+
+	if (writer.out.num > UINT32_MAX) {
+		blog(LOG_ERROR, "obs-data.c: [obs_data_get_binary] "
+				"Data too large");
+		da_free(writer.out);
+		return NULL;
+	}
+
+	memcpy(writer.out.array, BIN_MAGIC, 4);
+	writer.out.array[4] = BIN_VERSION;
+	bin_put_u32(writer.out.array + 8, (uint32_t)writer.out.num);
+	bin_put_u32(writer.out.array + 12, writer.key_count);
+	bin_put_u32(writer.out.array + 16, (uint32_t)keys_offset);
+
+	*size = writer.out.num;
+	return writer.out.array;
+}
+
+bool obs_data_save_binary(obs_data_t *data, const char *file)
+{
+	size_t size;
+	uint8_t *bin = obs_data_get_binary(data, &size);
+	bool success = false;
+
+	if (bin) {
+		success = os_quick_write_utf8_file(file, (const char *)bin, size, false);
+		bfree(bin);
+	}
+
+	return success;
+}
+
+bool obs_data_save_binary_safe(obs_data_t *data, const char *file, const char *temp_ext, const char *backup_ext)
+{
+	size_t size;
+	uint8_t *bin = obs_data_get_binary(data, &size);
+	bool success = false;
+
+	if (bin) {
+		success = os_quick_write_utf8_file_safe(file, (const char *)bin, size, false, temp_ext, backup_ext);
+		bfree(bin);
+	}
+
+	return success;
+}
+
 static void get_defaults_array_cb(obs_data_t *data, void *vp)
 {
 	obs_data_array_t *defs = (obs_data_array_t *)vp;
@@ -981,20 +1887,20 @@ static inline void copy_item(struct obs_data *data, struct obs_data_item *item)
 	void *ptr = get_item_data(item);
 
 	if (item->type == OBS_DATA_OBJECT) {
-		obs_data_t **obj = item->data_size ? ptr : NULL;
+		obs_data_t **obj = item->user_val.size ? ptr : NULL;
 
 		if (obj)
 			copy_obj(data, name, *obj, obs_data_set_obj);
 
 	} else if (item->type == OBS_DATA_ARRAY) {
-		obs_data_array_t **array = item->data_size ? ptr : NULL;
+		obs_data_array_t **array = item->user_val.size ? ptr : NULL;
 
 		if (array)
 			copy_array(data, name, *array, obs_data_set_array);
 
 	} else {
-		if (item->data_size)
-			set_item(data, NULL, name, ptr, item->data_size, item->type);
+		if (item->user_val.size)
+			set_item(data, NULL, name, ptr, item->user_val.size, item->type);
 	}
 }
 
@@ -1022,30 +1928,8 @@ void obs_data_erase(obs_data_t *data, const char *name)
 
 static inline void clear_item(struct obs_data_item *item)
 {
-	void *ptr = get_item_data(item);
-	size_t size;
-
-	if (item->data_len) {
-		if (item->type == OBS_DATA_OBJECT) {
-			obs_data_t **obj = item->data_size ? ptr : NULL;
-
-			if (obj && *obj)
-				obs_data_release(*obj);
-
-		} else if (item->type == OBS_DATA_ARRAY) {
-			obs_data_array_t **array = item->data_size ? ptr : NULL;
-
-			if (array && *array)
-				obs_data_array_release(*array);
-		}
-
-		size = item->default_len + item->autoselect_size;
-		if (size)
-			memmove(ptr, (uint8_t *)ptr + item->data_len, size);
-
-		item->data_size = 0;
-		item->data_len = 0;
-	}
+	value_release(item, &item->user_val);
+	item->user_val.size = 0;
 }
 
 void obs_data_clear(obs_data_t *target)
@@ -1411,17 +2295,17 @@ bool obs_data_has_autoselect_value(obs_data_t *data, const char *name)
 
 bool obs_data_item_has_user_value(obs_data_item_t *item)
 {
-	return item && item->data_size;
+	return item && item->user_val.size;
 }
 
 bool obs_data_item_has_default_value(obs_data_item_t *item)
 {
-	return item && item->default_size;
+	return item && item->default_val.size;
 }
 
 bool obs_data_item_has_autoselect_value(obs_data_item_t *item)
 {
-	return item && item->autoselect_size;
+	return item && item->autoselect_val.size;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -1444,42 +2328,29 @@ void obs_data_unset_autoselect_value(obs_data_t *data, const char *name)
 
 void obs_data_item_unset_user_value(obs_data_item_t *item)
 {
-	if (!item || !item->data_size)
+	if (!item || !item->user_val.size)
 		return;
 
-	void *old_non_user_data = get_default_data_ptr(item);
-
-	item_data_release(item);
-	item->data_size = 0;
-	item->data_len = 0;
-
-	if (item->default_size || item->autoselect_size)
-		move_data(item, old_non_user_data, item, get_default_data_ptr(item),
-			  item->default_len + item->autoselect_size);
+	value_release(item, &item->user_val);
+	item->user_val.size = 0;
 }
 
 void obs_data_item_unset_default_value(obs_data_item_t *item)
 {
-	if (!item || !item->default_size)
+	if (!item || !item->default_val.size)
 		return;
 
-	void *old_autoselect_data = get_autoselect_data_ptr(item);
-
-	item_default_data_release(item);
-	item->default_size = 0;
-	item->default_len = 0;
-
-	if (item->autoselect_size)
-		move_data(item, old_autoselect_data, item, get_autoselect_data_ptr(item), item->autoselect_size);
+	value_release(item, &item->default_val);
+	item->default_val.size = 0;
 }
 
 void obs_data_item_unset_autoselect_value(obs_data_item_t *item)
 {
-	if (!item || !item->autoselect_size)
+	if (!item || !item->autoselect_val.size)
 		return;
 
-	item_autoselect_data_release(item);
-	item->autoselect_size = 0;
+	value_release(item, &item->autoselect_val);
+	item->autoselect_val.size = 0;
 }
 
 /* ------------------------------------------------------------------------- */
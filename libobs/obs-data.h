@@ -61,6 +61,7 @@ EXPORT obs_data_t *obs_data_create();
 EXPORT obs_data_t *obs_data_create_from_json(const char *json_string);
 EXPORT obs_data_t *obs_data_create_from_json_file(const char *json_file);
 EXPORT obs_data_t *obs_data_create_from_json_file_safe(const char *json_file, const char *backup_ext);
+EXPORT obs_data_t *obs_data_create_from_binary(const void *data, size_t size);
 EXPORT void obs_data_addref(obs_data_t *data);
 EXPORT void obs_data_release(obs_data_t *data);
 
@@ -74,6 +75,13 @@ EXPORT bool obs_data_save_json_safe(obs_data_t *data, const char *file, const ch
 EXPORT bool obs_data_save_json_pretty_safe(obs_data_t *data, const char *file, const char *temp_ext,
 					   const char *backup_ext);
 
+/* compact binary form of the user values, free the result with bfree.
+ * obs_data_create_from_json and obs_data_create_from_json_file detect it */
+EXPORT uint8_t *obs_data_get_binary(obs_data_t *data, size_t *size);
+EXPORT bool obs_data_save_binary(obs_data_t *data, const char *file);
+EXPORT bool obs_data_save_binary_safe(obs_data_t *data, const char *file, const char *temp_ext,
+				      const char *backup_ext);
+
 EXPORT void obs_data_apply(obs_data_t *target, obs_data_t *apply_data);
 
 EXPORT void obs_data_erase(obs_data_t *data, const char *name);
@@ -0,0 +1,295 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <inttypes.h>
+
+#include "media-io/video-frame.h"
+#include "obs-internal.h"
+
+/* Frames for async video are shared between all sources.  Buffers are
+ * grouped into size classes a quarter of a power of two apart, so sources
+ * that renegotiate to a similar size can reuse each other's frames instead
+ * of going back to the allocator.  Idle frames are released once they have
+ * not been used for a while or when the idle memory goes over the limit. */
+
+#define MIN_CLASS_SIZE 4096
+#define DEFAULT_POOL_LIMIT (256 * 1024 * 1024)
+#define MAX_IDLE_TIME_NS 10000000000ULL
+
+struct pool_frame {
+	struct obs_source_frame frame;
+	size_t capacity;
+	uint64_t idle_since;
+};
+
+struct frame_pool_class {
+	size_t size;
+	DARRAY(struct pool_frame *) frames; /* idle frames, oldest first */
+};
+
+struct obs_frame_pool {
+	pthread_mutex_t mutex;
+	DARRAY(struct frame_pool_class) classes;
+
+	size_t limit;
+	size_t cached_frames;
+	size_t cached_bytes;
+	size_t peak_cached_bytes;
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+};
+
+static size_t get_class_size(size_t size)
+{
+	if (size <= MIN_CLASS_SIZE)
+		return MIN_CLASS_SIZE;
+
+	size_t pow2 = MIN_CLASS_SIZE;
+	while (pow2 <= size / 2)
+		pow2 <<= 1;
+
+	size_t step = pow2 / 4;
+	return (size + step - 1) / step * step;
+}
+
+static struct frame_pool_class *get_class(struct obs_frame_pool *pool, size_t size, bool create)
+{
+	for (size_t i = 0; i < pool->classes.num; i++) {
+		if (pool->classes.array[i].size == size)
+			return &pool->classes.array[i];
+	}
+
+	if (!create)
+		return NULL;
+
+	struct frame_pool_class *cls = da_push_back_new(pool->classes);
+	cls->size = size;
+	return cls;
+}
+
+static inline void free_pool_frame(struct pool_frame *pf)
+{
+	bfree(pf->frame.data[0]);
+	bfree(pf);
+}
+
+static void evict_oldest(struct obs_frame_pool *pool)
+{
+	struct frame_pool_class *oldest = NULL;
+
+	for (size_t i = 0; i < pool->classes.num; i++) {
+		struct frame_pool_class *cls = &pool->classes.array[i];
+		if (!cls->frames.num)
+			continue;
+		if (!oldest || cls->frames.array[0]->idle_since < oldest->frames.array[0]->idle_since)
+			oldest = cls;
+	}
+
+	if (!oldest)
+		return;
+
+	free_pool_frame(oldest->frames.array[0]);
+	da_erase(oldest->frames, 0);
+
+	pool->cached_bytes -= oldest->size;
+	pool->cached_frames--;
+	pool->evictions++;
+}
+
+static void evict_expired(struct obs_frame_pool *pool, uint64_t now)
+{
+	for (size_t i = 0; i < pool->classes.num; i++) {
+		struct frame_pool_class *cls = &pool->classes.array[i];
+
+		while (cls->frames.num && now - cls->frames.array[0]->idle_since > MAX_IDLE_TIME_NS) {
+			free_pool_frame(cls->frames.array[0]);
+			da_erase(cls->frames, 0);
+
+			pool->cached_bytes -= cls->size;
+			pool->cached_frames--;
+			pool->evictions++;
+		}
+	}
+}
+
+struct obs_frame_pool *obs_frame_pool_create(void)
+{
+	struct obs_frame_pool *pool = bzalloc(sizeof(*pool));
+
+	if (pthread_mutex_init(&pool->mutex, NULL) != 0) {
+		bfree(pool);
+		return NULL;
+	}
+
+	pool->limit = DEFAULT_POOL_LIMIT;
+	return pool;
+}
+
+void obs_frame_pool_destroy(struct obs_frame_pool *pool)
+{
+	if (!pool)
+		return;
+
+	blog(LOG_INFO,
+	     "Async frame pool: %" PRIu64 " hits, %" PRIu64 " misses, %" PRIu64 " evictions, "
+	     "peak %.1f MB idle",
+	     pool->hits, pool->misses, pool->evictions, (double)pool->peak_cached_bytes / (1024.0 * 1024.0));
+
+	for (size_t i = 0; i < pool->classes.num; i++) {
+		struct frame_pool_class *cls = &pool->classes.array[i];
+		for (size_t j = 0; j < cls->frames.num; j++)
+			free_pool_frame(cls->frames.array[j]);
+		da_free(cls->frames);
+	}
+
+	da_free(pool->classes);
+	pthread_mutex_destroy(&pool->mutex);
+	bfree(pool);
+}
+
+struct obs_source_frame *obs_frame_pool_get(struct obs_frame_pool *pool, enum video_format format, uint32_t width,
+					    uint32_t height)
+{
+	size_t size = get_class_size(video_frame_get_buffer_size(format, width, height));
+	struct pool_frame *pf = NULL;
+
+	if (pool) {
+		pthread_mutex_lock(&pool->mutex);
+
+		struct frame_pool_class *cls = get_class(pool, size, false);
+		if (cls && cls->frames.num) {
+			pf = cls->frames.array[cls->frames.num - 1];
+			da_pop_back(cls->frames);
+
+			pool->cached_bytes -= size;
+			pool->cached_frames--;
+			pool->hits++;
+		} else {
+			pool->misses++;
+		}
+
+		evict_expired(pool, os_gettime_ns());
+		pthread_mutex_unlock(&pool->mutex);
+	}
+
+	if (pf) {
+		uint8_t *data = pf->frame.data[0];
+		memset(&pf->frame, 0, sizeof(pf->frame));
+		pf->frame.data[0] = data;
+	} else {
+		pf = bzalloc(sizeof(*pf));
+		pf->frame.data[0] = bmalloc(size);
+		pf->capacity = size;
+	}
+
+	struct video_frame vid_frame;
+	video_frame_init_buffer(&vid_frame, pf->frame.data[0], format, width, height);
+
+	pf->frame.format = format;
+	pf->frame.width = width;
+	pf->frame.height = height;
+
+	for (size_t i = 0; i < MAX_AV_PLANES; i++) {
+		pf->frame.data[i] = vid_frame.data[i];
+		pf->frame.linesize[i] = vid_frame.linesize[i];
+	}
+
+	return &pf->frame;
+}
+
+/* frames from obs_frame_pool_get can also be freed with
+ * obs_source_frame_destroy, they just aren't recycled then */
+void obs_frame_pool_release(struct obs_frame_pool *pool, struct obs_source_frame *frame)
+{
+	struct pool_frame *pf = (struct pool_frame *)frame;
+
+	if (!frame)
+		return;
+
+	if (!pool) {
+		free_pool_frame(pf);
+		return;
+	}
+
+	uint64_t now = os_gettime_ns();
+	pf->idle_since = now;
+
+	pthread_mutex_lock(&pool->mutex);
+
+	if (pf->capacity > pool->limit) {
+		pthread_mutex_unlock(&pool->mutex);
+		free_pool_frame(pf);
+		return;
+	}
+
+	evict_expired(pool, now);
+	while (pool->cached_frames && pool->cached_bytes + pf->capacity > pool->limit)
+		evict_oldest(pool);
+
+	struct frame_pool_class *cls = get_class(pool, pf->capacity, true);
+	da_push_back(cls->frames, &pf);
+
+	pool->cached_bytes += pf->capacity;
+	pool->cached_frames++;
+	if (pool->cached_bytes > pool->peak_cached_bytes)
+		pool->peak_cached_bytes = pool->cached_bytes;
+
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+void obs_frame_pool_set_limit(struct obs_frame_pool *pool, size_t limit)
+{
+	pthread_mutex_lock(&pool->mutex);
+	pool->limit = limit;
+	while (pool->cached_frames && pool->cached_bytes > pool->limit)
+		evict_oldest(pool);
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+void obs_frame_pool_get_stats(struct obs_frame_pool *pool, struct obs_frame_pool_stats *stats)
+{
+	pthread_mutex_lock(&pool->mutex);
+	stats->hits = pool->hits;
+	stats->misses = pool->misses;
+	stats->evictions = pool->evictions;
+	stats->cached_frames = pool->cached_frames;
+	stats->cached_bytes = pool->cached_bytes;
+	stats->peak_cached_bytes = pool->peak_cached_bytes;
+	stats->limit = pool->limit;
+	pthread_mutex_unlock(&pool->mutex);
+}
+
+/* ------------------------------------------------------------------------- */
+
+void obs_set_frame_pool_limit(size_t bytes)
+{
+	if (!obs || !obs->data.frame_pool)
+		return;
+
+	obs_frame_pool_set_limit(obs->data.frame_pool, bytes);
+}
+
+bool obs_get_frame_pool_stats(struct obs_frame_pool_stats *stats)
+{
+	if (!obs || !obs->data.frame_pool || !obs_ptr_valid(stats, "obs_get_frame_pool_stats"))
+		return false;
+
+	obs_frame_pool_get_stats(obs->data.frame_pool, stats);
+	return true;
+}
@@ -46,6 +46,33 @@ bool obs_hevc_keyframe(const uint8_t *data, size_t size)
 	return false;
 }
 
+/* returns the temporal sub-layer of the picture, 0 for the base layer */
+int obs_hevc_temporal_id(const uint8_t *data, size_t size)
+{
+	const uint8_t *nal_start;
+	const uint8_t *end = data + size;
+
+	nal_start = obs_nal_find_startcode(data, end);
+	while (true) {
+		while (nal_start < end && !*(nal_start++))
+			;
+
+		if (nal_start == end)
+			break;
+
+		const uint8_t type = (nal_start[0] & 0x7F) >> 1;
+
+		/* nuh_temporal_id_plus1 is the low 3 bits of the second byte
+		 * of the NAL unit header */
+		if (type <= OBS_HEVC_NAL_RSV_VCL31)
+			return (end - nal_start >= 2 && (nal_start[1] & 0x7)) ? (nal_start[1] & 0x7) - 1 : 0;
+
+		nal_start = obs_nal_find_startcode(nal_start, end);
+	}
+
+	return 0;
+}
+
 static int compute_hevc_keyframe_priority(const uint8_t *nal_start, bool *is_keyframe, int priority)
 {
 	int new_priority;
@@ -134,6 +134,37 @@ void obs_hotkey_pair_set_descriptions(obs_hotkey_pair_id id, const char *desc0,
 	obs_hotkey_set_description(pair->id[1], desc1);
 }
 
+typedef DARRAY(obs_key_combination_t) obs_key_combination_array_t;
+
+static void get_binding_keys(obs_hotkey_id id, obs_key_combination_array_t *keys)
+{
+	for (size_t i = 0; i < obs->hotkeys.bindings.num; i++) {
+		obs_hotkey_binding_t *binding = &obs->hotkeys.bindings.array[i];
+		if (binding->hotkey_id == id)
+			da_push_back(*keys, &binding->key);
+	}
+}
+
+/* bindings are saved along with the source that registered the hotkey, only
+ * an actual rebind changes what's saved */
+static void hotkey_source_changed(obs_hotkey_t *hotkey, const obs_key_combination_array_t *old_keys)
+{
+	obs_weak_source_t *weak = hotkey->registerer;
+	obs_key_combination_array_t keys = {0};
+	bool changed;
+
+	if (hotkey->registerer_type != OBS_HOTKEY_REGISTERER_SOURCE || !weak)
+		return;
+
+	get_binding_keys(hotkey->id, &keys);
+	changed = keys.num != old_keys->num ||
+		  (keys.num && memcmp(keys.array, old_keys->array, keys.num * sizeof(*keys.array)) != 0);
+	da_free(keys);
+
+	if (changed)
+		obs_source_changed(weak->source);
+}
+
 static void hotkey_signal(const char *signal, obs_hotkey_t *hotkey)
 {
 	calldata_t data;
@@ -508,12 +539,18 @@ void obs_hotkey_load_bindings(obs_hotkey_id id, obs_key_combination_t *combinati
 	obs_hotkey_t *hotkey;
 	HASH_FIND_HKEY(obs->hotkeys.hotkeys, id, hotkey);
 	if (hotkey) {
+		obs_key_combination_array_t old_keys = {0};
+		get_binding_keys(id, &old_keys);
+
 		bool changed = remove_bindings(id);
 		for (size_t i = 0; i < num; i++)
 			create_binding(hotkey, combinations[i]);
 
 		if (num || changed)
 			hotkey_signal("hotkey_bindings_changed", hotkey);
+
+		hotkey_source_changed(hotkey, &old_keys);
+		da_free(old_keys);
 	}
 
 	unlock();
@@ -527,8 +564,14 @@ void obs_hotkey_load(obs_hotkey_id id, obs_data_array_t *data)
 	obs_hotkey_t *hotkey;
 	HASH_FIND_HKEY(obs->hotkeys.hotkeys, id, hotkey);
 	if (hotkey) {
+		obs_key_combination_array_t old_keys = {0};
+		get_binding_keys(id, &old_keys);
+
 		remove_bindings(id);
 		load_bindings(hotkey, data);
+
+		hotkey_source_changed(hotkey, &old_keys);
+		da_free(old_keys);
 	}
 	unlock();
 }
@@ -602,15 +645,24 @@ void obs_hotkey_pair_load(obs_hotkey_pair_id id, obs_data_array_t *data0, obs_da
 	HASH_FIND_HKEY(obs->hotkeys.hotkeys, pair->id[0], p1);
 	HASH_FIND_HKEY(obs->hotkeys.hotkeys, pair->id[1], p2);
 
+	obs_key_combination_array_t old_keys = {0};
+
 	if (p1) {
+		get_binding_keys(pair->id[0], &old_keys);
 		remove_bindings(pair->id[0]);
 		load_bindings(p1, data0);
+		hotkey_source_changed(p1, &old_keys);
+		da_resize(old_keys, 0);
 	}
 	if (p2) {
+		get_binding_keys(pair->id[1], &old_keys);
 		remove_bindings(pair->id[1]);
 		load_bindings(p2, data1);
+		hotkey_source_changed(p2, &old_keys);
 	}
 
+	da_free(old_keys);
+
 unlock:
 	unlock();
 }
@@ -0,0 +1,181 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "obs-interleave.h"
+
+#define HEAP_INVALID ((size_t)-1)
+
+static inline struct encoder_packet *track_first(struct obs_interleave_track *track)
+{
+	return (struct encoder_packet *)deque_data(&track->packets, 0);
+}
+
+static inline bool track_before(struct obs_interleave_track *a, struct obs_interleave_track *b)
+{
+	return obs_interleave_packet_before(track_first(a), track_first(b));
+}
+
+static inline void heap_set(struct obs_interleaver *il, size_t idx, struct obs_interleave_track *track)
+{
+	il->heap[idx] = track;
+	track->heap_idx = idx;
+}
+
+static void heap_sift_up(struct obs_interleaver *il, size_t idx)
+{
+	struct obs_interleave_track *track = il->heap[idx];
+
+	while (idx) {
+		size_t parent = (idx - 1) / 2;
+		if (!track_before(track, il->heap[parent]))
+			break;
+
+		heap_set(il, idx, il->heap[parent]);
+		idx = parent;
+	}
+
+	heap_set(il, idx, track);
+}
+
+static void heap_sift_down(struct obs_interleaver *il, size_t idx)
+{
+	struct obs_interleave_track *track = il->heap[idx];
+
+	for (;;) {
+		size_t child = idx * 2 + 1;
+		if (child >= il->heap_size)
+			break;
+		if (child + 1 < il->heap_size && track_before(il->heap[child + 1], il->heap[child]))
+			child++;
+		if (!track_before(il->heap[child], track))
+			break;
+
+		heap_set(il, idx, il->heap[child]);
+		idx = child;
+	}
+
+	heap_set(il, idx, track);
+}
+
+static void heap_remove_top(struct obs_interleaver *il)
+{
+	il->heap[0]->heap_idx = HEAP_INVALID;
+
+	if (--il->heap_size) {
+		heap_set(il, 0, il->heap[il->heap_size]);
+		heap_sift_down(il, 0);
+	}
+}
+
+static inline bool in_heap(struct obs_interleaver *il, struct obs_interleave_track *track)
+{
+	return track->heap_idx < il->heap_size && il->heap[track->heap_idx] == track;
+}
+
+void obs_interleaver_free(struct obs_interleaver *il)
+{
+	struct encoder_packet packet;
+
+	while (obs_interleaver_pop(il, &packet))
+		obs_encoder_packet_release(&packet);
+
+	for (size_t i = 0; i < MAX_OUTPUT_VIDEO_ENCODERS; i++)
+		deque_free(&il->video[i].packets);
+	for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++)
+		deque_free(&il->audio[i].packets);
+}
+
+void obs_interleaver_push(struct obs_interleaver *il, const struct encoder_packet *packet)
+{
+	struct obs_interleave_track *track = obs_interleaver_track(il, packet->type, packet->track_idx);
+	size_t count = obs_interleave_track_count(track);
+	size_t idx = count;
+
+	/* encoders hand out packets in decode order, so this almost always
+	 * appends; anything else gets moved back to its place */
+	deque_push_back(&track->packets, packet, sizeof(*packet));
+
+	while (idx && obs_interleave_packet_before(packet, obs_interleave_track_packet(track, idx - 1))) {
+		*obs_interleave_track_packet(track, idx) = *obs_interleave_track_packet(track, idx - 1);
+		idx--;
+	}
+	if (idx != count)
+		*obs_interleave_track_packet(track, idx) = *packet;
+
+	il->num_packets++;
+
+	if (!in_heap(il, track)) {
+		heap_set(il, il->heap_size++, track);
+		heap_sift_up(il, track->heap_idx);
+	} else if (idx == 0) {
+		heap_sift_up(il, track->heap_idx);
+	}
+}
+
+bool obs_interleaver_pop(struct obs_interleaver *il, struct encoder_packet *packet)
+{
+	struct obs_interleave_track *track;
+
+	if (!il->heap_size)
+		return false;
+
+	track = il->heap[0];
+	deque_pop_front(&track->packets, packet, sizeof(*packet));
+	il->num_packets--;
+
+	if (track->packets.size)
+		heap_sift_down(il, 0);
+	else
+		heap_remove_top(il);
+
+	return true;
+}
+
+void obs_interleaver_reorder(struct obs_interleaver *il)
+{
+	for (size_t i = il->heap_size / 2; i > 0; i--)
+		heap_sift_down(il, i - 1);
+}
+
+/* number of packets in the track ordered before the given packet */
+static size_t track_count_before(struct obs_interleave_track *track, const struct encoder_packet *packet)
+{
+	size_t lo = 0;
+	size_t hi = obs_interleave_track_count(track);
+
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
+
+		if (obs_interleave_packet_before(obs_interleave_track_packet(track, mid), packet))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return lo;
+}
+
+size_t obs_interleaver_count_before(struct obs_interleaver *il, const struct encoder_packet *packet)
+{
+	size_t count = 0;
+
+	for (size_t i = 0; i < il->heap_size; i++)
+		count += track_count_before(il->heap[i], packet);
+
+	return count;
+}
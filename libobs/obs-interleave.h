@@ -0,0 +1,114 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include "util/deque.h"
+#include "obs.h"
+
+/**
+ * @file
+ * @brief Packet interleaving for outputs.
+ *
+ * Encoded packets are queued per track, each track in decode order.  A
+ * min-heap over the first packet of every track gives the next packet of
+ * the interleaved stream, so adding or taking a packet costs O(log tracks)
+ * no matter how many packets are buffered.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define OBS_INTERLEAVE_MAX_TRACKS (MAX_OUTPUT_VIDEO_ENCODERS + MAX_OUTPUT_AUDIO_ENCODERS)
+
+struct obs_interleave_track {
+	struct deque packets; /* struct encoder_packet */
+	size_t heap_idx;
+};
+
+struct obs_interleaver {
+	struct obs_interleave_track video[MAX_OUTPUT_VIDEO_ENCODERS];
+	struct obs_interleave_track audio[MAX_OUTPUT_AUDIO_ENCODERS];
+
+	/* non-empty tracks, ordered by their first packet */
+	struct obs_interleave_track *heap[OBS_INTERLEAVE_MAX_TRACKS];
+	size_t heap_size;
+
+	size_t num_packets;
+};
+
+/**
+ * Interleaving order: decode time, then video before audio, then track
+ * index.  Video packets with the same decode time are kept in track order
+ * so the output start logic doesn't prune additional video tracks.
+ */
+static inline bool obs_interleave_packet_before(const struct encoder_packet *a, const struct encoder_packet *b)
+{
+	if (a->dts_usec != b->dts_usec)
+		return a->dts_usec < b->dts_usec;
+	if (a->type != b->type)
+		return a->type == OBS_ENCODER_VIDEO;
+	return a->track_idx < b->track_idx;
+}
+
+/** Releases every queued packet and frees the queues */
+EXPORT void obs_interleaver_free(struct obs_interleaver *il);
+
+/** Takes ownership of the packet, packet->track_idx must be set */
+EXPORT void obs_interleaver_push(struct obs_interleaver *il, const struct encoder_packet *packet);
+
+/** Removes the next packet in interleaved order, the caller owns it */
+EXPORT bool obs_interleaver_pop(struct obs_interleaver *il, struct encoder_packet *packet);
+
+/** Restores the interleaving order after the packet timestamps changed */
+EXPORT void obs_interleaver_reorder(struct obs_interleaver *il);
+
+/** Number of queued packets ordered before the given packet */
+EXPORT size_t obs_interleaver_count_before(struct obs_interleaver *il, const struct encoder_packet *packet);
+
+static inline struct encoder_packet *obs_interleaver_peek(struct obs_interleaver *il)
+{
+	return il->heap_size ? (struct encoder_packet *)deque_data(&il->heap[0]->packets, 0) : NULL;
+}
+
+static inline struct obs_interleave_track *obs_interleaver_track(struct obs_interleaver *il,
+								  enum obs_encoder_type type, size_t idx)
+{
+	return type == OBS_ENCODER_VIDEO ? &il->video[idx] : &il->audio[idx];
+}
+
+static inline size_t obs_interleave_track_count(const struct obs_interleave_track *track)
+{
+	return track->packets.size / sizeof(struct encoder_packet);
+}
+
+static inline struct encoder_packet *obs_interleave_track_packet(struct obs_interleave_track *track, size_t i)
+{
+	return (struct encoder_packet *)deque_data(&track->packets, i * sizeof(struct encoder_packet));
+}
+
+static inline struct encoder_packet *obs_interleave_track_last(struct obs_interleave_track *track)
+{
+	size_t count = obs_interleave_track_count(track);
+	return count ? obs_interleave_track_packet(track, count - 1) : NULL;
+}
+
+#ifdef __cplusplus
+}
+#endif
@@ -38,6 +38,7 @@
 #include "media-io/audio-io.h"
 
 #include "obs.h"
+#include "obs-interleave.h"
 
 #include <obsversion.h>
 #include <caption/caption.h>
@@ -439,6 +440,12 @@ extern void add_ready_encoder_group(obs_encoder_t *encoder);
 
 struct audio_monitor;
 
+struct audio_mix_job {
+	struct obs_source *source;
+	size_t start_point;
+	size_t total_floats;
+};
+
 struct obs_core_audio {
 	audio_t *audio;
 
@@ -461,6 +468,16 @@ struct obs_core_audio {
 	struct deque tasks;
 
 	struct obs_source *monitoring_duplicating_source;
+
+	/* parallel mixing, only touched by the audio thread */
+	os_task_pool_t *mix_pool;
+	bool parallel_active;
+	DARRAY(struct obs_source *) parallel_sources;
+	DARRAY(struct audio_mix_job) mix_jobs;
+
+	uint64_t tick_count;
+	uint64_t tick_total_ns;
+	uint64_t tick_max_ns;
 };
 
 /* user sources, output channels, and displays */
@@ -502,6 +519,8 @@ struct obs_core_data {
 
 	DARRAY(char *) protocols;
 	DARRAY(obs_source_t *) sources_to_tick;
+
+	struct obs_frame_pool *frame_pool;
 };
 
 /* user hotkeys */
@@ -541,6 +560,12 @@ struct obs_core_hotkeys {
 
 typedef DARRAY(struct obs_source_info) obs_source_info_array_t;
 
+struct obs_thread_role {
+	char *name;
+	struct obs_thread_config config;
+	struct obs_thread_status status;
+};
+
 struct obs_core {
 	struct obs_module *first_module;
 	struct obs_module *first_disabled_module;
@@ -557,6 +582,7 @@ struct obs_core {
 	DARRAY(struct obs_output_info) output_types;
 	DARRAY(struct obs_encoder_info) encoder_types;
 	DARRAY(struct obs_service_info) service_types;
+	DARRAY(struct obs_bitrate_policy_info) bitrate_policy_types;
 
 	signal_handler_t *signals;
 	proc_handler_t *procs;
@@ -576,6 +602,11 @@ struct obs_core {
 	os_task_queue_t *destruction_task_thread;
 
 	obs_task_handler_t ui_task_handler;
+
+	volatile bool parallel_audio_mixing;
+
+	pthread_mutex_t thread_roles_mutex;
+	DARRAY(struct obs_thread_role) thread_roles;
 };
 
 extern struct obs_core *obs;
@@ -600,6 +631,7 @@ extern gs_effect_t *obs_load_effect(gs_effect_t **effect, const char *file);
 
 extern bool audio_callback(void *param, uint64_t start_ts_in, uint64_t end_ts_in, uint64_t *out_ts, uint32_t mixers,
 			   struct audio_output_data *mixes);
+extern void log_audio_tick_stats(struct obs_core_audio *audio);
 
 extern struct obs_core_video_mix *get_mix_for_video(video_t *video);
 
@@ -998,6 +1030,9 @@ struct obs_source {
 	/* private data */
 	obs_data_t *private_settings;
 
+	/* incremented whenever something obs_save_source writes changes */
+	volatile long save_revision;
+
 	/* canvas this source belongs to (only used for scenes) */
 	obs_weak_canvas_t *canvas;
 };
@@ -1055,6 +1090,16 @@ static inline void obs_source_dosignal_canvas(struct obs_source *source, struct
 		signal_handler_signal(source->context.signals, signal_source, &data);
 }
 
+/* changes to a filter are saved as part of the source it's on */
+static inline void obs_source_changed(struct obs_source *source)
+{
+	struct obs_source *parent = source->filter_parent;
+
+	os_atomic_inc_long(&source->save_revision);
+	if (parent)
+		os_atomic_inc_long(&parent->save_revision);
+}
+
 /* maximum timestamp variance in nanoseconds */
 #define MAX_TS_VAR 2000000000ULL
 
@@ -1141,6 +1186,17 @@ extern void deinterlace_process_last_frame(obs_source_t *source, uint64_t sys_ti
 extern void deinterlace_update_async_video(obs_source_t *source);
 extern void deinterlace_render(obs_source_t *s);
 
+/* async frames shared between sources, see obs-frame-pool.c */
+struct obs_frame_pool;
+
+extern struct obs_frame_pool *obs_frame_pool_create(void);
+extern void obs_frame_pool_destroy(struct obs_frame_pool *pool);
+extern struct obs_source_frame *obs_frame_pool_get(struct obs_frame_pool *pool, enum video_format format,
+						   uint32_t width, uint32_t height);
+extern void obs_frame_pool_release(struct obs_frame_pool *pool, struct obs_source_frame *frame);
+extern void obs_frame_pool_set_limit(struct obs_frame_pool *pool, size_t limit);
+extern void obs_frame_pool_get_stats(struct obs_frame_pool *pool, struct obs_frame_pool_stats *stats);
+
 /* ------------------------------------------------------------------------- */
 /* outputs  */
 
@@ -1156,8 +1212,14 @@ struct delay_data {
 	struct encoder_packet packet;
 	bool packet_time_valid;
 	struct encoder_packet_time packet_time;
+
+	/* packet data is in the spill files instead of memory */
+	bool spilled;
+	uint64_t spill_pos;
 };
 
+struct delay_spill;
+
 typedef void (*encoded_callback_t)(void *data, struct encoder_packet *packet, struct encoder_packet_time *frame_time);
 
 struct obs_weak_output {
@@ -1226,7 +1288,7 @@ struct obs_output {
 	pthread_t end_data_capture_thread;
 	os_event_t *stopping_event;
 	pthread_mutex_t interleaved_mutex;
-	DARRAY(struct encoder_packet) interleaved_packets;
+	struct obs_interleaver interleaver;
 	size_t interleaver_max_batch_size;
 	int stop_code;
 
@@ -1290,6 +1352,8 @@ struct obs_output {
 	encoded_callback_t delay_callback;
 	struct deque delay_data; /* struct delay_data */
 	pthread_mutex_t delay_mutex;
+	char *delay_spill_path;
+	struct delay_spill *delay_spill;
 	uint32_t delay_sec;
 	uint32_t delay_flags;
 	uint32_t delay_cur_flags;
@@ -1493,6 +1557,11 @@ void obs_service_destroy(obs_service_t *service);
 
 void obs_output_remove_encoder_internal(struct obs_output *output, struct obs_encoder *encoder);
 
+/* ------------------------------------------------------------------------- */
+/* bitrate control */
+
+extern const struct obs_bitrate_policy_info *find_bitrate_policy(const char *id);
+
 /** Internal Source Profiler functions **/
 
 /* Start of frame in graphics loop */
@@ -992,6 +992,7 @@ cleanup:
 #define output_warn(format, ...) blog(LOG_WARNING, "obs_register_output: " format, ##__VA_ARGS__)
 #define encoder_warn(format, ...) blog(LOG_WARNING, "obs_register_encoder: " format, ##__VA_ARGS__)
 #define service_warn(format, ...) blog(LOG_WARNING, "obs_register_service: " format, ##__VA_ARGS__)
+#define bitrate_policy_warn(format, ...) blog(LOG_WARNING, "obs_register_bitrate_policy: " format, ##__VA_ARGS__)
 
 void obs_register_source_s(const struct obs_source_info *info, size_t size)
 {
@@ -1233,3 +1234,25 @@ void obs_register_service_s(const struct obs_service_info *info, size_t size)
 error:
 	HANDLE_ERROR(size, obs_service_info, info);
 }
+
+void obs_register_bitrate_policy_s(const struct obs_bitrate_policy_info *info, size_t size)
+{
+	if (find_bitrate_policy(info->id)) {
+		bitrate_policy_warn("Bitrate policy id '%s' already exists!  "
+				    "Duplicate library?",
+				    info->id);
+		goto error;
+	}
+
+#define CHECK_REQUIRED_VAL_(info, val, func) CHECK_REQUIRED_VAL(struct obs_bitrate_policy_info, info, val, func)
+	CHECK_REQUIRED_VAL_(info, create, obs_register_bitrate_policy);
+	CHECK_REQUIRED_VAL_(info, destroy, obs_register_bitrate_policy);
+	CHECK_REQUIRED_VAL_(info, update, obs_register_bitrate_policy);
+#undef CHECK_REQUIRED_VAL_
+
+	REGISTER_OBS_DEF(size, obs_bitrate_policy_info, obs->bitrate_policy_types, info);
+	return;
+
+error:
+	HANDLE_ERROR(size, obs_bitrate_policy_info, info);
+}
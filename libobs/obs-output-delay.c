@@ -43,19 +43,216 @@ static inline bool log_flag_encoded(const struct obs_output *output, const char
 	return ret;
 }
 
+/* ------------------------------------------------------------------------- */
+/* Spilling delayed packets to disk                                          */
+
+/* Packet data is appended to a series of fixed size temporary files and read
+ * back when the packet leaves the delay.  Only the file being written and the
+ * one being read are mapped, so memory use doesn't depend on the delay length
+ * or bitrate, only the delay_data index stays in memory. */
+
+#define SPILL_SEGMENT_SIZE (32 * 1024 * 1024)
+
+struct delay_spill {
+	struct dstr path_prefix;
+	uint64_t next_file_id;
+
+	/* os_mapped_file_t *, from the one being read to the one being
+	 * written, the first one holds spill positions starting at
+	 * first_segment * SPILL_SEGMENT_SIZE */
+	struct deque segments;
+	uint64_t first_segment;
+	uint64_t write_pos;
+
+	/* a drained file kept around for the writer to reuse */
+	os_mapped_file_t *spare;
+	bool failed;
+};
+
+static inline size_t num_segments(struct delay_spill *spill)
+{
+	return spill->segments.size / sizeof(os_mapped_file_t *);
+}
+
+static inline os_mapped_file_t *get_segment(struct delay_spill *spill, size_t idx)
+{
+	return *(os_mapped_file_t **)deque_data(&spill->segments, idx * sizeof(os_mapped_file_t *));
+}
+
+static struct delay_spill *delay_spill_create(const char *path)
+{
+	struct delay_spill *spill = bzalloc(sizeof(*spill));
+	char *uuid = os_generate_uuid();
+
+	dstr_copy(&spill->path_prefix, path);
+	dstr_replace(&spill->path_prefix, "\\", "/");
+	if (dstr_end(&spill->path_prefix) != '/')
+		dstr_cat_ch(&spill->path_prefix, '/');
+	dstr_catf(&spill->path_prefix, "obs-delay-%s", uuid);
+
+	bfree(uuid);
+	return spill;
+}
+
+static void delay_spill_destroy(struct delay_spill *spill)
+{
+	if (!spill)
+		return;
+
+	while (spill->segments.size) {
+		os_mapped_file_t *segment;
+		deque_pop_front(&spill->segments, &segment, sizeof(segment));
+		os_mapped_file_close(segment);
+	}
+
+	os_mapped_file_close(spill->spare);
+	deque_free(&spill->segments);
+	dstr_free(&spill->path_prefix);
+	bfree(spill);
+}
+
+static os_mapped_file_t *new_segment(struct delay_spill *spill)
+{
+	os_mapped_file_t *segment = spill->spare;
+	struct dstr path = {0};
+
+	if (segment) {
+		spill->spare = NULL;
+		return segment;
+	}
+
+	dstr_printf(&path, "%s-%" PRIu64 ".tmp", spill->path_prefix.array, spill->next_file_id++);
+	segment = os_mapped_file_create(path.array, SPILL_SEGMENT_SIZE, true);
+	if (!segment)
+		blog(LOG_WARNING, "Failed to create delay spill file '%s', keeping delayed packets in memory",
+		     path.array);
+
+	dstr_free(&path);
+	return segment;
+}
+
+/* drops the files before the given segment, all of their packets were read */
+static void release_segments(struct delay_spill *spill, uint64_t segment_num)
+{
+	while (spill->first_segment < segment_num && spill->segments.size) {
+		os_mapped_file_t *segment;
+		deque_pop_front(&spill->segments, &segment, sizeof(segment));
+		spill->first_segment++;
+
+		if (!spill->spare) {
+			os_mapped_file_unmap(segment);
+			spill->spare = segment;
+		} else {
+			os_mapped_file_close(segment);
+		}
+	}
+
+	if (!spill->segments.size)
+		spill->first_segment = segment_num;
+}
+
+static bool delay_spill_write(struct delay_spill *spill, const struct encoder_packet *packet, uint64_t *pos)
+{
+	size_t offset = (size_t)(spill->write_pos % SPILL_SEGMENT_SIZE);
+	uint64_t segment_num;
+	size_t idx;
+	uint8_t *data;
+
+	if (spill->failed || packet->size > SPILL_SEGMENT_SIZE)
+		return false;
+
+	/* packets don't cross files */
+	if (offset + packet->size > SPILL_SEGMENT_SIZE) {
+		spill->write_pos += SPILL_SEGMENT_SIZE - offset;
+		offset = 0;
+	}
+
+	segment_num = spill->write_pos / SPILL_SEGMENT_SIZE;
+	if (!spill->segments.size)
+		spill->first_segment = segment_num;
+
+	idx = (size_t)(segment_num - spill->first_segment);
+	if (idx == num_segments(spill)) {
+		os_mapped_file_t *segment = new_segment(spill);
+		if (!segment) {
+			spill->failed = true;
+			return false;
+		}
+
+		/* the previous file is done, unless it's being read it
+		 * doesn't need to stay mapped */
+		if (idx > 1)
+			os_mapped_file_unmap(get_segment(spill, idx - 1));
+
+		deque_push_back(&spill->segments, &segment, sizeof(segment));
+	}
+
+	data = os_mapped_file_map(get_segment(spill, idx));
+	if (!data) {
+		blog(LOG_WARNING, "Failed to map delay spill file, keeping delayed packets in memory");
+		spill->failed = true;
+		return false;
+	}
+
+	memcpy(data + offset, packet->data, packet->size);
+	*pos = spill->write_pos;
+	spill->write_pos += packet->size;
+	return true;
+}
+
+/* reads the packet data back into a new packet buffer */
+static bool delay_spill_read(struct delay_spill *spill, struct delay_data *dd)
+{
+	uint64_t segment_num = dd->spill_pos / SPILL_SEGMENT_SIZE;
+	struct encoder_packet packet = dd->packet;
+	uint8_t *data;
+
+	release_segments(spill, segment_num);
+	if (!spill->segments.size)
+		return false;
+
+	data = os_mapped_file_map(get_segment(spill, 0));
+	if (!data)
+		return false;
+
+	packet.data = data + dd->spill_pos % SPILL_SEGMENT_SIZE;
+	obs_encoder_packet_create_instance(&dd->packet, &packet);
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+
 static inline void push_packet(struct obs_output *output, struct encoder_packet *packet,
 			       struct encoder_packet_time *packet_time, uint64_t t)
 {
-	struct delay_data dd;
+	struct delay_data dd = {0};
+	bool spill;
 
 	dd.msg = DELAY_MSG_PACKET;
 	dd.ts = t;
 	dd.packet_time_valid = packet_time != NULL;
 	if (packet_time != NULL)
 		dd.packet_time = *packet_time;
-	obs_encoder_packet_create_instance(&dd.packet, packet);
+
+	spill = output->delay_spill_path != NULL;
+	if (!spill)
+		obs_encoder_packet_create_instance(&dd.packet, packet);
 
 	pthread_mutex_lock(&output->delay_mutex);
+
+	if (spill) {
+		if (!output->delay_spill && output->delay_spill_path)
+			output->delay_spill = delay_spill_create(output->delay_spill_path);
+
+		dd.spilled = output->delay_spill && delay_spill_write(output->delay_spill, packet, &dd.spill_pos);
+		if (dd.spilled) {
+			dd.packet = *packet;
+			dd.packet.data = NULL;
+		} else {
+			obs_encoder_packet_create_instance(&dd.packet, packet);
+		}
+	}
+
 	deque_push_back(&output->delay_data, &dd, sizeof(dd));
 	pthread_mutex_unlock(&output->delay_mutex);
 }
@@ -89,6 +286,9 @@ void obs_output_cleanup_delay(obs_output_t *output)
 		}
 	}
 
+	delay_spill_destroy(output->delay_spill);
+	output->delay_spill = NULL;
+
 	output->active_delay_ns = 0;
 	os_atomic_set_long(&output->delay_restart_refs, 0);
 }
@@ -98,6 +298,7 @@ static inline bool pop_packet(struct obs_output *output, uint64_t t)
 	uint64_t elapsed_time;
 	struct delay_data dd;
 	bool popped = false;
+	bool lost = false;
 	bool preserve;
 
 	/* ------------------------------------------------ */
@@ -116,6 +317,12 @@ static inline bool pop_packet(struct obs_output *output, uint64_t t)
 		} else if (elapsed_time > output->active_delay_ns) {
 			deque_pop_front(&output->delay_data, NULL, sizeof(dd));
 			popped = true;
+
+			if (dd.spilled && !delay_spill_read(output->delay_spill, &dd)) {
+				blog(LOG_ERROR, "Output '%s': Failed to read delayed packet back from disk",
+				     output->context.name);
+				lost = true;
+			}
 		}
 	}
 
@@ -123,7 +330,7 @@ static inline bool pop_packet(struct obs_output *output, uint64_t t)
 
 	/* ------------------------------------------------ */
 
-	if (popped)
+	if (popped && !lost)
 		process_delay_data(output, &dd);
 
 	return popped;
@@ -197,6 +404,19 @@ void obs_output_set_delay(obs_output_t *output, uint32_t delay_sec, uint32_t fla
 	output->delay_flags = flags;
 }
 
+void obs_output_set_delay_spill_path(obs_output_t *output, const char *path)
+{
+	if (!obs_output_valid(output, "obs_output_set_delay_spill_path"))
+		return;
+	if (!log_flag_encoded(output, __FUNCTION__, false))
+		return;
+
+	pthread_mutex_lock(&output->delay_mutex);
+	bfree(output->delay_spill_path);
+	output->delay_spill_path = (path && *path) ? bstrdup(path) : NULL;
+	pthread_mutex_unlock(&output->delay_mutex);
+}
+
 uint32_t obs_output_get_delay(const obs_output_t *output)
 {
 	return obs_output_valid(output, "obs_output_set_delay") ? output->delay_sec : 0;
@@ -262,9 +262,7 @@ fail:
 
 static inline void free_packets(struct obs_output *output)
 {
-	for (size_t i = 0; i < output->interleaved_packets.num; i++)
-		obs_encoder_packet_release(output->interleaved_packets.array + i);
-	da_free(output->interleaved_packets);
+	obs_interleaver_free(&output->interleaver);
 }
 
 static inline void clear_raw_audio_buffers(obs_output_t *output)
@@ -342,7 +340,9 @@ void obs_output_destroy(obs_output_t *output)
 		pthread_mutex_destroy(&output->pkt_callbacks_mutex);
 		os_event_destroy(output->reconnect_stop_event);
 		obs_context_data_free(&output->context);
+		obs_output_cleanup_delay(output);
 		deque_free(&output->delay_data);
+		bfree(output->delay_spill_path);
 		if (output->owns_info_id)
 			bfree((void *)output->info.id);
 		if (output->last_error_message)
@@ -1680,11 +1680,11 @@ static bool add_caption(struct obs_output *output, struct encoder_packet *out)
 
 static inline void send_interleaved(struct obs_output *output)
 {
-	struct encoder_packet out = output->interleaved_packets.array[0];
+	struct encoder_packet out;
 	struct encoder_packet_time ept_local = {0};
 	bool found_ept = false;
 
-	da_erase(output->interleaved_packets, 0);
+	obs_interleaver_pop(&output->interleaver, &out);
 
 	if (out.type == OBS_ENCODER_VIDEO) {
 		output->total_frames++;
@@ -1769,51 +1769,81 @@ static inline void set_higher_ts(struct obs_output *output, struct encoder_packe
 }
 
 static inline struct encoder_packet *find_first_packet_type(struct obs_output *output, enum obs_encoder_type type,
-							    size_t audio_idx);
-static int find_first_packet_type_idx(struct obs_output *output, enum obs_encoder_type type, size_t audio_idx);
+							    size_t idx)
+{
+	struct obs_interleave_track *track = obs_interleaver_track(&output->interleaver, type, idx);
+	return obs_interleave_track_count(track) ? obs_interleave_track_packet(track, 0) : NULL;
+}
 
-/* gets the point where audio and video are closest together */
-static size_t get_interleaved_start_idx(struct obs_output *output)
+static inline struct encoder_packet *find_last_packet_type(struct obs_output *output, enum obs_encoder_type type,
+							   size_t idx)
 {
-	int64_t closest_diff = 0x7FFFFFFFFFFFFFFFLL;
-	struct encoder_packet *first_video = find_first_packet_type(output, OBS_ENCODER_VIDEO, 0);
-	size_t video_idx = DARRAY_INVALID;
-	size_t idx = 0;
+	return obs_interleave_track_last(obs_interleaver_track(&output->interleaver, type, idx));
+}
 
-	for (size_t i = 0; i < output->interleaved_packets.num; i++) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i];
-		int64_t diff;
+/* first audio packet that isn't ordered before the given packet */
+static struct encoder_packet *find_first_audio_from(struct obs_output *output, struct encoder_packet *from)
+{
+	struct encoder_packet *first = NULL;
 
-		if (packet->type != OBS_ENCODER_AUDIO) {
-			if (packet == first_video)
-				video_idx = i;
-			continue;
+	for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++) {
+		struct obs_interleave_track *track = &output->interleaver.audio[i];
+		size_t count = obs_interleave_track_count(track);
+
+		for (size_t j = 0; j < count; j++) {
+			struct encoder_packet *packet = obs_interleave_track_packet(track, j);
+			if (obs_interleave_packet_before(packet, from))
+				continue;
+
+			if (!first || obs_interleave_packet_before(packet, first))
+				first = packet;
+			break;
 		}
+	}
+
+	return first;
+}
+
+/* gets the point where audio and video are closest together */
+static struct encoder_packet *get_interleaved_start(struct obs_output *output)
+{
+	int64_t closest_diff = 0x7FFFFFFFFFFFFFFFLL;
+	struct encoder_packet *first_video = find_first_packet_type(output, OBS_ENCODER_VIDEO, 0);
+	struct encoder_packet *start = NULL;
 
-		diff = llabs(packet->dts_usec - first_video->dts_usec);
-		if (diff < closest_diff) {
-			closest_diff = diff;
-			idx = i;
+	for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++) {
+		struct obs_interleave_track *track = &output->interleaver.audio[i];
+		size_t count = obs_interleave_track_count(track);
+
+		for (size_t j = 0; j < count; j++) {
+			struct encoder_packet *packet = obs_interleave_track_packet(track, j);
+			int64_t diff = llabs(packet->dts_usec - first_video->dts_usec);
+
+			if (diff < closest_diff || (diff == closest_diff && obs_interleave_packet_before(packet, start))) {
+				closest_diff = diff;
+				start = packet;
+			} else if (packet->dts_usec > first_video->dts_usec) {
+				break;
+			}
 		}
 	}
 
-	idx = video_idx < idx ? video_idx : idx;
+	if (!start || obs_interleave_packet_before(first_video, start))
+		start = first_video;
 
 	/* Early AAC/Opus audio packets will be for "priming" the encoder and contain silence, but they should not be
-	 * discarded. Set the idx to the first audio packet if closest PTS was <= 0. */
-	size_t first_audio_idx = idx;
-	while (output->interleaved_packets.array[first_audio_idx].type != OBS_ENCODER_AUDIO)
-		first_audio_idx++;
+	 * discarded. Start at the first audio packet if closest PTS was <= 0. */
+	struct encoder_packet *first_audio = find_first_audio_from(output, start);
 
-	if (output->interleaved_packets.array[first_audio_idx].pts <= 0) {
+	if (first_audio && first_audio->pts <= 0) {
 		for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++) {
-			int audio_idx = find_first_packet_type_idx(output, OBS_ENCODER_AUDIO, i);
-			if (audio_idx >= 0 && (size_t)audio_idx < idx)
-				idx = audio_idx;
+			struct encoder_packet *audio = find_first_packet_type(output, OBS_ENCODER_AUDIO, i);
+			if (audio && obs_interleave_packet_before(audio, start))
+				start = audio;
 		}
 	}
 
-	return idx;
+	return start;
 }
 
 static int64_t get_encoder_duration(struct obs_encoder *encoder)
@@ -1821,42 +1851,40 @@ static int64_t get_encoder_duration(struct obs_encoder *encoder)
 	return (encoder->timebase_num * 1000000LL / encoder->timebase_den) * encoder->framesize;
 }
 
-static int prune_premature_packets(struct obs_output *output)
+/* returns -1 if there isn't enough data yet, 1 if everything up to and
+ * including *prune_end has to be pruned, 0 otherwise */
+static int prune_premature_packets(struct obs_output *output, struct encoder_packet **prune_end)
 {
 	struct encoder_packet *video;
-	int video_idx;
-	int max_idx;
+	struct encoder_packet *last;
 	int64_t duration_usec, max_audio_duration_usec = 0;
 	int64_t max_diff = 0;
 	int64_t diff = 0;
 	int audio_encoders = 0;
 
-	video_idx = find_first_packet_type_idx(output, OBS_ENCODER_VIDEO, 0);
-	if (video_idx == -1)
+	video = find_first_packet_type(output, OBS_ENCODER_VIDEO, 0);
+	if (!video)
 		return -1;
 
-	max_idx = video_idx;
-	video = &output->interleaved_packets.array[video_idx];
+	last = video;
 	duration_usec = video->timebase_num * 1000000LL / video->timebase_den;
 
 	for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++) {
 		struct encoder_packet *audio;
-		int audio_idx;
 		int64_t audio_duration_usec = 0;
 
 		if (!output->audio_encoders[i])
 			continue;
 		audio_encoders++;
 
-		audio_idx = find_first_packet_type_idx(output, OBS_ENCODER_AUDIO, i);
-		if (audio_idx == -1) {
+		audio = find_first_packet_type(output, OBS_ENCODER_AUDIO, i);
+		if (!audio) {
 			output->received_audio = false;
 			return -1;
 		}
 
-		audio = &output->interleaved_packets.array[audio_idx];
-		if (audio_idx > max_idx)
-			max_idx = audio_idx;
+		if (obs_interleave_packet_before(last, audio))
+			last = audio;
 
 		diff = audio->dts_usec - video->dts_usec;
 		if (diff > max_diff)
@@ -1877,40 +1905,62 @@ static int prune_premature_packets(struct obs_output *output)
 		duration_usec = max_audio_duration_usec;
 	}
 
-	return diff > duration_usec ? max_idx + 1 : 0;
+	*prune_end = last;
+	return diff > duration_usec ? 1 : 0;
 }
 
 #define DEBUG_STARTING_PACKETS 0
 
-static void discard_to_idx(struct obs_output *output, size_t idx)
+static inline void discard_packet(struct obs_output *output, struct encoder_packet *packet)
 {
-	for (size_t i = 0; i < idx; i++) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i];
 #if DEBUG_STARTING_PACKETS == 1
-		blog(LOG_DEBUG, "discarding %s packet, dts: %lld, pts: %lld",
-		     packet->type == OBS_ENCODER_VIDEO ? "video" : "audio", packet->dts, packet->pts);
+	blog(LOG_DEBUG, "discarding %s packet, dts: %lld, pts: %lld",
+	     packet->type == OBS_ENCODER_VIDEO ? "video" : "audio", packet->dts, packet->pts);
 #endif
-		if (packet->type == OBS_ENCODER_VIDEO) {
-			da_pop_front(output->encoder_packet_times[packet->track_idx]);
-		}
-		obs_encoder_packet_release(packet);
+	if (packet->type == OBS_ENCODER_VIDEO) {
+		da_pop_front(output->encoder_packet_times[packet->track_idx]);
 	}
+	obs_encoder_packet_release(packet);
+}
+
+/* discards the packets ordered before the given one, and the packet itself
+ * if inclusive is set */
+static void discard_to_packet(struct obs_output *output, const struct encoder_packet *last, bool inclusive)
+{
+	struct encoder_packet key = *last;
+	struct encoder_packet *next;
+
+	while ((next = obs_interleaver_peek(&output->interleaver)) != NULL) {
+		bool discard = obs_interleave_packet_before(next, &key) ||
+			       (inclusive && !obs_interleave_packet_before(&key, next));
+		if (!discard)
+			break;
 
-	da_erase_range(output->interleaved_packets, 0, idx);
+		struct encoder_packet packet;
+		obs_interleaver_pop(&output->interleaver, &packet);
+		discard_packet(output, &packet);
+	}
 }
 
 static bool prune_interleaved_packets(struct obs_output *output)
 {
-	size_t start_idx = 0;
-	int prune_start = prune_premature_packets(output);
+	struct encoder_packet *prune_end = NULL;
+	int prune_start = prune_premature_packets(output, &prune_end);
 
 #if DEBUG_STARTING_PACKETS == 1
 	blog(LOG_DEBUG, "--------- Pruning! %d ---------", prune_start);
-	for (size_t i = 0; i < output->interleaved_packets.num; i++) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i];
-		blog(LOG_DEBUG, "packet: %s %d, ts: %lld, pruned = %s",
-		     packet->type == OBS_ENCODER_AUDIO ? "audio" : "video", (int)packet->track_idx, packet->dts_usec,
-		     (int)i < prune_start ? "true" : "false");
+	for (size_t i = 0; i < OBS_INTERLEAVE_MAX_TRACKS; i++) {
+		struct obs_interleave_track *track = i < MAX_OUTPUT_VIDEO_ENCODERS
+							     ? &output->interleaver.video[i]
+							     : &output->interleaver.audio[i - MAX_OUTPUT_VIDEO_ENCODERS];
+
+		for (size_t j = 0; j < obs_interleave_track_count(track); j++) {
+			struct encoder_packet *packet = obs_interleave_track_packet(track, j);
+			blog(LOG_DEBUG, "packet: %s %d, ts: %lld, pruned = %s",
+			     packet->type == OBS_ENCODER_AUDIO ? "audio" : "video", (int)packet->track_idx,
+			     packet->dts_usec,
+			     prune_start == 1 && !obs_interleave_packet_before(prune_end, packet) ? "true" : "false");
+		}
 	}
 #endif
 
@@ -1918,54 +1968,13 @@ static bool prune_interleaved_packets(struct obs_output *output)
 	if (prune_start == -1)
 		return false;
 	else if (prune_start != 0)
-		start_idx = (size_t)prune_start;
+		discard_to_packet(output, prune_end, true);
 	else
-		start_idx = get_interleaved_start_idx(output);
-
-	if (start_idx)
-		discard_to_idx(output, start_idx);
+		discard_to_packet(output, get_interleaved_start(output), false);
 
 	return true;
 }
 
-static int find_first_packet_type_idx(struct obs_output *output, enum obs_encoder_type type, size_t idx)
-{
-	for (size_t i = 0; i < output->interleaved_packets.num; i++) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i];
-
-		if (packet->type == type && packet->track_idx == idx)
-			return (int)i;
-	}
-
-	return -1;
-}
-
-static int find_last_packet_type_idx(struct obs_output *output, enum obs_encoder_type type, size_t idx)
-{
-	for (size_t i = output->interleaved_packets.num; i > 0; i--) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i - 1];
-
-		if (packet->type == type && packet->track_idx == idx)
-			return (int)(i - 1);
-	}
-
-	return -1;
-}
-
-static inline struct encoder_packet *find_first_packet_type(struct obs_output *output, enum obs_encoder_type type,
-							    size_t audio_idx)
-{
-	int idx = find_first_packet_type_idx(output, type, audio_idx);
-	return (idx != -1) ? &output->interleaved_packets.array[idx] : NULL;
-}
-
-static inline struct encoder_packet *find_last_packet_type(struct obs_output *output, enum obs_encoder_type type,
-							   size_t audio_idx)
-{
-	int idx = find_last_packet_type_idx(output, type, audio_idx);
-	return (idx != -1) ? &output->interleaved_packets.array[idx] : NULL;
-}
-
 static bool get_audio_and_video_packets(struct obs_output *output, struct encoder_packet **video,
 					struct encoder_packet **audio)
 {
@@ -2000,7 +2009,7 @@ static bool initialize_interleaved_packets(struct obs_output *output)
 	struct encoder_packet *video[MAX_OUTPUT_VIDEO_ENCODERS] = {0};
 	struct encoder_packet *audio[MAX_OUTPUT_AUDIO_ENCODERS] = {0};
 	struct encoder_packet *last_audio[MAX_OUTPUT_AUDIO_ENCODERS] = {0};
-	size_t start_idx;
+	struct encoder_packet *start;
 	size_t first_audio_idx;
 	size_t first_video_idx;
 
@@ -2029,9 +2038,9 @@ static bool initialize_interleaved_packets(struct obs_output *output)
 	}
 
 	/* clear out excess starting audio if it hasn't been already */
-	start_idx = get_interleaved_start_idx(output);
-	if (start_idx) {
-		discard_to_idx(output, start_idx);
+	start = get_interleaved_start(output);
+	if (start != obs_interleaver_peek(&output->interleaver)) {
+		discard_to_packet(output, start, false);
 		if (!get_audio_and_video_packets(output, video, audio))
 			return false;
 	}
@@ -2062,67 +2071,35 @@ static bool initialize_interleaved_packets(struct obs_output *output)
 	output->highest_audio_ts -= audio[first_audio_idx]->dts_usec;
 
 	/* apply new offsets to all existing packet DTS/PTS values */
-	for (size_t i = 0; i < output->interleaved_packets.num; i++) {
-		struct encoder_packet *packet = &output->interleaved_packets.array[i];
-		apply_interleaved_packet_offset(output, packet, NULL);
-	}
-
-	return true;
-}
-
-static inline void insert_interleaved_packet(struct obs_output *output, struct encoder_packet *out)
-{
-	size_t idx;
-	for (idx = 0; idx < output->interleaved_packets.num; idx++) {
-		struct encoder_packet *cur_packet;
-		cur_packet = output->interleaved_packets.array + idx;
-
-		// sort video packets with same DTS by track index,
-		// to prevent the pruning logic from removing additional
-		// video tracks
-		if (out->dts_usec == cur_packet->dts_usec && out->type == OBS_ENCODER_VIDEO &&
-		    cur_packet->type == OBS_ENCODER_VIDEO && out->track_idx > cur_packet->track_idx)
-			continue;
+	for (size_t i = 0; i < output->interleaver.heap_size; i++) {
+		struct obs_interleave_track *track = output->interleaver.heap[i];
+		size_t count = obs_interleave_track_count(track);
 
-		if (out->dts_usec == cur_packet->dts_usec && out->type == OBS_ENCODER_VIDEO) {
-			break;
-		} else if (out->dts_usec < cur_packet->dts_usec) {
-			break;
-		}
+		for (size_t j = 0; j < count; j++)
+			apply_interleaved_packet_offset(output, obs_interleave_track_packet(track, j), NULL);
 	}
 
-	da_insert(output->interleaved_packets, idx, out);
+	return true;
 }
 
 static void resort_interleaved_packets(struct obs_output *output)
 {
-	DARRAY(struct encoder_packet) old_array;
-
-	old_array.da = output->interleaved_packets.da;
-	memset(&output->interleaved_packets, 0, sizeof(output->interleaved_packets));
-
-	for (size_t i = 0; i < old_array.num; i++) {
-		set_higher_ts(output, &old_array.array[i]);
+	/* packets of a track are sorted, so its last one has the highest ts */
+	for (size_t i = 0; i < output->interleaver.heap_size; i++)
+		set_higher_ts(output, obs_interleave_track_last(output->interleaver.heap[i]));
 
-		insert_interleaved_packet(output, &old_array.array[i]);
-	}
-
-	da_free(old_array);
+	obs_interleaver_reorder(&output->interleaver);
 }
 
 static void discard_unused_audio_packets(struct obs_output *output, int64_t dts_usec)
 {
-	size_t idx = 0;
+	struct encoder_packet *next;
 
-	for (; idx < output->interleaved_packets.num; idx++) {
-		struct encoder_packet *p = &output->interleaved_packets.array[idx];
-
-		if (p->dts_usec >= dts_usec)
-			break;
+	while ((next = obs_interleaver_peek(&output->interleaver)) != NULL && next->dts_usec < dts_usec) {
+		struct encoder_packet packet;
+		obs_interleaver_pop(&output->interleaver, &packet);
+		discard_packet(output, &packet);
 	}
-
-	if (idx)
-		discard_to_idx(output, idx);
 }
 
 static bool purge_encoder_group_keyframe_data(obs_output_t *output, size_t idx)
@@ -2201,22 +2178,45 @@ static void apply_ept_offsets(struct obs_output *output)
 	}
 }
 
-static inline size_t count_streamable_frames(struct obs_output *output)
+/* first packet of the track that doesn't have packets of the opposing type
+ * with a higher timestamp */
+static struct encoder_packet *find_first_unstreamable(struct obs_output *output, struct obs_interleave_track *track)
 {
-	size_t eligible = 0;
+	size_t lo = 0;
+	size_t hi = obs_interleave_track_count(track);
 
-	for (size_t idx = 0; idx < output->interleaved_packets.num; idx++) {
-		struct encoder_packet *pkt = &output->interleaved_packets.array[idx];
+	while (lo < hi) {
+		size_t mid = lo + (hi - lo) / 2;
 
-		/* Only count an interleaved packet as streamable if there are packets of the opposing type and of a
-		 * higher timestamp in the interleave buffer. This ensures that the timestamps are monotonic. */
-		if (!has_higher_opposing_ts(output, pkt))
-			break;
+		if (has_higher_opposing_ts(output, obs_interleave_track_packet(track, mid)))
+			lo = mid + 1;
+		else
+			hi = mid;
+	}
+
+	return obs_interleave_track_packet(track, lo);
+}
 
-		eligible++;
+static inline size_t count_streamable_frames(struct obs_output *output)
+{
+	struct encoder_packet *first_unstreamable = NULL;
+
+	/* Only count an interleaved packet as streamable if there are packets of the opposing type and of a
+	 * higher timestamp in the interleave buffer. This ensures that the timestamps are monotonic.
+	 *
+	 * Within a track that holds for a prefix of its packets, so the streamable packets are the ones ordered
+	 * before the earliest packet of any track that doesn't. */
+	for (size_t i = 0; i < output->interleaver.heap_size; i++) {
+		struct encoder_packet *packet = find_first_unstreamable(output, output->interleaver.heap[i]);
+
+		if (packet && (!first_unstreamable || obs_interleave_packet_before(packet, first_unstreamable)))
+			first_unstreamable = packet;
 	}
 
-	return eligible;
+	if (!first_unstreamable)
+		return output->interleaver.num_packets;
+
+	return obs_interleaver_count_before(&output->interleaver, first_unstreamable);
 }
 
 static void interleave_packets(void *data, struct encoder_packet *packet, struct encoder_packet_time *packet_time)
@@ -2269,7 +2269,7 @@ static void interleave_packets(void *data, struct encoder_packet *packet, struct
 	else
 		check_received(output, packet);
 
-	insert_interleaved_packet(output, &out);
+	obs_interleaver_push(&output->interleaver, &out);
 
 	received_video = true;
 	for (size_t i = 0; i < MAX_OUTPUT_VIDEO_ENCODERS; i++) {
@@ -2509,6 +2509,9 @@ static void hook_data_capture(struct obs_output *output)
 			     "Output '%s': %" PRIu32 " second delay "
 			     "active, preserve on disconnect is %s",
 			     output->context.name, output->delay_sec, preserve_active(output) ? "on" : "off");
+			if (output->delay_spill_path)
+				blog(LOG_INFO, "Output '%s': spilling delayed packets to '%s'", output->context.name,
+				     output->delay_spill_path);
 		}
 
 		if (has_audio)
@@ -19,6 +19,7 @@
 #include "util/threading.h"
 #include "util/util_uint64.h"
 #include "graphics/math-defs.h"
+#include "media-io/audio-mix.h"
 #include "obs-scene.h"
 #include "obs-internal.h"
 
@@ -291,6 +292,14 @@ static void scene_enum_all_sources(void *data, obs_source_enum_proc_t enum_callb
 	scene_enum_sources(data, enum_callback, param, false);
 }
 
+/* scenes are saved with their items, any change to an item is a change to
+ * the scene */
+static inline void item_changed(struct obs_scene_item *item)
+{
+	if (item->parent)
+		obs_source_changed(item->parent->source);
+}
+
 static inline void detach_sceneitem(struct obs_scene_item *item)
 {
 	if (item->prev)
@@ -301,6 +310,7 @@ static inline void detach_sceneitem(struct obs_scene_item *item)
 	if (item->next)
 		item->next->prev = item->prev;
 
+	item_changed(item);
 	item->parent = NULL;
 }
 
@@ -320,6 +330,8 @@ static inline void attach_sceneitem(struct obs_scene *parent, struct obs_scene_i
 			parent->first_item->prev = item;
 		parent->first_item = item;
 	}
+
+	item_changed(item);
 }
 
 void add_alignment(struct vec2 *v, uint32_t align, int cx, int cy)
@@ -695,6 +707,8 @@ static void update_item_transform(struct obs_scene_item *item, bool update_tex)
 
 	/* ----------------------- */
 
+	item_changed(item);
+
 	calldata_init_fixed(&params, stack, sizeof(stack));
 	calldata_set_ptr(&params, "item", item);
 	signal_parent(item->parent, "item_transform", &params);
@@ -1589,25 +1603,14 @@ static void process_all_audio_actions(struct obs_scene_item *item, size_t sample
 		;
 }
 
-static void mix_audio_with_buf(float *p_out, float *p_in, float *buf_in, size_t pos, size_t count)
+static inline void mix_audio_with_buf(float *p_out, float *p_in, float *buf_in, size_t pos, size_t count)
 {
-	register float *out = p_out + pos;
-	register float *buf = buf_in;
-	register float *in = p_in;
-	register float *end = in + count;
-
-	while (in < end)
-		*(out++) += *(in++) * *(buf++);
+	audio_mix_add_mul(p_out + pos, p_in, buf_in, count);
 }
 
 static inline void mix_audio(float *p_out, float *p_in, size_t pos, size_t count)
 {
-	register float *out = p_out + pos;
-	register float *in = p_in;
-	register float *end = in + count;
-
-	while (in < end)
-		*(out++) += *(in++);
+	audio_mix_add(p_out + pos, p_in, count);
 }
 
 static bool scene_audio_render(void *data, uint64_t *ts_out, struct obs_source_audio_mix *audio_output, uint32_t mixers,
@@ -2242,6 +2245,9 @@ static void sceneitem_renamed(void *param, calldata_t *data)
 	const char *name = calldata_string(data, "new_name");
 
 	sceneitem_rename_hotkey(scene_item, name);
+
+	/* items are saved with the name of their source */
+	item_changed(scene_item);
 }
 
 static inline bool source_has_audio(obs_source_t *source)
@@ -2627,11 +2633,17 @@ void obs_scene_load_transform_states(const char *data)
 {
 	obs_data_t *dat = obs_data_create_from_json(data);
 
-	obs_data_array_t *scenes_and_groups = obs_data_get_array(dat, "scenes_and_groups");
+	obs_scene_load_transform_states_data(dat);
+
+	obs_data_release(dat);
+}
+
+void obs_scene_load_transform_states_data(obs_data_t *states)
+{
+	obs_data_array_t *scenes_and_groups = obs_data_get_array(states, "scenes_and_groups");
 
 	obs_data_array_enum(scenes_and_groups, iterate_scenes_and_groups_transform_states, NULL);
 
-	obs_data_release(dat);
 	obs_data_array_release(scenes_and_groups);
 }
 
@@ -2659,6 +2671,7 @@ bool obs_sceneitem_selected(const obs_sceneitem_t *item)
 
 #define do_update_transform(item)                                          \
 	do {                                                               \
+		item_changed(item);                                        \
 		if (!item->parent || item->parent->is_group)               \
 			os_atomic_set_bool(&item->update_transform, true); \
 		else                                                       \
@@ -2712,6 +2725,7 @@ static inline void signal_reorder(struct obs_scene_item *item)
 	uint8_t stack[128];
 
 	command = "reorder";
+	item_changed(item);
 
 	calldata_init_fixed(&params, stack, sizeof(stack));
 	signal_parent(item->parent, command, &params);
@@ -2724,6 +2738,7 @@ static inline void signal_refresh(obs_scene_t *scene)
 	uint8_t stack[128];
 
 	command = "refresh";
+	obs_source_changed(scene->source);
 
 	calldata_init_fixed(&params, stack, sizeof(stack));
 	signal_parent(scene, command, &params);
@@ -3030,6 +3045,7 @@ bool obs_sceneitem_set_visible(obs_sceneitem_t *item, bool visible)
 		obs_sceneitem_group_enum_items(item, group_item_transition, &visible);
 
 	item->user_visible = visible;
+	item_changed(item);
 
 	if (visible) {
 		if (os_atomic_inc_long(&item->active_refs) == 1) {
@@ -3076,6 +3092,7 @@ bool obs_sceneitem_set_locked(obs_sceneitem_t *item, bool lock)
 		return false;
 
 	item->locked = lock;
+	item_changed(item);
 
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "item", item);
@@ -3193,6 +3210,7 @@ void obs_sceneitem_set_crop(obs_sceneitem_t *item, const struct obs_sceneitem_cr
 	if (item->crop.bottom < 0)
 		item->crop.bottom = 0;
 
+	item_changed(item);
 	os_atomic_set_bool(&item->update_transform, true);
 }
 
@@ -3212,6 +3230,7 @@ void obs_sceneitem_set_scale_filter(obs_sceneitem_t *item, enum obs_scale_type f
 		return;
 
 	item->scale_filter = filter;
+	item_changed(item);
 
 	os_atomic_set_bool(&item->update_transform, true);
 }
@@ -3227,6 +3246,7 @@ void obs_sceneitem_set_blending_method(obs_sceneitem_t *item, enum obs_blending_
 		return;
 
 	item->blend_method = method;
+	item_changed(item);
 }
 
 enum obs_blending_method obs_sceneitem_get_blending_method(obs_sceneitem_t *item)
@@ -3240,6 +3260,7 @@ void obs_sceneitem_set_blending_mode(obs_sceneitem_t *item, enum obs_blending_ty
 		return;
 
 	item->blend_type = type;
+	item_changed(item);
 
 	os_atomic_set_bool(&item->update_transform, true);
 }
@@ -3294,6 +3315,7 @@ int64_t obs_sceneitem_get_id(const obs_sceneitem_t *item)
 void obs_sceneitem_set_id(obs_sceneitem_t *item, int64_t id)
 {
 	item->id = id;
+	item_changed(item);
 }
 
 obs_data_t *obs_sceneitem_get_private_settings(obs_sceneitem_t *item)
@@ -3921,6 +3943,7 @@ bool obs_scene_reorder_items2(obs_scene_t *scene, struct obs_sceneitem_order_inf
 			}
 
 			resize_group(info->item, false);
+			obs_source_changed(sub_scene->source);
 			full_unlock(sub_scene);
 			obs_scene_release(sub_scene);
 		}
@@ -4012,6 +4035,7 @@ void obs_sceneitem_set_transition(obs_sceneitem_t *item, bool show, obs_source_t
 	if (*target)
 		obs_source_release(*target);
 	*target = obs_source_get_ref(transition);
+	item_changed(item);
 }
 
 obs_source_t *obs_sceneitem_get_transition(obs_sceneitem_t *item, bool show)
@@ -4030,6 +4054,7 @@ void obs_sceneitem_set_transition_duration(obs_sceneitem_t *item, bool show, uin
 		item->show_transition_duration = duration_ms;
 	else
 		item->hide_transition_duration = duration_ms;
+	item_changed(item);
 }
 
 uint32_t obs_sceneitem_get_transition_duration(obs_sceneitem_t *item, bool show)
@@ -4119,9 +4144,7 @@ obs_data_t *obs_sceneitem_transition_save(struct obs_scene_item *item, bool show
 		obs_data_set_string(data, "id", obs_source_get_unversioned_id(transition));
 		obs_data_set_string(data, "versioned_id", obs_source_get_id(transition));
 		obs_data_set_string(data, "name", obs_source_get_name(transition));
-		obs_data_t *s = obs_source_get_settings(transition);
-		obs_data_set_obj(data, "transition", s);
-		obs_data_release(s);
+		obs_data_set_obj(data, "transition", transition->context.settings);
 	}
 	obs_data_set_int(data, "duration", show ? item->show_transition_duration : item->hide_transition_duration);
 	return data;
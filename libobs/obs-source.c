@@ -700,7 +700,7 @@ void obs_source_frame_init(struct obs_source_frame *frame, enum video_format for
 static inline void obs_source_frame_decref(struct obs_source_frame *frame)
 {
 	if (os_atomic_dec_long(&frame->refs) == 0)
-		obs_source_frame_destroy(frame);
+		obs_frame_pool_release(obs->data.frame_pool, frame);
 }
 
 static bool obs_source_filter_remove_refless(obs_source_t *source, obs_source_t *filter);
@@ -1072,6 +1072,8 @@ void obs_source_update(obs_source_t *source, obs_data_t *settings)
 		obs_data_apply(source->context.settings, settings);
 	}
 
+	obs_source_changed(source);
+
 	if (source->info.output_flags & OBS_SOURCE_VIDEO) {
 		os_atomic_inc_long(&source->defer_update_count);
 	} else if (source->context.data && source->info.update) {
@@ -3108,6 +3110,8 @@ void obs_source_filter_add(obs_source_t *source, obs_source_t *filter)
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_changed(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3145,6 +3149,8 @@ static bool obs_source_filter_remove_refless(obs_source_t *source, obs_source_t
 
 	pthread_mutex_unlock(&source->filter_mutex);
 
+	obs_source_changed(source);
+
 	calldata_init_fixed(&cd, stack, sizeof(stack));
 	calldata_set_ptr(&cd, "source", source);
 	calldata_set_ptr(&cd, "filter", filter);
@@ -3270,8 +3276,10 @@ void obs_source_filter_set_order(obs_source_t *source, obs_source_t *filter, enu
 	success = move_filter_dir(source, filter, movement);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_changed(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 int obs_source_filter_get_index(obs_source_t *source, obs_source_t *filter)
@@ -3315,8 +3323,10 @@ void obs_source_filter_set_index(obs_source_t *source, obs_source_t *filter, siz
 	success = set_filter_index(source, filter, index);
 	pthread_mutex_unlock(&source->filter_mutex);
 
-	if (success)
+	if (success) {
+		obs_source_changed(source);
 		obs_source_dosignal(source, NULL, "reorder_filters");
+	}
 }
 
 obs_data_t *obs_source_get_settings(const obs_source_t *source)
@@ -3493,7 +3503,7 @@ static void clean_cache(obs_source_t *source)
 		struct async_frame *af = &source->async_cache.array[i - 1];
 		if (!af->used) {
 			if (++af->unused_count == MAX_UNUSED_FRAME_DURATION) {
-				obs_source_frame_destroy(af->frame);
+				obs_frame_pool_release(obs->data.frame_pool, af->frame);
 				da_erase(source->async_cache, i - 1);
 			}
 		}
@@ -3501,7 +3511,7 @@ static void clean_cache(obs_source_t *source)
 }
 
 #define MAX_ASYNC_FRAMES 30
-//if return value is not null then do (os_atomic_dec_long(&output->refs) == 0) && obs_source_frame_destroy(output)
+//if return value is not null then do (os_atomic_dec_long(&output->refs) == 0) && obs_frame_pool_release(output)
 static inline struct obs_source_frame *cache_video(struct obs_source *source, const struct obs_source_frame *frame)
 {
 	struct obs_source_frame *new_frame = NULL;
@@ -3542,7 +3552,7 @@ static inline struct obs_source_frame *cache_video(struct obs_source *source, co
 	if (!new_frame) {
 		struct async_frame new_af;
 
-		new_frame = obs_source_frame_create(format, frame->width, frame->height);
+		new_frame = obs_frame_pool_get(obs->data.frame_pool, format, frame->width, frame->height);
 		new_af.frame = new_frame;
 		new_af.used = true;
 		new_af.unused_count = 0;
@@ -3582,7 +3592,7 @@ static void obs_source_output_video_internal(obs_source_t *source, const struct
 	pthread_mutex_lock(&source->async_mutex);
 	if (output) {
 		if (os_atomic_dec_long(&output->refs) == 0) {
-			obs_source_frame_destroy(output);
+			obs_frame_pool_release(obs->data.frame_pool, output);
 			output = NULL;
 		} else {
 			da_push_back(source->async_frames, &output);
@@ -4228,7 +4238,7 @@ void obs_source_release_frame(obs_source_t *source, struct obs_source_frame *fra
 		pthread_mutex_lock(&source->async_mutex);
 
 		if (os_atomic_dec_long(&frame->refs) == 0)
-			obs_source_frame_destroy(frame);
+			obs_frame_pool_release(obs->data.frame_pool, frame);
 		else
 			remove_async_frame(source, frame);
 
@@ -4274,6 +4284,8 @@ void obs_source_set_name(obs_source_t *source, const char *name)
 			calldata_free(&data);
 			bfree(prev_name);
 		}
+
+		obs_source_changed(source);
 	}
 }
 
@@ -4535,6 +4547,7 @@ void obs_source_set_volume(obs_source_t *source, float volume)
 		pthread_mutex_unlock(&source->audio_actions_mutex);
 
 		source->user_volume = volume;
+		obs_source_changed(source);
 	}
 }
 
@@ -4556,6 +4569,7 @@ void obs_source_set_sync_offset(obs_source_t *source, int64_t offset)
 		signal_handler_signal(source->context.signals, "audio_sync", &data);
 
 		source->sync_offset = calldata_int(&data, "offset");
+		obs_source_changed(source);
 	}
 }
 
@@ -4740,8 +4754,46 @@ void obs_source_save(obs_source_t *source)
 
 	obs_source_dosignal(source, "source_save", "save");
 
-	if (source->info.save)
+	if (source->info.save) {
+		/* state only written out here counts as a change when the
+		 * settings come out different, scenes track changes to their
+		 * items themselves */
+		bool track = source->info.type != OBS_SOURCE_TYPE_SCENE;
+		size_t old_size = 0;
+		size_t new_size = 0;
+		uint8_t *old_data = NULL;
+		uint8_t *new_data = NULL;
+
+		if (track)
+			old_data = obs_data_get_binary(source->context.settings, &old_size);
+
 		source->info.save(source->context.data, source->context.settings);
+
+		if (track) {
+			new_data = obs_data_get_binary(source->context.settings, &new_size);
+			if (!old_data || !new_data || old_size != new_size || memcmp(old_data, new_data, new_size) != 0)
+				obs_source_changed(source);
+
+			bfree(old_data);
+			bfree(new_data);
+		}
+	}
+}
+
+void obs_source_mark_changed(obs_source_t *source)
+{
+	if (!obs_source_valid(source, "obs_source_mark_changed"))
+		return;
+
+	obs_source_changed(source);
+}
+
+long obs_source_get_save_revision(const obs_source_t *source)
+{
+	if (!obs_source_valid(source, "obs_source_get_save_revision"))
+		return 0;
+
+	return os_atomic_load_long(&source->save_revision);
 }
 
 void obs_source_load(obs_source_t *source)
@@ -4796,6 +4848,7 @@ void obs_source_set_flags(obs_source_t *source, uint32_t flags)
 
 	if (flags != source->flags) {
 		source->flags = flags;
+		obs_source_changed(source);
 		signal_flags_updated(source);
 	}
 }
@@ -4835,6 +4888,7 @@ void obs_source_set_audio_mixers(obs_source_t *source, uint32_t mixers)
 	mixers = (uint32_t)calldata_int(&data, "mixers");
 
 	source->audio_mixers = mixers;
+	obs_source_changed(source);
 }
 
 uint32_t obs_source_get_audio_mixers(const obs_source_t *source)
@@ -5014,6 +5068,7 @@ void obs_source_set_enabled(obs_source_t *source, bool enabled)
 		return;
 
 	source->enabled = enabled;
+	obs_source_changed(source);
 
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
@@ -5037,6 +5092,7 @@ void obs_source_set_muted(obs_source_t *source, bool muted)
 		return;
 
 	source->user_muted = muted;
+	obs_source_changed(source);
 
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
@@ -5054,6 +5110,8 @@ static void source_signal_push_to_changed(obs_source_t *source, const char *sign
 	struct calldata data;
 	uint8_t stack[128];
 
+	obs_source_changed(source);
+
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
 	calldata_set_bool(&data, "enabled", enabled);
@@ -5066,6 +5124,8 @@ static void source_signal_push_to_delay(obs_source_t *source, const char *signal
 	struct calldata data;
 	uint8_t stack[128];
 
+	obs_source_changed(source);
+
 	calldata_init_fixed(&data, stack, sizeof(stack));
 	calldata_set_ptr(&data, "source", source);
 	calldata_set_int(&data, "delay", delay);
@@ -5587,6 +5647,7 @@ void obs_source_set_monitoring_type(obs_source_t *source, enum obs_monitoring_ty
 	}
 
 	source->monitoring_type = type;
+	obs_source_changed(source);
 }
 
 enum obs_monitoring_type obs_source_get_monitoring_type(const obs_source_t *source)
@@ -5670,6 +5731,7 @@ void obs_source_set_balance_value(obs_source_t *source, float balance)
 		signal_handler_signal(source->context.signals, "audio_balance", &data);
 
 		source->balance = (float)calldata_float(&data, "balance");
+		obs_source_changed(source);
 	}
 }
 
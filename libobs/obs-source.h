@@ -208,6 +208,12 @@ enum obs_media_state {
  */
 #define OBS_SOURCE_REQUIRES_CANVAS (1 << 17)
 
+/**
+ * Source type can be created (and updated from its settings) on a worker
+ * thread while a scene collection is loaded
+ */
+#define OBS_SOURCE_PARALLEL_CREATE (1 << 18)
+
 /** @} */
 
 typedef void (*obs_source_enum_proc_t)(obs_source_t *parent, obs_source_t *child, void *param);
@@ -29,6 +29,7 @@ static void *gpu_encode_thread(void *data)
 	da_init(encoders);
 
 	os_set_thread_name("obs gpu encode thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_GPU_ENCODE);
 	const char *gpu_encode_thread_name = profile_store_name(
 		obs_get_profiler_name_store(), "obs_gpu_encode_thread(%g" NBSP "ms)", interval / 1000000.);
 	profile_register_root(gpu_encode_thread_name, interval);
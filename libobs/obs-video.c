@@ -1174,6 +1174,7 @@ void *obs_graphics_thread(void *param)
 	obs->video.video_time = os_gettime_ns();
 
 	os_set_thread_name("libobs: graphics thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_GRAPHICS);
 
 	const char *video_thread_name = profile_store_name(obs_get_profiler_name_store(),
 							   "obs_graphics_thread(%g" NBSP "ms)", interval / 1000000.);
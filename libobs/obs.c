@@ -947,9 +947,14 @@ static void obs_free_audio(void)
 	if (audio->audio)
 		audio_output_close(audio->audio);
 
+	log_audio_tick_stats(audio);
+	os_task_pool_destroy(audio->mix_pool);
+
 	deque_free(&audio->buffered_timestamps);
 	da_free(audio->render_order);
 	da_free(audio->root_nodes);
+	da_free(audio->parallel_sources);
+	da_free(audio->mix_jobs);
 
 	da_free(audio->monitors);
 	bfree(audio->monitoring_device_name);
@@ -992,6 +997,7 @@ static bool obs_init_data(void)
 	data->canvases = NULL;
 	data->named_canvases = NULL;
 	data->private_data = obs_data_create();
+	data->frame_pool = obs_frame_pool_create();
 	data->valid = true;
 
 fail:
@@ -1068,6 +1074,8 @@ static void obs_free_data(void)
 	da_free(data->rendered_callbacks);
 	da_free(data->tick_callbacks);
 	obs_data_release(data->private_data);
+	obs_frame_pool_destroy(data->frame_pool);
+	data->frame_pool = NULL;
 
 	for (size_t i = 0; i < data->protocols.num; i++)
 		bfree(data->protocols.array[i]);
@@ -1227,6 +1235,7 @@ static bool obs_init(const char *locale, const char *module_config_path, profile
 	pthread_mutex_init_value(&obs->video.task_mutex);
 	pthread_mutex_init_value(&obs->video.encoder_group_mutex);
 	pthread_mutex_init_value(&obs->video.mixes_mutex);
+	pthread_mutex_init_value(&obs->thread_roles_mutex);
 
 	obs->name_store_owned = !store;
 	obs->name_store = store ? store : profiler_name_store_create();
@@ -1237,6 +1246,8 @@ static bool obs_init(const char *locale, const char *module_config_path, profile
 
 	log_system_info();
 
+	if (pthread_mutex_init(&obs->thread_roles_mutex, NULL) != 0)
+		return false;
 	if (!obs_init_data())
 		return false;
 	if (!obs_init_handlers())
@@ -1402,6 +1413,7 @@ void obs_shutdown(void)
 	FREE_REGISTERED_TYPES(obs_output_info, obs->output_types);
 	FREE_REGISTERED_TYPES(obs_encoder_info, obs->encoder_types);
 	FREE_REGISTERED_TYPES(obs_service_info, obs->service_types);
+	FREE_REGISTERED_TYPES(obs_bitrate_policy_info, obs->bitrate_policy_types);
 
 #undef FREE_REGISTERED_TYPES
 
@@ -1460,6 +1472,11 @@ void obs_shutdown(void)
 	}
 	da_free(obs->core_modules);
 
+	for (size_t i = 0; i < obs->thread_roles.num; i++)
+		bfree(obs->thread_roles.array[i].name);
+	da_free(obs->thread_roles);
+	pthread_mutex_destroy(&obs->thread_roles_mutex);
+
 	if (obs->name_store_owned)
 		profiler_name_store_free(obs->name_store);
 
@@ -1633,9 +1650,11 @@ bool obs_reset_audio2(const struct obs_audio_info2 *oai)
 	     "\tsamples per sec: %d\n"
 	     "\tspeakers:        %d\n"
 	     "\tmax buffering:   %d milliseconds\n"
-	     "\tbuffering type:  %s",
+	     "\tbuffering type:  %s\n"
+	     "\tparallel mixing: %s",
 	     (int)ai.samples_per_sec, (int)ai.speakers, max_buffering_ms,
-	     oai->fixed_buffering ? "fixed" : "dynamically increasing");
+	     oai->fixed_buffering ? "fixed" : "dynamically increasing",
+	     os_atomic_load_bool(&obs->parallel_audio_mixing) ? "enabled" : "disabled");
 
 	return obs_init_audio(&ai);
 }
@@ -1712,6 +1731,140 @@ bool obs_get_audio_info2(struct obs_audio_info2 *oai2)
 	}
 }
 
+void obs_set_parallel_audio_mixing(bool enable)
+{
+	if (!obs)
+		return;
+
+	os_atomic_set_bool(&obs->parallel_audio_mixing, enable);
+}
+
+bool obs_get_parallel_audio_mixing(void)
+{
+	return obs ? os_atomic_load_bool(&obs->parallel_audio_mixing) : false;
+}
+
+static struct obs_thread_role *find_thread_role(const char *role)
+{
+	for (size_t i = 0; i < obs->thread_roles.num; i++) {
+		struct obs_thread_role *info = &obs->thread_roles.array[i];
+		if (strcmp(info->name, role) == 0)
+			return info;
+	}
+
+	return NULL;
+}
+
+void obs_set_thread_config(const char *role, const struct obs_thread_config *config)
+{
+	if (!obs || !role)
+		return;
+
+	pthread_mutex_lock(&obs->thread_roles_mutex);
+
+	struct obs_thread_role *info = find_thread_role(role);
+	if (!config) {
+		if (info) {
+			bfree(info->name);
+			da_erase_item(obs->thread_roles, info);
+		}
+	} else {
+		if (!info) {
+			info = da_push_back_new(obs->thread_roles);
+			info->name = bstrdup(role);
+		}
+		info->config = *config;
+		memset(&info->status, 0, sizeof(info->status));
+	}
+
+	pthread_mutex_unlock(&obs->thread_roles_mutex);
+}
+
+bool obs_get_thread_config(const char *role, struct obs_thread_config *config)
+{
+	bool found = false;
+
+	if (!obs || !role || !config)
+		return false;
+
+	pthread_mutex_lock(&obs->thread_roles_mutex);
+	struct obs_thread_role *info = find_thread_role(role);
+	if (info) {
+		*config = info->config;
+		found = true;
+	}
+	pthread_mutex_unlock(&obs->thread_roles_mutex);
+
+	return found;
+}
+
+bool obs_get_thread_status(const char *role, struct obs_thread_status *status)
+{
+	bool found = false;
+
+	if (!obs || !role || !status)
+		return false;
+
+	pthread_mutex_lock(&obs->thread_roles_mutex);
+	struct obs_thread_role *info = find_thread_role(role);
+	if (info) {
+		*status = info->status;
+		found = true;
+	}
+	pthread_mutex_unlock(&obs->thread_roles_mutex);
+
+	return found;
+}
+
+static const char *thread_policy_name(enum obs_thread_policy policy)
+{
+	switch (policy) {
+	case OBS_THREAD_POLICY_FIFO:
+		return "FIFO";
+	case OBS_THREAD_POLICY_RR:
+		return "RR";
+	case OBS_THREAD_POLICY_DEFAULT:
+		break;
+	}
+
+	return "default";
+}
+
+void obs_apply_thread_config(const char *role)
+{
+	struct obs_thread_config config;
+	enum os_thread_policy os_policy = OS_THREAD_POLICY_DEFAULT;
+	int priority = 0;
+	uint64_t affinity = 0;
+
+	if (!obs_get_thread_config(role, &config))
+		return;
+
+	bool policy_set = os_set_thread_policy((enum os_thread_policy)config.policy, config.priority);
+	bool affinity_set = os_set_thread_affinity(config.affinity);
+
+	os_get_thread_policy(&os_policy, &priority);
+	os_get_thread_affinity(&affinity);
+
+	pthread_mutex_lock(&obs->thread_roles_mutex);
+	struct obs_thread_role *info = find_thread_role(role);
+	if (info) {
+		info->status.threads++;
+		if (!policy_set || !affinity_set)
+			info->status.failed++;
+		info->status.policy = (enum obs_thread_policy)os_policy;
+		info->status.priority = priority;
+		info->status.affinity = affinity;
+	}
+	pthread_mutex_unlock(&obs->thread_roles_mutex);
+
+	blog(policy_set && affinity_set ? LOG_INFO : LOG_WARNING,
+	     "Thread role '%s': requested %s/%d on CPUs 0x%" PRIx64 ", got %s/%d on CPUs 0x%" PRIx64 "%s%s", role,
+	     thread_policy_name(config.policy), config.priority, config.affinity,
+	     thread_policy_name((enum obs_thread_policy)os_policy), priority, affinity,
+	     policy_set ? "" : " (policy refused)", affinity_set ? "" : " (affinity refused)");
+}
+
 bool obs_enum_source_types(size_t idx, const char **id)
 {
 	if (idx >= obs->source_types.num)
@@ -2392,30 +2545,388 @@ obs_source_t *obs_load_private_source(obs_data_t *source_data)
 	return obs_load_source_type(source_data, true);
 }
 
-void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *private_data)
+static obs_source_load_progress_callback_t source_load_progress_callback = NULL;
+static void *source_load_progress_param = NULL;
+
+void obs_set_source_load_progress_callback(obs_source_load_progress_callback_t callback, void *param)
+{
+	source_load_progress_callback = callback;
+	source_load_progress_param = param;
+}
+
+static inline void report_source_load_progress(enum obs_source_load_phase phase, size_t processed, size_t total,
+					       uint64_t start_time)
 {
-	DARRAY(obs_source_t *) sources;
+	if (source_load_progress_callback)
+		source_load_progress_callback(source_load_progress_param, phase, processed, total,
+					      os_gettime_ns() - start_time);
+}
+
+#define MAX_SOURCE_LOAD_THREADS 8
+
+struct source_load_node {
+	obs_data_t *data;
+	obs_source_t *source;
+	bool parallel;
+	bool dispatched;
+
+	/* scenes wait for the sources they contain */
+	size_t deps_left;
+	DARRAY(size_t) dependents;
+};
+
+struct source_load_key {
+	const char *key;
+	size_t idx;
+};
+
+struct source_loader {
+	struct source_load_node *nodes;
 	size_t count;
-	size_t i;
+	size_t created;
+	size_t created_in_parallel;
+	uint64_t start_time;
+
+	/* nodes that are ready but have to be created on this thread */
+	struct deque ready;
+
+	/* worker threads, work and done are protected by the mutex */
+	DARRAY(pthread_t) threads;
+	pthread_mutex_t mutex;
+	os_sem_t *work_sem;
+	os_sem_t *done_sem;
+	struct deque work;
+	struct deque done;
+	size_t in_flight;
+};
+
+static bool source_type_can_create_in_parallel(obs_data_t *source_data)
+{
+	const char *id = obs_data_get_string(source_data, "id");
+	const char *v_id = obs_data_get_string(source_data, "versioned_id");
+	const struct obs_source_info *info = get_source_info(*v_id ? v_id : id);
+
+	return info && (info->output_flags & OBS_SOURCE_PARALLEL_CREATE) != 0;
+}
+
+/* filters are created together with their parent, so they have to allow it
+ * as well */
+static bool can_create_in_parallel(obs_data_t *source_data)
+{
+	obs_data_array_t *filters;
+	bool parallel;
+
+	if (!source_type_can_create_in_parallel(source_data))
+		return false;
+
+	filters = obs_data_get_array(source_data, "filters");
+	parallel = true;
+
+	for (size_t i = 0; parallel && i < obs_data_array_count(filters); i++) {
+		obs_data_t *filter_data = obs_data_array_item(filters, i);
+		parallel = source_type_can_create_in_parallel(filter_data);
+		obs_data_release(filter_data);
+	}
+
+	obs_data_array_release(filters);
+	return parallel;
+}
 
-	da_init(sources);
+static int cmp_source_load_key(const void *a, const void *b)
+{
+	const struct source_load_key *key_a = a;
+	const struct source_load_key *key_b = b;
+	return strcmp(key_a->key, key_b->key);
+}
 
-	count = obs_data_array_count(array);
-	da_reserve(sources, count);
+static size_t find_source_load_key(const struct source_load_key *keys, size_t num, const char *key)
+{
+	struct source_load_key search = {key, 0};
+	struct source_load_key *found;
 
-	for (i = 0; i < count; i++) {
-		obs_data_t *source_data = obs_data_array_item(array, i);
-		obs_source_t *source = obs_load_source(source_data);
+	if (!key || !*key || !num)
+		return DARRAY_INVALID;
 
-		da_push_back(sources, &source);
+	found = bsearch(&search, keys, num, sizeof(*keys), cmp_source_load_key);
+	return found ? found->idx : DARRAY_INVALID;
+}
 
-		obs_data_release(source_data);
+static void build_source_load_graph(struct source_loader *loader)
+{
+	DARRAY(struct source_load_key) names;
+	DARRAY(struct source_load_key) uuids;
+
+	da_init(names);
+	da_init(uuids);
+
+	for (size_t i = 0; i < loader->count; i++) {
+		obs_data_t *data = loader->nodes[i].data;
+		struct source_load_key name = {obs_data_get_string(data, "name"), i};
+		struct source_load_key uuid = {obs_data_get_string(data, "uuid"), i};
+
+		da_push_back(names, &name);
+		if (*uuid.key)
+			da_push_back(uuids, &uuid);
 	}
 
+	qsort(names.array, names.num, sizeof(*names.array), cmp_source_load_key);
+	qsort(uuids.array, uuids.num, sizeof(*uuids.array), cmp_source_load_key);
+
+	for (size_t i = 0; i < loader->count; i++) {
+		struct source_load_node *node = &loader->nodes[i];
+		const char *id = obs_data_get_string(node->data, "id");
+
+		if (!obs_source_type_is_scene(id) && !obs_source_type_is_group(id))
+			continue;
+
+		obs_data_t *settings = obs_data_get_obj(node->data, "settings");
+		obs_data_array_t *items = obs_data_get_array(settings, "items");
+		size_t count = obs_data_array_count(items);
+
+		for (size_t j = 0; j < count; j++) {
+			obs_data_t *item_data = obs_data_array_item(items, j);
+			const char *uuid = obs_data_get_string(item_data, "source_uuid");
+			const char *name = obs_data_get_string(item_data, "name");
+			size_t dep = find_source_load_key(uuids.array, uuids.num, uuid);
+
+			if (dep == DARRAY_INVALID)
+				dep = find_source_load_key(names.array, names.num, name);
+
+			if (dep != DARRAY_INVALID && dep != i) {
+				da_push_back(loader->nodes[dep].dependents, &i);
+				node->deps_left++;
+			}
+
+			obs_data_release(item_data);
+		}
+
+		obs_data_array_release(items);
+		obs_data_release(settings);
+	}
+
+	da_free(names);
+	da_free(uuids);
+}
+
+static void *source_load_thread(void *param)
+{
+	struct source_loader *loader = param;
+
+	os_set_thread_name("libobs: source loader");
+
+	while (os_sem_wait(loader->work_sem) == 0) {
+		size_t idx;
+
+		/* a post without work tells the thread to exit */
+		pthread_mutex_lock(&loader->mutex);
+		if (!loader->work.size) {
+			pthread_mutex_unlock(&loader->mutex);
+			break;
+		}
+		deque_pop_front(&loader->work, &idx, sizeof(idx));
+		pthread_mutex_unlock(&loader->mutex);
+
+		loader->nodes[idx].source = obs_load_source(loader->nodes[idx].data);
+
+		pthread_mutex_lock(&loader->mutex);
+		deque_push_back(&loader->done, &idx, sizeof(idx));
+		pthread_mutex_unlock(&loader->mutex);
+		os_sem_post(loader->done_sem);
+	}
+
+	return NULL;
+}
+
+static void start_source_load_threads(struct source_loader *loader)
+{
+	size_t parallel = 0;
+	size_t num_threads;
+	int cores = os_get_logical_cores();
+
+	for (size_t i = 0; i < loader->count; i++) {
+		if (loader->nodes[i].parallel)
+			parallel++;
+	}
+
+	if (parallel < 2)
+		return;
+
+	num_threads = cores > 1 ? (size_t)cores : 1;
+	if (num_threads > MAX_SOURCE_LOAD_THREADS)
+		num_threads = MAX_SOURCE_LOAD_THREADS;
+	if (num_threads > parallel)
+		num_threads = parallel;
+
+	if (pthread_mutex_init(&loader->mutex, NULL) != 0)
+		return;
+	if (os_sem_init(&loader->work_sem, 0) != 0 || os_sem_init(&loader->done_sem, 0) != 0) {
+		os_sem_destroy(loader->work_sem);
+		pthread_mutex_destroy(&loader->mutex);
+		return;
+	}
+
+	for (size_t i = 0; i < num_threads; i++) {
+		pthread_t thread;
+		if (pthread_create(&thread, NULL, source_load_thread, loader) == 0)
+			da_push_back(loader->threads, &thread);
+	}
+
+	if (!loader->threads.num) {
+		os_sem_destroy(loader->work_sem);
+		os_sem_destroy(loader->done_sem);
+		pthread_mutex_destroy(&loader->mutex);
+	}
+}
+
+static void stop_source_load_threads(struct source_loader *loader)
+{
+	if (!loader->threads.num)
+		return;
+
+	for (size_t i = 0; i < loader->threads.num; i++)
+		os_sem_post(loader->work_sem);
+	for (size_t i = 0; i < loader->threads.num; i++)
+		pthread_join(loader->threads.array[i], NULL);
+
+	da_free(loader->threads);
+	deque_free(&loader->work);
+	deque_free(&loader->done);
+	os_sem_destroy(loader->work_sem);
+	os_sem_destroy(loader->done_sem);
+	pthread_mutex_destroy(&loader->mutex);
+}
+
+static void dispatch_source_load_node(struct source_loader *loader, size_t idx)
+{
+	struct source_load_node *node = &loader->nodes[idx];
+
+	node->dispatched = true;
+
+	if (node->parallel && loader->threads.num) {
+		pthread_mutex_lock(&loader->mutex);
+		deque_push_back(&loader->work, &idx, sizeof(idx));
+		pthread_mutex_unlock(&loader->mutex);
+
+		loader->in_flight++;
+		os_sem_post(loader->work_sem);
+	} else {
+		deque_push_back(&loader->ready, &idx, sizeof(idx));
+	}
+}
+
+static void finish_source_load_node(struct source_loader *loader, size_t idx)
+{
+	struct source_load_node *node = &loader->nodes[idx];
+
+	loader->created++;
+	report_source_load_progress(OBS_SOURCE_LOAD_PHASE_CREATE, loader->created, loader->count, loader->start_time);
+
+	for (size_t i = 0; i < node->dependents.num; i++) {
+		struct source_load_node *dependent = &loader->nodes[node->dependents.array[i]];
+
+		if (dependent->deps_left && --dependent->deps_left == 0 && !dependent->dispatched)
+			dispatch_source_load_node(loader, node->dependents.array[i]);
+	}
+}
+
+/* every entry taken from the done queue consumes one post of done_sem */
+static void collect_created_sources(struct source_loader *loader, bool wait)
+{
+	DARRAY(size_t) done;
+
+	da_init(done);
+
+	if (wait)
+		os_sem_wait(loader->done_sem);
+
+	pthread_mutex_lock(&loader->mutex);
+	while (loader->done.size) {
+		size_t idx;
+		deque_pop_front(&loader->done, &idx, sizeof(idx));
+		da_push_back(done, &idx);
+	}
+	pthread_mutex_unlock(&loader->mutex);
+
+	for (size_t i = 0; i < done.num; i++) {
+		if (i > 0 || !wait)
+			os_sem_wait(loader->done_sem);
+
+		loader->in_flight--;
+		loader->created_in_parallel++;
+		finish_source_load_node(loader, done.array[i]);
+	}
+
+	da_free(done);
+}
+
+static void create_sources(struct source_loader *loader)
+{
+	for (size_t i = 0; i < loader->count; i++) {
+		if (!loader->nodes[i].deps_left)
+			dispatch_source_load_node(loader, i);
+	}
+
+	while (loader->created < loader->count) {
+		if (loader->in_flight)
+			collect_created_sources(loader, false);
+
+		if (loader->ready.size) {
+			size_t idx;
+			deque_pop_front(&loader->ready, &idx, sizeof(idx));
+
+			loader->nodes[idx].source = obs_load_source(loader->nodes[idx].data);
+			finish_source_load_node(loader, idx);
+
+		} else if (loader->in_flight) {
+			collect_created_sources(loader, true);
+
+		} else {
+			/* nothing is ready or running, so scenes must contain
+			 * each other.  create the first one anyway */
+			for (size_t i = 0; i < loader->count; i++) {
+				if (!loader->nodes[i].dispatched) {
+					dispatch_source_load_node(loader, i);
+					break;
+				}
+			}
+		}
+	}
+}
+
+void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *private_data)
+{
+	struct source_loader loader = {0};
+	uint64_t create_time;
+	uint64_t load_start;
+	size_t num_threads;
+	size_t i;
+
+	loader.count = obs_data_array_count(array);
+	loader.nodes = bzalloc(sizeof(struct source_load_node) * (loader.count ? loader.count : 1));
+	loader.start_time = os_gettime_ns();
+
+	for (i = 0; i < loader.count; i++) {
+		struct source_load_node *node = &loader.nodes[i];
+		node->data = obs_data_array_item(array, i);
+		node->parallel = can_create_in_parallel(node->data);
+	}
+
+	report_source_load_progress(OBS_SOURCE_LOAD_PHASE_CREATE, 0, loader.count, loader.start_time);
+
+	build_source_load_graph(&loader);
+	start_source_load_threads(&loader);
+	num_threads = loader.threads.num;
+	create_sources(&loader);
+	stop_source_load_threads(&loader);
+
+	load_start = os_gettime_ns();
+	create_time = load_start - loader.start_time;
+	report_source_load_progress(OBS_SOURCE_LOAD_PHASE_LOAD, 0, loader.count, load_start);
+
 	/* tell sources that we want to load */
-	for (i = 0; i < sources.num; i++) {
-		obs_source_t *source = sources.array[i];
-		obs_data_t *source_data = obs_data_array_item(array, i);
+	for (i = 0; i < loader.count; i++) {
+		obs_source_t *source = loader.nodes[i].source;
+		obs_data_t *source_data = loader.nodes[i].data;
 		if (source) {
 			if (source->info.type == OBS_SOURCE_TYPE_TRANSITION)
 				obs_transition_load(source, source_data);
@@ -2423,20 +2934,30 @@ void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *priv
 			if (cb)
 				cb(private_data, source);
 		}
-		obs_data_release(source_data);
+		report_source_load_progress(OBS_SOURCE_LOAD_PHASE_LOAD, i + 1, loader.count, load_start);
 	}
 
-	for (i = 0; i < sources.num; i++)
-		obs_source_release(sources.array[i]);
+	blog(LOG_INFO,
+	     "Loaded %zu sources: created in %" PRIu64 " ms (%zu on %zu threads), "
+	     "loaded in %" PRIu64 " ms",
+	     loader.count, create_time / 1000000, loader.created_in_parallel, num_threads,
+	     (os_gettime_ns() - load_start) / 1000000);
+
+	for (i = 0; i < loader.count; i++) {
+		obs_source_release(loader.nodes[i].source);
+		obs_data_release(loader.nodes[i].data);
+		da_free(loader.nodes[i].dependents);
+	}
 
-	da_free(sources);
+	deque_free(&loader.ready);
+	bfree(loader.nodes);
 }
 
 obs_data_t *obs_save_source(obs_source_t *source)
 {
 	obs_data_array_t *filters = obs_data_array_create();
 	obs_data_t *source_data = obs_data_create();
-	obs_data_t *settings = obs_source_get_settings(source);
+	obs_data_t *settings = source->context.settings;
 	obs_data_t *hotkey_data = source->context.hotkey_data;
 	obs_data_t *hotkeys;
 	float volume = obs_source_get_volume(source);
@@ -2528,7 +3049,6 @@ obs_data_t *obs_save_source(obs_source_t *source)
 
 	da_free(filters_copy);
 
-	obs_data_release(settings);
 	obs_data_array_release(filters);
 
 	return source_data;
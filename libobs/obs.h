@@ -82,6 +82,7 @@ typedef struct obs_weak_canvas obs_weak_canvas_t;
 #include "obs-encoder.h"
 #include "obs-output.h"
 #include "obs-service.h"
+#include "obs-bitrate-control.h"
 #include "obs-audio-controls.h"
 #include "obs-hotkey.h"
 
@@ -466,6 +467,61 @@ EXPORT bool obs_get_audio_info(struct obs_audio_info *oai);
  */
 EXPORT bool obs_get_audio_info2(struct obs_audio_info2 *oai2);
 
+/**
+ * Enables or disables parallel audio mixing.  When enabled, the audio thread
+ * renders independent audio sources and the individual mixes on a pool of
+ * worker threads.  The mixed output is identical to serial mixing.  Takes
+ * effect on the next audio tick and persists across audio resets.
+ */
+EXPORT void obs_set_parallel_audio_mixing(bool enable);
+EXPORT bool obs_get_parallel_audio_mixing(void);
+
+/* Thread roles (OBS_THREAD_ROLE_*) are defined in util/threading.h */
+
+enum obs_thread_policy {
+	OBS_THREAD_POLICY_DEFAULT,
+	OBS_THREAD_POLICY_FIFO,
+	OBS_THREAD_POLICY_RR,
+};
+
+struct obs_thread_config {
+	enum obs_thread_policy policy;
+	/* real-time priority, clamped to what the OS allows */
+	int priority;
+	/* bit n allows CPU n, 0 allows every CPU */
+	uint64_t affinity;
+};
+
+struct obs_thread_status {
+	/* threads of this role that started since the config was set */
+	uint32_t threads;
+	/* how many of those could not apply the policy or affinity */
+	uint32_t failed;
+
+	/* what the OS reported for the most recent thread */
+	enum obs_thread_policy policy;
+	int priority;
+	uint64_t affinity;
+};
+
+/**
+ * Sets the scheduling policy and CPU affinity for threads of the given role.
+ * The config is applied by each thread of that role when it starts, so it
+ * takes effect on the next video/audio reset or output start.  Pass NULL to
+ * go back to the OS defaults.
+ */
+EXPORT void obs_set_thread_config(const char *role, const struct obs_thread_config *config);
+EXPORT bool obs_get_thread_config(const char *role, struct obs_thread_config *config);
+
+/** Reports what actually took effect for threads of the given role */
+EXPORT bool obs_get_thread_status(const char *role, struct obs_thread_status *status);
+
+/**
+ * Applies the config of the given role to the calling thread.  Called by
+ * the thread itself right after it starts.
+ */
+EXPORT void obs_apply_thread_config(const char *role);
+
 /**
  * Opens a plugin module directly from a specific path.
  *
@@ -855,6 +911,20 @@ EXPORT gs_texture_t *obs_get_main_texture(void);
 /** Saves a source to settings data */
 EXPORT obs_data_t *obs_save_source(obs_source_t *source);
 
+/**
+ * Returns a value that changes whenever anything obs_save_source saves for
+ * the source changes, so previously saved data can be reused until then.
+ * Read it before saving, not after.
+ */
+EXPORT long obs_source_get_save_revision(const obs_source_t *source);
+
+/**
+ * Marks saved state of the source as changed.  Call it after changing the
+ * settings or private settings of a source in place, without
+ * obs_source_update.
+ */
+EXPORT void obs_source_mark_changed(obs_source_t *source);
+
 /** Loads a source from settings data */
 EXPORT obs_source_t *obs_load_source(obs_data_t *data);
 
@@ -872,9 +942,28 @@ EXPORT void obs_source_load2(obs_source_t *source);
 
 typedef void (*obs_load_source_cb)(void *private_data, obs_source_t *source);
 
-/** Loads sources from a data array */
+/**
+ * Loads sources from a data array.  Sources of types flagged with
+ * OBS_SOURCE_PARALLEL_CREATE are created on worker threads, scenes and groups
+ * are created after the sources they contain.  The load callback is always
+ * called on the calling thread.
+ */
 EXPORT void obs_load_sources(obs_data_array_t *array, obs_load_source_cb cb, void *private_data);
 
+enum obs_source_load_phase {
+	OBS_SOURCE_LOAD_PHASE_CREATE,
+	OBS_SOURCE_LOAD_PHASE_LOAD,
+};
+
+typedef void (*obs_source_load_progress_callback_t)(void *param, enum obs_source_load_phase phase, size_t processed,
+						    size_t total, uint64_t elapsed_ns);
+
+/**
+ * Sets a callback to report the progress of obs_load_sources, called on the
+ * loading thread at the start of each phase and after every source.
+ */
+EXPORT void obs_set_source_load_progress_callback(obs_source_load_progress_callback_t callback, void *param);
+
 /** Saves sources to a data array */
 EXPORT obs_data_array_t *obs_save_sources(void);
 
@@ -1775,6 +1864,9 @@ EXPORT obs_data_t *obs_scene_save_transform_states(obs_scene_t *scene, bool all_
 /** Load all the transform states of sceneitems in that scene */
 EXPORT void obs_scene_load_transform_states(const char *state);
 
+/** Load transform states that were already parsed, e.g. from binary data */
+EXPORT void obs_scene_load_transform_states_data(obs_data_t *states);
+
 /**  Gets a sceneitem's order in its scene */
 EXPORT int obs_sceneitem_get_order_position(obs_sceneitem_t *item);
 
@@ -1967,6 +2059,14 @@ EXPORT uint32_t obs_output_get_delay(const obs_output_t *output);
 /** If delay is active, gets the currently active delay value, in seconds. */
 EXPORT uint32_t obs_output_get_active_delay(const obs_output_t *output);
 
+/**
+ * Keeps delayed packets in temporary files in the given directory instead
+ * of memory, so long delays at high bitrates don't use up RAM.  NULL turns
+ * it off.  Applies to packets that enter the delay after the call; packets
+ * already delayed stay where they are.
+ */
+EXPORT void obs_output_set_delay_spill_path(obs_output_t *output, const char *path);
+
 /** Forces the output to stop.  Usually only used with delay. */
 EXPORT void obs_output_force_stop(obs_output_t *output);
 
@@ -2615,6 +2715,24 @@ static inline void obs_source_frame_destroy(struct obs_source_frame *frame)
 
 EXPORT void obs_source_frame_copy(struct obs_source_frame *dst, const struct obs_source_frame *src);
 
+/** Statistics of the frame pool shared by async video sources */
+struct obs_frame_pool_stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	size_t cached_frames;
+	size_t cached_bytes;
+	size_t peak_cached_bytes;
+	size_t limit;
+};
+
+/**
+ * Sets how much memory the async frame pool may keep in idle frames.  Frames
+ * released while the pool is full evict the least recently used ones.
+ */
+EXPORT void obs_set_frame_pool_limit(size_t bytes);
+EXPORT bool obs_get_frame_pool_stats(struct obs_frame_pool_stats *stats);
+
 /* ------------------------------------------------------------------------- */
 /* Get source icon type */
 EXPORT enum obs_icon_type obs_source_get_icon_type(const char *id);
@@ -19,6 +19,8 @@
 #include <sys/types.h>
 #include <sys/stat.h>
 #include <sys/statvfs.h>
+#include <sys/mman.h>
+#include <fcntl.h>
 #include <dirent.h>
 #include <stdlib.h>
 #include <limits.h>
@@ -1106,3 +1108,72 @@ char *os_generate_uuid(void)
 	uuid_unparse_lower(uuid, out);
 	return out;
 }
+
+struct os_mapped_file {
+	int fd;
+	size_t size;
+	void *data;
+};
+
+os_mapped_file_t *os_mapped_file_create(const char *path, size_t size, bool temporary)
+{
+	struct os_mapped_file *mf;
+	int fd;
+
+	fd = open(path, O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0600);
+	if (fd == -1)
+		return NULL;
+
+	/* the open descriptor keeps the data around */
+	if (temporary)
+		unlink(path);
+
+#ifdef __APPLE__
+	if (ftruncate(fd, (off_t)size) != 0) {
+#else
+	/* reserve the space up front, writing to a mapping of a sparse file
+	 * on a full disk raises SIGBUS */
+	if (posix_fallocate(fd, 0, (off_t)size) != 0) {
+#endif
+		close(fd);
+		if (!temporary)
+			unlink(path);
+		return NULL;
+	}
+
+	mf = bzalloc(sizeof(*mf));
+	mf->fd = fd;
+	mf->size = size;
+	return mf;
+}
+
+void os_mapped_file_close(os_mapped_file_t *mf)
+{
+	if (!mf)
+		return;
+
+	os_mapped_file_unmap(mf);
+	close(mf->fd);
+	bfree(mf);
+}
+
+void *os_mapped_file_map(os_mapped_file_t *mf)
+{
+	if (!mf->data) {
+		void *data = mmap(NULL, mf->size, PROT_READ | PROT_WRITE, MAP_SHARED, mf->fd, 0);
+		if (data == MAP_FAILED)
+			return NULL;
+
+		mf->data = data;
+	}
+
+	return mf->data;
+}
+
+void os_mapped_file_unmap(os_mapped_file_t *mf)
+{
+	if (mf->data) {
+		munmap(mf->data, mf->size);
+		mf->data = NULL;
+	}
+}
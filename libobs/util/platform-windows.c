@@ -1370,3 +1370,69 @@ char *os_generate_uuid(void)
 
 	return uuid_str.array;
 }
+
+struct os_mapped_file {
+	HANDLE file;
+	HANDLE mapping;
+	size_t size;
+	void *data;
+};
+
+os_mapped_file_t *os_mapped_file_create(const char *path, size_t size, bool temporary)
+{
+	struct os_mapped_file *mf;
+	wchar_t *wpath = NULL;
+	DWORD flags = temporary ? (FILE_ATTRIBUTE_TEMPORARY | FILE_FLAG_DELETE_ON_CLOSE) : FILE_ATTRIBUTE_NORMAL;
+	HANDLE file;
+	HANDLE mapping;
+
+	os_utf8_to_wcs_ptr(path, 0, &wpath);
+	if (!wpath)
+		return NULL;
+
+	file = CreateFileW(wpath, GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, flags, NULL);
+	bfree(wpath);
+
+	if (file == INVALID_HANDLE_VALUE)
+		return NULL;
+
+	/* creating the mapping extends the file to its full size */
+	mapping = CreateFileMappingW(file, NULL, PAGE_READWRITE, (DWORD)((uint64_t)size >> 32), (DWORD)size, NULL);
+	if (!mapping) {
+		CloseHandle(file);
+		return NULL;
+	}
+
+	mf = bzalloc(sizeof(*mf));
+	mf->file = file;
+	mf->mapping = mapping;
+	mf->size = size;
+	return mf;
+}
+
+void os_mapped_file_close(os_mapped_file_t *mf)
+{
+	if (!mf)
+		return;
+
+	os_mapped_file_unmap(mf);
+	CloseHandle(mf->mapping);
+	CloseHandle(mf->file);
+	bfree(mf);
+}
+
+void *os_mapped_file_map(os_mapped_file_t *mf)
+{
+	if (!mf->data)
+		mf->data = MapViewOfFile(mf->mapping, FILE_MAP_ALL_ACCESS, 0, 0, mf->size);
+
+	return mf->data;
+}
+
+void os_mapped_file_unmap(os_mapped_file_t *mf)
+{
+	if (mf->data) {
+		UnmapViewOfFile(mf->data);
+		mf->data = NULL;
+	}
+}
@@ -207,6 +207,7 @@ size_t os_fread_utf8(FILE *file, char **pstr)
 		utf8str[size] = 0;
 
 		*pstr = utf8str;
+		len = size;
 	}
 
 	return len;
@@ -554,10 +555,17 @@ static inline void from_locale(char *buffer)
 double os_strtod(const char *str)
 {
 	char buf[64];
-	strncpy(buf, str, sizeof(buf) - 1);
-	buf[sizeof(buf) - 1] = 0;
-	to_locale(buf);
-	return strtod(buf, NULL);
+	size_t len = strlen(str);
+	char *copy = len < sizeof(buf) ? buf : bmalloc(len + 1);
+	double val;
+
+	memcpy(copy, str, len + 1);
+	to_locale(copy);
+	val = strtod(copy, NULL);
+
+	if (copy != buf)
+		bfree(copy);
+	return val;
 }
 
 int os_dtostr(double value, char *dst, size_t size)
@@ -605,6 +613,7 @@ int os_dtostr(double value, char *dst, size_t size)
 		if (end != start) {
 			memmove(start, end, length - (size_t)(end - dst));
 			length -= (size_t)(end - start);
+			dst[length] = '\0';
 		}
 	}
 
@@ -196,6 +196,19 @@ EXPORT uint64_t os_get_proc_virtual_size(void);
 
 EXPORT char *os_generate_uuid(void);
 
+/* File of a fixed size that can be mapped into memory for reading and
+ * writing.  Temporary files are deleted when closed, or when the process
+ * exits. */
+typedef struct os_mapped_file os_mapped_file_t;
+
+EXPORT os_mapped_file_t *os_mapped_file_create(const char *path, size_t size, bool temporary);
+EXPORT void os_mapped_file_close(os_mapped_file_t *mf);
+
+/* maps the whole file, mapping an already mapped file returns the same
+ * pointer */
+EXPORT void *os_mapped_file_map(os_mapped_file_t *mf);
+EXPORT void os_mapped_file_unmap(os_mapped_file_t *mf);
+
 EXPORT
 struct timespec *os_nstime_to_timespec(uint64_t timestamp, struct timespec *storage);
 
@@ -35,17 +35,12 @@ typedef struct profiler_time_entry profiler_time_entry;
 typedef struct profile_call profile_call;
 struct profile_call {
 	const char *name;
-#ifdef TRACK_OVERHEAD
-	uint64_t overhead_start;
-#endif
 	uint64_t start_time;
 	uint64_t end_time;
 #ifdef TRACK_OVERHEAD
-	uint64_t overhead_end;
+	uint64_t overhead;
 #endif
-	uint64_t expected_time_between_calls;
 	DARRAY(profile_call) children;
-	profile_call *parent;
 };
 
 typedef struct profile_times_table_entry profile_times_table_entry;
@@ -230,7 +225,9 @@ static void merge_call(profile_entry *entry, profile_call *call, profile_call *p
 		merge_call(get_child(entry, child->name), child, NULL);
 	}
 
-	if (entry->expected_time_between_calls != 0 && prev_call) {
+	/* calls from different threads are aggregated one buffer at a time,
+	 * so a previous call is not guaranteed to have started earlier */
+	if (entry->expected_time_between_calls != 0 && prev_call && prev_call->start_time <= call->start_time) {
 		migrate_old_entries(&entry->times_between_calls, true);
 		uint64_t usec = diff_ns_to_usec(prev_call->start_time, call->start_time);
 		add_hashmap_entry(&entry->times_between_calls, usec, 1);
@@ -242,30 +239,51 @@ static void merge_call(profile_entry *entry, profile_call *call, profile_call *p
 
 #ifdef TRACK_OVERHEAD
 	migrate_old_entries(&entry->overhead, true);
-	usec = diff_ns_to_usec(call->overhead_start, call->start_time);
-	usec += diff_ns_to_usec(call->end_time, call->overhead_end);
+	usec = diff_ns_to_usec(0, call->overhead);
 	add_hashmap_entry(&entry->overhead, usec, 1);
 #endif
 }
 
-static bool enabled = false;
+/* Profiled calls are recorded without locks: each thread keeps its open calls
+ * on a small thread-local stack and publishes every finished call into its
+ * own ring buffer (see "Call buffers" below).  An aggregation thread drains
+ * the rings, rebuilds the call trees and merges them into the root entries,
+ * so the hashmaps and root_mutex are never touched by profiled threads. */
+
+#define MAX_CALL_DEPTH 64
+#define AGGREGATE_INTERVAL_MS 10
+
+static volatile bool enabled = false;
 static pthread_mutex_t root_mutex = PTHREAD_MUTEX_INITIALIZER;
 static DARRAY(profile_root_entry) root_entries;
 
-static THREAD_LOCAL profile_call *thread_context = NULL;
 static THREAD_LOCAL bool thread_enabled = true;
+static THREAD_LOCAL const char *call_names[MAX_CALL_DEPTH];
+static THREAD_LOCAL uint64_t call_starts[MAX_CALL_DEPTH];
+#ifdef TRACK_OVERHEAD
+static THREAD_LOCAL uint64_t call_overheads[MAX_CALL_DEPTH];
+#endif
+static THREAD_LOCAL unsigned call_depth = 0;
+static THREAD_LOCAL unsigned overflow_depth = 0;
+
+static void publish_call(const char *name, uint64_t start, uint64_t end, unsigned depth);
+static void aggregate_calls(void);
+static void start_aggregate_thread(void);
+static void stop_aggregate_thread(void);
+static void free_call_buffers(void);
 
 void profiler_start(void)
 {
 	pthread_mutex_lock(&root_mutex);
-	enabled = true;
+	os_atomic_set_bool(&enabled, true);
+	start_aggregate_thread();
 	pthread_mutex_unlock(&root_mutex);
 }
 
 void profiler_stop(void)
 {
 	pthread_mutex_lock(&root_mutex);
-	enabled = false;
+	os_atomic_set_bool(&enabled, false);
 	pthread_mutex_unlock(&root_mutex);
 }
 
@@ -274,9 +292,7 @@ void profile_reenable_thread(void)
 	if (thread_enabled)
 		return;
 
-	pthread_mutex_lock(&root_mutex);
-	thread_enabled = enabled;
-	pthread_mutex_unlock(&root_mutex);
+	thread_enabled = os_atomic_load_bool(&enabled);
 }
 
 static bool lock_root(void)
@@ -326,16 +342,14 @@ void profile_register_root(const char *name, uint64_t expected_time_between_call
 
 static void free_call_context(profile_call *context);
 
+/* only called from the aggregation side */
 static void merge_context(profile_call *context)
 {
 	pthread_mutex_t *mutex = NULL;
 	profile_entry *entry = NULL;
 	profile_call *prev_call = NULL;
 
-	if (!lock_root()) {
-		free_call_context(context);
-		return;
-	}
+	pthread_mutex_lock(&root_mutex);
 
 	profile_root_entry *r_entry = get_root_entry(context->name);
 
@@ -360,26 +374,26 @@ void profile_start(const char *name)
 	if (!thread_enabled)
 		return;
 
-	profile_call new_call = {
-		.name = name,
 #ifdef TRACK_OVERHEAD
-		.overhead_start = os_gettime_ns(),
+	uint64_t overhead_start = os_gettime_ns();
 #endif
-		.parent = thread_context,
-	};
 
-	profile_call *call = NULL;
+	if (!call_depth && !os_atomic_load_bool(&enabled)) {
+		thread_enabled = false;
+		return;
+	}
 
-	if (new_call.parent) {
-		size_t idx = da_push_back(new_call.parent->children, &new_call);
-		call = &new_call.parent->children.array[idx];
-	} else {
-		call = bmalloc(sizeof(profile_call));
-		memcpy(call, &new_call, sizeof(profile_call));
+	if (call_depth == MAX_CALL_DEPTH) {
+		overflow_depth++;
+		return;
 	}
 
-	thread_context = call;
-	call->start_time = os_gettime_ns();
+	call_names[call_depth] = name;
+	call_starts[call_depth] = os_gettime_ns();
+#ifdef TRACK_OVERHEAD
+	call_overheads[call_depth] = call_starts[call_depth] - overhead_start;
+#endif
+	call_depth++;
 }
 
 void profile_end(const char *name)
@@ -388,45 +402,44 @@ void profile_end(const char *name)
 	if (!thread_enabled)
 		return;
 
-	profile_call *call = thread_context;
-	if (!call) {
+	if (overflow_depth) {
+		overflow_depth--;
+		return;
+	}
+
+	if (!call_depth) {
 		blog(LOG_ERROR, "Called profile end with no active profile");
 		return;
 	}
 
-	if (!call->name)
-		call->name = name;
+	unsigned idx = call_depth - 1;
 
-	if (call->name != name) {
+	if (!call_names[idx])
+		call_names[idx] = name;
+
+	if (call_names[idx] != name) {
 		blog(LOG_ERROR,
 		     "Called profile end with mismatching name: "
 		     "start(\"%s\"[%p]) <-> end(\"%s\"[%p])",
-		     call->name, call->name, name, name);
+		     call_names[idx], call_names[idx], name, name);
 
-		profile_call *parent = call->parent;
-		while (parent && parent->parent && parent->name != name)
-			parent = parent->parent;
+		while (idx > 0 && call_names[idx] != name)
+			idx--;
 
-		if (!parent || parent->name != name)
+		if (call_names[idx] != name)
 			return;
 
-		while (call->name != name) {
-			profile_end(call->name);
-			call = call->parent;
-		}
-	}
+		while (call_depth - 1 > idx)
+			profile_end(call_names[call_depth - 1]);
 
-	thread_context = call->parent;
+		end = os_gettime_ns();
+	}
 
-	call->end_time = end;
+	call_depth--;
 #ifdef TRACK_OVERHEAD
-	call->overhead_end = os_gettime_ns();
+	call_overheads[call_depth] += os_gettime_ns() - end;
 #endif
-
-	if (call->parent)
-		return;
-
-	merge_context(call);
+	publish_call(name, call_starts[call_depth], end, call_depth);
 }
 
 static int profiler_time_entry_compare(const void *first, const void *second)
@@ -768,8 +781,10 @@ void profiler_free(void)
 {
 	DARRAY(profile_root_entry) old_root_entries = {0};
 
+	os_atomic_set_bool(&enabled, false);
+	stop_aggregate_thread();
+
 	pthread_mutex_lock(&root_mutex);
-	enabled = false;
 	da_move(old_root_entries, root_entries);
 	pthread_mutex_unlock(&root_mutex);
 
@@ -792,6 +807,408 @@ void profiler_free(void)
 	da_free(old_root_entries);
 
 	pthread_mutex_destroy(&root_mutex);
+
+	free_call_buffers();
+}
+
+/* ------------------------------------------------------------------------- */
+/* Call buffers */
+
+/* Every thread that finishes a profiled call gets its own ring buffer.  The
+ * thread is the only writer and publishes each call by advancing write_pos;
+ * the aggregation thread and the trace exporter only read.  Readers check
+ * write_pos again after copying an entry and discard it if the writer may
+ * have lapped them in the meantime.  Buffers stay allocated until
+ * profiler_free() since readers can be using them while their threads exit.
+ * Freeing them bumps buffers_generation, so threads that still hold a
+ * pointer to their old buffer create a new one on their next call.
+ *
+ * Starting a trace raises trace_capacity.  Only the owning thread may swap
+ * out its events array, so existing rings grow on their thread's next call,
+ * under aggregate_mutex so that no reader is looking at the old array. */
+
+#define CALL_BUFFER_EVENTS (1 << 13)
+#define TRACE_DEFAULT_EVENTS (1 << 16)
+#define TRACE_MAX_EVENTS (1 << 20)
+
+struct call_event {
+	const char *name;
+	uint64_t start;
+	uint64_t end;
+#ifdef TRACK_OVERHEAD
+	uint64_t overhead;
+#endif
+	unsigned depth;
+};
+
+struct call_buffer {
+	struct call_buffer *next;
+	const char *thread_name;
+	long thread_id;
+
+	struct call_event *events;
+	unsigned long mask;
+	volatile long write_pos;
+
+	/* aggregation state, protected by aggregate_mutex */
+	unsigned long read_pos;
+	uint64_t dropped;
+	DARRAY(profile_call) pending[MAX_CALL_DEPTH + 1];
+};
+
+static pthread_mutex_t buffers_mutex = PTHREAD_MUTEX_INITIALIZER;
+static struct call_buffer *call_buffers = NULL;
+static volatile long trace_capacity = 0;
+static long buffer_thread_count = 0;
+static volatile bool trace_enabled = false;
+static volatile long buffers_generation = 0;
+
+static THREAD_LOCAL struct call_buffer *thread_buffer = NULL;
+static THREAD_LOCAL long thread_buffer_generation = 0;
+
+static pthread_mutex_t aggregate_mutex = PTHREAD_MUTEX_INITIALIZER;
+static pthread_t aggregate_thread;
+static os_event_t *aggregate_stop_event = NULL;
+static bool aggregate_thread_active = false;
+
+static struct call_buffer *create_call_buffer(void)
+{
+	struct call_buffer *buf = bzalloc(sizeof(*buf));
+	unsigned long capacity = (unsigned long)os_atomic_load_long(&trace_capacity);
+	if (capacity < CALL_BUFFER_EVENTS)
+		capacity = CALL_BUFFER_EVENTS;
+
+	buf->events = bzalloc(capacity * sizeof(struct call_event));
+	buf->mask = capacity - 1;
+
+	pthread_mutex_lock(&buffers_mutex);
+	buf->thread_id = ++buffer_thread_count;
+	buf->next = call_buffers;
+	call_buffers = buf;
+	pthread_mutex_unlock(&buffers_mutex);
+
+	return buf;
+}
+
+static struct call_buffer *get_call_buffers(void)
+{
+	pthread_mutex_lock(&buffers_mutex);
+	struct call_buffer *buf = call_buffers;
+	pthread_mutex_unlock(&buffers_mutex);
+	return buf;
+}
+
+/* Called by the owning thread only.  The newest events are carried over to
+ * the same positions in the new array, so read_pos stays valid and the
+ * aggregator simply sees a larger ring.  If a reader holds the lock, try
+ * again on the next call rather than stalling the profiled thread. */
+static void grow_call_buffer(struct call_buffer *buf, unsigned long capacity)
+{
+	if (pthread_mutex_trylock(&aggregate_mutex) != 0)
+		return;
+
+	unsigned long old_capacity = buf->mask + 1;
+	unsigned long end = (unsigned long)buf->write_pos;
+	unsigned long count = end < old_capacity ? end : old_capacity;
+	unsigned long mask = capacity - 1;
+
+	struct call_event *events = bzalloc(capacity * sizeof(struct call_event));
+	for (unsigned long pos = end - count; pos != end; pos++)
+		events[pos & mask] = buf->events[pos & buf->mask];
+
+	bfree(buf->events);
+	buf->events = events;
+	buf->mask = mask;
+
+	pthread_mutex_unlock(&aggregate_mutex);
+}
+
+static void publish_call(const char *name, uint64_t start, uint64_t end, unsigned depth)
+{
+	struct call_buffer *buf = thread_buffer;
+	long generation = os_atomic_load_long(&buffers_generation);
+	if (!buf || thread_buffer_generation != generation) {
+		buf = thread_buffer = create_call_buffer();
+		thread_buffer_generation = generation;
+	}
+
+	unsigned long capacity = (unsigned long)os_atomic_load_long(&trace_capacity);
+	if (capacity > buf->mask + 1)
+		grow_call_buffer(buf, capacity);
+
+	/* name the thread after the first root it profiles */
+	if (!depth && !buf->thread_name)
+		buf->thread_name = name;
+
+	unsigned long pos = (unsigned long)buf->write_pos;
+	struct call_event *event = &buf->events[pos & buf->mask];
+	event->name = name;
+	event->start = start;
+	event->end = end;
+	event->depth = depth;
+#ifdef TRACK_OVERHEAD
+	event->overhead = call_overheads[depth];
+#endif
+
+	os_atomic_store_long(&buf->write_pos, (long)(pos + 1));
+}
+
+static void clear_pending_calls(struct call_buffer *buf)
+{
+	for (size_t i = 0; i <= MAX_CALL_DEPTH; i++) {
+		for (size_t j = 0; j < buf->pending[i].num; j++)
+			free_call_children(&buf->pending[i].array[j]);
+		da_resize(buf->pending[i], 0);
+	}
+}
+
+/* Calls arrive in the order they finished, so the children of a call are
+ * the calls one level deeper that finished since the last call at its own
+ * level. */
+static void add_call_event(struct call_buffer *buf, const struct call_event *event)
+{
+	profile_call call = {
+		.name = event->name,
+		.start_time = event->start,
+		.end_time = event->end,
+#ifdef TRACK_OVERHEAD
+		.overhead = event->overhead,
+#endif
+	};
+
+	da_move(call.children, buf->pending[event->depth + 1]);
+
+	if (event->depth) {
+		da_push_back(buf->pending[event->depth], &call);
+		return;
+	}
+
+	profile_call *root = bmalloc(sizeof(profile_call));
+	memcpy(root, &call, sizeof(profile_call));
+	merge_context(root);
+}
+
+static void aggregate_buffer(struct call_buffer *buf)
+{
+	unsigned long capacity = buf->mask + 1;
+	unsigned long write_pos = (unsigned long)os_atomic_load_long(&buf->write_pos);
+
+	while (buf->read_pos != write_pos) {
+		/* the slot at write_pos - capacity may be getting rewritten
+		 * right now, so only the newest capacity - 1 calls are safe */
+		if (write_pos - buf->read_pos >= capacity) {
+			buf->dropped += write_pos - capacity + 1 - buf->read_pos;
+			buf->read_pos = write_pos - capacity + 1;
+			clear_pending_calls(buf);
+		}
+
+		struct call_event event = buf->events[buf->read_pos & buf->mask];
+
+		unsigned long now = (unsigned long)os_atomic_load_long(&buf->write_pos);
+		if (now - buf->read_pos >= capacity) {
+			write_pos = now;
+			continue;
+		}
+
+		buf->read_pos++;
+		add_call_event(buf, &event);
+	}
+}
+
+static void aggregate_calls(void)
+{
+	pthread_mutex_lock(&aggregate_mutex);
+	for (struct call_buffer *buf = get_call_buffers(); buf; buf = buf->next)
+		aggregate_buffer(buf);
+	pthread_mutex_unlock(&aggregate_mutex);
+}
+
+static void *aggregate_thread_func(void *unused)
+{
+	os_set_thread_name("profiler: aggregate thread");
+
+	while (os_event_timedwait(aggregate_stop_event, AGGREGATE_INTERVAL_MS) == ETIMEDOUT)
+		aggregate_calls();
+
+	UNUSED_PARAMETER(unused);
+	return NULL;
+}
+
+/* called with root_mutex held */
+static void start_aggregate_thread(void)
+{
+	if (aggregate_thread_active)
+		return;
+
+	if (os_event_init(&aggregate_stop_event, OS_EVENT_TYPE_MANUAL) != 0)
+		return;
+
+	aggregate_thread_active = pthread_create(&aggregate_thread, NULL, aggregate_thread_func, NULL) == 0;
+	if (!aggregate_thread_active) {
+		os_event_destroy(aggregate_stop_event);
+		aggregate_stop_event = NULL;
+	}
+}
+
+static void stop_aggregate_thread(void)
+{
+	pthread_mutex_lock(&root_mutex);
+	bool active = aggregate_thread_active;
+	aggregate_thread_active = false;
+	pthread_mutex_unlock(&root_mutex);
+
+	if (!active)
+		return;
+
+	os_event_signal(aggregate_stop_event);
+	pthread_join(aggregate_thread, NULL);
+	os_event_destroy(aggregate_stop_event);
+	aggregate_stop_event = NULL;
+}
+
+static void free_call_buffers(void)
+{
+	os_atomic_set_bool(&trace_enabled, false);
+
+	pthread_mutex_lock(&buffers_mutex);
+	struct call_buffer *buf = call_buffers;
+	call_buffers = NULL;
+	os_atomic_inc_long(&buffers_generation);
+	pthread_mutex_unlock(&buffers_mutex);
+
+	while (buf) {
+		struct call_buffer *next = buf->next;
+		if (buf->dropped)
+			blog(LOG_WARNING, "Profiler dropped %" PRIu64 " calls on thread '%s'", buf->dropped,
+			     buf->thread_name ? buf->thread_name : "unnamed thread");
+
+		clear_pending_calls(buf);
+		for (size_t i = 0; i <= MAX_CALL_DEPTH; i++)
+			da_free(buf->pending[i]);
+		bfree(buf->events);
+		bfree(buf);
+		buf = next;
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* Event tracing */
+
+static size_t round_up_pow2(size_t val)
+{
+	size_t pow2 = 1;
+	while (pow2 < val)
+		pow2 <<= 1;
+	return pow2;
+}
+
+void profiler_trace_start(size_t events_per_thread)
+{
+	if (!events_per_thread)
+		events_per_thread = TRACE_DEFAULT_EVENTS;
+	if (events_per_thread > TRACE_MAX_EVENTS)
+		events_per_thread = TRACE_MAX_EVENTS;
+
+	/* rings that already exist grow on their thread's next call */
+	os_atomic_set_long(&trace_capacity, (long)round_up_pow2(events_per_thread));
+	os_atomic_set_bool(&trace_enabled, true);
+}
+
+void profiler_trace_stop(void)
+{
+	/* keep the grown rings so that the trace can still be dumped */
+	os_atomic_set_long(&trace_capacity, 0);
+	os_atomic_set_bool(&trace_enabled, false);
+}
+
+bool profiler_trace_active(void)
+{
+	return os_atomic_load_bool(&trace_enabled);
+}
+
+static void json_cat_string(struct dstr *buffer, const char *str)
+{
+	dstr_cat_ch(buffer, '"');
+	for (; str && *str; str++) {
+		unsigned char ch = (unsigned char)*str;
+		if (ch == '"' || ch == '\\') {
+			dstr_cat_ch(buffer, '\\');
+			dstr_cat_ch(buffer, (char)ch);
+		} else if (ch < 0x20) {
+			dstr_catf(buffer, "\\u%04x", ch);
+		} else {
+			dstr_cat_ch(buffer, (char)ch);
+		}
+	}
+	dstr_cat_ch(buffer, '"');
+}
+
+static void dump_trace_buffer(struct call_buffer *buf, FILE *f, struct dstr *buffer, bool *first)
+{
+	size_t capacity = (size_t)buf->mask + 1;
+	struct call_event *copy = bmalloc(capacity * sizeof(struct call_event));
+	unsigned long end = (unsigned long)os_atomic_load_long(&buf->write_pos);
+	unsigned long count = end < capacity ? end : (unsigned long)capacity;
+	unsigned long start = end - count;
+
+	for (unsigned long i = 0; i < count; i++)
+		copy[i] = buf->events[(start + i) & buf->mask];
+
+	/* the owning thread keeps writing while we copy, so any event it may
+	 * have overwritten in the meantime could be torn; skip those */
+	unsigned long written = (unsigned long)os_atomic_load_long(&buf->write_pos) - start;
+	unsigned long skip = written >= capacity ? written - (unsigned long)capacity + 1 : 0;
+	if (skip > count)
+		skip = count;
+
+	dstr_printf(buffer,
+		    "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,"
+		    "\"tid\":%ld,\"args\":{\"name\":",
+		    *first ? "" : ",", buf->thread_id);
+	json_cat_string(buffer, buf->thread_name ? buf->thread_name : "unnamed thread");
+	dstr_cat(buffer, "}}");
+	fwrite(buffer->array, 1, buffer->len, f);
+	*first = false;
+
+	for (unsigned long i = skip; i < count; i++) {
+		struct call_event *event = &copy[i];
+
+		dstr_copy(buffer, ",\n{\"name\":");
+		json_cat_string(buffer, event->name);
+		dstr_catf(buffer,
+			  ",\"ph\":\"X\",\"pid\":1,\"tid\":%ld,"
+			  "\"ts\":%" PRIu64 ".%03u,\"dur\":%" PRIu64 ".%03u}",
+			  buf->thread_id, event->start / 1000, (unsigned)(event->start % 1000),
+			  (event->end - event->start) / 1000, (unsigned)((event->end - event->start) % 1000));
+		fwrite(buffer->array, 1, buffer->len, f);
+	}
+
+	bfree(copy);
+}
+
+bool profiler_trace_dump_json(const char *filename)
+{
+	struct dstr buffer = {0};
+	bool first = true;
+
+	FILE *f = os_fopen(filename, "wb");
+	if (!f)
+		return false;
+
+	fputs("{\"displayTimeUnit\":\"ms\",\"traceEvents\":[", f);
+
+	/* owning threads only swap out their events arrays under
+	 * aggregate_mutex, so hold it while copying */
+	pthread_mutex_lock(&aggregate_mutex);
+	for (struct call_buffer *buf = get_call_buffers(); buf; buf = buf->next)
+		dump_trace_buffer(buf, f, &buffer, &first);
+	pthread_mutex_unlock(&aggregate_mutex);
+
+	fputs("\n]}\n", f);
+
+	dstr_free(&buffer);
+	fclose(f);
+	return true;
 }
 
 /* ------------------------------------------------------------------------- */
@@ -887,6 +1304,8 @@ profiler_snapshot_t *profile_snapshot_create(void)
 {
 	profiler_snapshot_t *snap = bzalloc(sizeof(profiler_snapshot_t));
 
+	aggregate_calls();
+
 	pthread_mutex_lock(&root_mutex);
 	da_reserve(snap->roots, root_entries.num);
 	for (size_t i = 0; i < root_entries.num; i++) {
@@ -32,6 +32,22 @@ EXPORT void profiler_print_time_between_calls(profiler_snapshot_t *snap);
 
 EXPORT void profiler_free(void);
 
+/* ------------------------------------------------------------------------- */
+/* Event tracing */
+
+/* Records the begin and end time of every profiled call into a ring buffer
+ * per thread, keeping the most recent events_per_thread calls (0 selects the
+ * default).  Threads that are already running switch to the larger ring on
+ * their next profiled call.  Only takes effect while the profiler itself is
+ * enabled. */
+EXPORT void profiler_trace_start(size_t events_per_thread);
+EXPORT void profiler_trace_stop(void);
+EXPORT bool profiler_trace_active(void);
+
+/* Writes the buffered events as Chrome trace-event JSON, which can be opened
+ * in Perfetto or chrome://tracing */
+EXPORT bool profiler_trace_dump_json(const char *filename);
+
 /* ------------------------------------------------------------------------- */
 /* Profiler name storage */
 
@@ -162,3 +162,138 @@ static void *tiny_tubular_task_thread(void *param)
 
 	return NULL;
 }
+
+/* ------------------------------------------------------------------------- */
+
+struct os_task_pool {
+	pthread_t *threads;
+	size_t num_threads;
+	char *name;
+
+	os_sem_t *start_sem;
+	os_sem_t *done_sem;
+	pthread_mutex_t run_mutex;
+	bool stop;
+
+	os_task_range_t task;
+	void *param;
+	long count;
+	volatile long next;
+};
+
+static void run_task_range(struct os_task_pool *pool)
+{
+	for (;;) {
+		long idx = os_atomic_inc_long(&pool->next) - 1;
+		if (idx >= pool->count)
+			break;
+
+		pool->task(pool->param, (size_t)idx);
+	}
+}
+
+static void *task_pool_thread(void *param)
+{
+	struct os_task_pool *pool = param;
+
+	os_set_thread_name(pool->name);
+
+	while (os_sem_wait(pool->start_sem) == 0) {
+		if (pool->stop)
+			break;
+
+		run_task_range(pool);
+		os_sem_post(pool->done_sem);
+	}
+
+	return NULL;
+}
+
+os_task_pool_t *os_task_pool_create(size_t threads, const char *name)
+{
+	struct os_task_pool *pool = bzalloc(sizeof(*pool));
+	pool->name = bstrdup(name ? name : "os_task_pool");
+
+	if (pthread_mutex_init(&pool->run_mutex, NULL) != 0)
+		goto fail1;
+	if (os_sem_init(&pool->start_sem, 0) != 0)
+		goto fail2;
+	if (os_sem_init(&pool->done_sem, 0) != 0)
+		goto fail3;
+
+	if (threads)
+		pool->threads = bmalloc(threads * sizeof(pthread_t));
+
+	for (size_t i = 0; i < threads; i++) {
+		if (pthread_create(&pool->threads[i], NULL, task_pool_thread, pool) != 0)
+			break;
+		pool->num_threads++;
+	}
+
+	return pool;
+
+fail3:
+	os_sem_destroy(pool->start_sem);
+fail2:
+	pthread_mutex_destroy(&pool->run_mutex);
+fail1:
+	bfree(pool->name);
+	bfree(pool);
+	return NULL;
+}
+
+void os_task_pool_run(os_task_pool_t *pool, os_task_range_t task, void *param, size_t count)
+{
+	size_t helpers;
+
+	if (!count)
+		return;
+
+	if (!pool || !pool->num_threads || count == 1) {
+		for (size_t i = 0; i < count; i++)
+			task(param, i);
+		return;
+	}
+
+	pthread_mutex_lock(&pool->run_mutex);
+
+	pool->task = task;
+	pool->param = param;
+	pool->count = (long)count;
+	os_atomic_set_long(&pool->next, 0);
+
+	helpers = count - 1 < pool->num_threads ? count - 1 : pool->num_threads;
+	for (size_t i = 0; i < helpers; i++)
+		os_sem_post(pool->start_sem);
+
+	run_task_range(pool);
+
+	for (size_t i = 0; i < helpers; i++)
+		os_sem_wait(pool->done_sem);
+
+	pthread_mutex_unlock(&pool->run_mutex);
+}
+
+size_t os_task_pool_threads(const os_task_pool_t *pool)
+{
+	return pool ? pool->num_threads : 0;
+}
+
+void os_task_pool_destroy(os_task_pool_t *pool)
+{
+	if (!pool)
+		return;
+
+	pool->stop = true;
+	for (size_t i = 0; i < pool->num_threads; i++)
+		os_sem_post(pool->start_sem);
+	for (size_t i = 0; i < pool->num_threads; i++)
+		pthread_join(pool->threads[i], NULL);
+
+	os_sem_destroy(pool->done_sem);
+	os_sem_destroy(pool->start_sem);
+	pthread_mutex_destroy(&pool->run_mutex);
+	bfree(pool->threads);
+	bfree(pool->name);
+	bfree(pool);
+}
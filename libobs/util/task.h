@@ -17,6 +17,20 @@ EXPORT void os_task_queue_destroy(os_task_queue_t *tt);
 EXPORT bool os_task_queue_wait(os_task_queue_t *tt);
 EXPORT bool os_task_queue_inside(os_task_queue_t *tt);
 
+/* Fork-join pool: os_task_pool_run calls task(param, idx) for every idx in
+ * [0, count) across the pool threads and the calling thread, and returns once
+ * all of them have finished.  Indices are handed out one at a time, so idle
+ * threads keep picking up whatever work is left. */
+struct os_task_pool;
+typedef struct os_task_pool os_task_pool_t;
+
+typedef void (*os_task_range_t)(void *param, size_t idx);
+
+EXPORT os_task_pool_t *os_task_pool_create(size_t threads, const char *name);
+EXPORT void os_task_pool_run(os_task_pool_t *pool, os_task_range_t task, void *param, size_t count);
+EXPORT size_t os_task_pool_threads(const os_task_pool_t *pool);
+EXPORT void os_task_pool_destroy(os_task_pool_t *pool);
+
 #ifdef __cplusplus
 }
 #endif
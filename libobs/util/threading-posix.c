@@ -30,6 +30,8 @@
 #include <pthread_np.h>
 #endif
 
+#include <sched.h>
+
 #include "bmem.h"
 #include "threading.h"
 
@@ -271,3 +273,103 @@ void os_set_thread_name(const char *name)
 	}
 #endif
 }
+
+static inline int get_sched_policy(enum os_thread_policy policy)
+{
+	switch (policy) {
+	case OS_THREAD_POLICY_FIFO:
+		return SCHED_FIFO;
+	case OS_THREAD_POLICY_RR:
+		return SCHED_RR;
+	case OS_THREAD_POLICY_DEFAULT:
+		break;
+	}
+
+	return SCHED_OTHER;
+}
+
+bool os_set_thread_policy(enum os_thread_policy policy, int priority)
+{
+	int sched_policy = get_sched_policy(policy);
+	struct sched_param param = {0};
+
+	if (sched_policy != SCHED_OTHER) {
+		int min_priority = sched_get_priority_min(sched_policy);
+		int max_priority = sched_get_priority_max(sched_policy);
+
+		if (priority < min_priority)
+			priority = min_priority;
+		if (priority > max_priority)
+			priority = max_priority;
+		param.sched_priority = priority;
+	}
+
+	return pthread_setschedparam(pthread_self(), sched_policy, &param) == 0;
+}
+
+bool os_get_thread_policy(enum os_thread_policy *policy, int *priority)
+{
+	struct sched_param param;
+	int sched_policy;
+
+	if (pthread_getschedparam(pthread_self(), &sched_policy, &param) != 0)
+		return false;
+
+	if (policy) {
+		if (sched_policy == SCHED_FIFO)
+			*policy = OS_THREAD_POLICY_FIFO;
+		else if (sched_policy == SCHED_RR)
+			*policy = OS_THREAD_POLICY_RR;
+		else
+			*policy = OS_THREAD_POLICY_DEFAULT;
+	}
+	if (priority)
+		*priority = param.sched_priority;
+	return true;
+}
+
+#if defined(__GLIBC__) && !defined(__MINGW32__)
+
+bool os_set_thread_affinity(uint64_t mask)
+{
+	cpu_set_t set;
+	CPU_ZERO(&set);
+
+	for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+		if (!mask || (cpu < 64 && (mask & (1ULL << cpu)) != 0))
+			CPU_SET(cpu, &set);
+	}
+
+	return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+}
+
+bool os_get_thread_affinity(uint64_t *mask)
+{
+	cpu_set_t set;
+
+	if (!mask || pthread_getaffinity_np(pthread_self(), sizeof(set), &set) != 0)
+		return false;
+
+	*mask = 0;
+	for (int cpu = 0; cpu < 64; cpu++) {
+		if (CPU_ISSET(cpu, &set))
+			*mask |= 1ULL << cpu;
+	}
+	return true;
+}
+
+#else
+
+/* macOS only offers affinity hints, and the BSDs use a different API */
+bool os_set_thread_affinity(uint64_t mask)
+{
+	return mask == 0;
+}
+
+bool os_get_thread_affinity(uint64_t *mask)
+{
+	UNUSED_PARAMETER(mask);
+	return false;
+}
+
+#endif
@@ -211,3 +211,62 @@ void os_set_thread_name(const char *name)
 		FreeLibrary(hModule);
 	}
 }
+
+bool os_set_thread_policy(enum os_thread_policy policy, int priority)
+{
+	int win_priority = THREAD_PRIORITY_NORMAL;
+
+	/* Windows has no real-time policies for individual threads, so map
+	 * them onto the two highest thread priorities */
+	if (policy == OS_THREAD_POLICY_FIFO)
+		win_priority = THREAD_PRIORITY_TIME_CRITICAL;
+	else if (policy == OS_THREAD_POLICY_RR)
+		win_priority = THREAD_PRIORITY_HIGHEST;
+
+	UNUSED_PARAMETER(priority);
+	return !!SetThreadPriority(GetCurrentThread(), win_priority);
+}
+
+bool os_get_thread_policy(enum os_thread_policy *policy, int *priority)
+{
+	int win_priority = GetThreadPriority(GetCurrentThread());
+	if (win_priority == THREAD_PRIORITY_ERROR_RETURN)
+		return false;
+
+	if (policy) {
+		if (win_priority == THREAD_PRIORITY_TIME_CRITICAL)
+			*policy = OS_THREAD_POLICY_FIFO;
+		else if (win_priority == THREAD_PRIORITY_HIGHEST)
+			*policy = OS_THREAD_POLICY_RR;
+		else
+			*policy = OS_THREAD_POLICY_DEFAULT;
+	}
+	if (priority)
+		*priority = win_priority;
+	return true;
+}
+
+bool os_set_thread_affinity(uint64_t mask)
+{
+	DWORD_PTR process_mask;
+	DWORD_PTR system_mask;
+
+	if (!mask) {
+		if (!GetProcessAffinityMask(GetCurrentProcess(), &process_mask, &system_mask))
+			return false;
+		mask = process_mask;
+	}
+
+	return SetThreadAffinityMask(GetCurrentThread(), (DWORD_PTR)mask) != 0;
+}
+
+bool os_get_thread_affinity(uint64_t *mask)
+{
+	GROUP_AFFINITY affinity;
+
+	if (!mask || !GetThreadGroupAffinity(GetCurrentThread(), &affinity))
+		return false;
+
+	*mask = affinity.Mask;
+	return true;
+}
@@ -92,6 +92,31 @@ EXPORT int os_sem_wait(os_sem_t *sem);
 
 EXPORT void os_set_thread_name(const char *name);
 
+/* Thread roles used by libobs and the built-in outputs */
+#define OBS_THREAD_ROLE_GRAPHICS "graphics"
+#define OBS_THREAD_ROLE_VIDEO "video"
+#define OBS_THREAD_ROLE_AUDIO "audio"
+#define OBS_THREAD_ROLE_GPU_ENCODE "gpu_encode"
+#define OBS_THREAD_ROLE_OUTPUT_SEND "output_send"
+
+enum os_thread_policy {
+	OS_THREAD_POLICY_DEFAULT,
+	OS_THREAD_POLICY_FIFO,
+	OS_THREAD_POLICY_RR,
+};
+
+/* Changes the scheduling of the calling thread.  For the real-time policies,
+ * priority is clamped to the range the OS allows; it is ignored for the
+ * default policy.  Returns false if the OS refused the change, which usually
+ * means the process lacks the privilege to use real-time scheduling. */
+EXPORT bool os_set_thread_policy(enum os_thread_policy policy, int priority);
+EXPORT bool os_get_thread_policy(enum os_thread_policy *policy, int *priority);
+
+/* Restricts the calling thread to the CPUs set in mask (bit n is CPU n).  A
+ * mask of 0 allows every CPU again. */
+EXPORT bool os_set_thread_affinity(uint64_t mask);
+EXPORT bool os_get_thread_affinity(uint64_t *mask);
+
 #ifdef _MSC_VER
 #define THREAD_LOCAL __declspec(thread)
 #else
@@ -133,6 +133,7 @@ void DeckLinkInput::SaveSettings()
 	obs_data_set_string(settings, "device_name", device->GetDisplayName().c_str());
 	obs_data_set_int(settings, "mode_id", instance->GetActiveModeId());
 	obs_data_set_string(settings, "mode_name", mode->GetName().c_str());
+	obs_source_mark_changed(source);
 
 	obs_data_release(settings);
 }
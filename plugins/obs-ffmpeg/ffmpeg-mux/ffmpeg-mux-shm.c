@@ -0,0 +1,409 @@
+/*
+ * Copyright (c) 2026 Uniflow, Inc.
+ * Author: Kim Taehyung <gaiaengine@gmail.com>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifdef __linux__
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE
+#endif
+#include <fcntl.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <linux/futex.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/syscall.h>
+#include <sys/wait.h>
+#endif
+
+#include <stdalign.h>
+#include <stdint.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+
+#include "ffmpeg-mux-shm.h"
+
+#ifdef __linux__
+
+/* must be a power of two */
+#define FFM_SHM_SIZE (1024 * 1024)
+#define FFM_SHM_MAGIC 0x6d686673
+
+#define WAIT_TIMEOUT_NS 100000000LL
+#define CHECK_INTERVAL_NS 1000000000ULL
+#define ATTACH_TIMEOUT_NS 10000000000ULL
+#define STOP_TIMEOUT_NS 1000000000ULL
+
+/* the futex words are only bumped to wake the other side, the positions
+ * are what's actually synchronized */
+struct ffm_shm_header {
+	uint32_t magic;
+	uint32_t size;
+
+	uint32_t data_seq;
+	uint32_t space_seq;
+	uint32_t reader_waiting;
+	uint32_t writer_waiting;
+	uint32_t writer_closed;
+	uint32_t reader_closed;
+	int32_t reader_pid;
+
+	/* written by one side each, kept on separate cache lines */
+	alignas(64) uint64_t write_pos;
+	alignas(64) uint64_t read_pos;
+	alignas(64) uint8_t data[];
+};
+
+struct ffm_shm {
+	struct ffm_shm_header *header;
+	size_t map_size;
+	int fd;
+	bool writer;
+
+	pid_t parent;
+	uint64_t created;
+	uint64_t last_check;
+	char path[64];
+};
+
+#define load(ptr) __atomic_load_n(ptr, __ATOMIC_ACQUIRE)
+#define store(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_RELEASE)
+#define load_sc(ptr) __atomic_load_n(ptr, __ATOMIC_SEQ_CST)
+#define store_sc(ptr, val) __atomic_store_n(ptr, val, __ATOMIC_SEQ_CST)
+
+static void futex_wait(uint32_t *addr, uint32_t val)
+{
+	struct timespec ts = {0, WAIT_TIMEOUT_NS};
+	syscall(SYS_futex, addr, FUTEX_WAIT, val, &ts, NULL, 0);
+}
+
+static void futex_wake(uint32_t *addr)
+{
+	syscall(SYS_futex, addr, FUTEX_WAKE, 1, NULL, NULL, 0);
+}
+
+/* publishing bumps the sequence first, so a waiter either sees the new
+ * position or gets woken up */
+static inline void signal_seq(uint32_t *seq, uint32_t *waiting)
+{
+	__atomic_fetch_add(seq, 1, __ATOMIC_SEQ_CST);
+	if (load_sc(waiting))
+		futex_wake(seq);
+}
+
+static struct ffm_shm *map_shm(int fd, size_t size)
+{
+	struct ffm_shm *shm;
+	void *map = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+	if (map == MAP_FAILED)
+		return NULL;
+
+	shm = bzalloc(sizeof(*shm));
+	shm->header = map;
+	shm->map_size = size;
+	shm->fd = fd;
+	shm->created = os_gettime_ns();
+	return shm;
+}
+
+struct ffm_shm *ffm_shm_create(void)
+{
+	size_t size = sizeof(struct ffm_shm_header) + FFM_SHM_SIZE;
+	struct ffm_shm *shm;
+	int fd;
+
+	fd = memfd_create("obs-ffmpeg-mux", MFD_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+
+	if (ftruncate(fd, (off_t)size) != 0) {
+		close(fd);
+		return NULL;
+	}
+
+	shm = map_shm(fd, size);
+	if (!shm) {
+		close(fd);
+		return NULL;
+	}
+
+	shm->writer = true;
+	shm->header->magic = FFM_SHM_MAGIC;
+	shm->header->size = FFM_SHM_SIZE;
+
+	/* the helper opens the memfd through the parent's fd table, so it
+	 * doesn't have to be inherited */
+	snprintf(shm->path, sizeof(shm->path), "/proc/%d/fd/%d", (int)getpid(), fd);
+	return shm;
+}
+
+const char *ffm_shm_path(const struct ffm_shm *shm)
+{
+	return shm->path;
+}
+
+struct ffm_shm *ffm_shm_open(const char *path)
+{
+	struct ffm_shm *shm;
+	struct stat st;
+	int fd;
+
+	fd = open(path, O_RDWR | O_CLOEXEC);
+	if (fd == -1)
+		return NULL;
+
+	if (fstat(fd, &st) != 0 || (size_t)st.st_size < sizeof(struct ffm_shm_header)) {
+		close(fd);
+		return NULL;
+	}
+
+	shm = map_shm(fd, (size_t)st.st_size);
+	if (!shm) {
+		close(fd);
+		return NULL;
+	}
+
+	if (shm->header->magic != FFM_SHM_MAGIC ||
+	    sizeof(struct ffm_shm_header) + shm->header->size > shm->map_size) {
+		ffm_shm_destroy(shm);
+		return NULL;
+	}
+
+	shm->parent = getppid();
+	store_sc(&shm->header->reader_pid, (int32_t)getpid());
+	futex_wake((uint32_t *)&shm->header->reader_pid);
+	return shm;
+}
+
+/* there's no pipe to break when ffmpeg-mux goes away, so check on it */
+static bool reader_gone(struct ffm_shm *shm, uint64_t now)
+{
+	struct ffm_shm_header *h = shm->header;
+	siginfo_t info = {0};
+	pid_t pid;
+
+	if (load_sc(&h->reader_closed))
+		return true;
+
+	pid = (pid_t)load_sc(&h->reader_pid);
+	if (!pid)
+		return now - shm->created > ATTACH_TIMEOUT_NS;
+
+	/* WNOWAIT leaves the exit status for os_process_pipe_destroy */
+	if (waitid(P_PID, (id_t)pid, &info, WEXITED | WNOHANG | WNOWAIT) == 0 && info.si_pid == pid)
+		return true;
+
+	return false;
+}
+
+/* the helper opens the memfd through /proc/<pid>/fd, which only works while
+ * the fd is still open here, so give it a moment to attach before closing.
+ * This runs when the output stops, so it only waits a short while, and not
+ * at all once the helper is gone. */
+static void wait_for_reader(struct ffm_shm *shm)
+{
+	struct ffm_shm_header *h = shm->header;
+	uint64_t start = os_gettime_ns();
+	uint64_t now = start;
+
+	while (!load_sc(&h->reader_pid) && !reader_gone(shm, now) && now - start < STOP_TIMEOUT_NS) {
+		futex_wait((uint32_t *)&h->reader_pid, 0);
+		now = os_gettime_ns();
+	}
+}
+
+void ffm_shm_destroy(struct ffm_shm *shm)
+{
+	struct ffm_shm_header *h;
+
+	if (!shm)
+		return;
+
+	h = shm->header;
+	if (h->magic == FFM_SHM_MAGIC) {
+		if (shm->writer) {
+			wait_for_reader(shm);
+			store_sc(&h->writer_closed, 1);
+			signal_seq(&h->data_seq, &h->reader_waiting);
+		} else {
+			store_sc(&h->reader_closed, 1);
+			signal_seq(&h->space_seq, &h->writer_waiting);
+		}
+	}
+
+	munmap(shm->header, shm->map_size);
+	close(shm->fd);
+	bfree(shm);
+}
+
+static bool writer_gone(struct ffm_shm *shm)
+{
+	return load_sc(&shm->header->writer_closed) || getppid() != shm->parent;
+}
+
+static bool wait_for_space(struct ffm_shm *shm, uint64_t write_pos)
+{
+	struct ffm_shm_header *h = shm->header;
+	uint32_t seq = load_sc(&h->space_seq);
+	bool full;
+
+	store_sc(&h->writer_waiting, 1);
+	full = write_pos - load_sc(&h->read_pos) >= h->size;
+	if (full)
+		futex_wait(&h->space_seq, seq);
+	store_sc(&h->writer_waiting, 0);
+
+	if (full) {
+		shm->last_check = os_gettime_ns();
+		return !reader_gone(shm, shm->last_check);
+	}
+	return true;
+}
+
+static bool wait_for_data(struct ffm_shm *shm, uint64_t read_pos)
+{
+	struct ffm_shm_header *h = shm->header;
+	uint32_t seq = load_sc(&h->data_seq);
+	bool empty;
+
+	store_sc(&h->reader_waiting, 1);
+	empty = load_sc(&h->write_pos) == read_pos;
+	if (empty && !load_sc(&h->writer_closed))
+		futex_wait(&h->data_seq, seq);
+	store_sc(&h->reader_waiting, 0);
+
+	/* everything written before closing is still read */
+	return load(&h->write_pos) != read_pos || !writer_gone(shm);
+}
+
+bool ffm_shm_write(struct ffm_shm *shm, const void *vdata, size_t size)
+{
+	struct ffm_shm_header *h = shm->header;
+	const uint8_t *data = vdata;
+	uint64_t write_pos = h->write_pos;
+	uint64_t now = os_gettime_ns();
+
+	if (now - shm->last_check > CHECK_INTERVAL_NS) {
+		shm->last_check = now;
+		if (reader_gone(shm, now))
+			return false;
+	}
+
+	while (size) {
+		size_t space = h->size - (size_t)(write_pos - load(&h->read_pos));
+		size_t offset = (size_t)(write_pos & (h->size - 1));
+		size_t chunk = size;
+
+		if (!space) {
+			if (!wait_for_space(shm, write_pos))
+				return false;
+			continue;
+		}
+
+		if (chunk > space)
+			chunk = space;
+		if (chunk > h->size - offset)
+			chunk = h->size - offset;
+
+		memcpy(h->data + offset, data, chunk);
+		data += chunk;
+		size -= chunk;
+		write_pos += chunk;
+
+		store(&h->write_pos, write_pos);
+		signal_seq(&h->data_seq, &h->reader_waiting);
+	}
+
+	return true;
+}
+
+size_t ffm_shm_read(struct ffm_shm *shm, void *vdata, size_t size)
+{
+	struct ffm_shm_header *h = shm->header;
+	uint8_t *data = vdata;
+	uint64_t read_pos = h->read_pos;
+	size_t total = size;
+
+	while (size) {
+		size_t avail = (size_t)(load(&h->write_pos) - read_pos);
+		size_t offset = (size_t)(read_pos & (h->size - 1));
+		size_t chunk = size;
+
+		if (!avail) {
+			if (!wait_for_data(shm, read_pos))
+				return 0;
+			continue;
+		}
+
+		if (chunk > avail)
+			chunk = avail;
+		if (chunk > h->size - offset)
+			chunk = h->size - offset;
+
+		memcpy(data, h->data + offset, chunk);
+		data += chunk;
+		size -= chunk;
+		read_pos += chunk;
+
+		store(&h->read_pos, read_pos);
+		signal_seq(&h->space_seq, &h->writer_waiting);
+	}
+
+	return total;
+}
+
+#else
+
+struct ffm_shm *ffm_shm_create(void)
+{
+	return NULL;
+}
+
+const char *ffm_shm_path(const struct ffm_shm *shm)
+{
+	UNUSED_PARAMETER(shm);
+	return NULL;
+}
+
+bool ffm_shm_write(struct ffm_shm *shm, const void *data, size_t size)
+{
+	UNUSED_PARAMETER(shm);
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(size);
+	return false;
+}
+
+struct ffm_shm *ffm_shm_open(const char *path)
+{
+	UNUSED_PARAMETER(path);
+	return NULL;
+}
+
+size_t ffm_shm_read(struct ffm_shm *shm, void *data, size_t size)
+{
+	UNUSED_PARAMETER(shm);
+	UNUSED_PARAMETER(data);
+	UNUSED_PARAMETER(size);
+	return 0;
+}
+
+void ffm_shm_destroy(struct ffm_shm *shm)
+{
+	UNUSED_PARAMETER(shm);
+}
+
+#endif
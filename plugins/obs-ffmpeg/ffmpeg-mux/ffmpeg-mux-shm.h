@@ -0,0 +1,47 @@
+/*
+ * Copyright (c) 2026 Uniflow, Inc.
+ * Author: Kim Taehyung <gaiaengine@gmail.com>
+ *
+ * Permission to use, copy, modify, and distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+
+/*
+ * Shared memory ring used in place of the stdin pipe to hand packets to
+ * ffmpeg-mux.  The data is the same byte stream that would go through the
+ * pipe, ffm_packet_info headers followed by packet data.  Only available on
+ * Linux (memfd and futex), ffm_shm_create returns NULL everywhere else and
+ * the pipe is used.
+ */
+
+#define FFM_SHM_ARG "--shm="
+
+struct ffm_shm;
+
+/* obs side */
+struct ffm_shm *ffm_shm_create(void);
+const char *ffm_shm_path(const struct ffm_shm *shm);
+bool ffm_shm_write(struct ffm_shm *shm, const void *data, size_t size);
+
+/* ffmpeg-mux side, returns size, or 0 once obs closed the ring */
+struct ffm_shm *ffm_shm_open(const char *path);
+size_t ffm_shm_read(struct ffm_shm *shm, void *data, size_t size);
+
+/* closes either end, the other end sees the ring as closed.  The obs side
+ * first waits for ffmpeg-mux to attach, for at most a second and only while
+ * ffmpeg-mux is still running. */
+void ffm_shm_destroy(struct ffm_shm *shm);
@@ -25,6 +25,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include "ffmpeg-mux.h"
+#include "ffmpeg-mux-shm.h"
 
 #include <util/threading.h>
 #include <util/platform.h>
@@ -44,6 +45,7 @@
 /* ------------------------------------------------------------------------- */
 
 static char *global_stream_key = "";
+static struct ffm_shm *global_shm = NULL;
 
 struct resize_buf {
 	uint8_t *buf;
@@ -606,6 +608,9 @@ static size_t safe_read(void *vdata, size_t size)
 	uint8_t *data = vdata;
 	size_t total = size;
 
+	if (global_shm)
+		return ffm_shm_read(global_shm, vdata, size);
+
 	while (size > 0) {
 		size_t in_size = fread(data, 1, size, stdin);
 		if (in_size == 0)
@@ -1147,6 +1152,8 @@ int main(int argc, char *argv[])
 	struct resize_buf rb_filename = {0};
 	bool fail = false;
 	int ret;
+	int mux_argc;
+	char **mux_argv;
 
 #ifdef _WIN32
 	char **argv;
@@ -1168,15 +1175,32 @@ int main(int argc, char *argv[])
 #endif
 	setvbuf(stderr, NULL, _IONBF, 0);
 
-	ret = ffmpeg_mux_init(&ffm, argc, argv);
+	mux_argc = argc;
+	mux_argv = argv;
+
+	/* packets come through shared memory instead of stdin */
+	if (argc > 1 && strncmp(argv[1], FFM_SHM_ARG, strlen(FFM_SHM_ARG)) == 0) {
+		global_shm = ffm_shm_open(argv[1] + strlen(FFM_SHM_ARG));
+		if (!global_shm) {
+			fprintf(stderr, "Couldn't open shared memory\n");
+			return FFM_ERROR;
+		}
+
+		/* the option takes the place of the program name */
+		mux_argc--;
+		mux_argv++;
+	}
+
+	ret = ffmpeg_mux_init(&ffm, mux_argc, mux_argv);
 	if (ret != FFM_SUCCESS) {
 		fprintf(stderr, "Couldn't initialize muxer\n");
+		ffm_shm_destroy(global_shm);
 		return ret;
 	}
 
 	while (!fail && safe_read(&info, sizeof(info)) == sizeof(info)) {
 		if (info.type == FFM_PACKET_CHANGE_FILE) {
-			fail = !read_change_file(&ffm, info.size, &rb_filename, argc, argv);
+			fail = !read_change_file(&ffm, info.size, &rb_filename, mux_argc, mux_argv);
 			continue;
 		}
 
@@ -1192,6 +1216,7 @@ int main(int argc, char *argv[])
 	ffmpeg_mux_free(&ffm);
 	resize_buf_free(&rb);
 	resize_buf_free(&rb_filename);
+	ffm_shm_destroy(global_shm);
 
 #ifdef _WIN32
 	for (int i = 0; i < argc; i++)
@@ -723,6 +723,7 @@ static void ffmpeg_mpegts_destroy(void *data)
 		os_sem_destroy(stream->write_sem);
 		os_event_destroy(stream->stop_event);
 		pthread_mutex_destroy(&stream->start_stop_mutex);
+		obs_bitrate_controller_destroy(stream->dbr);
 
 		bfree(data);
 	}
@@ -777,9 +778,15 @@ static int mpegts_process_packet(struct ffmpeg_output *stream)
 	}
 	stream->total_bytes += packet->size;
 	uint8_t *buf = packet->data;
+	struct obs_bitrate_sample dbr_sample = {.send_beg_ns = os_gettime_ns(), .size = (size_t)packet->size};
 	ret = av_interleaved_write_frame(stream->ff_data.output, packet);
 	av_freep(&buf);
 
+	if (stream->dbr && ret >= 0) {
+		dbr_sample.send_end_ns = os_gettime_ns();
+		obs_bitrate_controller_frame_sent(stream->dbr, &dbr_sample);
+	}
+
 	if (ret < 0) {
 		ffmpeg_mpegts_log_error(LOG_WARNING, &stream->ff_data, "process_packet: Error writing packet: %s",
 					av_err2str(ret));
@@ -987,6 +994,78 @@ static bool setup_muxer_settings(struct ffmpeg_output *stream, struct ffmpeg_cfg
 	return true;
 }
 
+static void setup_dynamic_bitrate(struct ffmpeg_output *stream, struct ffmpeg_cfg *config)
+{
+	obs_encoder_t *vencoder = obs_output_get_video_encoder(stream->output);
+	obs_data_t *settings = obs_output_get_settings(stream->output);
+	long audio_bitrate = 0;
+
+	/* the controller of the previous session is kept until here since
+	 * late packets of a delayed stop can still update it */
+	pthread_mutex_lock(&stream->write_mutex);
+	obs_bitrate_controller_destroy(stream->dbr);
+	stream->dbr = NULL;
+	pthread_mutex_unlock(&stream->write_mutex);
+
+	if (!obs_data_get_bool(settings, "dyn_bitrate"))
+		goto done;
+
+	if ((obs_encoder_get_caps(vencoder) & OBS_ENCODER_CAP_DYN_BITRATE) == 0) {
+		info("Dynamic bitrate disabled. "
+		     "The encoder does not support on-the-fly bitrate reconfiguration.");
+		goto done;
+	}
+
+	if (obs_output_get_delay(stream->output) != 0)
+		goto done;
+
+	for (int idx = 0; idx < config->audio_mix_count; idx++)
+		audio_bitrate += config->audio_bitrates[idx];
+
+	obs_bitrate_controller_t *dbr = obs_bitrate_controller_create(
+		obs_data_get_string(settings, "dyn_bitrate_policy"), config->video_bitrate, audio_bitrate);
+	if (dbr)
+		info("Dynamic bitrate enabled.");
+
+	pthread_mutex_lock(&stream->write_mutex);
+	stream->dbr = dbr;
+	pthread_mutex_unlock(&stream->write_mutex);
+
+done:
+	obs_data_release(settings);
+}
+
+static void dbr_set_bitrate(struct ffmpeg_output *stream)
+{
+	obs_encoder_t *vencoder = obs_output_get_video_encoder(stream->output);
+	obs_bitrate_controller_apply(stream->dbr, vencoder);
+}
+
+/* the queue duration is the distance between the oldest and the newest packet
+ * still waiting for the write thread.  The controller is only created and
+ * destroyed with write_mutex held, so it is checked under that lock too. */
+static void dbr_update(struct ffmpeg_output *stream, AVPacket *newest)
+{
+	int64_t queue_usec = 0;
+	bool changed = false;
+
+	pthread_mutex_lock(&stream->write_mutex);
+	if (stream->dbr) {
+		if (stream->packets.num) {
+			uint64_t oldest_ts = get_packet_sys_dts(stream, stream->packets.array[0]);
+			uint64_t newest_ts = get_packet_sys_dts(stream, newest);
+			if (newest_ts > oldest_ts)
+				queue_usec = (int64_t)((newest_ts - oldest_ts) / 1000);
+		}
+
+		changed = obs_bitrate_controller_update(stream->dbr, os_gettime_ns(), queue_usec);
+	}
+	pthread_mutex_unlock(&stream->write_mutex);
+
+	if (changed)
+		dbr_set_bitrate(stream);
+}
+
 static bool ffmpeg_mpegts_finalize(struct ffmpeg_output *stream, struct ffmpeg_cfg *config, int *code)
 {
 	bool success = ffmpeg_mpegts_data_init(stream, &stream->ff_data, config);
@@ -1038,6 +1117,7 @@ static bool set_config(struct ffmpeg_output *stream)
 
 	setup_audio_settings(stream, &config);
 	setup_muxer_settings(stream, &config);
+	setup_dynamic_bitrate(stream, &config);
 
 	/* unused for now; placeholder. */
 	config.video_settings = "";
@@ -1212,7 +1292,19 @@ static void ffmpeg_mpegts_deactivate(struct ffmpeg_output *stream)
 
 	da_free(stream->packets);
 
+	/* reset bitrate on stop, the controller itself stays alive until the
+	 * next start or destroy as the encoder thread may still use it */
+	bool reset = false;
+	if (stream->dbr) {
+		long cur_bitrate = obs_bitrate_controller_get_bitrate(stream->dbr);
+		obs_bitrate_controller_reset(stream->dbr);
+		reset = cur_bitrate != obs_bitrate_controller_get_bitrate(stream->dbr);
+	}
+
 	pthread_mutex_unlock(&stream->write_mutex);
+
+	if (reset)
+		dbr_set_bitrate(stream);
 }
 
 static uint64_t ffmpeg_mpegts_total_bytes(void *data)
@@ -1262,6 +1354,9 @@ void mpegts_write_packet(struct ffmpeg_output *stream, struct encoder_packet *en
 	if (encpacket->keyframe)
 		packet->flags = AV_PKT_FLAG_KEY;
 
+	if (is_video)
+		dbr_update(stream, packet);
+
 	pthread_mutex_lock(&stream->write_mutex);
 	da_push_back(stream->packets, &packet);
 	pthread_mutex_unlock(&stream->write_mutex);
@@ -53,6 +53,8 @@ static inline void replay_buffer_clear(struct ffmpeg_muxer *stream)
 	}
 
 	deque_free(&stream->packets);
+	replay_ring_release(stream->ring);
+	stream->ring = NULL;
 	stream->cur_size = 0;
 	stream->cur_time = 0;
 	stream->max_size = 0;
@@ -73,7 +75,7 @@ static void ffmpeg_mux_destroy(void *data)
 	da_free(stream->mux_packets);
 	deque_free(&stream->packets);
 
-	os_process_pipe_destroy(stream->pipe);
+	stop_pipe(stream);
 	dstr_free(&stream->path);
 	dstr_free(&stream->printable_path);
 	dstr_free(&stream->stream_key);
@@ -283,6 +285,9 @@ static void build_command_line(struct ffmpeg_muxer *stream, os_process_args_t **
 	*args = os_process_args_create(exe);
 	bfree(exe);
 
+	if (stream->shm)
+		os_process_args_add_argf(*args, "%s%s", FFM_SHM_ARG, ffm_shm_path(stream->shm));
+
 	dstr_copy(&stream->path, path);
 	os_process_args_add_arg(*args, path);
 	os_process_args_add_argf(*args, "%d", vencoder ? 1 : 0);
@@ -306,9 +311,40 @@ static void build_command_line(struct ffmpeg_muxer *stream, os_process_args_t **
 void start_pipe(struct ffmpeg_muxer *stream, const char *path)
 {
 	os_process_args_t *args = NULL;
+
+	/* the pipe is still created when packets go through shared memory,
+	 * it carries errors back and waits for the process on exit */
+	stream->shm = ffm_shm_create();
+
 	build_command_line(stream, &args, path);
 	stream->pipe = os_process_pipe_create2(args, "w");
 	os_process_args_destroy(args);
+
+	if (!stream->pipe) {
+		ffm_shm_destroy(stream->shm);
+		stream->shm = NULL;
+	}
+}
+
+int stop_pipe(struct ffmpeg_muxer *stream)
+{
+	int ret;
+
+	/* closing the ring is the end of input, same as closing stdin */
+	ffm_shm_destroy(stream->shm);
+	stream->shm = NULL;
+
+	ret = os_process_pipe_destroy(stream->pipe);
+	stream->pipe = NULL;
+	return ret;
+}
+
+static size_t pipe_write(struct ffmpeg_muxer *stream, const uint8_t *data, size_t size)
+{
+	if (stream->shm)
+		return ffm_shm_write(stream->shm, data, size) ? size : 0;
+
+	return os_process_pipe_write(stream->pipe, data, size);
 }
 
 static void set_file_not_readable_error(struct ffmpeg_muxer *stream, obs_data_t *settings, const char *path)
@@ -467,8 +503,7 @@ int deactivate(struct ffmpeg_muxer *stream, int code)
 	}
 
 	if (active(stream)) {
-		ret = os_process_pipe_destroy(stream->pipe);
-		stream->pipe = NULL;
+		ret = stop_pipe(stream);
 
 		os_atomic_set_bool(&stream->active, false);
 		os_atomic_set_bool(&stream->sent_headers, false);
@@ -623,16 +658,16 @@ bool write_packet(struct ffmpeg_muxer *stream, struct encoder_packet *packet)
 		}
 	}
 
-	ret = os_process_pipe_write(stream->pipe, (const uint8_t *)&info, sizeof(info));
+	ret = pipe_write(stream, (const uint8_t *)&info, sizeof(info));
 	if (ret != sizeof(info)) {
-		warn("os_process_pipe_write for info structure failed");
+		warn("pipe_write for info structure failed");
 		signal_failure(stream);
 		return false;
 	}
 
-	ret = os_process_pipe_write(stream->pipe, packet->data, packet->size);
+	ret = pipe_write(stream, packet->data, packet->size);
 	if (ret != packet->size) {
-		warn("os_process_pipe_write for packet data failed");
+		warn("pipe_write for packet data failed");
 		signal_failure(stream);
 		return false;
 	}
@@ -716,16 +751,16 @@ static bool send_new_filename(struct ffmpeg_muxer *stream, const char *filename)
 	uint32_t size = (uint32_t)strlen(filename);
 	struct ffm_packet_info info = {.type = FFM_PACKET_CHANGE_FILE, .size = size};
 
-	ret = os_process_pipe_write(stream->pipe, (const uint8_t *)&info, sizeof(info));
+	ret = pipe_write(stream, (const uint8_t *)&info, sizeof(info));
 	if (ret != sizeof(info)) {
-		warn("os_process_pipe_write for info structure failed");
+		warn("pipe_write for info structure failed");
 		signal_failure(stream);
 		return false;
 	}
 
-	ret = os_process_pipe_write(stream->pipe, (const uint8_t *)filename, size);
+	ret = pipe_write(stream, (const uint8_t *)filename, size);
 	if (ret != size) {
-		warn("os_process_pipe_write for packet data failed");
+		warn("pipe_write for packet data failed");
 		signal_failure(stream);
 		return false;
 	}
@@ -987,6 +1022,15 @@ static bool replay_buffer_start(void *data)
 	obs_data_t *s = obs_output_get_settings(stream->output);
 	stream->max_time = obs_data_get_int(s, "max_time_sec") * 1000000LL;
 	stream->max_size = obs_data_get_int(s, "max_size_mb") * (1024 * 1024);
+
+	stream->ring_wait_keyframe = false;
+
+	const char *buffer_dir = obs_data_get_string(s, "buffer_dir");
+	if (buffer_dir && *buffer_dir) {
+		stream->ring = replay_ring_create(buffer_dir, stream->max_size, stream->max_time);
+		if (stream->ring)
+			info("Buffering replay in '%s'", buffer_dir);
+	}
 	obs_data_release(s);
 
 	os_atomic_set_bool(&stream->active, true);
@@ -1060,8 +1104,34 @@ static inline void replay_buffer_purge(struct ffmpeg_muxer *stream, struct encod
 		purge(stream);
 }
 
-static void insert_packet(mux_packets_t *packets, struct encoder_packet *packet, int64_t video_offset,
-			  int64_t *audio_offsets, int64_t video_pts_offset, int64_t *audio_dts_offsets)
+struct replay_offsets {
+	bool found_video;
+	bool found_audio[MAX_AUDIO_MIXES];
+	int64_t video_offset;
+	int64_t video_pts_offset;
+	int64_t audio_offsets[MAX_AUDIO_MIXES];
+	int64_t audio_dts_offsets[MAX_AUDIO_MIXES];
+};
+
+/* every track of the saved replay starts at zero */
+static void update_offsets(struct replay_offsets *offsets, const struct encoder_packet *pkt)
+{
+	if (pkt->type == OBS_ENCODER_VIDEO) {
+		if (!offsets->found_video) {
+			offsets->video_pts_offset = pkt->pts;
+			offsets->video_offset = offsets->video_pts_offset * 1000000 / pkt->timebase_den;
+			offsets->found_video = true;
+		}
+	} else {
+		if (!offsets->found_audio[pkt->track_idx]) {
+			offsets->found_audio[pkt->track_idx] = true;
+			offsets->audio_offsets[pkt->track_idx] = pkt->dts_usec;
+			offsets->audio_dts_offsets[pkt->track_idx] = pkt->dts;
+		}
+	}
+}
+
+static void insert_packet(mux_packets_t *packets, struct encoder_packet *packet, const struct replay_offsets *offsets)
 {
 	struct encoder_packet pkt;
 	size_t idx;
@@ -1069,13 +1139,13 @@ static void insert_packet(mux_packets_t *packets, struct encoder_packet *packet,
 	obs_encoder_packet_ref(&pkt, packet);
 
 	if (pkt.type == OBS_ENCODER_VIDEO) {
-		pkt.dts_usec -= video_offset;
-		pkt.dts -= video_pts_offset;
-		pkt.pts -= video_pts_offset;
+		pkt.dts_usec -= offsets->video_offset;
+		pkt.dts -= offsets->video_pts_offset;
+		pkt.pts -= offsets->video_pts_offset;
 	} else {
-		pkt.dts_usec -= audio_offsets[pkt.track_idx];
-		pkt.dts -= audio_dts_offsets[pkt.track_idx];
-		pkt.pts -= audio_dts_offsets[pkt.track_idx];
+		pkt.dts_usec -= offsets->audio_offsets[pkt.track_idx];
+		pkt.dts -= offsets->audio_dts_offsets[pkt.track_idx];
+		pkt.pts -= offsets->audio_dts_offsets[pkt.track_idx];
 	}
 
 	for (idx = packets->num; idx > 0; idx--) {
@@ -1087,21 +1157,41 @@ static void insert_packet(mux_packets_t *packets, struct encoder_packet *packet,
 	da_insert(*packets, idx, &pkt);
 }
 
-static void *replay_buffer_mux_thread(void *data)
+static bool replay_buffer_mux_begin(struct ffmpeg_muxer *stream)
 {
-	struct ffmpeg_muxer *stream = data;
-	bool error = false;
-
 	start_pipe(stream, stream->path.array);
 
 	if (!stream->pipe) {
 		warn("Failed to create process pipe");
-		error = true;
-		goto error;
+		return false;
 	}
 
 	if (!send_headers(stream)) {
 		warn("Could not write headers for file '%s'", stream->path.array);
+		return false;
+	}
+
+	return true;
+}
+
+static void replay_buffer_mux_end(struct ffmpeg_muxer *stream, bool error)
+{
+	stop_pipe(stream);
+	os_atomic_set_bool(&stream->muxing, false);
+
+	if (!error) {
+		calldata_t cd = {0};
+		signal_handler_t *sh = obs_output_get_signal_handler(stream->output);
+		signal_handler_signal(sh, "saved", &cd);
+	}
+}
+
+static void *replay_buffer_mux_thread(void *data)
+{
+	struct ffmpeg_muxer *stream = data;
+	bool error = false;
+
+	if (!replay_buffer_mux_begin(stream)) {
 		error = true;
 		goto error;
 	}
@@ -1119,70 +1209,136 @@ static void *replay_buffer_mux_thread(void *data)
 	info("Wrote replay buffer to '%s'", stream->path.array);
 
 error:
-	os_process_pipe_destroy(stream->pipe);
-	stream->pipe = NULL;
 	if (error) {
 		for (size_t i = 0; i < stream->mux_packets.num; i++)
 			obs_encoder_packet_release(&stream->mux_packets.array[i]);
 	}
 	da_free(stream->mux_packets);
-	os_atomic_set_bool(&stream->muxing, false);
+	replay_buffer_mux_end(stream, error);
 
-	if (!error) {
-		calldata_t cd = {0};
-		signal_handler_t *sh = obs_output_get_signal_handler(stream->output);
-		signal_handler_signal(sh, "saved", &cd);
+	return NULL;
+}
+
+/* the per-track offsets only move packets by less than a frame, so a few
+ * packets of lookahead are enough to keep the output in order */
+#define RING_REORDER_PACKETS 64
+
+static bool write_front_packet(struct ffmpeg_muxer *stream, mux_packets_t *packets)
+{
+	bool success = write_packet(stream, &packets->array[0]);
+	obs_encoder_packet_release(&packets->array[0]);
+	da_erase(*packets, 0);
+	return success;
+}
+
+/* streams the pinned range of the disk buffer straight to the muxer, only
+ * the reorder window is held in memory */
+static void *replay_buffer_ring_mux_thread(void *data)
+{
+	struct ffmpeg_muxer *stream = data;
+	struct replay_ring *ring = stream->save_ring;
+	struct replay_ring_range range = stream->save_range;
+	struct replay_offsets offsets = {0};
+	mux_packets_t packets = {0};
+	struct encoder_packet pkt;
+	bool error = false;
+
+	if (!replay_buffer_mux_begin(stream)) {
+		error = true;
+		goto error;
+	}
+
+	while (replay_ring_read(ring, &range, &pkt, true)) {
+		update_offsets(&offsets, &pkt);
+		insert_packet(&packets, &pkt, &offsets);
+		obs_encoder_packet_release(&pkt);
+
+		if (packets.num > RING_REORDER_PACKETS && !write_front_packet(stream, &packets)) {
+			warn("Could not write packet for file '%s'", stream->path.array);
+			error = true;
+			goto error;
+		}
+	}
+
+	if (range.start < range.end) {
+		warn("Could not read replay buffer for file '%s'", stream->path.array);
+		error = true;
+		goto error;
+	}
+
+	while (packets.num) {
+		if (!write_front_packet(stream, &packets)) {
+			warn("Could not write packet for file '%s'", stream->path.array);
+			error = true;
+			goto error;
+		}
 	}
 
+	info("Wrote replay buffer to '%s'", stream->path.array);
+
+error:
+	for (size_t i = 0; i < packets.num; i++)
+		obs_encoder_packet_release(&packets.array[i]);
+	da_free(packets);
+
+	replay_ring_end_read(ring);
+	replay_ring_release(ring);
+	stream->save_ring = NULL;
+
+	replay_buffer_mux_end(stream, error);
 	return NULL;
 }
 
-static void replay_buffer_save(struct ffmpeg_muxer *stream)
+static void get_mux_packets(struct ffmpeg_muxer *stream)
 {
 	const size_t size = sizeof(struct encoder_packet);
 	size_t num_packets = stream->packets.size / size;
+	struct replay_offsets offsets = {0};
 
 	da_reserve(stream->mux_packets, num_packets);
 
-	/* ---------------------------- */
-	/* reorder packets */
-
-	bool found_video = false;
-	bool found_audio[MAX_AUDIO_MIXES] = {0};
-	int64_t video_offset = 0;
-	int64_t video_pts_offset = 0;
-	int64_t audio_offsets[MAX_AUDIO_MIXES] = {0};
-	int64_t audio_dts_offsets[MAX_AUDIO_MIXES] = {0};
-
 	for (size_t i = 0; i < num_packets; i++) {
 		struct encoder_packet *pkt;
 		pkt = deque_data(&stream->packets, i * size);
 
-		if (pkt->type == OBS_ENCODER_VIDEO) {
-			if (!found_video) {
-				video_pts_offset = pkt->pts;
-				video_offset = video_pts_offset * 1000000 / pkt->timebase_den;
-				found_video = true;
-			}
-		} else {
-			if (!found_audio[pkt->track_idx]) {
-				found_audio[pkt->track_idx] = true;
-				audio_offsets[pkt->track_idx] = pkt->dts_usec;
-				audio_dts_offsets[pkt->track_idx] = pkt->dts;
-			}
+		update_offsets(&offsets, pkt);
+		insert_packet(&stream->mux_packets, pkt, &offsets);
+	}
+}
+
+static void replay_buffer_save(struct ffmpeg_muxer *stream)
+{
+	void *(*mux_thread)(void *) = replay_buffer_mux_thread;
+
+	if (stream->ring) {
+		if (!replay_ring_begin_read(stream->ring, &stream->save_range)) {
+			warn("Could not read replay buffer");
+			return;
 		}
 
-		insert_packet(&stream->mux_packets, pkt, video_offset, audio_offsets, video_pts_offset,
-			      audio_dts_offsets);
+		replay_ring_addref(stream->ring);
+		stream->save_ring = stream->ring;
+		mux_thread = replay_buffer_ring_mux_thread;
+	} else {
+		get_mux_packets(stream);
 	}
 
 	generate_filename(stream, &stream->path, true);
 
 	os_atomic_set_bool(&stream->muxing, true);
-	stream->mux_thread_joinable = pthread_create(&stream->mux_thread, NULL, replay_buffer_mux_thread, stream) == 0;
+	stream->mux_thread_joinable = pthread_create(&stream->mux_thread, NULL, mux_thread, stream) == 0;
 	if (!stream->mux_thread_joinable) {
 		warn("Failed to create muxer thread");
 		os_atomic_set_bool(&stream->muxing, false);
+
+		if (stream->save_ring) {
+			replay_ring_end_read(stream->save_ring);
+			replay_ring_release(stream->save_ring);
+			stream->save_ring = NULL;
+		}
+		for (size_t i = 0; i < stream->mux_packets.num; i++)
+			obs_encoder_packet_release(&stream->mux_packets.array[i]);
+		da_free(stream->mux_packets);
 	}
 }
 
@@ -1221,17 +1377,34 @@ static void replay_buffer_data(void *data, struct encoder_packet *packet)
 		}
 	}
 
-	obs_encoder_packet_ref(&pkt, packet);
-	replay_buffer_purge(stream, &pkt);
+	if (stream->ring && !replay_ring_push(stream->ring, packet)) {
+		warn("Could not write to replay buffer files, buffering in memory instead");
+		replay_ring_release(stream->ring);
+		stream->ring = NULL;
 
-	if (!stream->packets.size)
-		stream->cur_time = pkt.dts_usec;
-	stream->cur_size += pkt.size;
+		/* the memory buffer has to start on a keyframe for the next
+		 * save to be decodable */
+		stream->ring_wait_keyframe = true;
+	}
+
+	if (stream->ring_wait_keyframe) {
+		if (packet->type == OBS_ENCODER_VIDEO && packet->keyframe)
+			stream->ring_wait_keyframe = false;
+	}
+
+	if (!stream->ring && !stream->ring_wait_keyframe) {
+		obs_encoder_packet_ref(&pkt, packet);
+		replay_buffer_purge(stream, &pkt);
 
-	deque_push_back(&stream->packets, packet, sizeof(*packet));
+		if (!stream->packets.size)
+			stream->cur_time = pkt.dts_usec;
+		stream->cur_size += pkt.size;
 
-	if (packet->type == OBS_ENCODER_VIDEO && packet->keyframe)
-		stream->keyframes++;
+		deque_push_back(&stream->packets, packet, sizeof(*packet));
+
+		if (packet->type == OBS_ENCODER_VIDEO && packet->keyframe)
+			stream->keyframes++;
+	}
 
 	if (stream->save_ts && packet->sys_dts_usec >= stream->save_ts) {
 		if (os_atomic_load_bool(&stream->muxing))
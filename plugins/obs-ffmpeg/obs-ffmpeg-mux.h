@@ -9,11 +9,15 @@
 #include <util/platform.h>
 #include <util/threading.h>
 
+#include "obs-ffmpeg-replay-ring.h"
+#include "ffmpeg-mux/ffmpeg-mux-shm.h"
+
 typedef DARRAY(struct encoder_packet) mux_packets_t;
 
 struct ffmpeg_muxer {
 	obs_output_t *output;
 	os_process_pipe_t *pipe;
+	struct ffm_shm *shm;
 	int64_t stop_ts;
 	uint64_t total_bytes;
 	bool sent_headers;
@@ -38,6 +42,12 @@ struct ffmpeg_muxer {
 	volatile bool muxing;
 	mux_packets_t mux_packets;
 
+	/* replay buffer on disk */
+	struct replay_ring *ring;
+	struct replay_ring *save_ring;
+	struct replay_ring_range save_range;
+	bool ring_wait_keyframe;
+
 	/* split file */
 	bool found_video;
 	bool found_audio[MAX_AUDIO_MIXES];
@@ -69,6 +79,7 @@ struct ffmpeg_muxer {
 bool stopping(struct ffmpeg_muxer *stream);
 bool active(struct ffmpeg_muxer *stream);
 void start_pipe(struct ffmpeg_muxer *stream, const char *path);
+int stop_pipe(struct ffmpeg_muxer *stream);
 bool write_packet(struct ffmpeg_muxer *stream, struct encoder_packet *packet);
 bool send_headers(struct ffmpeg_muxer *stream);
 int deactivate(struct ffmpeg_muxer *stream, int code);
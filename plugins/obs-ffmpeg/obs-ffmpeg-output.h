@@ -122,6 +122,8 @@ struct ffmpeg_output {
 	pthread_mutex_t start_stop_mutex;
 	volatile bool start_stop_thread_active;
 	bool has_connected;
+
+	obs_bitrate_controller_t *dbr;
 #endif
 };
 
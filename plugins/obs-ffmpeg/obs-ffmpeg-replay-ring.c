@@ -0,0 +1,459 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include "obs-ffmpeg-replay-ring.h"
+
+#include <inttypes.h>
+#include <util/deque.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#define RING_SEGMENT_SIZE (64 * 1024 * 1024)
+#define NO_SEGMENT UINT64_MAX
+
+/* packet header in the segment files, followed by the packet data */
+struct ring_record {
+	int64_t pts;
+	int64_t dts;
+	int64_t dts_usec;
+	int64_t sys_dts_usec;
+	int32_t timebase_num;
+	int32_t timebase_den;
+	uint32_t size;
+	uint32_t track_idx;
+	int32_t priority;
+	uint8_t type;
+	uint8_t keyframe;
+};
+
+struct ring_segment {
+	os_mapped_file_t *file;
+	size_t used;
+};
+
+struct ring_keyframe {
+	uint64_t pos;
+	int64_t dts_usec;
+	int64_t bytes;
+};
+
+/* positions are segment number * RING_SEGMENT_SIZE + offset, so they keep
+ * increasing while the files are reused */
+struct replay_ring {
+	volatile long refs;
+	pthread_mutex_t mutex;
+
+	struct dstr path_prefix;
+	uint64_t next_file_id;
+	size_t max_segments;
+	int64_t max_size;
+	int64_t max_time;
+	bool failed;
+
+	struct deque segments; /* struct ring_segment, oldest first */
+	uint64_t first_segment;
+
+	/* video keyframes from the start of the buffer on */
+	struct deque keyframes; /* struct ring_keyframe */
+	int64_t bytes_written;
+
+	bool empty;
+	uint64_t start_pos;
+	int64_t start_dts_usec;
+	int64_t start_bytes;
+
+	bool reading;
+	uint64_t read_segment;
+	uint64_t read_mapped;
+};
+
+static inline size_t record_size(size_t data_size)
+{
+	size_t size = sizeof(struct ring_record) + data_size;
+	return (size + 7) & ~(size_t)7;
+}
+
+static inline size_t num_segments(struct replay_ring *ring)
+{
+	return ring->segments.size / sizeof(struct ring_segment);
+}
+
+static inline struct ring_segment *get_segment(struct replay_ring *ring, uint64_t segment_num)
+{
+	if (segment_num < ring->first_segment)
+		return NULL;
+	return deque_data(&ring->segments, (size_t)(segment_num - ring->first_segment) * sizeof(struct ring_segment));
+}
+
+static inline uint64_t write_segment(struct replay_ring *ring)
+{
+	return ring->first_segment + num_segments(ring) - 1;
+}
+
+static inline size_t num_keyframes(struct replay_ring *ring)
+{
+	return ring->keyframes.size / sizeof(struct ring_keyframe);
+}
+
+/* the segment still holds buffered packets */
+static inline bool segment_live(struct replay_ring *ring, uint64_t segment_num)
+{
+	return !ring->empty && ring->start_pos < (segment_num + 1) * RING_SEGMENT_SIZE;
+}
+
+static inline bool segment_pinned(struct replay_ring *ring, uint64_t segment_num)
+{
+	return ring->reading && segment_num >= ring->read_segment;
+}
+
+struct replay_ring *replay_ring_create(const char *dir, int64_t max_size, int64_t max_time)
+{
+	struct replay_ring *ring = bzalloc(sizeof(*ring));
+	char *uuid = os_generate_uuid();
+
+	ring->refs = 1;
+	ring->empty = true;
+	ring->read_mapped = NO_SEGMENT;
+	ring->max_size = max_size;
+	ring->max_time = max_time;
+
+	/* one extra for the partially purged oldest segment */
+	if (max_size)
+		ring->max_segments = (size_t)((max_size + RING_SEGMENT_SIZE - 1) / RING_SEGMENT_SIZE) + 1;
+
+	dstr_copy(&ring->path_prefix, dir);
+	dstr_replace(&ring->path_prefix, "\\", "/");
+	if (dstr_end(&ring->path_prefix) != '/')
+		dstr_cat_ch(&ring->path_prefix, '/');
+	dstr_catf(&ring->path_prefix, "obs-replay-%s", uuid);
+	bfree(uuid);
+
+	if (pthread_mutex_init(&ring->mutex, NULL) != 0) {
+		dstr_free(&ring->path_prefix);
+		bfree(ring);
+		return NULL;
+	}
+
+	return ring;
+}
+
+void replay_ring_addref(struct replay_ring *ring)
+{
+	os_atomic_inc_long(&ring->refs);
+}
+
+void replay_ring_release(struct replay_ring *ring)
+{
+	if (!ring || os_atomic_dec_long(&ring->refs) != 0)
+		return;
+
+	while (ring->segments.size) {
+		struct ring_segment segment;
+		deque_pop_front(&ring->segments, &segment, sizeof(segment));
+		os_mapped_file_close(segment.file);
+	}
+
+	deque_free(&ring->segments);
+	deque_free(&ring->keyframes);
+	dstr_free(&ring->path_prefix);
+	pthread_mutex_destroy(&ring->mutex);
+	bfree(ring);
+}
+
+/* moves the start of the buffer to the next keyframe */
+static bool purge_gop(struct replay_ring *ring)
+{
+	struct ring_keyframe *keyframe = deque_data(&ring->keyframes, 0);
+	size_t count = num_keyframes(ring);
+
+	if (!count || (count == 1 && keyframe->pos == ring->start_pos))
+		return false;
+
+	if (keyframe->pos == ring->start_pos) {
+		deque_pop_front(&ring->keyframes, NULL, sizeof(*keyframe));
+		keyframe = deque_data(&ring->keyframes, 0);
+	}
+
+	ring->start_pos = keyframe->pos;
+	ring->start_dts_usec = keyframe->dts_usec;
+	ring->start_bytes = keyframe->bytes;
+	return true;
+}
+
+static void purge(struct replay_ring *ring, const struct encoder_packet *packet)
+{
+	if (ring->empty)
+		return;
+
+	while (num_keyframes(ring) > 2) {
+		int64_t size = ring->bytes_written - ring->start_bytes + (int64_t)packet->size;
+		bool over_size = ring->max_size && size > ring->max_size;
+		bool over_time = packet->dts_usec - ring->start_dts_usec > ring->max_time;
+
+		if (!over_size && !over_time)
+			break;
+		if (!purge_gop(ring))
+			break;
+	}
+}
+
+static os_mapped_file_t *new_segment_file(struct replay_ring *ring)
+{
+	struct dstr path = {0};
+	os_mapped_file_t *file;
+
+	dstr_printf(&path, "%s-%" PRIu64 ".tmp", ring->path_prefix.array, ring->next_file_id++);
+	file = os_mapped_file_create(path.array, RING_SEGMENT_SIZE, true);
+	if (!file)
+		blog(LOG_WARNING, "Failed to create replay buffer file '%s'", path.array);
+
+	dstr_free(&path);
+	return file;
+}
+
+static bool next_segment(struct replay_ring *ring)
+{
+	struct ring_segment segment = {0};
+	size_t count = num_segments(ring);
+
+	/* at the size limit the oldest file gets reused, even if that means
+	 * dropping buffered packets earlier than the purge would */
+	if (ring->max_segments && count >= ring->max_segments && !segment_pinned(ring, ring->first_segment)) {
+		while (segment_live(ring, ring->first_segment) && purge_gop(ring))
+			;
+	}
+
+	if (count > 1 && !segment_live(ring, ring->first_segment) && !segment_pinned(ring, ring->first_segment)) {
+		deque_pop_front(&ring->segments, &segment, sizeof(segment));
+		ring->first_segment++;
+		segment.used = 0;
+
+		if (ring->read_mapped != ring->first_segment - 1)
+			os_mapped_file_unmap(segment.file);
+	} else {
+		segment.file = new_segment_file(ring);
+		if (!segment.file)
+			return false;
+	}
+
+	deque_push_back(&ring->segments, &segment, sizeof(segment));
+	return true;
+}
+
+static struct ring_segment *get_write_segment(struct replay_ring *ring, size_t size)
+{
+	if (ring->segments.size) {
+		uint64_t segment_num = write_segment(ring);
+		struct ring_segment *segment = get_segment(ring, segment_num);
+
+		if (segment->used + size <= RING_SEGMENT_SIZE)
+			return segment;
+
+		/* done with it, unless it's being read it doesn't need to
+		 * stay mapped */
+		if (ring->read_mapped != segment_num)
+			os_mapped_file_unmap(segment->file);
+	}
+
+	if (!next_segment(ring))
+		return NULL;
+
+	return get_segment(ring, write_segment(ring));
+}
+
+bool replay_ring_push(struct replay_ring *ring, const struct encoder_packet *packet)
+{
+	size_t size = record_size(packet->size);
+	struct ring_segment *segment;
+	struct ring_record record;
+	uint8_t *data;
+	uint64_t pos;
+
+	if (size > RING_SEGMENT_SIZE)
+		return false;
+
+	pthread_mutex_lock(&ring->mutex);
+
+	if (ring->failed)
+		goto fail;
+
+	purge(ring, packet);
+
+	segment = get_write_segment(ring, size);
+	if (!segment)
+		goto fail;
+
+	data = os_mapped_file_map(segment->file);
+	if (!data) {
+		blog(LOG_WARNING, "Failed to map replay buffer file");
+		goto fail;
+	}
+
+	record.pts = packet->pts;
+	record.dts = packet->dts;
+	record.dts_usec = packet->dts_usec;
+	record.sys_dts_usec = packet->sys_dts_usec;
+	record.timebase_num = packet->timebase_num;
+	record.timebase_den = packet->timebase_den;
+	record.size = (uint32_t)packet->size;
+	record.track_idx = (uint32_t)packet->track_idx;
+	record.priority = packet->priority;
+	record.type = (uint8_t)packet->type;
+	record.keyframe = packet->keyframe;
+
+	memcpy(data + segment->used, &record, sizeof(record));
+	memcpy(data + segment->used + sizeof(record), packet->data, packet->size);
+
+	pos = write_segment(ring) * RING_SEGMENT_SIZE + segment->used;
+	segment->used += size;
+
+	if (ring->empty) {
+		ring->empty = false;
+		ring->start_pos = pos;
+		ring->start_dts_usec = packet->dts_usec;
+		ring->start_bytes = ring->bytes_written;
+	}
+
+	if (packet->type == OBS_ENCODER_VIDEO && packet->keyframe) {
+		struct ring_keyframe keyframe = {pos, packet->dts_usec, ring->bytes_written};
+		deque_push_back(&ring->keyframes, &keyframe, sizeof(keyframe));
+	}
+
+	ring->bytes_written += (int64_t)packet->size;
+
+	pthread_mutex_unlock(&ring->mutex);
+	return true;
+
+fail:
+	ring->failed = true;
+	pthread_mutex_unlock(&ring->mutex);
+	return false;
+}
+
+bool replay_ring_begin_read(struct replay_ring *ring, struct replay_ring_range *range)
+{
+	bool success = false;
+
+	pthread_mutex_lock(&ring->mutex);
+
+	if (!ring->empty && !ring->failed && !ring->reading) {
+		uint64_t segment_num = write_segment(ring);
+
+		range->start = ring->start_pos;
+		range->end = segment_num * RING_SEGMENT_SIZE + get_segment(ring, segment_num)->used;
+
+		ring->reading = true;
+		ring->read_segment = ring->start_pos / RING_SEGMENT_SIZE;
+		ring->read_mapped = NO_SEGMENT;
+		success = true;
+	}
+
+	pthread_mutex_unlock(&ring->mutex);
+	return success;
+}
+
+static void unmap_read_segment(struct replay_ring *ring)
+{
+	struct ring_segment *segment;
+
+	if (ring->read_mapped == NO_SEGMENT)
+		return;
+
+	segment = get_segment(ring, ring->read_mapped);
+	if (segment && ring->read_mapped != write_segment(ring))
+		os_mapped_file_unmap(segment->file);
+
+	ring->read_mapped = NO_SEGMENT;
+}
+
+void replay_ring_end_read(struct replay_ring *ring)
+{
+	pthread_mutex_lock(&ring->mutex);
+	unmap_read_segment(ring);
+	ring->reading = false;
+	pthread_mutex_unlock(&ring->mutex);
+}
+
+bool replay_ring_read(struct replay_ring *ring, struct replay_ring_range *range, struct encoder_packet *packet,
+		      bool with_data)
+{
+	bool success = false;
+
+	pthread_mutex_lock(&ring->mutex);
+
+	while (range->start < range->end) {
+		uint64_t segment_num = range->start / RING_SEGMENT_SIZE;
+		size_t offset = (size_t)(range->start % RING_SEGMENT_SIZE);
+		struct ring_segment *segment = get_segment(ring, segment_num);
+		struct ring_record record;
+		uint8_t *data;
+
+		if (!segment)
+			break;
+
+		if (offset >= segment->used) {
+			range->start = (segment_num + 1) * RING_SEGMENT_SIZE;
+			continue;
+		}
+
+		if (ring->read_mapped != segment_num) {
+			unmap_read_segment(ring);
+			ring->read_mapped = segment_num;
+		}
+
+		/* segments that have been streamed out can be reused */
+		if (with_data)
+			ring->read_segment = segment_num;
+
+		data = os_mapped_file_map(segment->file);
+		if (!data)
+			break;
+
+		memcpy(&record, data + offset, sizeof(record));
+
+		memset(packet, 0, sizeof(*packet));
+		packet->pts = record.pts;
+		packet->dts = record.dts;
+		packet->dts_usec = record.dts_usec;
+		packet->sys_dts_usec = record.sys_dts_usec;
+		packet->timebase_num = record.timebase_num;
+		packet->timebase_den = record.timebase_den;
+		packet->size = record.size;
+		packet->track_idx = record.track_idx;
+		packet->priority = record.priority;
+		packet->type = (enum obs_encoder_type)record.type;
+		packet->keyframe = record.keyframe;
+
+		/* same layout as packets from libobs so it can be released
+		 * with obs_encoder_packet_release */
+		if (with_data) {
+			long *refs = bmalloc(sizeof(long) + record.size);
+			*refs = 1;
+			packet->data = (uint8_t *)(refs + 1);
+			memcpy(packet->data, data + offset + sizeof(record), record.size);
+		}
+
+		range->start += record_size(record.size);
+		success = true;
+		break;
+	}
+
+	pthread_mutex_unlock(&ring->mutex);
+	return success;
+}
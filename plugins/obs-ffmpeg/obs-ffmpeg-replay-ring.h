@@ -0,0 +1,34 @@
+#pragma once
+
+#include <obs-module.h>
+
+/*
+ * Disk-backed packet store for the replay buffer.  Packets are appended to a
+ * ring of preallocated segment files as they arrive, only the keyframe index
+ * is kept in memory.  A save pins the buffered range so it can be streamed
+ * back out while new packets keep being written.
+ */
+
+struct replay_ring;
+
+struct replay_ring_range {
+	uint64_t start;
+	uint64_t end;
+};
+
+extern struct replay_ring *replay_ring_create(const char *dir, int64_t max_size, int64_t max_time);
+extern void replay_ring_addref(struct replay_ring *ring);
+extern void replay_ring_release(struct replay_ring *ring);
+
+/* copies the packet into the ring, purging old data as needed */
+extern bool replay_ring_push(struct replay_ring *ring, const struct encoder_packet *packet);
+
+/* pins the currently buffered packets until replay_ring_end_read */
+extern bool replay_ring_begin_read(struct replay_ring *ring, struct replay_ring_range *range);
+extern void replay_ring_end_read(struct replay_ring *ring);
+
+/* reads the packet at range->start and advances it.  without with_data only
+ * the packet's timing information is filled in and packet->data is NULL,
+ * otherwise the packet must be released with obs_encoder_packet_release */
+extern bool replay_ring_read(struct replay_ring *ring, struct replay_ring_range *range, struct encoder_packet *packet,
+			     bool with_data);
@@ -264,6 +264,43 @@ static inline void write_previous_tag_size(struct serializer *s)
 	write_previous_tag_size_without_header(s, 0);
 }
 
+/* writes tag headers into a fixed buffer on the stack for the *_header
+ * functions, whose callers send the packet payload separately */
+struct tag_header_data {
+	uint8_t *buf;
+	size_t pos;
+};
+
+static size_t tag_header_write(void *param, const void *data, size_t size)
+{
+	struct tag_header_data *header = param;
+
+	assert(header->pos + size <= FLV_TAG_HEADER_MAX);
+	if (header->pos + size > FLV_TAG_HEADER_MAX)
+		return 0;
+
+	memcpy(header->buf + header->pos, data, size);
+	header->pos += size;
+	return size;
+}
+
+static int64_t tag_header_get_pos(void *param)
+{
+	struct tag_header_data *header = param;
+	return (int64_t)header->pos;
+}
+
+static void tag_header_serializer_init(struct serializer *s, struct tag_header_data *data,
+				       uint8_t buf[FLV_TAG_HEADER_MAX])
+{
+	memset(s, 0, sizeof(*s));
+	data->buf = buf;
+	data->pos = 0;
+	s->data = data;
+	s->write = tag_header_write;
+	s->get_pos = tag_header_get_pos;
+}
+
 void flv_meta_data(obs_output_t *context, uint8_t **output, size_t *size, bool write_header)
 {
 	struct array_output_data data;
@@ -305,7 +342,8 @@ void flv_meta_data(obs_output_t *context, uint8_t **output, size_t *size, bool w
 static int32_t last_time = 0;
 #endif
 
-static void flv_video(struct serializer *s, int32_t dts_offset, struct encoder_packet *packet, bool is_header)
+static void flv_video(struct serializer *s, int32_t dts_offset, struct encoder_packet *packet, bool is_header,
+		      bool header_only)
 {
 	int32_t ct_offset_ms = get_ms_time(packet, packet->pts) - get_ms_time(packet, packet->dts);
 	int32_t time_ms = get_ms_time(packet, packet->dts) - dts_offset;
@@ -333,12 +371,16 @@ static void flv_video(struct serializer *s, int32_t dts_offset, struct encoder_p
 	s_w8(s, packet->keyframe ? 0x17 : 0x27);
 	s_w8(s, is_header ? 0 : 1);
 	s_wb24(s, ct_offset_ms);
+	if (header_only)
+		return;
+
 	s_write(s, packet->data, packet->size);
 
 	write_previous_tag_size(s);
 }
 
-static void flv_audio(struct serializer *s, int32_t dts_offset, struct encoder_packet *packet, bool is_header)
+static void flv_audio(struct serializer *s, int32_t dts_offset, struct encoder_packet *packet, bool is_header,
+		      bool header_only)
 {
 	int32_t time_ms = get_ms_time(packet, packet->dts) - dts_offset;
 
@@ -364,6 +406,9 @@ static void flv_audio(struct serializer *s, int32_t dts_offset, struct encoder_p
 	/* these are the two extra bytes mentioned above */
 	s_w8(s, 0xaf);
 	s_w8(s, is_header ? 0 : 1);
+	if (header_only)
+		return;
+
 	s_write(s, packet->data, packet->size);
 
 	write_previous_tag_size(s);
@@ -377,22 +422,33 @@ void flv_packet_mux(struct encoder_packet *packet, int32_t dts_offset, uint8_t *
 	array_output_serializer_init(&s, &data);
 
 	if (packet->type == OBS_ENCODER_VIDEO)
-		flv_video(&s, dts_offset, packet, is_header);
+		flv_video(&s, dts_offset, packet, is_header, false);
 	else
-		flv_audio(&s, dts_offset, packet, is_header);
+		flv_audio(&s, dts_offset, packet, is_header, false);
 
 	*output = data.bytes.array;
 	*size = data.bytes.num;
 }
 
-void flv_packet_audio_ex(struct encoder_packet *packet, enum audio_id_t codec_id, int32_t dts_offset, uint8_t **output,
-			 size_t *size, int type, size_t idx)
+size_t flv_packet_mux_header(struct encoder_packet *packet, int32_t dts_offset, uint8_t buf[FLV_TAG_HEADER_MAX],
+			     bool is_header)
 {
-	struct array_output_data data;
+	struct tag_header_data data;
 	struct serializer s;
 
-	array_output_serializer_init(&s, &data);
+	tag_header_serializer_init(&s, &data, buf);
+
+	if (packet->type == OBS_ENCODER_VIDEO)
+		flv_video(&s, dts_offset, packet, is_header, true);
+	else
+		flv_audio(&s, dts_offset, packet, is_header, true);
+
+	return data.pos;
+}
 
+static void flv_audio_ex(struct serializer *s, struct encoder_packet *packet, enum audio_id_t codec_id,
+			 int32_t dts_offset, int type, size_t idx, bool header_only)
+{
 	assert(packet->type == OBS_ENCODER_AUDIO);
 
 	int32_t time_ms = get_ms_time(packet, packet->dts) - dts_offset;
@@ -406,7 +462,7 @@ void flv_packet_audio_ex(struct encoder_packet *packet, enum audio_id_t codec_id
 	if (is_multitrack)
 		header_metadata_size += 2; // w8 + w8
 
-	s_w8(&s, RTMP_PACKET_TYPE_AUDIO);
+	s_w8(s, RTMP_PACKET_TYPE_AUDIO);
 
 #ifdef DEBUG_TIMESTAMPS
 	blog(LOG_DEBUG, "Audio: %lu", time_ms);
@@ -417,36 +473,45 @@ void flv_packet_audio_ex(struct encoder_packet *packet, enum audio_id_t codec_id
 	last_time = time_ms;
 #endif
 
-	s_wb24(&s, (uint32_t)packet->size + header_metadata_size);
-	s_wb24(&s, (uint32_t)time_ms);
-	s_w8(&s, (time_ms >> 24) & 0x7F);
-	s_wb24(&s, 0);
+	s_wb24(s, (uint32_t)packet->size + header_metadata_size);
+	s_wb24(s, (uint32_t)time_ms);
+	s_w8(s, (time_ms >> 24) & 0x7F);
+	s_wb24(s, 0);
 
-	s_w8(&s, AUDIO_HEADER_EX | (is_multitrack ? AUDIO_PACKETTYPE_MULTITRACK : type));
+	s_w8(s, AUDIO_HEADER_EX | (is_multitrack ? AUDIO_PACKETTYPE_MULTITRACK : type));
 	if (is_multitrack) {
-		s_w8(&s, MULTITRACKTYPE_ONE_TRACK | type);
-		s_wa4cc(&s, codec_id);
-		s_w8(&s, (uint8_t)idx);
+		s_w8(s, MULTITRACKTYPE_ONE_TRACK | type);
+		s_wa4cc(s, codec_id);
+		s_w8(s, (uint8_t)idx);
 	} else {
-		s_wa4cc(&s, codec_id);
+		s_wa4cc(s, codec_id);
 	}
 
-	s_write(&s, packet->data, packet->size);
+	if (header_only)
+		return;
 
-	write_previous_tag_size(&s);
+	s_write(s, packet->data, packet->size);
 
-	*output = data.bytes.array;
-	*size = data.bytes.num;
+	write_previous_tag_size(s);
 }
 
-// Y2023 spec
-void flv_packet_ex(struct encoder_packet *packet, enum video_id_t codec_id, int32_t dts_offset, uint8_t **output,
-		   size_t *size, int type, size_t idx)
+void flv_packet_audio_ex(struct encoder_packet *packet, enum audio_id_t codec_id, int32_t dts_offset, uint8_t **output,
+			 size_t *size, int type, size_t idx)
 {
 	struct array_output_data data;
 	struct serializer s;
+
 	array_output_serializer_init(&s, &data);
+	flv_audio_ex(&s, packet, codec_id, dts_offset, type, idx, false);
+
+	*output = data.bytes.array;
+	*size = data.bytes.num;
+}
 
+// Y2023 spec
+static void flv_video_ex(struct serializer *s, struct encoder_packet *packet, enum video_id_t codec_id,
+			 int32_t dts_offset, int type, size_t idx, bool header_only)
+{
 	assert(packet->type == OBS_ENCODER_VIDEO);
 
 	int32_t time_ms = get_ms_time(packet, packet->dts) - dts_offset;
@@ -462,10 +527,10 @@ void flv_packet_ex(struct encoder_packet *packet, enum video_id_t codec_id, int3
 	if (is_multitrack)
 		header_metadata_size += 2; // w8+w8
 
-	s_w8(&s, RTMP_PACKET_TYPE_VIDEO);
-	s_wb24(&s, (uint32_t)packet->size + header_metadata_size);
-	s_wtimestamp(&s, time_ms);
-	s_wb24(&s, 0); // always 0
+	s_w8(s, RTMP_PACKET_TYPE_VIDEO);
+	s_wb24(s, (uint32_t)packet->size + header_metadata_size);
+	s_wtimestamp(s, time_ms);
+	s_wb24(s, 0); // always 0
 
 	uint8_t frame_type = packet->keyframe ? FT_KEY : FT_INTER;
 
@@ -474,27 +539,40 @@ void flv_packet_ex(struct encoder_packet *packet, enum video_id_t codec_id, int3
 	 * The default trackId is 0.
 	 */
 	if (is_multitrack) {
-		s_w8(&s, FRAME_HEADER_EX | PACKETTYPE_MULTITRACK | frame_type);
-		s_w8(&s, MULTITRACKTYPE_ONE_TRACK | type);
-		s_w4cc(&s, codec_id);
+		s_w8(s, FRAME_HEADER_EX | PACKETTYPE_MULTITRACK | frame_type);
+		s_w8(s, MULTITRACKTYPE_ONE_TRACK | type);
+		s_w4cc(s, codec_id);
 		// trackId
-		s_w8(&s, (uint8_t)idx);
+		s_w8(s, (uint8_t)idx);
 	} else {
-		s_w8(&s, FRAME_HEADER_EX | type | frame_type);
-		s_w4cc(&s, codec_id);
+		s_w8(s, FRAME_HEADER_EX | type | frame_type);
+		s_w4cc(s, codec_id);
 	}
 
 	// H.264/HEVC composition time offset
 	if ((codec_id == CODEC_H264 || codec_id == CODEC_HEVC) && type == PACKETTYPE_FRAMES) {
 		int32_t ct_offset_ms = get_ms_time(packet, packet->pts) - get_ms_time(packet, packet->dts);
-		s_wb24(&s, ct_offset_ms);
+		s_wb24(s, ct_offset_ms);
 	}
 
+	if (header_only)
+		return;
+
 	// packet data
-	s_write(&s, packet->data, packet->size);
+	s_write(s, packet->data, packet->size);
 
 	// packet tail
-	write_previous_tag_size(&s);
+	write_previous_tag_size(s);
+}
+
+void flv_packet_ex(struct encoder_packet *packet, enum video_id_t codec_id, int32_t dts_offset, uint8_t **output,
+		   size_t *size, int type, size_t idx)
+{
+	struct array_output_data data;
+	struct serializer s;
+	array_output_serializer_init(&s, &data);
+
+	flv_video_ex(&s, packet, codec_id, dts_offset, type, idx, false);
 
 	*output = data.bytes.array;
 	*size = data.bytes.num;
@@ -505,15 +583,30 @@ void flv_packet_start(struct encoder_packet *packet, enum video_id_t codec, uint
 	flv_packet_ex(packet, codec, 0, output, size, PACKETTYPE_SEQ_START, idx);
 }
 
-void flv_packet_frames(struct encoder_packet *packet, enum video_id_t codec, int32_t dts_offset, uint8_t **output,
-		       size_t *size, size_t idx)
+static inline int get_frames_packet_type(struct encoder_packet *packet, enum video_id_t codec)
 {
-	int packet_type = PACKETTYPE_FRAMES;
 	// PACKETTYPE_FRAMESX is an optimization to avoid sending composition
 	// time offsets of 0. See Enhanced RTMP spec.
 	if ((codec == CODEC_H264 || codec == CODEC_HEVC) && packet->dts == packet->pts)
-		packet_type = PACKETTYPE_FRAMESX;
-	flv_packet_ex(packet, codec, dts_offset, output, size, packet_type, idx);
+		return PACKETTYPE_FRAMESX;
+	return PACKETTYPE_FRAMES;
+}
+
+void flv_packet_frames(struct encoder_packet *packet, enum video_id_t codec, int32_t dts_offset, uint8_t **output,
+		       size_t *size, size_t idx)
+{
+	flv_packet_ex(packet, codec, dts_offset, output, size, get_frames_packet_type(packet, codec), idx);
+}
+
+size_t flv_packet_frames_header(struct encoder_packet *packet, enum video_id_t codec, int32_t dts_offset,
+				uint8_t buf[FLV_TAG_HEADER_MAX], size_t idx)
+{
+	struct tag_header_data data;
+	struct serializer s;
+
+	tag_header_serializer_init(&s, &data, buf);
+	flv_video_ex(&s, packet, codec, dts_offset, get_frames_packet_type(packet, codec), idx, true);
+	return data.pos;
 }
 
 void flv_packet_end(struct encoder_packet *packet, enum video_id_t codec, uint8_t **output, size_t *size, size_t idx)
@@ -533,6 +626,17 @@ void flv_packet_audio_frames(struct encoder_packet *packet, enum audio_id_t code
 	flv_packet_audio_ex(packet, codec, dts_offset, output, size, AUDIO_PACKETTYPE_FRAMES, idx);
 }
 
+size_t flv_packet_audio_frames_header(struct encoder_packet *packet, enum audio_id_t codec, int32_t dts_offset,
+				      uint8_t buf[FLV_TAG_HEADER_MAX], size_t idx)
+{
+	struct tag_header_data data;
+	struct serializer s;
+
+	tag_header_serializer_init(&s, &data, buf);
+	flv_audio_ex(&s, packet, codec, dts_offset, AUDIO_PACKETTYPE_FRAMES, idx, true);
+	return data.pos;
+}
+
 void flv_packet_metadata(enum video_id_t codec_id, uint8_t **output, size_t *size, int bits_per_raw_sample,
 			 uint8_t color_primaries, int color_trc, int color_space, int min_luminance, int max_luminance,
 			 size_t idx)
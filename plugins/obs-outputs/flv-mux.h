@@ -63,11 +63,25 @@ extern void write_file_info(FILE *file, int64_t duration_ms, int64_t size);
 extern void flv_meta_data(obs_output_t *context, uint8_t **output, size_t *size, bool write_header);
 extern void flv_packet_mux(struct encoder_packet *packet, int32_t dts_offset, uint8_t **output, size_t *size,
 			   bool is_header);
+
+/* Largest FLV tag header plus tag body prefix written by the *_header
+ * functions below.  These write the tag up to the packet payload and return
+ * its size, so the payload can be sent from packet->data without copying.
+ * The previous tag size that follows the tag is not written. */
+#define FLV_TAG_HEADER_MAX 32
+
+/* Size of the previous tag size field that follows every FLV tag */
+#define FLV_PREV_TAG_SIZE 4
+
+extern size_t flv_packet_mux_header(struct encoder_packet *packet, int32_t dts_offset, uint8_t buf[FLV_TAG_HEADER_MAX],
+				    bool is_header);
 // Y2023 spec
 extern void flv_packet_start(struct encoder_packet *packet, enum video_id_t codec, uint8_t **output, size_t *size,
 			     size_t idx);
 extern void flv_packet_frames(struct encoder_packet *packet, enum video_id_t codec, int32_t dts_offset,
 			      uint8_t **output, size_t *size, size_t idx);
+extern size_t flv_packet_frames_header(struct encoder_packet *packet, enum video_id_t codec, int32_t dts_offset,
+				       uint8_t buf[FLV_TAG_HEADER_MAX], size_t idx);
 extern void flv_packet_end(struct encoder_packet *packet, enum video_id_t codec, uint8_t **output, size_t *size,
 			   size_t idx);
 extern void flv_packet_metadata(enum video_id_t codec, uint8_t **output, size_t *size, int bits_per_raw_sample,
@@ -77,3 +91,5 @@ extern void flv_packet_audio_start(struct encoder_packet *packet, enum audio_id_
 				   size_t idx);
 extern void flv_packet_audio_frames(struct encoder_packet *packet, enum audio_id_t codec, int32_t dts_offset,
 				    uint8_t **output, size_t *size, size_t idx);
+extern size_t flv_packet_audio_frames_header(struct encoder_packet *packet, enum audio_id_t codec, int32_t dts_offset,
+					     uint8_t buf[FLV_TAG_HEADER_MAX], size_t idx);
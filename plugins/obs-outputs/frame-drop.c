@@ -0,0 +1,110 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/*
+ * Congestion handling shared by the RTMP outputs.  Each output keeps its own
+ * send buffer, these only decide which of the buffered frames can go.
+ */
+
+#include "frame-drop.h"
+
+#include <obs-avc.h>
+
+const char *drop_level_name(int level)
+{
+	switch (level) {
+	case OBS_NAL_PRIORITY_LOW:
+		return "non_reference";
+	case OBS_NAL_PRIORITY_HIGH:
+		return "enhancement";
+	default:
+		return "gop";
+	}
+}
+
+int64_t drop_goal(size_t buffered_size, size_t dropped_size, int64_t buffer_duration_usec, int64_t drop_threshold)
+{
+	return (int64_t)buffered_size - (int64_t)((double)(drop_threshold * DROP_TARGET_PERCENT / 100) *
+						  (double)(buffered_size + dropped_size) /
+						  (double)buffer_duration_usec);
+}
+
+/*
+ * Sheds the fewest bytes that bring the buffer back under the target without
+ * breaking decoding.  Frames are taken by reference level, lowest first:
+ * non-reference frames, then low priority and enhancement layer references,
+ * then (for p-frames) the tails of whole GOPs.  A reference can only go if
+ * everything after it that may depend on it goes too, so every run of lower
+ * level frames between two frames of the current level is trimmed from its
+ * end backwards, oldest run first.  If the newest run gets trimmed, incoming
+ * frames below that level are dropped until the next frame of the level.
+ */
+bool plan_frame_drops(struct encoder_packet *const *video, size_t num_video, int64_t goal, int max_level, bool *drop,
+		      struct drop_plan *plan)
+{
+	memset(plan, 0, sizeof(*plan));
+
+	for (int level = OBS_NAL_PRIORITY_LOW; level <= max_level && plan->size < goal; level++) {
+		size_t run_start = 0;
+
+		for (size_t i = 0; i <= num_video && plan->size < goal; i++) {
+			/* do not drop video keyframes */
+			if (i < num_video && video[i]->drop_priority < level && !video[i]->keyframe)
+				continue;
+
+			for (size_t j = i; j > run_start && plan->size < goal; j--) {
+				if (drop[j - 1])
+					continue;
+
+				drop[j - 1] = true;
+				plan->size += video[j - 1]->size;
+				plan->frames++;
+				plan->level = level;
+
+				/* nothing references non-reference frames */
+				if (i == num_video && level > OBS_NAL_PRIORITY_LOW)
+					plan->until_next = level;
+			}
+
+			run_start = i + 1;
+		}
+	}
+
+	return plan->frames != 0;
+}
+
+int64_t effective_buffer_duration(struct deque *dropped, size_t *dropped_size, size_t buffered_size,
+				  int64_t first_dts_usec, int64_t buffer_duration_usec)
+{
+	struct dropped_frame frame;
+
+	while (dropped->size) {
+		deque_peek_front(dropped, &frame, sizeof(frame));
+		if (frame.dts_usec >= first_dts_usec)
+			break;
+
+		deque_pop_front(dropped, &frame, sizeof(frame));
+		*dropped_size -= frame.size;
+	}
+
+	if (!*dropped_size)
+		return buffer_duration_usec;
+
+	return (int64_t)((double)buffer_duration_usec * (double)buffered_size /
+			 (double)(buffered_size + *dropped_size));
+}
@@ -0,0 +1,60 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#pragma once
+
+#include <obs.h>
+#include <util/deque.h>
+
+/* frames are shed until the buffer is back under this share of the drop
+ * threshold */
+#define DROP_TARGET_PERCENT 90
+
+/* a frame shed from the send buffer */
+struct dropped_frame {
+	int64_t dts_usec;
+	size_t size;
+};
+
+/* the frames picked by plan_frame_drops() */
+struct drop_plan {
+	int level;
+	int frames;
+	int64_t size;
+
+	/* incoming frames below this level are dropped until the next frame
+	 * of the level, or 0 */
+	int until_next;
+};
+
+extern const char *drop_level_name(int level);
+
+/* bytes to shed for the effective buffer duration to get back under
+ * DROP_TARGET_PERCENT of the threshold */
+extern int64_t drop_goal(size_t buffered_size, size_t dropped_size, int64_t buffer_duration_usec,
+			 int64_t drop_threshold);
+
+/* marks the buffered video frames to drop in the drop array, returns false if
+ * nothing can be dropped up to max_level */
+extern bool plan_frame_drops(struct encoder_packet *const *video, size_t num_video, int64_t goal, int max_level,
+			     bool *drop, struct drop_plan *plan);
+
+/* frames shed from the buffer still count toward the time between its oldest
+ * and newest frame, so scale that by the share of bytes left to send */
+extern int64_t effective_buffer_duration(struct deque *dropped, size_t *dropped_size, size_t buffered_size,
+					 int64_t first_dts_usec, int64_t buffer_duration_usec);
@@ -0,0 +1,780 @@
+/******************************************************************************
+    Copyright (C) 2024 by Dennis Sädtler <dennis@obsproject.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/******************************************************************************
+    Modifications Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+    Modified: 2026-02-12
+    Notes: CMAF HLS output based on the MP4 muxer.
+******************************************************************************/
+
+#include "mp4-mux.h"
+
+#include <inttypes.h>
+
+#include <obs-module.h>
+#include <util/array-serializer.h>
+#include <util/darray.h>
+#include <util/deque.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <util/threading.h>
+
+#include <curl/curl.h>
+
+/*
+ * HLS output writing CMAF (fragmented MP4) segments directly from the MP4
+ * muxer.  Every fragment the muxer flushes is a partial segment, a keyframe
+ * starts a new segment.  The header, segments, (low-latency) parts and the
+ * media playlist are uploaded with HTTP PUT next to the playlist URL.
+ */
+
+#define do_log(level, format, ...) \
+	blog(level, "[hls output: '%s'] " format, obs_output_get_name(out->output), ##__VA_ARGS__)
+
+#define warn(format, ...) do_log(LOG_WARNING, format, ##__VA_ARGS__)
+#define info(format, ...) do_log(LOG_INFO, format, ##__VA_ARGS__)
+
+#define DEFAULT_SEGMENT_DURATION 2
+/* Each upload is tried UPLOAD_ATTEMPTS times, the output stops after
+ * MAX_UPLOAD_FAILURES uploads in a row failed every attempt */
+#define UPLOAD_ATTEMPTS 3
+#define UPLOAD_RETRY_DELAY_MS 250
+#define MAX_UPLOAD_FAILURES 3
+#define UPLOAD_TIMEOUT_SEC 10L
+/* Parts are listed for the segment being written and the ones before it */
+#define PARTS_IN_PLAYLIST 3
+
+struct hls_upload {
+	struct dstr url;
+	const char *content_type;
+	DARRAY(uint8_t) data;
+	/* Marks the end of the stream, nothing is uploaded */
+	bool final;
+};
+
+struct hls_part {
+	int64_t duration_usec;
+	bool independent;
+};
+
+struct hls_segment {
+	uint64_t sequence;
+	int64_t duration_usec;
+	bool complete;
+	DARRAY(struct hls_part) parts;
+};
+
+struct hls_output {
+	obs_output_t *output;
+
+	pthread_mutex_t mutex;
+
+	volatile bool active;
+	volatile bool stopping;
+	uint64_t stop_ts;
+	uint64_t total_bytes;
+
+	struct mp4_mux *muxer;
+	struct serializer serializer;
+	struct array_output_data buffer;
+
+	/* Everything is uploaded to <url_base><name><url_suffix>, the playlist
+	 * refers to it as <name_base><name><url_suffix>. */
+	struct dstr playlist_url;
+	struct dstr url_base;
+	struct dstr url_suffix;
+	struct dstr name_base;
+
+	bool low_latency;
+	int64_t part_duration;
+	int64_t target_duration;
+	size_t playlist_size;
+
+	/* Segments currently in the playlist, the last one may still be
+	 * written to */
+	DARRAY(struct hls_segment) segments;
+	DARRAY(uint8_t) segment_data;
+	uint64_t next_sequence;
+
+	/* Uploads are done in order on a separate thread */
+	pthread_t upload_thread;
+	bool upload_thread_active;
+	pthread_mutex_t upload_mutex;
+	os_sem_t *upload_sem;
+	struct deque uploads;
+	volatile bool abort_uploads;
+};
+
+static inline bool stopping(struct hls_output *out)
+{
+	return os_atomic_load_bool(&out->stopping);
+}
+
+static inline bool active(struct hls_output *out)
+{
+	return os_atomic_load_bool(&out->active);
+}
+
+static const char *hls_output_name(void *unused)
+{
+	UNUSED_PARAMETER(unused);
+	return obs_module_text("HLSOutput");
+}
+
+/* ------------------------------------------------------------------------- */
+/* Uploads                                                                   */
+
+static void hls_upload_free(struct hls_upload *upload)
+{
+	dstr_free(&upload->url);
+	da_free(upload->data);
+	bfree(upload);
+}
+
+static void push_upload(struct hls_output *out, struct hls_upload *upload)
+{
+	pthread_mutex_lock(&out->upload_mutex);
+	deque_push_back(&out->uploads, &upload, sizeof(upload));
+	pthread_mutex_unlock(&out->upload_mutex);
+	os_sem_post(out->upload_sem);
+}
+
+static struct hls_upload *pop_upload(struct hls_output *out)
+{
+	struct hls_upload *upload = NULL;
+
+	pthread_mutex_lock(&out->upload_mutex);
+	if (out->uploads.size)
+		deque_pop_front(&out->uploads, &upload, sizeof(upload));
+	pthread_mutex_unlock(&out->upload_mutex);
+
+	return upload;
+}
+
+static void free_uploads(struct hls_output *out)
+{
+	struct hls_upload *upload;
+
+	while ((upload = pop_upload(out)) != NULL)
+		hls_upload_free(upload);
+}
+
+/* Takes over the data, leaving the array empty.  A NULL name uploads the
+ * playlist itself. */
+static void queue_upload(struct hls_output *out, const char *name, const char *content_type, struct darray *data)
+{
+	struct hls_upload *upload = bzalloc(sizeof(*upload));
+
+	if (name)
+		dstr_printf(&upload->url, "%s%s%s", out->url_base.array, name,
+			    out->url_suffix.array ? out->url_suffix.array : "");
+	else
+		dstr_copy_dstr(&upload->url, &out->playlist_url);
+	upload->content_type = content_type;
+	darray_move(&upload->data.da, data);
+
+	out->total_bytes += upload->data.num;
+	push_upload(out, upload);
+}
+
+struct upload_reader {
+	const uint8_t *data;
+	size_t size;
+	size_t pos;
+};
+
+static size_t read_upload(char *buffer, size_t size, size_t nitems, void *param)
+{
+	struct upload_reader *reader = param;
+	size_t len = size * nitems;
+
+	if (len > reader->size - reader->pos)
+		len = reader->size - reader->pos;
+
+	memcpy(buffer, reader->data + reader->pos, len);
+	reader->pos += len;
+	return len;
+}
+
+static size_t discard_response(char *ptr, size_t size, size_t nmemb, void *param)
+{
+	UNUSED_PARAMETER(ptr);
+	UNUSED_PARAMETER(param);
+	return size * nmemb;
+}
+
+static bool send_upload(struct hls_output *out, CURL *curl, struct hls_upload *upload)
+{
+	struct upload_reader reader = {upload->data.array, upload->data.num, 0};
+	char error[CURL_ERROR_SIZE] = {0};
+	struct curl_slist *headers = NULL;
+	struct dstr content_type = {0};
+	long response_code = 0;
+	CURLcode res;
+
+	dstr_printf(&content_type, "Content-Type: %s", upload->content_type);
+	headers = curl_slist_append(headers, content_type.array);
+	dstr_free(&content_type);
+
+	curl_easy_setopt(curl, CURLOPT_URL, upload->url.array);
+	curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+	curl_easy_setopt(curl, CURLOPT_READDATA, &reader);
+	curl_easy_setopt(curl, CURLOPT_INFILESIZE_LARGE, (curl_off_t)upload->data.num);
+	curl_easy_setopt(curl, CURLOPT_ERRORBUFFER, error);
+
+	res = curl_easy_perform(curl);
+	curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+	curl_slist_free_all(headers);
+
+	if (res != CURLE_OK) {
+		warn("Upload of '%s' failed: %s", upload->url.array, *error ? error : curl_easy_strerror(res));
+		return false;
+	}
+	if (response_code < 200 || response_code >= 300) {
+		warn("Upload of '%s' failed with HTTP status %ld", upload->url.array, response_code);
+		return false;
+	}
+
+	return true;
+}
+
+/* A segment that never arrives leaves a hole in the playlist, so retry
+ * before giving up on it */
+static bool send_upload_retry(struct hls_output *out, CURL *curl, struct hls_upload *upload)
+{
+	for (int attempt = 1;; attempt++) {
+		if (send_upload(out, curl, upload))
+			return true;
+		if (attempt == UPLOAD_ATTEMPTS)
+			return false;
+
+		os_sleep_ms(UPLOAD_RETRY_DELAY_MS);
+		if (os_atomic_load_bool(&out->abort_uploads))
+			return false;
+	}
+}
+
+static void *upload_thread(void *data)
+{
+	struct hls_output *out = data;
+	struct dstr user_agent = {0};
+	size_t failures = 0;
+	bool finished = false;
+	CURL *curl;
+
+	os_set_thread_name("hls-output: upload");
+
+	curl = curl_easy_init();
+	if (!curl) {
+		warn("Failed to initialize curl");
+		goto fail;
+	}
+
+	/* One handle for everything so the connection is kept alive */
+	dstr_printf(&user_agent, "libobs/%s", obs_get_version_string());
+	curl_easy_setopt(curl, CURLOPT_UPLOAD, 1L);
+	curl_easy_setopt(curl, CURLOPT_READFUNCTION, read_upload);
+	curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, discard_response);
+	curl_easy_setopt(curl, CURLOPT_USERAGENT, user_agent.array);
+	curl_easy_setopt(curl, CURLOPT_TIMEOUT, UPLOAD_TIMEOUT_SEC);
+	curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+
+	while (os_sem_wait(out->upload_sem) == 0) {
+		struct hls_upload *upload = pop_upload(out);
+
+		if (os_atomic_load_bool(&out->abort_uploads)) {
+			if (upload)
+				hls_upload_free(upload);
+			break;
+		}
+		if (!upload)
+			continue;
+
+		finished = upload->final;
+		if (!finished && !send_upload_retry(out, curl, upload))
+			failures++;
+		else
+			failures = 0;
+
+		hls_upload_free(upload);
+
+		if (finished)
+			break;
+		if (failures >= MAX_UPLOAD_FAILURES) {
+			warn("Too many failed uploads, stopping");
+			goto fail;
+		}
+	}
+
+	curl_easy_cleanup(curl);
+	dstr_free(&user_agent);
+
+	if (finished) {
+		info("All segments uploaded");
+		obs_output_end_data_capture(out->output);
+	}
+	return NULL;
+
+fail:
+	if (curl)
+		curl_easy_cleanup(curl);
+	dstr_free(&user_agent);
+
+	os_atomic_set_bool(&out->active, false);
+	obs_output_signal_stop(out->output, OBS_OUTPUT_DISCONNECTED);
+	return NULL;
+}
+
+static void stop_upload_thread(struct hls_output *out)
+{
+	if (out->upload_thread_active) {
+		os_atomic_set_bool(&out->abort_uploads, true);
+		os_sem_post(out->upload_sem);
+		pthread_join(out->upload_thread, NULL);
+		out->upload_thread_active = false;
+	}
+
+	free_uploads(out);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Playlist                                                                  */
+
+static inline double usec_to_sec(int64_t usec)
+{
+	return (double)usec / 1000000.0;
+}
+
+static void free_segment(struct hls_segment *segment)
+{
+	da_free(segment->parts);
+}
+
+static void free_segments(struct hls_output *out)
+{
+	for (size_t i = 0; i < out->segments.num; i++)
+		free_segment(&out->segments.array[i]);
+
+	da_free(out->segments);
+	da_free(out->segment_data);
+}
+
+static inline struct hls_segment *current_segment(struct hls_output *out)
+{
+	struct hls_segment *last = da_end(out->segments);
+	return last && !last->complete ? last : NULL;
+}
+
+static void write_playlist(struct hls_output *out, bool end)
+{
+	struct dstr playlist = {0};
+	struct darray data = {0};
+	const char *suffix = out->url_suffix.array ? out->url_suffix.array : "";
+	const char *name = out->name_base.array ? out->name_base.array : "";
+	uint64_t first_sequence = out->segments.num ? out->segments.array[0].sequence : out->next_sequence;
+	int64_t target = out->target_duration;
+
+	/* EXT-X-TARGETDURATION has to cover every segment */
+	for (size_t i = 0; i < out->segments.num; i++) {
+		if (out->segments.array[i].complete && out->segments.array[i].duration_usec > target)
+			target = out->segments.array[i].duration_usec;
+	}
+
+	dstr_copy(&playlist, "#EXTM3U\n");
+	dstr_catf(&playlist, "#EXT-X-VERSION:%d\n", out->low_latency ? 9 : 7);
+	dstr_catf(&playlist, "#EXT-X-TARGETDURATION:%" PRId64 "\n", (target + 999999) / 1000000);
+
+	if (out->low_latency) {
+		dstr_catf(&playlist, "#EXT-X-SERVER-CONTROL:PART-HOLD-BACK=%.3f\n",
+			  usec_to_sec(out->part_duration * 3));
+		dstr_catf(&playlist, "#EXT-X-PART-INF:PART-TARGET=%.3f\n", usec_to_sec(out->part_duration));
+	}
+
+	dstr_catf(&playlist, "#EXT-X-MEDIA-SEQUENCE:%" PRIu64 "\n", first_sequence);
+	dstr_catf(&playlist, "#EXT-X-MAP:URI=\"%sinit.mp4%s\"\n", name, suffix);
+
+	for (size_t i = 0; i < out->segments.num; i++) {
+		struct hls_segment *segment = &out->segments.array[i];
+
+		if (out->low_latency && !end && i + PARTS_IN_PLAYLIST >= out->segments.num) {
+			for (size_t p = 0; p < segment->parts.num; p++) {
+				struct hls_part *part = &segment->parts.array[p];
+
+				dstr_catf(&playlist, "#EXT-X-PART:DURATION=%.5f,URI=\"%s%" PRIu64 ".%zu.m4s%s\"%s\n",
+					  usec_to_sec(part->duration_usec), name, segment->sequence, p, suffix,
+					  part->independent ? ",INDEPENDENT=YES" : "");
+			}
+		}
+
+		if (segment->complete) {
+			dstr_catf(&playlist, "#EXTINF:%.3f,\n", usec_to_sec(segment->duration_usec));
+			dstr_catf(&playlist, "%s%" PRIu64 ".m4s%s\n", name, segment->sequence, suffix);
+		}
+	}
+
+	if (end) {
+		dstr_cat(&playlist, "#EXT-X-ENDLIST\n");
+	} else if (out->low_latency) {
+		struct hls_segment *segment = current_segment(out);
+
+		if (segment)
+			dstr_catf(&playlist, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s%" PRIu64 ".%zu.m4s%s\"\n", name,
+				  segment->sequence, segment->parts.num, suffix);
+		else
+			dstr_catf(&playlist, "#EXT-X-PRELOAD-HINT:TYPE=PART,URI=\"%s%" PRIu64 ".0.m4s%s\"\n", name,
+				  out->next_sequence, suffix);
+	}
+
+	darray_push_back_array(sizeof(char), &data, playlist.array, playlist.len);
+	dstr_free(&playlist);
+	queue_upload(out, NULL, "application/vnd.apple.mpegurl", &data);
+}
+
+static void finish_segment(struct hls_output *out)
+{
+	struct hls_segment *segment = current_segment(out);
+	struct dstr name = {0};
+
+	if (!segment)
+		return;
+
+	segment->complete = true;
+
+	dstr_printf(&name, "%" PRIu64 ".m4s", segment->sequence);
+	queue_upload(out, name.array, "video/mp4", &out->segment_data.da);
+	dstr_free(&name);
+
+	while (out->segments.num > out->playlist_size) {
+		free_segment(&out->segments.array[0]);
+		da_erase(out->segments, 0);
+	}
+}
+
+static void hls_fragment_written(void *param, const struct mp4_fragment_info *frag)
+{
+	struct hls_output *out = param;
+	struct hls_segment *segment;
+
+	if (frag->header) {
+		queue_upload(out, "init.mp4", "video/mp4", &out->buffer.bytes.da);
+		array_output_serializer_reset(&out->buffer);
+		return;
+	}
+
+	/* Segments always start with a keyframe */
+	if (frag->independent && out->segment_data.num) {
+		finish_segment(out);
+		if (!out->low_latency)
+			write_playlist(out, false);
+	}
+
+	segment = current_segment(out);
+	if (!segment) {
+		segment = da_push_back_new(out->segments);
+		segment->sequence = out->next_sequence++;
+	}
+
+	segment->duration_usec += frag->duration_usec;
+	da_push_back_array(out->segment_data, out->buffer.bytes.array, out->buffer.bytes.num);
+
+	if (out->low_latency) {
+		struct hls_part *part = da_push_back_new(segment->parts);
+		struct dstr name = {0};
+
+		part->duration_usec = frag->duration_usec;
+		part->independent = frag->independent;
+
+		dstr_printf(&name, "%" PRIu64 ".%zu.m4s", segment->sequence, segment->parts.num - 1);
+		queue_upload(out, name.array, "video/mp4", &out->buffer.bytes.da);
+		dstr_free(&name);
+
+		write_playlist(out, false);
+	}
+
+	array_output_serializer_reset(&out->buffer);
+}
+
+/* ------------------------------------------------------------------------- */
+
+/* Segments are named after the playlist, "stream.m3u8?key" uploads
+ * "stream_init.mp4?key", "stream_0.m4s?key" and so on.  A URL without a
+ * playlist name is treated as a directory. */
+static void parse_url(struct hls_output *out, const char *url)
+{
+	const char *ext = strstr(url, ".m3u8");
+	const char *query;
+	const char *slash;
+
+	if (ext) {
+		dstr_ncopy(&out->url_base, url, ext - url);
+		dstr_copy(&out->url_suffix, ext + strlen(".m3u8"));
+		dstr_copy(&out->playlist_url, url);
+	} else {
+		dstr_copy(&out->url_base, url);
+		dstr_depad(&out->url_base);
+		if (dstr_end(&out->url_base) != '/')
+			dstr_cat_ch(&out->url_base, '/');
+		dstr_cat(&out->url_base, "stream");
+		dstr_free(&out->url_suffix);
+		dstr_printf(&out->playlist_url, "%s.m3u8", out->url_base.array);
+	}
+
+	dstr_cat_ch(&out->url_base, '_');
+
+	/* The playlist refers to everything relative to its own location */
+	query = strchr(out->url_base.array, '?');
+	slash = out->url_base.array;
+	for (const char *c = out->url_base.array; *c && (!query || c < query); c++) {
+		if (*c == '/')
+			slash = c + 1;
+	}
+	dstr_copy(&out->name_base, slash);
+}
+
+static void hls_output_destroy(void *data)
+{
+	struct hls_output *out = data;
+
+	stop_upload_thread(out);
+	if (out->muxer)
+		mp4_mux_destroy(out->muxer);
+
+	free_segments(out);
+	array_output_serializer_free(&out->buffer);
+	deque_free(&out->uploads);
+	os_sem_destroy(out->upload_sem);
+	pthread_mutex_destroy(&out->upload_mutex);
+	pthread_mutex_destroy(&out->mutex);
+	dstr_free(&out->playlist_url);
+	dstr_free(&out->url_base);
+	dstr_free(&out->url_suffix);
+	dstr_free(&out->name_base);
+	bfree(out);
+}
+
+static void *hls_output_create(obs_data_t *settings, obs_output_t *output)
+{
+	struct hls_output *out = bzalloc(sizeof(struct hls_output));
+	out->output = output;
+	array_output_serializer_init(&out->serializer, &out->buffer);
+	pthread_mutex_init_value(&out->mutex);
+	pthread_mutex_init_value(&out->upload_mutex);
+
+	if (pthread_mutex_init(&out->mutex, NULL) != 0)
+		goto fail;
+	if (pthread_mutex_init(&out->upload_mutex, NULL) != 0)
+		goto fail;
+	if (os_sem_init(&out->upload_sem, 0) != 0)
+		goto fail;
+
+	UNUSED_PARAMETER(settings);
+	return out;
+
+fail:
+	hls_output_destroy(out);
+	return NULL;
+}
+
+static bool hls_output_start(void *data)
+{
+	struct hls_output *out = data;
+	obs_service_t *service;
+	obs_encoder_t *vencoder;
+	obs_data_t *settings;
+	struct dstr url = {0};
+	int keyint_sec;
+
+	if (!obs_output_can_begin_data_capture(out->output, 0))
+		return false;
+	if (!obs_output_initialize_encoders(out->output, 0))
+		return false;
+
+	service = obs_output_get_service(out->output);
+	if (!service)
+		return false;
+
+	/* Clean up after a previous run */
+	stop_upload_thread(out);
+	free_segments(out);
+	array_output_serializer_reset(&out->buffer);
+	os_atomic_set_bool(&out->abort_uploads, false);
+	os_atomic_set_bool(&out->stopping, false);
+	out->next_sequence = 0;
+	out->total_bytes = 0;
+
+	const char *server = obs_service_get_connect_info(service, OBS_SERVICE_CONNECT_INFO_SERVER_URL);
+	const char *key = obs_service_get_connect_info(service, OBS_SERVICE_CONNECT_INFO_STREAM_KEY);
+	dstr_copy(&url, server);
+	dstr_replace(&url, "{stream_key}", key ? key : "");
+	if (dstr_is_empty(&url)) {
+		warn("No server URL specified");
+		dstr_free(&url);
+		return false;
+	}
+	parse_url(out, url.array);
+	dstr_free(&url);
+
+	/* One segment per keyframe interval */
+	vencoder = obs_output_get_video_encoder(out->output);
+	settings = obs_encoder_get_settings(vencoder);
+	keyint_sec = (int)obs_data_get_int(settings, "keyint_sec");
+	obs_data_release(settings);
+	out->target_duration = (keyint_sec ? keyint_sec : DEFAULT_SEGMENT_DURATION) * 1000000LL;
+
+	settings = obs_output_get_settings(out->output);
+	out->low_latency = obs_data_get_bool(settings, "low_latency");
+	out->part_duration = obs_data_get_int(settings, "part_duration_ms") * 1000;
+	out->playlist_size = (size_t)obs_data_get_int(settings, "playlist_size");
+	obs_data_release(settings);
+
+	if (out->part_duration <= 0 || out->part_duration > out->target_duration)
+		out->low_latency = false;
+	if (out->playlist_size < 1)
+		out->playlist_size = 1;
+
+	out->upload_thread_active = pthread_create(&out->upload_thread, NULL, upload_thread, out) == 0;
+	if (!out->upload_thread_active) {
+		warn("Failed to create upload thread");
+		return false;
+	}
+
+	/* Initialise muxer and start capture.  A muxer is still around if the
+	 * previous run was stopped by an upload failure. */
+	pthread_mutex_lock(&out->mutex);
+	if (out->muxer)
+		mp4_mux_destroy(out->muxer);
+	out->muxer = mp4_mux_create(out->output, &out->serializer, MP4_USE_NEGATIVE_CTS | MP4_SKIP_FINALISATION,
+				    FLAVOR_CMAF);
+	mp4_mux_set_fragment_callback(out->muxer, hls_fragment_written, out);
+	if (out->low_latency)
+		mp4_mux_set_fragment_duration(out->muxer, out->part_duration);
+	pthread_mutex_unlock(&out->mutex);
+
+	os_atomic_set_bool(&out->active, true);
+	obs_output_begin_data_capture(out->output, 0);
+
+	info("Uploading %sHLS to '%s'...", out->low_latency ? "low-latency " : "", out->playlist_url.array);
+	return true;
+}
+
+static void hls_output_stop(void *data, uint64_t ts)
+{
+	struct hls_output *out = data;
+	out->stop_ts = ts / 1000;
+	os_atomic_set_bool(&out->stopping, true);
+}
+
+static void mp4_mux_destroy_task(void *ptr)
+{
+	struct mp4_mux *muxer = ptr;
+	mp4_mux_destroy(muxer);
+}
+
+static void hls_output_actual_stop(struct hls_output *out, int code)
+{
+	os_atomic_set_bool(&out->active, false);
+
+	if (code) {
+		obs_output_signal_stop(out->output, code);
+		os_atomic_set_bool(&out->abort_uploads, true);
+		os_sem_post(out->upload_sem);
+	} else {
+		/* Flush the last fragment and end the playlist, data capture
+		 * ends once everything has been uploaded. */
+		struct hls_upload *final = bzalloc(sizeof(*final));
+
+		mp4_mux_finalise(out->muxer);
+		finish_segment(out);
+		write_playlist(out, true);
+
+		final->final = true;
+		push_upload(out, final);
+	}
+
+	obs_queue_task(OBS_TASK_DESTROY, mp4_mux_destroy_task, out->muxer, false);
+	out->muxer = NULL;
+}
+
+static void hls_output_packet(void *data, struct encoder_packet *packet)
+{
+	struct hls_output *out = data;
+
+	pthread_mutex_lock(&out->mutex);
+
+	if (!active(out))
+		goto unlock;
+
+	if (!packet) {
+		hls_output_actual_stop(out, OBS_OUTPUT_ENCODE_ERROR);
+		goto unlock;
+	}
+
+	if (stopping(out)) {
+		if (packet->sys_dts_usec >= (int64_t)out->stop_ts) {
+			hls_output_actual_stop(out, 0);
+			goto unlock;
+		}
+	}
+
+	mp4_mux_submit_packet(out->muxer, packet);
+
+unlock:
+	pthread_mutex_unlock(&out->mutex);
+}
+
+static void hls_output_defaults(obs_data_t *settings)
+{
+	obs_data_set_default_bool(settings, "low_latency", false);
+	obs_data_set_default_int(settings, "part_duration_ms", 500);
+	obs_data_set_default_int(settings, "playlist_size", 5);
+}
+
+static obs_properties_t *hls_output_properties(void *unused)
+{
+	UNUSED_PARAMETER(unused);
+
+	obs_properties_t *props = obs_properties_create();
+
+	obs_properties_add_bool(props, "low_latency", obs_module_text("HLSOutput.LowLatency"));
+	obs_properties_add_int(props, "part_duration_ms", obs_module_text("HLSOutput.PartDuration"), 100, 2000, 50);
+	obs_properties_add_int(props, "playlist_size", obs_module_text("HLSOutput.PlaylistSize"), 1, 100, 1);
+	return props;
+}
+
+static uint64_t hls_output_total_bytes(void *data)
+{
+	struct hls_output *out = data;
+	return out->total_bytes;
+}
+
+struct obs_output_info hls_output_info = {
+	.id = "hls_output",
+	.flags = OBS_OUTPUT_AV | OBS_OUTPUT_ENCODED | OBS_OUTPUT_SERVICE,
+	.protocols = "HLS",
+	.encoded_video_codecs = "h264;hevc;av1",
+	.encoded_audio_codecs = "aac",
+	.get_name = hls_output_name,
+	.create = hls_output_create,
+	.destroy = hls_output_destroy,
+	.start = hls_output_start,
+	.stop = hls_output_stop,
+	.encoded_packet = hls_output_packet,
+	.get_defaults = hls_output_defaults,
+	.get_properties = hls_output_properties,
+	.get_total_bytes = hls_output_total_bytes,
+};
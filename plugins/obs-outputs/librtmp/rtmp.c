@@ -39,6 +39,21 @@
 #define MSG_NOSIGNAL 0
 #endif
 
+#ifdef _WIN32
+typedef WSABUF RTMPIOVec;
+#define IOVEC_BASE(v) ((v).buf)
+#define IOVEC_LEN(v) ((int)(v).len)
+#define IOVEC_SET(v, b, l) ((v).buf = (CHAR *)(b), (v).len = (ULONG)(l))
+#else
+#include <sys/uio.h>
+typedef struct iovec RTMPIOVec;
+#define IOVEC_BASE(v) ((char *)(v).iov_base)
+#define IOVEC_LEN(v) ((int)(v).iov_len)
+#define IOVEC_SET(v, b, l) ((v).iov_base = (void *)(b), (v).iov_len = (size_t)(l))
+#endif
+
+#define RTMP_MAX_IOVECS 64
+
 #ifdef CRYPTO
 
 #ifdef __APPLE__
@@ -1576,11 +1591,29 @@ ReadN(RTMP *r, char *buffer, int n)
     return nOriginalSize - n;
 }
 
+static void
+CloseOnSendError(RTMP *r, int sockerr)
+{
+    struct linger l;
+
+    r->last_error_code = sockerr;
+
+    // Force-close the socket. Sometimes a send() error isn't fatal, so
+    // we could end up writing an unpublish message which some services
+    // treat as a clean shutdown. We need to disable lingering too so
+    // the remote side sees an abortive shutdown (RST).
+    l.l_onoff = 1;
+    l.l_linger = 0;
+    setsockopt(r->m_sb.sb_socket, SOL_SOCKET, SO_LINGER, (char *)&l, sizeof(l));
+    RTMPSockBuf_Close(&r->m_sb);
+
+    RTMP_Close(r);
+}
+
 static int
 WriteN(RTMP *r, const char *buffer, int n)
 {
     const char *ptr = buffer;
-    struct linger l;
 
     while (n > 0)
     {
@@ -1603,18 +1636,7 @@ WriteN(RTMP *r, const char *buffer, int n)
             if (sockerr == EINTR && !RTMP_ctrlC)
                 continue;
 
-            r->last_error_code = sockerr;
-
-            // Force-close the socket. Sometimes a send() error isn't fatal, so
-            // we could end up writing an unpublish message which some services
-            // treat as a clean shutdown. We need to disable lingering too so
-            // the remote side sees an abortive shutdown (RST).
-            l.l_onoff = 1;
-            l.l_linger = 0;
-            setsockopt(r->m_sb.sb_socket, SOL_SOCKET, SO_LINGER, (char *)&l, sizeof(l));
-            RTMPSockBuf_Close(&r->m_sb);
-
-            RTMP_Close(r);
+            CloseOnSendError(r, sockerr);
             n = 1;
             break;
         }
@@ -1629,6 +1651,71 @@ WriteN(RTMP *r, const char *buffer, int n)
     return n == 0;
 }
 
+static int
+RTMPSockBuf_SendV(RTMPSockBuf *sb, RTMPIOVec *iov, int cnt)
+{
+#ifdef _WIN32
+    DWORD sent = 0;
+    if (WSASend(sb->sb_socket, iov, (DWORD)cnt, &sent, 0, NULL, NULL) != 0)
+        return -1;
+    return (int)sent;
+#else
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = iov;
+    msg.msg_iovlen = cnt;
+    return (int)sendmsg(sb->sb_socket, &msg, MSG_NOSIGNAL);
+#endif
+}
+
+/* WriteN for data scattered over several buffers, sent with a single
+ * gathering send call where the socket allows it */
+static int
+WriteVN(RTMP *r, RTMPIOVec *iov, int cnt)
+{
+    if (r->m_bCustomSend && r->m_customSendFunc)
+    {
+        for (int i = 0; i < cnt; i++)
+        {
+            if (!WriteN(r, IOVEC_BASE(iov[i]), IOVEC_LEN(iov[i])))
+                return FALSE;
+        }
+        return TRUE;
+    }
+
+    while (cnt > 0)
+    {
+        int nBytes = RTMPSockBuf_SendV(&r->m_sb, iov, cnt);
+
+        if (nBytes < 0)
+        {
+            int sockerr = GetSockError();
+            RTMP_Log(RTMP_LOGERROR, "%s, RTMP send error %d", __FUNCTION__, sockerr);
+
+            if (sockerr == EINTR && !RTMP_ctrlC)
+                continue;
+
+            CloseOnSendError(r, sockerr);
+            return FALSE;
+        }
+
+        if (nBytes == 0)
+            return FALSE;
+
+        /* skip what went out, the rest goes in the next call */
+        while (cnt > 0 && nBytes >= IOVEC_LEN(*iov))
+        {
+            nBytes -= IOVEC_LEN(*iov);
+            iov++;
+            cnt--;
+        }
+        if (cnt > 0 && nBytes > 0)
+            IOVEC_SET(*iov, IOVEC_BASE(*iov) + nBytes, IOVEC_LEN(*iov) - nBytes);
+    }
+
+    return TRUE;
+}
+
 #define SAVC(x)	static const AVal av_##x = AVC(#x)
 
 SAVC(app);
@@ -4085,18 +4172,19 @@ RTMP_SendChunk(RTMP *r, RTMPChunk *chunk)
     return wrote;
 }
 
-int
-RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
+/* Picks the header type of the first chunk of packet, compressing against
+ * the previous packet sent on its channel, and encodes that chunk header
+ * into hbuf.  Returns the header size, or 0 on failure. */
+static int
+EncodePacketHeader(RTMP *r, RTMPPacket *packet, char hbuf[RTMP_MAX_HEADER_SIZE], int *pcSize, char *pc,
+                   uint32_t *pt)
 {
     const RTMPPacket *prevPacket;
     uint32_t last = 0;
     int nSize;
     int hSize, cSize;
-    char *header, *hptr, *hend, hbuf[RTMP_MAX_HEADER_SIZE], c;
+    char *hptr, *hend = hbuf + RTMP_MAX_HEADER_SIZE, c;
     uint32_t t;
-    char *buffer, *tbuf = NULL, *toff = NULL;
-    int nChunkSize;
-    int tlen;
 
     if (packet->m_nChannel >= r->m_channelsAllocatedOut)
     {
@@ -4107,7 +4195,7 @@ RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
             free(r->m_vecChannelsOut);
             r->m_vecChannelsOut = NULL;
             r->m_channelsAllocatedOut = 0;
-            return FALSE;
+            return 0;
         }
         r->m_vecChannelsOut = packets;
         memset(r->m_vecChannelsOut + r->m_channelsAllocatedOut, 0, sizeof(RTMPPacket*) * (n - r->m_channelsAllocatedOut));
@@ -4128,8 +4216,8 @@ RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
          * whatever was previously sent, rather than just looking at the previous packet's absolute timestamp.
          *
          * The type 3 chunks/RTMP_PACKET_SIZE_MINIMUM packets produced here specify the beginning of a new
-         * message as opposed to message continuation type 3 chunks that are handled in the loop further down
-         * in this function.
+         * message as opposed to message continuation type 3 chunks that are handled in the chunk loops of
+         * RTMP_SendPacket and RTMP_WriteV.
          */
         uint32_t delta = packet->m_nTimeStamp - prevPacket->m_nTimeStamp;
         if (delta == prevPacket->m_nLastWireTimeStamp
@@ -4142,7 +4230,7 @@ RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
     {
         RTMP_Log(RTMP_LOGERROR, "sanity failed!! trying to send header of type: 0x%02x.",
                  (unsigned char)packet->m_headerType);
-        return FALSE;
+        return 0;
     }
 
     nSize = packetSize[packet->m_headerType];
@@ -4151,34 +4239,16 @@ RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
     t = packet->m_nTimeStamp - last;
     packet->m_nLastWireTimeStamp = t;
 
-    if (packet->m_body)
-    {
-        header = packet->m_body - nSize;
-        hend = packet->m_body;
-    }
-    else
-    {
-        header = hbuf + 6;
-        hend = hbuf + sizeof(hbuf);
-    }
-
     if (packet->m_nChannel > 319)
         cSize = 2;
     else if (packet->m_nChannel > 63)
         cSize = 1;
-    if (cSize)
-    {
-        header -= cSize;
-        hSize += cSize;
-    }
+    hSize += cSize;
 
     if (nSize > 1 && t >= 0xffffff)
-    {
-        header -= 4;
         hSize += 4;
-    }
 
-    hptr = header;
+    hptr = hbuf;
     c = packet->m_headerType << 6;
     switch (cSize)
     {
@@ -4217,6 +4287,37 @@ RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
     if (nSize > 1 && t >= 0xffffff)
         hptr = AMF_EncodeInt32(hptr, hend, t);
 
+    *pcSize = cSize;
+    *pc = c;
+    *pt = t;
+    return hSize;
+}
+
+int
+RTMP_SendPacket(RTMP *r, RTMPPacket *packet, int queue)
+{
+    int nSize;
+    int hSize, cSize;
+    char *header, hbuf[RTMP_MAX_HEADER_SIZE], c;
+    uint32_t t;
+    char *buffer, *tbuf = NULL, *toff = NULL;
+    int nChunkSize;
+    int tlen;
+
+    hSize = EncodePacketHeader(r, packet, hbuf, &cSize, &c, &t);
+    if (!hSize)
+        return FALSE;
+
+    if (packet->m_body)
+    {
+        header = packet->m_body - hSize;
+        memcpy(header, hbuf, hSize);
+    }
+    else
+    {
+        header = hbuf;
+    }
+
     nSize = packet->m_nBodySize;
     buffer = packet->m_body;
     nChunkSize = r->m_outChunkSize;
@@ -5393,3 +5494,143 @@ RTMP_Write(RTMP *r, const char *buf, int size, int streamIdx)
     }
     return size+s2;
 }
+
+static int
+WriteVCopy(RTMP *r, const char *tag, int tagSize, const char *payload, int payloadSize, int streamIdx)
+{
+    int size = tagSize + payloadSize + 4;
+    char *buf = malloc(size);
+    int ret;
+
+    if (!buf)
+        return -1;
+
+    memcpy(buf, tag, tagSize);
+    memcpy(buf + tagSize, payload, payloadSize);
+    AMF_EncodeInt32(buf + tagSize + payloadSize, buf + size, tagSize + payloadSize);
+
+    ret = RTMP_Write(r, buf, size, streamIdx);
+    free(buf);
+    return ret;
+}
+
+/* Sends one FLV tag like RTMP_Write, with the tag header and the start of
+ * the tag body in tag and the rest of the body in payload.  Chunk headers
+ * are built in scratch buffers and sent together with the caller's data,
+ * so the payload is never copied on plain TCP connections. */
+int
+RTMP_WriteV(RTMP *r, const char *tag, int tagSize, const char *payload, int payloadSize, int streamIdx)
+{
+    RTMPPacket packet;
+    RTMPIOVec iov[RTMP_MAX_IOVECS];
+    char hbuf[RTMP_MAX_HEADER_SIZE], cbuf[7], c;
+    int hSize, cSize, cbufSize, cnt = 0;
+    int nChunkSize = r->m_outChunkSize;
+    const char *prefix = tag + 11;
+    int prefixSize = tagSize - 11;
+    int offset = 0, bodySize;
+    uint32_t t;
+
+    if (tagSize < 11)
+    {
+        /* FLV pkt too small */
+        return 0;
+    }
+
+    if ((r->Link.protocol & RTMP_FEATURE_HTTP) || r->m_sb.sb_ssl)
+        return WriteVCopy(r, tag, tagSize, payload, payloadSize, streamIdx);
+
+    memset(&packet, 0, sizeof(packet));
+    packet.m_nChannel = 0x04;	/* source channel */
+    packet.m_nInfoField2 = r->Link.streams[streamIdx].id;
+    packet.m_packetType = tag[0];
+    packet.m_nBodySize = AMF_DecodeInt24(tag + 1);
+    packet.m_nTimeStamp = AMF_DecodeInt24(tag + 4);
+    packet.m_nTimeStamp |= (uint32_t)(unsigned char)tag[7] << 24;
+
+    if (packet.m_nBodySize != (uint32_t)(prefixSize + payloadSize))
+    {
+        RTMP_Log(RTMP_LOGERROR, "%s, FLV tag size %u does not match %d bytes of data", __FUNCTION__,
+                 packet.m_nBodySize, prefixSize + payloadSize);
+        return -1;
+    }
+
+    if (((packet.m_packetType == RTMP_PACKET_TYPE_AUDIO
+            || packet.m_packetType == RTMP_PACKET_TYPE_VIDEO) &&
+            !packet.m_nTimeStamp) || packet.m_packetType == RTMP_PACKET_TYPE_INFO)
+    {
+        packet.m_headerType = RTMP_PACKET_SIZE_LARGE;
+    }
+    else
+    {
+        packet.m_headerType = RTMP_PACKET_SIZE_MEDIUM;
+    }
+
+    hSize = EncodePacketHeader(r, &packet, hbuf, &cSize, &c, &t);
+    if (!hSize)
+        return -1;
+
+    /* every following chunk of the message starts with the same type 3
+     * header */
+    cbuf[0] = 0xc0 | c;
+    cbufSize = 1;
+    if (cSize)
+    {
+        int tmp = packet.m_nChannel - 64;
+        cbuf[cbufSize++] = tmp & 0xff;
+        if (cSize == 2)
+            cbuf[cbufSize++] = tmp >> 8;
+    }
+    if (t >= 0xffffff)
+    {
+        AMF_EncodeInt32(cbuf + cbufSize, cbuf + sizeof(cbuf), t);
+        cbufSize += 4;
+    }
+
+    bodySize = packet.m_nBodySize;
+    RTMP_Log(RTMP_LOGDEBUG2, "%s: fd=%d, size=%d", __FUNCTION__, (int)r->m_sb.sb_socket, bodySize);
+
+    IOVEC_SET(iov[cnt], hbuf, hSize);
+    cnt++;
+
+    while (offset < bodySize)
+    {
+        int end = offset + (bodySize - offset < nChunkSize ? bodySize - offset : nChunkSize);
+
+        if (offset)
+        {
+            IOVEC_SET(iov[cnt], cbuf, cbufSize);
+            cnt++;
+        }
+        if (offset < prefixSize)
+        {
+            int n = (end < prefixSize ? end : prefixSize) - offset;
+            IOVEC_SET(iov[cnt], prefix + offset, n);
+            cnt++;
+            offset += n;
+        }
+        if (offset < end)
+        {
+            IOVEC_SET(iov[cnt], payload + (offset - prefixSize), end - offset);
+            cnt++;
+            offset = end;
+        }
+
+        /* a chunk takes up to three entries */
+        if (cnt > RTMP_MAX_IOVECS - 3)
+        {
+            if (!WriteVN(r, iov, cnt))
+                return -1;
+            cnt = 0;
+        }
+    }
+
+    if (cnt && !WriteVN(r, iov, cnt))
+        return -1;
+
+    if (!r->m_vecChannelsOut[packet.m_nChannel])
+        r->m_vecChannelsOut[packet.m_nChannel] = malloc(sizeof(RTMPPacket));
+    memcpy(r->m_vecChannelsOut[packet.m_nChannel], &packet, sizeof(RTMPPacket));
+
+    return tagSize + payloadSize;
+}
@@ -72,6 +72,7 @@ struct fragment_sample {
 	uint32_t size;
 	int32_t offset;
 	uint32_t duration;
+	bool keyframe;
 };
 
 struct mp4_track {
@@ -135,6 +136,14 @@ struct mp4_mux {
 	uint32_t fragments_written;
 	/* PTS where next fragmentation should take place */
 	int64_t next_frag_pts;
+	/* PTS of the last fragmentation point */
+	int64_t last_frag_pts;
+	/* Maximum fragment duration, fragments are only split on keyframes if 0 */
+	int64_t frag_duration;
+
+	/* Called after the header and every fragment have been written */
+	mp4_fragment_cb fragment_cb;
+	void *fragment_param;
 
 	/* Creation time (seconds since Jan 1 1904) */
 	uint64_t creation_time;
@@ -92,6 +92,15 @@ static size_t mp4_write_ftyp(struct mp4_mux *mux, bool fragmented)
 		s_write(s, "qt  ", 4); // major brand
 		s_wb32(s, 0x20140200); // minor version (BCD YYYYMM00 per QTFF spec)
 		s_write(s, "qt  ", 4); // minor brand
+	} else if (mux->flavor == FLAVOR_CMAF) {
+		/* CMAF headers are only ever followed by fragments, so there is
+		 * no need to keep the size stable for a later rewrite. */
+		s_write(s, "iso6", 4); // major brand
+		s_wb32(s, 0);          // minor version
+		s_write(s, "iso6", 4); // minor brands
+		s_write(s, "cmfc", 4);
+		s_write(s, "isom", 4);
+		s_write(s, "mp41", 4);
 	} else {
 		const char *major_brand = "isom";
 		/* Following FFmpeg's example, when using negative CTS the major brand
@@ -2245,7 +2254,14 @@ static size_t mp4_write_tfhd(struct mp4_mux *mux, struct mp4_track *track, size_
 	struct serializer *s = mux->serializer;
 	int64_t start = serializer_get_pos(s);
 
-	uint32_t flags = BASE_DATA_OFFSET_PRESENT | DEFAULT_SAMPLE_FLAGS_PRESENT;
+	uint32_t flags = DEFAULT_SAMPLE_FLAGS_PRESENT;
+
+	/* CMAF fragments are delivered on their own, so data offsets have to
+	 * be relative to the moof rather than the start of the file. */
+	if (mux->flavor == FLAVOR_CMAF)
+		flags |= DEFAULT_BASE_IS_MOOF;
+	else
+		flags |= BASE_DATA_OFFSET_PRESENT;
 
 	/* Add default size/duration if all samples match. */
 	bool durations_match = true;
@@ -2277,7 +2293,8 @@ static size_t mp4_write_tfhd(struct mp4_mux *mux, struct mp4_track *track, size_
 	write_fullbox(s, 0, "tfhd", 0, flags);
 
 	s_wb32(s, track->track_id); // track_ID
-	s_wb64(s, moof_start);      // base_data_offset
+	if (flags & BASE_DATA_OFFSET_PRESENT)
+		s_wb64(s, moof_start); // base_data_offset
 
 	// default_sample_duration
 	if (durations_match) {
@@ -2366,8 +2383,11 @@ static size_t mp4_write_trun(struct mp4_mux *mux, struct mp4_track *track, uint3
 	if (track->sample_size)
 		return write_box_size(s, start);
 
-	if (track->type == TRACK_VIDEO)
+	/* Fragments only start on a non-keyframe when split by duration */
+	if (track->type == TRACK_VIDEO && track->fragment_samples.array[0].keyframe)
 		s_wb32(s, SAMPLE_FLAG_DEPENDS_NO); // first_sample_flags
+	else if (track->type == TRACK_VIDEO)
+		s_wb32(s, SAMPLE_FLAG_DEPENDS_YES | SAMPLE_FLAG_IS_NON_SYNC);
 
 	for (size_t idx = 0; idx < sample_count; idx++) {
 		struct fragment_sample *smp = &track->fragment_samples.array[idx];
@@ -2530,6 +2550,7 @@ static void process_packets(struct mp4_mux *mux, struct mp4_track *track, uint64
 		smp->size = size;
 		smp->offset = offset;
 		smp->duration = duration;
+		smp->keyframe = pkt->keyframe;
 
 		*mdat_size += size;
 
@@ -2611,6 +2632,17 @@ static void write_packets(struct mp4_mux *mux, struct mp4_track *track)
 	da_clear(track->fragment_samples);
 }
 
+/* Fragment timing is reported based on the first video track */
+static struct mp4_track *get_primary_track(struct mp4_mux *mux)
+{
+	for (size_t i = 0; i < mux->tracks.num; i++) {
+		if (mux->tracks.array[i].type == TRACK_VIDEO)
+			return &mux->tracks.array[i];
+	}
+
+	return mux->tracks.num ? mux->tracks.array : NULL;
+}
+
 static void mp4_flush_fragment(struct mp4_mux *mux)
 {
 	struct serializer *s = mux->serializer;
@@ -2618,9 +2650,12 @@ static void mp4_flush_fragment(struct mp4_mux *mux)
 	// Write file header if not already done
 	if (!mux->fragments_written) {
 		mp4_write_ftyp(mux, true);
-		/* Placeholder to write mdat header during soft-remux */
-		mux->placeholder_offset = serializer_get_pos(s);
-		mp4_write_free(mux);
+		/* Placeholder to write mdat header during soft-remux, CMAF is
+		 * never remuxed. */
+		if (mux->flavor != FLAVOR_CMAF) {
+			mux->placeholder_offset = serializer_get_pos(s);
+			mp4_write_free(mux);
+		}
 	}
 
 	// Array output as temporary buffer to avoid sending seeks to disk
@@ -2634,6 +2669,11 @@ static void mp4_flush_fragment(struct mp4_mux *mux)
 		mp4_write_moov(mux, true);
 		s_write(s, aod.bytes.array, aod.bytes.num);
 		array_output_serializer_reset(&aod);
+
+		if (mux->fragment_cb) {
+			struct mp4_fragment_info header = {.header = true};
+			mux->fragment_cb(mux->fragment_param, &header);
+		}
 	}
 
 	mux->fragments_written++;
@@ -2643,11 +2683,28 @@ static void mp4_flush_fragment(struct mp4_mux *mux)
 
 	uint64_t mdat_size = 8;
 
+	struct mp4_track *primary = get_primary_track(mux);
+	struct mp4_fragment_info frag = {0};
+	uint64_t primary_start = primary ? primary->duration : 0;
+
+	if (primary && primary->type == TRACK_VIDEO) {
+		struct encoder_packet *first = get_pkt_at(&primary->packets, 0);
+		frag.independent = first && first->keyframe;
+	} else {
+		frag.independent = true;
+	}
+
 	for (size_t idx = 0; idx < mux->tracks.num; idx++) {
 		struct mp4_track *track = &mux->tracks.array[idx];
 		process_packets(mux, track, &mdat_size);
 	}
 
+	if (primary) {
+		frag.start_usec = (int64_t)util_mul_div64(primary_start, 1000000, primary->timebase_den);
+		frag.duration_usec =
+			(int64_t)util_mul_div64(primary->duration - primary_start, 1000000, primary->timebase_den);
+	}
+
 	if (!mux->next_frag_pts && mux->chapter_track) {
 		// Create dummy chapter marker at the end so duration is correct
 		uint64_t duration = get_longest_track_duration(mux);
@@ -2693,6 +2750,10 @@ static void mp4_flush_fragment(struct mp4_mux *mux)
 	if (!mux->next_frag_pts && mux->chapter_track)
 		write_packets(mux, mux->chapter_track);
 
+	if (mux->fragment_cb)
+		mux->fragment_cb(mux->fragment_param, &frag);
+
+	mux->last_frag_pts = mux->next_frag_pts;
 	mux->next_frag_pts = 0;
 }
 
@@ -2923,6 +2984,16 @@ bool mp4_mux_submit_packet(struct mp4_mux *mux, struct encoder_packet *pkt)
 		/* Set fragmentation PTS if packet is keyframe and PTS > 0 */
 		if (parsed_packet.keyframe && parsed_packet.pts > 0) {
 			mux->next_frag_pts = packet_pts_usec(&parsed_packet);
+		} else if (mux->frag_duration && !mux->next_frag_pts) {
+			/* Otherwise split before this frame would make the
+			 * fragment longer than the maximum duration. */
+			int64_t pts_usec = packet_pts_usec(&parsed_packet);
+			int64_t frame_usec = (int64_t)util_mul_div64(parsed_packet.timebase_num, 1000000,
+								     parsed_packet.timebase_den);
+
+			if (pts_usec > mux->last_frag_pts &&
+			    pts_usec + frame_usec - mux->last_frag_pts > mux->frag_duration)
+				mux->next_frag_pts = pts_usec;
 		}
 	}
 
@@ -2966,6 +3037,10 @@ bool mp4_mux_finalise(struct mp4_mux *mux)
 
 	info("Number of fragments: %u", mux->fragments_written);
 
+	/* CMAF output only consists of the header and fragments */
+	if (mux->flavor == FLAVOR_CMAF)
+		return true;
+
 	if (mux->flags & MP4_SKIP_FINALISATION) {
 		warn("Skipping finalization!");
 		return true;
@@ -3014,3 +3089,14 @@ bool mp4_mux_finalise(struct mp4_mux *mux)
 	info("Final mdat size: %zu KiB", data_size / 1024);
 	return true;
 }
+
+void mp4_mux_set_fragment_duration(struct mp4_mux *mux, int64_t duration_usec)
+{
+	mux->frag_duration = duration_usec;
+}
+
+void mp4_mux_set_fragment_callback(struct mp4_mux *mux, mp4_fragment_cb cb, void *param)
+{
+	mux->fragment_cb = cb;
+	mux->fragment_param = param;
+}
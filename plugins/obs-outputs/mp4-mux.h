@@ -26,7 +26,7 @@ struct mp4_mux;
 enum mp4_flavor {
 	FLAVOR_MP4,  /* ISO/IEC 14496-12 */
 	FLAVOR_MOV,  /* Apple QuickTime */
-	FLAVOR_CMAF, /* ISO/IEC 23000-19 (not yet implemented) */
+	FLAVOR_CMAF, /* ISO/IEC 23000-19 (fragmented only, header reported separately) */
 };
 
 enum mp4_mux_flags {
@@ -40,9 +40,25 @@ enum mp4_mux_flags {
 	MP4_USE_NEGATIVE_CTS = 1 << 3,
 };
 
+/* Describes the data written to the serializer since the last callback */
+struct mp4_fragment_info {
+	/* ftyp + moov (CMAF header), written before the first fragment */
+	bool header;
+	/* Fragment starts with a video keyframe */
+	bool independent;
+	/* Decode time of the first sample and duration of the fragment */
+	int64_t start_usec;
+	int64_t duration_usec;
+};
+
+typedef void (*mp4_fragment_cb)(void *param, const struct mp4_fragment_info *info);
+
 struct mp4_mux *mp4_mux_create(obs_output_t *output, struct serializer *serializer, enum mp4_mux_flags flags,
 			       enum mp4_flavor flavor);
 void mp4_mux_destroy(struct mp4_mux *mux);
 bool mp4_mux_submit_packet(struct mp4_mux *mux, struct encoder_packet *pkt);
 bool mp4_mux_add_chapter(struct mp4_mux *mux, int64_t dts_usec, const char *name);
 bool mp4_mux_finalise(struct mp4_mux *mux);
+/* Also split fragments on non-keyframes to keep them within duration_usec */
+void mp4_mux_set_fragment_duration(struct mp4_mux *mux, int64_t duration_usec);
+void mp4_mux_set_fragment_callback(struct mp4_mux *mux, mp4_fragment_cb cb, void *param);
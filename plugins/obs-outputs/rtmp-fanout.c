@@ -0,0 +1,1104 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+/*
+ * Sends one encode to several RTMP ingests.  Packets go through interleaving
+ * and FLV muxing once, the muxed tags are refcounted and queued to every
+ * endpoint, so memory doesn't grow with the number of destinations.  Each
+ * endpoint has its own connection, send thread, frame dropping and
+ * reconnect, a slow or broken ingest doesn't hold back the others.
+ */
+
+#include "rtmp-fanout.h"
+#include "rtmp-av1.h"
+#include "rtmp-hevc.h"
+
+#include <obs-avc.h>
+#include <obs-hevc.h>
+
+static const char *rtmp_fanout_getname(void *unused)
+{
+	UNUSED_PARAMETER(unused);
+	return obs_module_text("RTMPFanout");
+}
+
+static inline bool stopping(struct rtmp_fanout *fanout)
+{
+	return os_event_try(fanout->stop_event) != EAGAIN;
+}
+
+static inline bool connecting(struct rtmp_fanout *fanout)
+{
+	return os_atomic_load_bool(&fanout->connecting);
+}
+
+static inline bool active(struct rtmp_fanout *fanout)
+{
+	return os_atomic_load_bool(&fanout->active);
+}
+
+static inline bool connected(struct fanout_endpoint *ep)
+{
+	return os_atomic_load_bool(&ep->connected);
+}
+
+/* ------------------------------------------------------------------------- */
+
+static inline void fanout_tag_release(struct fanout_tag *tag)
+{
+	if (os_atomic_dec_long(&tag->refs) == 0) {
+		obs_encoder_packet_release(&tag->packet);
+		bfree(tag);
+	}
+}
+
+static inline size_t num_buffered_tags(struct fanout_endpoint *ep)
+{
+	return ep->packets.size / sizeof(struct fanout_tag *);
+}
+
+static void free_packets(struct fanout_endpoint *ep)
+{
+	pthread_mutex_lock(&ep->packets_mutex);
+	while (ep->packets.size) {
+		struct fanout_tag *tag;
+		deque_pop_front(&ep->packets, &tag, sizeof(tag));
+		fanout_tag_release(tag);
+	}
+	deque_free(&ep->dropped);
+	ep->buffered_size = 0;
+	ep->dropped_size = 0;
+	pthread_mutex_unlock(&ep->packets_mutex);
+}
+
+static inline bool get_next_tag(struct fanout_endpoint *ep, struct fanout_tag **tag)
+{
+	bool new_tag = false;
+
+	pthread_mutex_lock(&ep->packets_mutex);
+	if (ep->packets.size) {
+		deque_pop_front(&ep->packets, tag, sizeof(*tag));
+		ep->buffered_size -= (*tag)->packet.size;
+		new_tag = true;
+	}
+	pthread_mutex_unlock(&ep->packets_mutex);
+
+	return new_tag;
+}
+
+static void endpoint_destroy(struct fanout_endpoint *ep)
+{
+	if (!ep)
+		return;
+
+	free_packets(ep);
+	RTMP_TLS_Free(&ep->rtmp);
+	dstr_free(&ep->path);
+	dstr_free(&ep->key);
+	dstr_free(&ep->username);
+	dstr_free(&ep->password);
+	deque_free(&ep->packets);
+	os_sem_destroy(ep->send_sem);
+	pthread_mutex_destroy(&ep->packets_mutex);
+	bfree(ep);
+}
+
+static struct fanout_endpoint *endpoint_create(struct rtmp_fanout *fanout, obs_data_t *settings)
+{
+	struct fanout_endpoint *ep = bzalloc(sizeof(*ep));
+	ep->fanout = fanout;
+	ep->idx = fanout->endpoints.num;
+	ep->retry_delay_sec = fanout->retry_delay_sec;
+	pthread_mutex_init_value(&ep->packets_mutex);
+
+	if (pthread_mutex_init(&ep->packets_mutex, NULL) != 0)
+		goto fail;
+	if (os_sem_init(&ep->send_sem, 0) != 0)
+		goto fail;
+
+	dstr_copy(&ep->path, obs_data_get_string(settings, "server"));
+	dstr_copy(&ep->key, obs_data_get_string(settings, "key"));
+	dstr_copy(&ep->username, obs_data_get_string(settings, "username"));
+	dstr_copy(&ep->password, obs_data_get_string(settings, "password"));
+	dstr_depad(&ep->path);
+	dstr_depad(&ep->key);
+	return ep;
+
+fail:
+	endpoint_destroy(ep);
+	return NULL;
+}
+
+/* waits for every endpoint thread of the last run and frees the endpoints */
+static void free_endpoints(struct rtmp_fanout *fanout)
+{
+	DARRAY(struct fanout_endpoint *) old_endpoints = {0};
+
+	pthread_mutex_lock(&fanout->endpoints_mutex);
+	da_move(old_endpoints, fanout->endpoints);
+	pthread_mutex_unlock(&fanout->endpoints_mutex);
+
+	for (size_t i = 0; i < old_endpoints.num; i++) {
+		struct fanout_endpoint *ep = old_endpoints.array[i];
+		if (ep->send_thread_active)
+			pthread_join(ep->send_thread, NULL);
+		endpoint_destroy(ep);
+	}
+
+	da_free(old_endpoints);
+}
+
+static void rtmp_fanout_destroy(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+
+	if (connecting(fanout))
+		pthread_join(fanout->connect_thread, NULL);
+
+	if (active(fanout)) {
+		fanout->stop_ts = 0;
+		os_event_signal(fanout->stop_event);
+
+		for (size_t i = 0; i < fanout->endpoints.num; i++)
+			os_sem_post(fanout->endpoints.array[i]->send_sem);
+	}
+
+	free_endpoints(fanout);
+	da_free(fanout->headers);
+	da_free(fanout->footers);
+	dstr_free(&fanout->bind_ip);
+	os_event_destroy(fanout->stop_event);
+	pthread_mutex_destroy(&fanout->endpoints_mutex);
+	bfree(fanout);
+}
+
+static void *rtmp_fanout_create(obs_data_t *settings, obs_output_t *output)
+{
+	struct rtmp_fanout *fanout = bzalloc(sizeof(struct rtmp_fanout));
+	fanout->output = output;
+	pthread_mutex_init_value(&fanout->endpoints_mutex);
+
+	if (pthread_mutex_init(&fanout->endpoints_mutex, NULL) != 0)
+		goto fail;
+	if (os_event_init(&fanout->stop_event, OS_EVENT_TYPE_MANUAL) != 0)
+		goto fail;
+
+	signal_handler_t *sh = obs_output_get_signal_handler(output);
+	signal_handler_add(sh, "void endpoint_connected(int endpoint)");
+	signal_handler_add(sh, "void endpoint_disconnected(int endpoint)");
+
+	UNUSED_PARAMETER(settings);
+	return fanout;
+
+fail:
+	rtmp_fanout_destroy(fanout);
+	return NULL;
+}
+
+static void rtmp_fanout_stop(void *data, uint64_t ts)
+{
+	struct rtmp_fanout *fanout = data;
+
+	if (stopping(fanout) && ts != 0)
+		return;
+
+	if (connecting(fanout))
+		pthread_join(fanout->connect_thread, NULL);
+
+	fanout->stop_ts = ts / 1000ULL;
+
+	if (ts)
+		fanout->shutdown_timeout_ts = ts + (uint64_t)fanout->max_shutdown_time_sec * 1000000000ULL;
+
+	if (active(fanout)) {
+		os_event_signal(fanout->stop_event);
+		if (fanout->stop_ts == 0) {
+			for (size_t i = 0; i < fanout->endpoints.num; i++)
+				os_sem_post(fanout->endpoints.array[i]->send_sem);
+		}
+	} else {
+		obs_output_signal_stop(fanout->output, OBS_OUTPUT_SUCCESS);
+	}
+}
+
+/* ------------------------------------------------------------------------- */
+/* Connections                                                               */
+
+static inline void set_rtmp_dstr(AVal *val, struct dstr *str)
+{
+	bool valid = !dstr_is_empty(str);
+	val->av_val = valid ? str->array : NULL;
+	val->av_len = valid ? (int)str->len : 0;
+}
+
+static void signal_endpoint(struct fanout_endpoint *ep, const char *signal)
+{
+	signal_handler_t *sh = obs_output_get_signal_handler(ep->fanout->output);
+	calldata_t cd = {0};
+
+	calldata_set_int(&cd, "endpoint", (long long)ep->idx);
+	signal_handler_signal(sh, signal, &cd);
+	calldata_free(&cd);
+}
+
+static int endpoint_connect(struct fanout_endpoint *ep)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+
+	if (dstr_is_empty(&ep->path)) {
+		warn("Endpoint %zu: URL is empty", ep->idx);
+		return OBS_OUTPUT_BAD_PATH;
+	}
+
+	info("Endpoint %zu: connecting to RTMP URL %s...", ep->idx, ep->path.array);
+
+	// free any existing RTMP TLS context
+	RTMP_TLS_Free(&ep->rtmp);
+
+	RTMP_Init(&ep->rtmp);
+
+	if (!RTMP_SetupURL(&ep->rtmp, ep->path.array))
+		return OBS_OUTPUT_BAD_PATH;
+
+	RTMP_EnableWrite(&ep->rtmp);
+
+	static struct dstr encoder_name = {
+		.array = "FMLE/3.0 (compatible; FMSc/1.0)",
+		.len = sizeof("FMLE/3.0 (compatible; FMSc/1.0)") - 1,
+	};
+
+	set_rtmp_dstr(&ep->rtmp.Link.pubUser, &ep->username);
+	set_rtmp_dstr(&ep->rtmp.Link.pubPasswd, &ep->password);
+	set_rtmp_dstr(&ep->rtmp.Link.flashVer, &encoder_name);
+	ep->rtmp.Link.swfUrl = ep->rtmp.Link.tcUrl;
+
+	if (dstr_is_empty(&fanout->bind_ip) || dstr_cmp(&fanout->bind_ip, "default") == 0) {
+		memset(&ep->rtmp.m_bindIP, 0, sizeof(ep->rtmp.m_bindIP));
+	} else {
+		netif_str_to_addr(&ep->rtmp.m_bindIP.addr, &ep->rtmp.m_bindIP.addrLen, fanout->bind_ip.array);
+	}
+
+	// Only use the IPv4 / IPv6 hint if a binding address isn't specified.
+	if (ep->rtmp.m_bindIP.addrLen == 0)
+		ep->rtmp.m_bindIP.addrLen = fanout->addrlen_hint;
+
+	RTMP_AddStream(&ep->rtmp, ep->key.array);
+
+	ep->rtmp.m_outChunkSize = 4096;
+	ep->rtmp.m_bSendChunkSizeInfo = true;
+	ep->rtmp.m_bUseNagle = true;
+
+	if (!RTMP_Connect(&ep->rtmp, NULL))
+		return OBS_OUTPUT_CONNECT_FAILED;
+
+	if (!RTMP_ConnectStream(&ep->rtmp, 0)) {
+		RTMP_Close(&ep->rtmp);
+		return OBS_OUTPUT_INVALID_STREAM;
+	}
+
+	char ip_address[INET6_ADDRSTRLEN] = {0};
+	netif_addr_to_str(&ep->rtmp.m_sb.sb_addr, ip_address, INET6_ADDRSTRLEN);
+	info("Endpoint %zu: connection to %s (%s) successful", ep->idx, ep->path.array, ip_address);
+
+	/* the shared tags carry timestamps from the start of the output, an
+	 * endpoint that connects later joins at the next keyframe */
+	pthread_mutex_lock(&ep->packets_mutex);
+	ep->sent_headers = false;
+	ep->wait_for_keyframe = true;
+	ep->min_priority = 0;
+	ep->congestion = 0.0f;
+	ep->retry_delay_sec = fanout->retry_delay_sec;
+	os_atomic_set_bool(&ep->connected, true);
+	pthread_mutex_unlock(&ep->packets_mutex);
+
+	signal_endpoint(ep, "endpoint_connected");
+	return OBS_OUTPUT_SUCCESS;
+}
+
+static void endpoint_disconnect(struct fanout_endpoint *ep)
+{
+	pthread_mutex_lock(&ep->packets_mutex);
+	os_atomic_set_bool(&ep->connected, false);
+	pthread_mutex_unlock(&ep->packets_mutex);
+
+	RTMP_Close(&ep->rtmp);
+	free_packets(ep);
+
+	signal_endpoint(ep, "endpoint_disconnected");
+}
+
+/* waits out the retry delay and reconnects, returns false when stopping */
+static bool endpoint_reconnect(struct fanout_endpoint *ep)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+
+	while (!stopping(fanout)) {
+		info("Endpoint %zu: reconnecting in %" PRIu32 " seconds...", ep->idx, ep->retry_delay_sec);
+
+		if (os_event_timedwait(fanout->stop_event, ep->retry_delay_sec * 1000) != ETIMEDOUT)
+			return false;
+
+		if (endpoint_connect(ep) == OBS_OUTPUT_SUCCESS)
+			return true;
+
+		ep->retry_delay_sec *= 2;
+		if (ep->retry_delay_sec > MAX_RETRY_DELAY_SEC)
+			ep->retry_delay_sec = MAX_RETRY_DELAY_SEC;
+	}
+
+	return false;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Send threads                                                              */
+
+static bool process_recv_data(struct fanout_endpoint *ep)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+	RTMPPacket packet = {0};
+	int recv_size = 0;
+	int ret;
+
+#ifdef _WIN32
+	ret = ioctlsocket(ep->rtmp.m_sb.sb_socket, FIONREAD, (u_long *)&recv_size);
+#else
+	ret = ioctl(ep->rtmp.m_sb.sb_socket, FIONREAD, &recv_size);
+#endif
+
+	if (ret < 0 || recv_size <= 0)
+		return true;
+
+	if (!RTMP_ReadPacket(&ep->rtmp, &packet)) {
+		warn("Endpoint %zu: RTMP_ReadPacket error", ep->idx);
+		return false;
+	}
+
+	if (packet.m_body)
+		RTMPPacket_Free(&packet);
+	return true;
+}
+
+static inline bool write_tags(struct fanout_endpoint *ep, const uint8_t *data, size_t size)
+{
+	if (!size)
+		return true;
+	if (RTMP_Write(&ep->rtmp, (const char *)data, (int)size, 0) < 0)
+		return false;
+
+	ep->total_bytes_sent += size;
+	return true;
+}
+
+static inline bool can_shutdown_stream(struct rtmp_fanout *fanout, struct encoder_packet *packet)
+{
+	uint64_t cur_time = os_gettime_ns();
+	bool timeout = cur_time >= fanout->shutdown_timeout_ts;
+
+	return timeout || packet->sys_dts_usec >= (int64_t)fanout->stop_ts;
+}
+
+/* sends queued tags until the endpoint disconnects (returns true) or the
+ * output stops (returns false) */
+static bool send_tags(struct fanout_endpoint *ep)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+
+	while (os_sem_wait(ep->send_sem) == 0) {
+		struct fanout_tag *tag;
+
+		if (stopping(fanout) && fanout->stop_ts == 0)
+			return false;
+
+		if (!get_next_tag(ep, &tag))
+			continue;
+
+		if (stopping(fanout) && can_shutdown_stream(fanout, &tag->packet)) {
+			fanout_tag_release(tag);
+			return false;
+		}
+
+		bool success = process_recv_data(ep);
+
+		if (success && !ep->sent_headers) {
+			success = write_tags(ep, fanout->headers.array, fanout->headers.num);
+			ep->sent_headers = true;
+		}
+
+		if (success) {
+			success = RTMP_WriteV(&ep->rtmp, (const char *)tag->header, (int)tag->header_size,
+					      (const char *)tag->packet.data, (int)tag->packet.size, 0) >= 0;
+			ep->total_bytes_sent += tag->header_size + tag->packet.size + FLV_PREV_TAG_SIZE;
+		}
+
+		fanout_tag_release(tag);
+
+		if (!success) {
+			info("Endpoint %zu: disconnected from %s", ep->idx, ep->path.array);
+			endpoint_disconnect(ep);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void *send_thread(void *data)
+{
+	struct fanout_endpoint *ep = data;
+	struct rtmp_fanout *fanout = ep->fanout;
+
+	os_set_thread_name("rtmp-fanout: send_thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_OUTPUT_SEND);
+
+	while (connected(ep) || endpoint_reconnect(ep)) {
+		if (!send_tags(ep))
+			break;
+	}
+
+	if (connected(ep)) {
+		if (!os_atomic_load_bool(&fanout->encode_error) && ep->sent_headers)
+			write_tags(ep, fanout->footers.array, fanout->footers.num); // Y2023 spec
+
+		os_atomic_set_bool(&ep->connected, false);
+		RTMP_Close(&ep->rtmp);
+	}
+
+	free_packets(ep);
+
+	/* the last endpoint to finish stops the output */
+	if (os_atomic_dec_long(&fanout->running_endpoints) == 0) {
+		bool encode_error = os_atomic_load_bool(&fanout->encode_error);
+
+		if (encode_error)
+			info("Encoder error, disconnecting");
+		else
+			info("User stopped the stream");
+
+		os_atomic_set_bool(&fanout->active, false);
+		os_event_reset(fanout->stop_event);
+
+		if (encode_error)
+			obs_output_signal_stop(fanout->output, OBS_OUTPUT_ENCODE_ERROR);
+		else
+			obs_output_end_data_capture(fanout->output);
+	}
+
+	return NULL;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Shared FLV muxing                                                         */
+
+static bool add_audio_header(struct rtmp_fanout *fanout, size_t idx, bool *next)
+{
+	obs_encoder_t *aencoder = obs_output_get_audio_encoder(fanout->output, idx);
+	struct encoder_packet packet = {.type = OBS_ENCODER_AUDIO, .timebase_den = 1};
+	uint8_t *header;
+	uint8_t *data;
+	size_t size;
+
+	if (!aencoder) {
+		*next = false;
+		return true;
+	}
+
+	if (!obs_encoder_get_extra_data(aencoder, &header, &packet.size))
+		return false;
+
+	packet.data = header;
+	if (idx == 0)
+		flv_packet_mux(&packet, 0, &data, &size, true);
+	else
+		flv_packet_audio_start(&packet, fanout->audio_codec[idx], &data, &size, idx);
+
+	da_push_back_array(fanout->headers, data, size);
+	bfree(data);
+	return true;
+}
+
+static bool add_video_header(struct rtmp_fanout *fanout, size_t idx)
+{
+	obs_encoder_t *vencoder = obs_output_get_video_encoder2(fanout->output, idx);
+	enum video_id_t codec = fanout->video_codec[idx];
+	struct encoder_packet packet = {.type = OBS_ENCODER_VIDEO, .timebase_den = 1, .keyframe = true};
+	uint8_t *header;
+	uint8_t *data;
+	size_t size;
+
+	if (!rtmp_video_metadata_tag(vencoder, codec, &data, &size, idx))
+		return false;
+	if (size) {
+		da_push_back_array(fanout->headers, data, size);
+		bfree(data);
+	}
+
+	if (!obs_encoder_get_extra_data(vencoder, &header, &size))
+		return false;
+
+	switch (codec) {
+	case CODEC_NONE:
+		warn("Codec not initialized for track %zu while muxing header", idx);
+		return false;
+	case CODEC_H264:
+		packet.size = obs_parse_avc_header(&packet.data, header, size);
+		break;
+	case CODEC_HEVC:
+#ifdef ENABLE_HEVC
+		packet.size = obs_parse_hevc_header(&packet.data, header, size);
+		break;
+#else
+		return false;
+#endif
+	case CODEC_AV1:
+		packet.size = obs_parse_av1_header(&packet.data, header, size);
+		break;
+	}
+
+	// Always send H.264 on track 0 as old style for compatibility.
+	if (codec == CODEC_H264 && idx == 0)
+		flv_packet_mux(&packet, 0, &data, &size, true);
+	else
+		flv_packet_start(&packet, codec, &data, &size, idx);
+
+	da_push_back_array(fanout->headers, data, size);
+	bfree(data);
+	bfree(packet.data);
+
+	if (codec != CODEC_H264 || idx != 0) {
+		struct encoder_packet footer = {.type = OBS_ENCODER_VIDEO, .timebase_den = 1};
+
+		flv_packet_end(&footer, codec, &data, &size, idx);
+		da_push_back_array(fanout->footers, data, size);
+		bfree(data);
+	}
+
+	return true;
+}
+
+/* muxes the metadata and sequence headers once, in the same order a single
+ * rtmp stream sends them */
+static bool build_headers(struct rtmp_fanout *fanout)
+{
+	uint8_t *data;
+	size_t size;
+	size_t i = 0;
+	bool next = true;
+
+	da_resize(fanout->headers, 0);
+	da_resize(fanout->footers, 0);
+
+	flv_meta_data(fanout->output, &data, &size, false);
+	da_push_back_array(fanout->headers, data, size);
+	bfree(data);
+
+	if (!add_audio_header(fanout, i++, &next))
+		return false;
+
+	for (size_t j = 0; j < MAX_OUTPUT_VIDEO_ENCODERS; j++) {
+		if (!obs_output_get_video_encoder2(fanout->output, j))
+			continue;
+		if (!add_video_header(fanout, j))
+			return false;
+	}
+
+	while (next) {
+		if (!add_audio_header(fanout, i++, &next))
+			return false;
+	}
+
+	fanout->got_headers = true;
+	return true;
+}
+
+static size_t mux_tag_header(struct rtmp_fanout *fanout, struct encoder_packet *packet,
+			     uint8_t header[FLV_TAG_HEADER_MAX])
+{
+	size_t idx = packet->track_idx;
+
+	if (packet->type == OBS_ENCODER_VIDEO && (fanout->video_codec[idx] != CODEC_H264 || idx != 0))
+		return flv_packet_frames_header(packet, fanout->video_codec[idx], fanout->start_dts_offset, header,
+						idx);
+	if (packet->type == OBS_ENCODER_AUDIO && idx != 0)
+		return flv_packet_audio_frames_header(packet, fanout->audio_codec[idx], fanout->start_dts_offset,
+						      header, idx);
+
+	return flv_packet_mux_header(packet, fanout->start_dts_offset, header, false);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Per endpoint frame dropping                                               */
+
+/* drops the frames picked by plan_frame_drops(), see frame-drop.c */
+static void drop_frames(struct fanout_endpoint *ep, int64_t buffer_duration_usec, int64_t drop_threshold,
+			int max_level)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+	size_t count = num_buffered_tags(ep);
+	struct encoder_packet **video = bmalloc(count * sizeof(*video));
+	bool *drop = bzalloc(count * sizeof(*drop));
+	size_t num_video = 0;
+	struct drop_plan plan;
+	int64_t goal;
+
+	for (size_t i = 0; i < count; i++) {
+		struct fanout_tag *tag = *(struct fanout_tag **)deque_data(&ep->packets, i * sizeof(tag));
+		if (tag->packet.type == OBS_ENCODER_VIDEO)
+			video[num_video++] = &tag->packet;
+	}
+
+	goal = drop_goal(ep->buffered_size, ep->dropped_size, buffer_duration_usec, drop_threshold);
+	bool dropping = plan_frame_drops(video, num_video, goal, max_level, drop, &plan);
+	bfree(video);
+
+	if (ep->min_priority < plan.until_next)
+		ep->min_priority = plan.until_next;
+	if (!dropping) {
+		bfree(drop);
+		return;
+	}
+
+	struct deque new_buf = {0};
+	size_t video_idx = 0;
+
+	deque_reserve(&new_buf, ep->packets.size);
+
+	while (ep->packets.size) {
+		struct fanout_tag *tag;
+		deque_pop_front(&ep->packets, &tag, sizeof(tag));
+
+		if (tag->packet.type == OBS_ENCODER_VIDEO && drop[video_idx++]) {
+			struct dropped_frame frame = {tag->packet.dts_usec, tag->packet.size};
+			deque_push_back(&ep->dropped, &frame, sizeof(frame));
+			ep->dropped_size += tag->packet.size;
+			ep->buffered_size -= tag->packet.size;
+			fanout_tag_release(tag);
+		} else {
+			deque_push_back(&new_buf, &tag, sizeof(tag));
+		}
+	}
+
+	bfree(drop);
+	deque_free(&ep->packets);
+	ep->packets = new_buf;
+
+	ep->dropped_frames += plan.frames;
+	debug("Endpoint %zu: dropped %d frames (%s, %" PRId64 " bytes), new packet count: %d", ep->idx, plan.frames,
+	      drop_level_name(plan.level), plan.size, (int)num_buffered_tags(ep));
+}
+
+static void check_to_drop_frames(struct fanout_endpoint *ep, bool pframes)
+{
+	struct rtmp_fanout *fanout = ep->fanout;
+	size_t num_tags = num_buffered_tags(ep);
+	int max_level = pframes ? OBS_NAL_PRIORITY_HIGHEST : OBS_NAL_PRIORITY_HIGH;
+	int64_t drop_threshold = pframes ? fanout->pframe_drop_threshold_usec : fanout->drop_threshold_usec;
+	int64_t first_dts_usec = 0;
+	int64_t buffer_duration_usec = 0;
+	int64_t effective_duration_usec = 0;
+
+	if (num_tags >= 5) {
+		for (size_t i = 0; i < num_tags; i++) {
+			struct fanout_tag *tag = *(struct fanout_tag **)deque_data(&ep->packets, i * sizeof(tag));
+			if (tag->packet.type == OBS_ENCODER_VIDEO && !tag->packet.keyframe) {
+				first_dts_usec = tag->packet.dts_usec;
+				buffer_duration_usec = ep->last_dts_usec - first_dts_usec;
+				break;
+			}
+		}
+	}
+
+	if (buffer_duration_usec)
+		effective_duration_usec = effective_buffer_duration(&ep->dropped, &ep->dropped_size, ep->buffered_size,
+								    first_dts_usec, buffer_duration_usec);
+
+	if (!pframes)
+		ep->congestion = (float)effective_duration_usec / (float)drop_threshold;
+
+	if (effective_duration_usec > drop_threshold) {
+		debug("Endpoint %zu: buffer_duration_usec: %" PRId64, ep->idx, effective_duration_usec);
+		drop_frames(ep, buffer_duration_usec, drop_threshold, max_level);
+	}
+}
+
+static void endpoint_add_tag(struct fanout_endpoint *ep, struct fanout_tag *tag)
+{
+	struct encoder_packet *packet = &tag->packet;
+	bool added = false;
+
+	pthread_mutex_lock(&ep->packets_mutex);
+
+	if (!connected(ep))
+		goto unlock;
+
+	if (ep->wait_for_keyframe) {
+		if (packet->type != OBS_ENCODER_VIDEO || !packet->keyframe)
+			goto unlock;
+		ep->wait_for_keyframe = false;
+	}
+
+	if (packet->type == OBS_ENCODER_VIDEO) {
+		check_to_drop_frames(ep, false);
+		check_to_drop_frames(ep, true);
+
+		/* if currently dropping frames, drop packets until it reaches
+		 * the desired priority */
+		if (packet->drop_priority < ep->min_priority) {
+			ep->dropped_frames++;
+			goto unlock;
+		}
+
+		ep->min_priority = 0;
+		ep->last_dts_usec = packet->dts_usec;
+	}
+
+	os_atomic_inc_long(&tag->refs);
+	deque_push_back(&ep->packets, &tag, sizeof(tag));
+	ep->buffered_size += packet->size;
+	added = true;
+
+unlock:
+	pthread_mutex_unlock(&ep->packets_mutex);
+
+	if (added)
+		os_sem_post(ep->send_sem);
+}
+
+static void rtmp_fanout_data(void *data, struct encoder_packet *packet)
+{
+	struct rtmp_fanout *fanout = data;
+	struct encoder_packet new_packet;
+
+	if (!active(fanout))
+		return;
+
+	/* encoder fail */
+	if (!packet) {
+		os_atomic_set_bool(&fanout->encode_error, true);
+		fanout->stop_ts = 0;
+		os_event_signal(fanout->stop_event);
+
+		for (size_t i = 0; i < fanout->endpoints.num; i++)
+			os_sem_post(fanout->endpoints.array[i]->send_sem);
+		return;
+	}
+
+	if (!fanout->got_first_packet) {
+		fanout->start_dts_offset = get_ms_time(packet, packet->dts);
+		fanout->got_first_packet = true;
+	}
+
+	if (packet->type == OBS_ENCODER_VIDEO) {
+		switch (fanout->video_codec[packet->track_idx]) {
+		case CODEC_NONE:
+			do_log(LOG_ERROR, "Codec not initialized for track %zu", packet->track_idx);
+			return;
+		case CODEC_H264:
+			obs_parse_avc_packet(&new_packet, packet);
+			break;
+		case CODEC_HEVC:
+#ifdef ENABLE_HEVC
+			obs_parse_hevc_packet(&new_packet, packet);
+			break;
+#else
+			return;
+#endif
+		case CODEC_AV1:
+			obs_parse_av1_packet(&new_packet, packet);
+			break;
+		}
+	} else {
+		obs_encoder_packet_ref(&new_packet, packet);
+	}
+
+	if (!fanout->got_headers && !build_headers(fanout)) {
+		warn("Failed to mux stream headers");
+		obs_encoder_packet_release(&new_packet);
+		return;
+	}
+
+	struct fanout_tag *tag = bzalloc(sizeof(*tag));
+	tag->refs = 1;
+	tag->packet = new_packet;
+	tag->header_size = mux_tag_header(fanout, &tag->packet, tag->header);
+
+	for (size_t i = 0; i < fanout->endpoints.num; i++)
+		endpoint_add_tag(fanout->endpoints.array[i], tag);
+
+	fanout_tag_release(tag);
+}
+
+/* ------------------------------------------------------------------------- */
+/* Start                                                                     */
+
+static bool init_connect(struct rtmp_fanout *fanout)
+{
+	obs_data_t *settings = obs_output_get_settings(fanout->output);
+	obs_data_array_t *endpoints = obs_data_get_array(settings, OPT_ENDPOINTS);
+	size_t count = obs_data_array_count(endpoints);
+	int64_t drop_p;
+	int64_t drop_b;
+
+	free_endpoints(fanout);
+
+	fanout->retry_delay_sec = (uint32_t)obs_data_get_int(settings, OPT_RETRY_DELAY_SEC);
+	if (!fanout->retry_delay_sec)
+		fanout->retry_delay_sec = 1;
+
+	for (size_t i = 0; i < count; i++) {
+		obs_data_t *item = obs_data_array_item(endpoints, i);
+		struct fanout_endpoint *ep = endpoint_create(fanout, item);
+		obs_data_release(item);
+
+		if (ep) {
+			pthread_mutex_lock(&fanout->endpoints_mutex);
+			da_push_back(fanout->endpoints, &ep);
+			pthread_mutex_unlock(&fanout->endpoints_mutex);
+		}
+	}
+
+	obs_data_array_release(endpoints);
+
+	os_atomic_set_bool(&fanout->encode_error, false);
+	fanout->got_first_packet = false;
+	fanout->got_headers = false;
+
+	drop_b = (int64_t)obs_data_get_int(settings, OPT_DROP_THRESHOLD);
+	drop_p = (int64_t)obs_data_get_int(settings, OPT_PFRAME_DROP_THRESHOLD);
+	if (drop_p < (drop_b + 200))
+		drop_p = drop_b + 200;
+
+	fanout->drop_threshold_usec = 1000 * drop_b;
+	fanout->pframe_drop_threshold_usec = 1000 * drop_p;
+	fanout->max_shutdown_time_sec = (int)obs_data_get_int(settings, OPT_MAX_SHUTDOWN_TIME_SEC);
+
+	for (size_t i = 0; i < MAX_OUTPUT_AUDIO_ENCODERS; i++) {
+		obs_encoder_t *enc = obs_output_get_audio_encoder(fanout->output, i);
+		if (enc)
+			fanout->audio_codec[i] = to_audio_type(obs_encoder_get_codec(enc));
+	}
+
+	for (size_t i = 0; i < MAX_OUTPUT_VIDEO_ENCODERS; i++) {
+		obs_encoder_t *enc = obs_output_get_video_encoder2(fanout->output, i);
+		if (enc)
+			fanout->video_codec[i] = to_video_type(obs_encoder_get_codec(enc));
+	}
+
+	dstr_copy(&fanout->bind_ip, obs_data_get_string(settings, OPT_BIND_IP));
+
+	const char *ip_family = obs_data_get_string(settings, OPT_IP_FAMILY);
+	fanout->addrlen_hint = 0;
+	if (strcmp(ip_family, "IPv6") == 0)
+		fanout->addrlen_hint = sizeof(struct sockaddr_in6);
+	else if (strcmp(ip_family, "IPv4") == 0)
+		fanout->addrlen_hint = sizeof(struct sockaddr_in);
+
+	obs_data_release(settings);
+
+	if (!fanout->endpoints.num) {
+		warn("No endpoints configured");
+		return false;
+	}
+
+	return true;
+}
+
+static void *connect_thread(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+	int ret = OBS_OUTPUT_CONNECT_FAILED;
+	size_t num_connected = 0;
+
+	os_set_thread_name("rtmp-fanout: connect_thread");
+
+	if (!init_connect(fanout)) {
+		obs_output_signal_stop(fanout->output, OBS_OUTPUT_BAD_PATH);
+		goto done;
+	}
+
+	for (size_t i = 0; i < fanout->endpoints.num; i++) {
+		struct fanout_endpoint *ep = fanout->endpoints.array[i];
+		int ep_ret = endpoint_connect(ep);
+
+		if (ep_ret == OBS_OUTPUT_SUCCESS)
+			num_connected++;
+		else
+			info("Endpoint %zu: connection to %s failed: %d", i, ep->path.array, ep_ret);
+
+		/* report the first endpoint's error if none of them connects */
+		if (i == 0)
+			ret = ep_ret;
+	}
+
+	if (!num_connected) {
+		obs_output_signal_stop(fanout->output, ret);
+		goto done;
+	}
+
+	info("Connected to %zu of %zu endpoints", num_connected, fanout->endpoints.num);
+
+	os_event_reset(fanout->stop_event);
+	os_atomic_set_bool(&fanout->active, true);
+	fanout->running_endpoints = (long)fanout->endpoints.num;
+
+	/* endpoints that failed to connect keep retrying in their thread */
+	for (size_t i = 0; i < fanout->endpoints.num; i++) {
+		struct fanout_endpoint *ep = fanout->endpoints.array[i];
+
+		if (pthread_create(&ep->send_thread, NULL, send_thread, ep) == 0) {
+			ep->send_thread_active = true;
+		} else {
+			warn("Endpoint %zu: failed to create send thread", i);
+			if (connected(ep))
+				endpoint_disconnect(ep);
+			os_atomic_dec_long(&fanout->running_endpoints);
+		}
+	}
+
+	obs_output_begin_data_capture(fanout->output, 0);
+
+done:
+	if (!stopping(fanout))
+		pthread_detach(fanout->connect_thread);
+
+	os_atomic_set_bool(&fanout->connecting, false);
+	return NULL;
+}
+
+static bool rtmp_fanout_start(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+
+	if (!obs_output_can_begin_data_capture(fanout->output, 0))
+		return false;
+	if (!obs_output_initialize_encoders(fanout->output, 0))
+		return false;
+
+	os_atomic_set_bool(&fanout->connecting, true);
+	return pthread_create(&fanout->connect_thread, NULL, connect_thread, fanout) == 0;
+}
+
+/* ------------------------------------------------------------------------- */
+
+static void rtmp_fanout_defaults(obs_data_t *defaults)
+{
+	obs_data_set_default_int(defaults, OPT_DROP_THRESHOLD, 700);
+	obs_data_set_default_int(defaults, OPT_PFRAME_DROP_THRESHOLD, 900);
+	obs_data_set_default_int(defaults, OPT_MAX_SHUTDOWN_TIME_SEC, 30);
+	obs_data_set_default_int(defaults, OPT_RETRY_DELAY_SEC, 2);
+	obs_data_set_default_string(defaults, OPT_BIND_IP, "default");
+}
+
+static obs_properties_t *rtmp_fanout_properties(void *unused)
+{
+	UNUSED_PARAMETER(unused);
+
+	obs_properties_t *props = obs_properties_create();
+	obs_property_t *p;
+
+	p = obs_properties_add_int(props, OPT_DROP_THRESHOLD, obs_module_text("RTMPStream.DropThreshold"), 200, 10000,
+				   100);
+	obs_property_int_set_suffix(p, " ms");
+
+	p = obs_properties_add_int(props, OPT_RETRY_DELAY_SEC, obs_module_text("RTMPFanout.RetryDelay"), 1,
+				   MAX_RETRY_DELAY_SEC, 1);
+	obs_property_int_set_suffix(p, " s");
+
+	return props;
+}
+
+static uint64_t rtmp_fanout_total_bytes_sent(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+	uint64_t total = 0;
+
+	pthread_mutex_lock(&fanout->endpoints_mutex);
+	for (size_t i = 0; i < fanout->endpoints.num; i++)
+		total += fanout->endpoints.array[i]->total_bytes_sent;
+	pthread_mutex_unlock(&fanout->endpoints_mutex);
+	return total;
+}
+
+static int rtmp_fanout_dropped_frames(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+	int dropped = 0;
+
+	pthread_mutex_lock(&fanout->endpoints_mutex);
+	for (size_t i = 0; i < fanout->endpoints.num; i++)
+		dropped += fanout->endpoints.array[i]->dropped_frames;
+	pthread_mutex_unlock(&fanout->endpoints_mutex);
+	return dropped;
+}
+
+/* the most congested endpoint */
+static float rtmp_fanout_congestion(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+	float congestion = 0.0f;
+
+	pthread_mutex_lock(&fanout->endpoints_mutex);
+	for (size_t i = 0; i < fanout->endpoints.num; i++) {
+		struct fanout_endpoint *ep = fanout->endpoints.array[i];
+		float cur = ep->min_priority > 0 ? 1.0f : ep->congestion;
+
+		if (cur > congestion)
+			congestion = cur;
+	}
+	pthread_mutex_unlock(&fanout->endpoints_mutex);
+
+	return congestion;
+}
+
+static int rtmp_fanout_connect_time(void *data)
+{
+	struct rtmp_fanout *fanout = data;
+	int connect_time = 0;
+
+	pthread_mutex_lock(&fanout->endpoints_mutex);
+	for (size_t i = 0; i < fanout->endpoints.num; i++) {
+		int cur = fanout->endpoints.array[i]->rtmp.connect_time_ms;
+		if (cur > connect_time)
+			connect_time = cur;
+	}
+	pthread_mutex_unlock(&fanout->endpoints_mutex);
+
+	return connect_time;
+}
+
+struct obs_output_info rtmp_fanout_output_info = {
+	.id = "rtmp_fanout_output",
+	.flags = OBS_OUTPUT_AV | OBS_OUTPUT_ENCODED | OBS_OUTPUT_MULTI_TRACK_AV,
+#ifdef ENABLE_HEVC
+	.encoded_video_codecs = "h264;hevc;av1",
+#else
+	.encoded_video_codecs = "h264;av1",
+#endif
+	.encoded_audio_codecs = "aac",
+	.get_name = rtmp_fanout_getname,
+	.create = rtmp_fanout_create,
+	.destroy = rtmp_fanout_destroy,
+	.start = rtmp_fanout_start,
+	.stop = rtmp_fanout_stop,
+	.encoded_packet = rtmp_fanout_data,
+	.get_defaults = rtmp_fanout_defaults,
+	.get_properties = rtmp_fanout_properties,
+	.get_total_bytes = rtmp_fanout_total_bytes_sent,
+	.get_congestion = rtmp_fanout_congestion,
+	.get_connect_time_ms = rtmp_fanout_connect_time,
+	.get_dropped_frames = rtmp_fanout_dropped_frames,
+};
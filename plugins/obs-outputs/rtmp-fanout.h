@@ -0,0 +1,95 @@
+#pragma once
+
+#include "rtmp-stream.h"
+#include <util/darray.h>
+
+#undef do_log
+#define do_log(level, format, ...) \
+	blog(level, "[rtmp fanout: '%s'] " format, obs_output_get_name(fanout->output), ##__VA_ARGS__)
+
+#define OPT_ENDPOINTS "endpoints"
+#define OPT_RETRY_DELAY_SEC "retry_delay_sec"
+
+#define MAX_RETRY_DELAY_SEC 60
+
+/* An FLV tag muxed once and shared by every endpoint.  The payload stays in
+ * the (refcounted) encoder packet, the tag header is written next to it. */
+struct fanout_tag {
+	volatile long refs;
+	struct encoder_packet packet;
+	uint8_t header[FLV_TAG_HEADER_MAX];
+	size_t header_size;
+};
+
+struct fanout_endpoint {
+	struct rtmp_fanout *fanout;
+	size_t idx;
+
+	struct dstr path, key;
+	struct dstr username, password;
+	RTMP rtmp;
+
+	pthread_t send_thread;
+	bool send_thread_active;
+	os_sem_t *send_sem;
+
+	/* struct fanout_tag pointers waiting to be sent */
+	pthread_mutex_t packets_mutex;
+	struct deque packets;
+
+	volatile bool connected;
+	bool sent_headers;
+	bool wait_for_keyframe;
+	uint32_t retry_delay_sec;
+
+	/* frame drop variables */
+	int min_priority;
+	float congestion;
+	int64_t last_dts_usec;
+	size_t buffered_size;
+	struct deque dropped;
+	size_t dropped_size;
+
+	uint64_t total_bytes_sent;
+	int dropped_frames;
+};
+
+struct rtmp_fanout {
+	obs_output_t *output;
+
+	/* the array is only changed on the connect thread, the lock keeps the
+	 * stats getters from walking it while it changes */
+	pthread_mutex_t endpoints_mutex;
+	DARRAY(struct fanout_endpoint *) endpoints;
+	volatile long running_endpoints;
+
+	volatile bool connecting;
+	pthread_t connect_thread;
+
+	volatile bool active;
+	volatile bool encode_error;
+
+	os_event_t *stop_event;
+	uint64_t stop_ts;
+	uint64_t shutdown_timeout_ts;
+	int max_shutdown_time_sec;
+
+	bool got_first_packet;
+	int64_t start_dts_offset;
+
+	/* metadata and sequence headers every endpoint sends after connecting,
+	 * and the enhanced RTMP end of sequence tags it sends when stopping */
+	bool got_headers;
+	DARRAY(uint8_t) headers;
+	DARRAY(uint8_t) footers;
+
+	int64_t drop_threshold_usec;
+	int64_t pframe_drop_threshold_usec;
+	uint32_t retry_delay_sec;
+
+	struct dstr bind_ip;
+	socklen_t addrlen_hint; /* hint IPv4 vs IPv6 */
+
+	enum audio_id_t audio_codec[MAX_OUTPUT_AUDIO_ENCODERS];
+	enum video_id_t video_codec[MAX_OUTPUT_VIDEO_ENCODERS];
+};
@@ -0,0 +1,683 @@
+#ifdef __linux__
+#include "rtmp-stream.h"
+
+#include <errno.h>
+#include <unistd.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <linux/io_uring.h>
+
+/* Linux counterpart of socket_thread_windows.  The send thread queues data
+ * into write_buf through socket_queue_data and this thread drains it on a
+ * non-blocking socket.  io_uring is used when the kernel provides it, with
+ * the send and the re-armed receive/wakeup reads going out in a single
+ * submission; otherwise the thread falls back to a plain epoll loop.
+ *
+ * Every write records how long the kernel took to accept it, which is fed
+ * into the congestion value reported by rtmp_stream_congestion. */
+
+#define LATENCY_FACTOR 20
+#define LATENCY_SMOOTHING 8
+#define SNDBUF_TUNE_INTERVAL_NS 1000000000ULL
+#define MAX_WRITE_BUF_SIZE (16 * 1024 * 1024)
+#define URING_ENTRIES 8
+
+enum uring_op {
+	URING_OP_SEND = 1,
+	URING_OP_RECV,
+	URING_OP_WAKE,
+	URING_OP_CANCEL,
+};
+
+struct uring {
+	int fd;
+	unsigned entries;
+
+	unsigned *sq_head;
+	unsigned *sq_tail;
+	unsigned *sq_mask;
+	unsigned *sq_array;
+	unsigned sq_local_tail;
+	unsigned sq_submitted;
+	struct io_uring_sqe *sqes;
+
+	unsigned *cq_head;
+	unsigned *cq_tail;
+	unsigned *cq_mask;
+	struct io_uring_cqe *cqes;
+
+	void *sq_ptr;
+	size_t sq_size;
+	void *cq_ptr;
+	size_t cq_size;
+	size_t sqes_size;
+};
+
+struct socket_writer {
+	struct rtmp_stream *stream;
+	int fd;
+
+	int delay_time;
+	size_t latency_packet_size;
+	uint64_t last_send_time;
+	uint64_t last_tune_time;
+	uint64_t write_start;
+
+	char discard[16384];
+	uint64_t wake_count;
+};
+
+static void fatal_sock_shutdown(struct rtmp_stream *stream)
+{
+	close(stream->rtmp.m_sb.sb_socket);
+	stream->rtmp.m_sb.sb_socket = -1;
+	stream->write_buf_len = 0;
+	os_event_signal(stream->buffer_space_available_event);
+}
+
+static bool should_exit(struct rtmp_stream *stream)
+{
+	bool empty;
+
+	if (os_event_try(stream->send_thread_signaled_exit) == EAGAIN)
+		return false;
+
+	pthread_mutex_lock(&stream->write_buf_mutex);
+	empty = stream->write_buf_len == 0;
+	pthread_mutex_unlock(&stream->write_buf_mutex);
+
+	if (empty)
+		os_event_reset(stream->send_thread_signaled_exit);
+	return empty;
+}
+
+static void record_write_latency(struct socket_writer *w, uint64_t now)
+{
+	long usec = (long)((now - w->write_start) / 1000);
+	long avg = os_atomic_load_long(&w->stream->write_latency_usec);
+
+	avg += (usec - avg) / LATENCY_SMOOTHING;
+	os_atomic_set_long(&w->stream->write_latency_usec, avg);
+	w->write_start = 0;
+}
+
+/* Windows has ideal send backlog notifications for this.  Here the
+ * bandwidth-delay product is estimated from the congestion window and
+ * write_buf is grown so it can hold that much.  The socket's SO_SNDBUF is
+ * left alone, setting it would turn off the kernel's own autotuning.
+ *
+ * Only called while no send is in flight, so write_buf can be moved. */
+static void tune_send_buffer(struct socket_writer *w, uint64_t now)
+{
+	struct rtmp_stream *stream = w->stream;
+	struct tcp_info ti;
+	socklen_t size = sizeof(ti);
+	bool grown = false;
+
+	if (stream->disable_send_window_optimization || now - w->last_tune_time < SNDBUF_TUNE_INTERVAL_NS)
+		return;
+
+	w->last_tune_time = now;
+
+	if (getsockopt(w->fd, IPPROTO_TCP, TCP_INFO, &ti, &size) != 0) {
+		blog(LOG_ERROR, "socket_thread_linux: getsockopt(TCP_INFO) failed, %d", errno);
+		return;
+	}
+
+	uint64_t ideal_send_backlog = (uint64_t)ti.tcpi_snd_cwnd * ti.tcpi_snd_mss * 2;
+	if (!ideal_send_backlog)
+		return;
+	if (ideal_send_backlog > MAX_WRITE_BUF_SIZE)
+		ideal_send_backlog = MAX_WRITE_BUF_SIZE;
+
+	pthread_mutex_lock(&stream->write_buf_mutex);
+	if (ideal_send_backlog > stream->write_buf_size) {
+		stream->write_buf = brealloc(stream->write_buf, (size_t)ideal_send_backlog);
+		stream->write_buf_size = (size_t)ideal_send_backlog;
+
+		if (stream->low_latency_mode)
+			w->latency_packet_size = stream->write_buf_size / (LATENCY_FACTOR - 2);
+		else
+			w->latency_packet_size = stream->write_buf_size;
+		grown = true;
+	}
+	pthread_mutex_unlock(&stream->write_buf_mutex);
+
+	if (!grown)
+		return;
+
+	os_event_signal(stream->buffer_space_available_event);
+
+	blog(LOG_INFO,
+	     "socket_thread_linux: Increasing write buffer to "
+	     "%" PRIu64 " (cwnd %u, rtt %u us, buffer: %zu / %zu)",
+	     ideal_send_backlog, ti.tcpi_snd_cwnd, ti.tcpi_rtt, stream->write_buf_len, stream->write_buf_size);
+}
+
+/* called with write_buf_mutex held */
+static void consume_data(struct socket_writer *w, size_t len)
+{
+	struct rtmp_stream *stream = w->stream;
+	uint64_t now = os_gettime_ns();
+
+	if (stream->write_buf_len - len)
+		memmove(stream->write_buf, stream->write_buf + len, stream->write_buf_len - len);
+	stream->write_buf_len -= len;
+
+	record_write_latency(w, now);
+	w->last_send_time = now / 1000000;
+
+	os_event_signal(stream->buffer_space_available_event);
+}
+
+static void log_closed(struct socket_writer *w, int err_code)
+{
+	struct rtmp_stream *stream = w->stream;
+
+	if (w->last_send_time) {
+		uint32_t diff = (uint32_t)(os_gettime_ns() / 1000000 - w->last_send_time);
+
+		blog(LOG_ERROR,
+		     "socket_thread_linux: Connection closed, %u ms since last send "
+		     "(buffer: %zu / %zu)",
+		     diff, stream->write_buf_len, stream->write_buf_size);
+	}
+
+	if (os_event_try(stream->stop_event) != EAGAIN)
+		blog(LOG_ERROR,
+		     "socket_thread_linux: Aborting due to connection close "
+		     "during shutdown, %zu bytes lost, error %d",
+		     stream->write_buf_len, err_code);
+	else
+		blog(LOG_ERROR, "socket_thread_linux: Aborting due to connection close, error %d", err_code);
+
+	stream->rtmp.last_error_code = err_code;
+}
+
+/* ------------------------------------------------------------------------- */
+/* io_uring                                                                  */
+
+static void uring_free(struct uring *ring)
+{
+	if (ring->sqes)
+		munmap(ring->sqes, ring->sqes_size);
+	if (ring->cq_ptr)
+		munmap(ring->cq_ptr, ring->cq_size);
+	if (ring->sq_ptr)
+		munmap(ring->sq_ptr, ring->sq_size);
+	if (ring->fd >= 0)
+		close(ring->fd);
+}
+
+static void *uring_map(int fd, size_t size, off_t offset)
+{
+	void *ptr = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd, offset);
+	return ptr == MAP_FAILED ? NULL : ptr;
+}
+
+static bool uring_init(struct uring *ring, unsigned entries)
+{
+	struct io_uring_params p;
+
+	memset(ring, 0, sizeof(*ring));
+	memset(&p, 0, sizeof(p));
+
+	ring->fd = (int)syscall(__NR_io_uring_setup, entries, &p);
+	if (ring->fd < 0) {
+		blog(LOG_INFO, "socket_thread_linux: io_uring unavailable (%d), using epoll", errno);
+		return false;
+	}
+
+	/* fast poll (5.7) implies send/recv support and lets sends wait for
+	 * socket space without punting to a worker thread */
+	if (!(p.features & IORING_FEAT_FAST_POLL)) {
+		blog(LOG_INFO, "socket_thread_linux: io_uring lacks fast poll, using epoll");
+		goto fail;
+	}
+
+	ring->entries = p.sq_entries;
+	ring->sq_size = p.sq_off.array + p.sq_entries * sizeof(unsigned);
+	ring->cq_size = p.cq_off.cqes + p.cq_entries * sizeof(struct io_uring_cqe);
+	ring->sqes_size = p.sq_entries * sizeof(struct io_uring_sqe);
+
+	ring->sq_ptr = uring_map(ring->fd, ring->sq_size, IORING_OFF_SQ_RING);
+	ring->cq_ptr = uring_map(ring->fd, ring->cq_size, IORING_OFF_CQ_RING);
+	ring->sqes = uring_map(ring->fd, ring->sqes_size, IORING_OFF_SQES);
+	if (!ring->sq_ptr || !ring->cq_ptr || !ring->sqes) {
+		blog(LOG_WARNING, "socket_thread_linux: Failed to map io_uring, using epoll");
+		goto fail;
+	}
+
+	uint8_t *sq = ring->sq_ptr;
+	ring->sq_head = (unsigned *)(sq + p.sq_off.head);
+	ring->sq_tail = (unsigned *)(sq + p.sq_off.tail);
+	ring->sq_mask = (unsigned *)(sq + p.sq_off.ring_mask);
+	ring->sq_array = (unsigned *)(sq + p.sq_off.array);
+	ring->sq_local_tail = *ring->sq_tail;
+	ring->sq_submitted = ring->sq_local_tail;
+
+	uint8_t *cq = ring->cq_ptr;
+	ring->cq_head = (unsigned *)(cq + p.cq_off.head);
+	ring->cq_tail = (unsigned *)(cq + p.cq_off.tail);
+	ring->cq_mask = (unsigned *)(cq + p.cq_off.ring_mask);
+	ring->cqes = (struct io_uring_cqe *)(cq + p.cq_off.cqes);
+	return true;
+
+fail:
+	uring_free(ring);
+	return false;
+}
+
+static struct io_uring_sqe *uring_get_sqe(struct uring *ring, enum uring_op op, uint8_t opcode, int fd)
+{
+	unsigned head = __atomic_load_n(ring->sq_head, __ATOMIC_ACQUIRE);
+	unsigned tail = ring->sq_local_tail;
+
+	if (tail - head >= ring->entries)
+		return NULL;
+
+	unsigned idx = tail & *ring->sq_mask;
+	struct io_uring_sqe *sqe = &ring->sqes[idx];
+
+	memset(sqe, 0, sizeof(*sqe));
+	sqe->opcode = opcode;
+	sqe->fd = fd;
+	sqe->user_data = op;
+
+	ring->sq_array[idx] = idx;
+	ring->sq_local_tail = tail + 1;
+	return sqe;
+}
+
+/* submits everything queued since the last call and optionally waits for a
+ * completion, all in one system call */
+static int uring_enter(struct uring *ring, unsigned wait_nr)
+{
+	unsigned to_submit = ring->sq_local_tail - ring->sq_submitted;
+	int ret;
+
+	__atomic_store_n(ring->sq_tail, ring->sq_local_tail, __ATOMIC_RELEASE);
+
+	ret = (int)syscall(__NR_io_uring_enter, ring->fd, to_submit, wait_nr, wait_nr ? IORING_ENTER_GETEVENTS : 0,
+			   NULL, 0);
+	if (ret >= 0)
+		ring->sq_submitted += (unsigned)ret;
+	return ret;
+}
+
+static bool uring_pop_cqe(struct uring *ring, uint64_t *user_data, int *res)
+{
+	unsigned head = *ring->cq_head;
+
+	if (head == __atomic_load_n(ring->cq_tail, __ATOMIC_ACQUIRE))
+		return false;
+
+	struct io_uring_cqe *cqe = &ring->cqes[head & *ring->cq_mask];
+	*user_data = cqe->user_data;
+	*res = cqe->res;
+
+	__atomic_store_n(ring->cq_head, head + 1, __ATOMIC_RELEASE);
+	return true;
+}
+
+static void uring_prep_recv(struct uring *ring, struct socket_writer *w)
+{
+	struct io_uring_sqe *sqe = uring_get_sqe(ring, URING_OP_RECV, IORING_OP_RECV, w->fd);
+	sqe->addr = (uintptr_t)w->discard;
+	sqe->len = sizeof(w->discard);
+}
+
+static void uring_prep_wake(struct uring *ring, struct socket_writer *w)
+{
+	struct io_uring_sqe *sqe = uring_get_sqe(ring, URING_OP_WAKE, IORING_OP_READ, w->stream->socket_wake_fd);
+	sqe->addr = (uintptr_t)&w->wake_count;
+	sqe->len = sizeof(w->wake_count);
+}
+
+static void uring_prep_send(struct uring *ring, struct socket_writer *w, size_t len)
+{
+	struct io_uring_sqe *sqe = uring_get_sqe(ring, URING_OP_SEND, IORING_OP_SEND, w->fd);
+	sqe->addr = (uintptr_t)w->stream->write_buf;
+	sqe->len = (uint32_t)len;
+	sqe->msg_flags = MSG_NOSIGNAL;
+}
+
+/* requests reference the socket and buffers owned by this thread, so they
+ * have to be cancelled and reaped before the ring and socket go away */
+static void uring_cancel_all(struct uring *ring, int inflight, bool send_inflight)
+{
+	static const enum uring_op ops[] = {URING_OP_SEND, URING_OP_RECV, URING_OP_WAKE};
+
+	for (size_t i = send_inflight ? 0 : 1; i < sizeof(ops) / sizeof(ops[0]); i++) {
+		struct io_uring_sqe *sqe = uring_get_sqe(ring, URING_OP_CANCEL, IORING_OP_ASYNC_CANCEL, -1);
+		if (sqe)
+			sqe->addr = ops[i];
+	}
+
+	while (inflight > 0) {
+		uint64_t user_data;
+		int res;
+
+		if (uring_enter(ring, 1) < 0 && errno != EINTR)
+			break;
+
+		while (uring_pop_cqe(ring, &user_data, &res)) {
+			if (user_data != URING_OP_CANCEL)
+				inflight--;
+		}
+	}
+}
+
+static bool socket_thread_uring(struct socket_writer *w)
+{
+	struct rtmp_stream *stream = w->stream;
+	struct uring ring;
+	bool send_inflight = false;
+	bool fatal = false;
+	int inflight = 2;
+
+	if (!uring_init(&ring, URING_ENTRIES))
+		return false;
+
+	blog(LOG_INFO, "socket_thread_linux: Using io_uring");
+
+	uring_prep_recv(&ring, w);
+	uring_prep_wake(&ring, w);
+
+	for (;;) {
+		if (!send_inflight) {
+			if (should_exit(stream))
+				break;
+
+			pthread_mutex_lock(&stream->write_buf_mutex);
+			size_t len = stream->write_buf_len;
+			pthread_mutex_unlock(&stream->write_buf_mutex);
+
+			/* write_buf only ever grows past write_buf_len while
+			 * a send is in flight, so the queued range is stable */
+			if (len) {
+				if (stream->low_latency_mode && len > w->latency_packet_size)
+					len = w->latency_packet_size;
+				if (!w->write_start)
+					w->write_start = os_gettime_ns();
+
+				uring_prep_send(&ring, w, len);
+				send_inflight = true;
+				inflight++;
+			}
+		}
+
+		if (uring_enter(&ring, 1) < 0) {
+			if (errno == EINTR)
+				continue;
+
+			blog(LOG_ERROR, "socket_thread_linux: Aborting due to io_uring_enter failure, %d", errno);
+			fatal = true;
+			break;
+		}
+
+		uint64_t user_data;
+		int res;
+
+		while (!fatal && uring_pop_cqe(&ring, &user_data, &res)) {
+			switch (user_data) {
+			case URING_OP_SEND:
+				send_inflight = false;
+				inflight--;
+
+				if (res > 0) {
+					pthread_mutex_lock(&stream->write_buf_mutex);
+					consume_data(w, (size_t)res);
+					pthread_mutex_unlock(&stream->write_buf_mutex);
+
+					tune_send_buffer(w, os_gettime_ns());
+
+					if (w->delay_time)
+						os_sleep_ms(w->delay_time);
+
+				} else if (res != -EAGAIN && res != -EINTR) {
+					blog(LOG_ERROR, "socket_thread_linux: Socket error, send() returned %d", res);
+					stream->rtmp.last_error_code = -res;
+					fatal = true;
+				}
+				break;
+
+			case URING_OP_RECV:
+				if (res > 0 || res == -EAGAIN || res == -EINTR) {
+					uring_prep_recv(&ring, w);
+				} else {
+					inflight--;
+					log_closed(w, -res);
+					fatal = true;
+				}
+				break;
+
+			case URING_OP_WAKE:
+				uring_prep_wake(&ring, w);
+				break;
+			}
+		}
+
+		if (fatal)
+			break;
+	}
+
+	uring_cancel_all(&ring, inflight, send_inflight);
+	uring_free(&ring);
+
+	if (fatal)
+		fatal_sock_shutdown(stream);
+	else
+		blog(LOG_INFO, "socket_thread_linux: Normal exit");
+	return true;
+}
+
+/* ------------------------------------------------------------------------- */
+/* epoll                                                                     */
+
+enum data_ret { RET_BREAK, RET_FATAL, RET_CONTINUE };
+
+static enum data_ret write_data(struct socket_writer *w, bool *can_write)
+{
+	struct rtmp_stream *stream = w->stream;
+	bool exit_loop = false;
+
+	pthread_mutex_lock(&stream->write_buf_mutex);
+
+	if (!stream->write_buf_len) {
+		pthread_mutex_unlock(&stream->write_buf_mutex);
+		return RET_BREAK;
+	}
+
+	size_t send_len = stream->write_buf_len;
+	if (stream->low_latency_mode && send_len > w->latency_packet_size)
+		send_len = w->latency_packet_size;
+
+	if (!w->write_start)
+		w->write_start = os_gettime_ns();
+
+	ssize_t ret = send(w->fd, stream->write_buf, send_len, MSG_NOSIGNAL);
+
+	if (ret > 0) {
+		consume_data(w, (size_t)ret);
+
+	} else if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR)) {
+		*can_write = errno == EINTR;
+		pthread_mutex_unlock(&stream->write_buf_mutex);
+		return *can_write ? RET_CONTINUE : RET_BREAK;
+
+	} else {
+		int err_code = ret < 0 ? errno : 0;
+
+		/* connection closed, or connection was aborted /
+		 * socket closed / etc, that's a fatal error. */
+		blog(LOG_ERROR, "socket_thread_linux: Socket error, send() returned %zd, errno %d", ret, err_code);
+
+		pthread_mutex_unlock(&stream->write_buf_mutex);
+		stream->rtmp.last_error_code = err_code;
+		fatal_sock_shutdown(stream);
+		return RET_FATAL;
+	}
+
+	/* finish writing for now */
+	if (stream->write_buf_len <= 1000)
+		exit_loop = true;
+
+	pthread_mutex_unlock(&stream->write_buf_mutex);
+
+	tune_send_buffer(w, os_gettime_ns());
+
+	if (w->delay_time)
+		os_sleep_ms(w->delay_time);
+
+	return exit_loop ? RET_BREAK : RET_CONTINUE;
+}
+
+static bool drain_socket(struct socket_writer *w)
+{
+	for (;;) {
+		ssize_t ret = recv(w->fd, w->discard, sizeof(w->discard), 0);
+		if (ret > 0)
+			continue;
+		if (ret < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return true;
+		if (ret < 0 && errno == EINTR)
+			continue;
+
+		log_closed(w, ret < 0 ? errno : 0);
+		fatal_sock_shutdown(w->stream);
+		return false;
+	}
+}
+
+static bool set_want_write(int epfd, int fd, bool want_write)
+{
+	struct epoll_event ev = {0};
+
+	ev.events = EPOLLIN | EPOLLRDHUP | (want_write ? EPOLLOUT : 0);
+	ev.data.fd = fd;
+	return epoll_ctl(epfd, EPOLL_CTL_MOD, fd, &ev) == 0;
+}
+
+static void socket_thread_epoll(struct socket_writer *w)
+{
+	struct rtmp_stream *stream = w->stream;
+	struct epoll_event ev = {0};
+	bool can_write = true;
+	bool want_write = false;
+	int epfd;
+
+	epfd = epoll_create1(EPOLL_CLOEXEC);
+	if (epfd < 0) {
+		blog(LOG_ERROR, "socket_thread_linux: Aborting due to epoll_create1 failure, %d", errno);
+		fatal_sock_shutdown(stream);
+		return;
+	}
+
+	ev.events = EPOLLIN;
+	ev.data.fd = stream->socket_wake_fd;
+	epoll_ctl(epfd, EPOLL_CTL_ADD, stream->socket_wake_fd, &ev);
+
+	ev.events = EPOLLIN | EPOLLRDHUP;
+	ev.data.fd = w->fd;
+	if (epoll_ctl(epfd, EPOLL_CTL_ADD, w->fd, &ev) != 0) {
+		blog(LOG_ERROR, "socket_thread_linux: Aborting due to epoll_ctl failure, %d", errno);
+		close(epfd);
+		fatal_sock_shutdown(stream);
+		return;
+	}
+
+	for (;;) {
+		struct epoll_event events[2];
+
+		if (should_exit(stream))
+			break;
+
+		/* only poll for writability while the kernel is pushing back,
+		 * otherwise a writable socket would wake us continuously */
+		if (want_write != !can_write) {
+			want_write = !can_write;
+			set_want_write(epfd, w->fd, want_write);
+		}
+
+		int count = epoll_wait(epfd, events, 2, -1);
+		if (count < 0) {
+			if (errno == EINTR)
+				continue;
+
+			blog(LOG_ERROR, "socket_thread_linux: Aborting due to epoll_wait failure, %d", errno);
+			close(epfd);
+			fatal_sock_shutdown(stream);
+			return;
+		}
+
+		for (int i = 0; i < count; i++) {
+			if (events[i].data.fd == stream->socket_wake_fd) {
+				eventfd_t val;
+				eventfd_read(stream->socket_wake_fd, &val);
+				continue;
+			}
+
+			if (events[i].events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR)) {
+				if (!drain_socket(w)) {
+					close(epfd);
+					return;
+				}
+			}
+			if (events[i].events & EPOLLOUT)
+				can_write = true;
+		}
+
+		while (can_write) {
+			enum data_ret ret = write_data(w, &can_write);
+
+			if (ret == RET_FATAL) {
+				close(epfd);
+				return;
+			}
+			if (ret == RET_BREAK)
+				break;
+		}
+	}
+
+	close(epfd);
+	blog(LOG_INFO, "socket_thread_linux: Normal exit");
+}
+
+/* ------------------------------------------------------------------------- */
+
+void *socket_thread_linux(void *data)
+{
+	struct rtmp_stream *stream = data;
+	struct socket_writer *w = bzalloc(sizeof(*w));
+
+	os_set_thread_name("rtmp-stream: socket_thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_OUTPUT_SEND);
+
+	w->stream = stream;
+	w->fd = stream->rtmp.m_sb.sb_socket;
+
+	if (stream->low_latency_mode) {
+		w->delay_time = 1000 / LATENCY_FACTOR;
+		w->latency_packet_size = stream->write_buf_size / (LATENCY_FACTOR - 2);
+	} else {
+		w->latency_packet_size = stream->write_buf_size;
+	}
+
+	if (stream->disable_send_window_optimization)
+		blog(LOG_INFO, "socket_thread_linux: Send window optimization disabled by user.");
+
+	os_atomic_set_long(&stream->write_latency_usec, 0);
+
+	if (!socket_thread_uring(w))
+		socket_thread_epoll(w);
+
+	bfree(w);
+	return NULL;
+}
+#endif
@@ -19,6 +19,7 @@
 #include "rtmp-av1.h"
 #include "rtmp-hevc.h"
 
+#include <obs-av1.h>
 #include <obs-avc.h>
 #include <obs-hevc.h>
 
@@ -38,12 +39,6 @@
 #define MSEC_TO_NSEC 1000000ULL
 #endif
 
-/* dynamic bitrate coefficients */
-#define DBR_INC_TIMER (4ULL * SEC_TO_NSEC)
-#define DBR_TRIGGER_USEC (200ULL * MSEC_TO_USEC)
-#define MIN_ESTIMATE_DURATION_MS 1000
-#define MAX_ESTIMATE_DURATION_MS 2000
-
 static const char *rtmp_stream_getname(void *unused)
 {
 	UNUSED_PARAMETER(unused);
@@ -75,6 +70,10 @@ static inline void free_packets(struct rtmp_stream *stream)
 		deque_pop_front(&stream->packets, &packet, sizeof(packet));
 		obs_encoder_packet_release(&packet);
 	}
+
+	stream->buffered_size = 0;
+	deque_free(&stream->dropped);
+	stream->dropped_size = 0;
 	pthread_mutex_unlock(&stream->packets_mutex);
 }
 
@@ -131,17 +130,21 @@ static void rtmp_stream_destroy(void *data)
 	os_sem_destroy(stream->send_sem);
 	pthread_mutex_destroy(&stream->packets_mutex);
 	deque_free(&stream->packets);
+	deque_free(&stream->dropped);
 #ifdef TEST_FRAMEDROPS
 	deque_free(&stream->droptest_info);
 #endif
-	deque_free(&stream->dbr_frames);
-	pthread_mutex_destroy(&stream->dbr_mutex);
+	obs_bitrate_controller_destroy(stream->dbr);
 
 	os_event_destroy(stream->buffer_space_available_event);
 	os_event_destroy(stream->buffer_has_data_event);
 	os_event_destroy(stream->socket_available_event);
 	os_event_destroy(stream->send_thread_signaled_exit);
 	pthread_mutex_destroy(&stream->write_buf_mutex);
+#ifdef __linux__
+	if (stream->socket_wake_fd >= 0)
+		close(stream->socket_wake_fd);
+#endif
 
 	if (stream->write_buf)
 		bfree(stream->write_buf);
@@ -153,6 +156,9 @@ static void *rtmp_stream_create(obs_data_t *settings, obs_output_t *output)
 	struct rtmp_stream *stream = bzalloc(sizeof(struct rtmp_stream));
 	stream->output = output;
 	pthread_mutex_init_value(&stream->packets_mutex);
+#ifdef __linux__
+	stream->socket_wake_fd = -1;
+#endif
 
 	RTMP_LogSetCallback(log_rtmp);
 	RTMP_LogSetLevel(RTMP_LOGWARNING);
@@ -167,11 +173,6 @@ static void *rtmp_stream_create(obs_data_t *settings, obs_output_t *output)
 		goto fail;
 	}
 
-	if (pthread_mutex_init(&stream->dbr_mutex, NULL) != 0) {
-		warn("Failed to initialize dbr mutex");
-		goto fail;
-	}
-
 	if (os_event_init(&stream->buffer_space_available_event, OS_EVENT_TYPE_AUTO) != 0) {
 		warn("Failed to initialize write buffer event");
 		goto fail;
@@ -188,6 +189,16 @@ static void *rtmp_stream_create(obs_data_t *settings, obs_output_t *output)
 		warn("Failed to initialize socket exit event");
 		goto fail;
 	}
+#ifdef __linux__
+	stream->socket_wake_fd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+	if (stream->socket_wake_fd < 0) {
+		warn("Failed to initialize socket wake eventfd");
+		goto fail;
+	}
+#endif
+
+	signal_handler_t *sh = obs_output_get_signal_handler(output);
+	signal_handler_add(sh, "void frames_dropped(string level, int frames, int size, int buffer_ms, bool until_next)");
 
 	UNUSED_PARAMETER(settings);
 	return stream;
@@ -235,6 +246,7 @@ static inline bool get_next_packet(struct rtmp_stream *stream, struct encoder_pa
 	pthread_mutex_lock(&stream->packets_mutex);
 	if (stream->packets.size) {
 		deque_pop_front(&stream->packets, packet, sizeof(struct encoder_packet));
+		stream->buffered_size -= packet->size;
 		new_packet = true;
 	}
 	pthread_mutex_unlock(&stream->packets_mutex);
@@ -341,7 +353,15 @@ static void droptest_cap_data_rate(struct rtmp_stream *stream, size_t size)
 }
 #endif
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(__linux__)
+static inline void wake_socket_thread(struct rtmp_stream *stream)
+{
+	os_event_signal(stream->buffer_has_data_event);
+#ifdef __linux__
+	eventfd_write(stream->socket_wake_fd, 1);
+#endif
+}
+
 static int socket_queue_data(RTMPSockBuf *sb, const char *data, int len, void *arg)
 {
 	UNUSED_PARAMETER(sb);
@@ -371,11 +391,11 @@ retry_send:
 
 	pthread_mutex_unlock(&stream->write_buf_mutex);
 
-	os_event_signal(stream->buffer_has_data_event);
+	wake_socket_thread(stream);
 
 	return len;
 }
-#endif // _WIN32
+#endif
 
 static int handle_socket_read(struct rtmp_stream *stream)
 {
@@ -396,8 +416,26 @@ static int handle_socket_read(struct rtmp_stream *stream)
 	return 0;
 }
 
+/* Sends an FLV tag whose header was written to a scratch buffer, with the
+ * payload going out straight from the encoder packet instead of being
+ * copied into an FLV buffer first */
+static int send_tag_vectored(struct rtmp_stream *stream, const uint8_t *header, size_t header_size,
+			     struct encoder_packet *packet)
+{
+	if (!header_size)
+		return 0;
+
+#ifdef TEST_FRAMEDROPS
+	droptest_cap_data_rate(stream, header_size + packet->size);
+#endif
+
+	return RTMP_WriteV(&stream->rtmp, (const char *)header, (int)header_size, (const char *)packet->data,
+			   (int)packet->size, 0);
+}
+
 static int send_packet(struct rtmp_stream *stream, struct encoder_packet *packet, bool is_header)
 {
+	uint8_t header[FLV_TAG_HEADER_MAX];
 	uint8_t *data;
 	size_t size;
 	int ret = 0;
@@ -405,7 +443,16 @@ static int send_packet(struct rtmp_stream *stream, struct encoder_packet *packet
 	if (handle_socket_read(stream))
 		return -1;
 
-	flv_packet_mux(packet, is_header ? 0 : stream->start_dts_offset, &data, &size, is_header);
+	if (!is_header) {
+		size = flv_packet_mux_header(packet, stream->start_dts_offset, header, false);
+		ret = send_tag_vectored(stream, header, size, packet);
+
+		stream->total_bytes_sent += size + packet->size + FLV_PREV_TAG_SIZE;
+		obs_encoder_packet_release(packet);
+		return ret;
+	}
+
+	flv_packet_mux(packet, 0, &data, &size, is_header);
 
 #ifdef TEST_FRAMEDROPS
 	droptest_cap_data_rate(stream, size);
@@ -413,11 +460,7 @@ static int send_packet(struct rtmp_stream *stream, struct encoder_packet *packet
 
 	ret = RTMP_Write(&stream->rtmp, (char *)data, (int)size, 0);
 	bfree(data);
-
-	if (is_header)
-		bfree(packet->data);
-	else
-		obs_encoder_packet_release(packet);
+	bfree(packet->data);
 
 	stream->total_bytes_sent += size;
 	return ret;
@@ -426,6 +469,7 @@ static int send_packet(struct rtmp_stream *stream, struct encoder_packet *packet
 static int send_packet_ex(struct rtmp_stream *stream, struct encoder_packet *packet, bool is_header, bool is_footer,
 			  size_t idx)
 {
+	uint8_t header[FLV_TAG_HEADER_MAX];
 	uint8_t *data;
 	size_t size = 0;
 	int ret = 0;
@@ -433,13 +477,20 @@ static int send_packet_ex(struct rtmp_stream *stream, struct encoder_packet *pac
 	if (handle_socket_read(stream))
 		return -1;
 
-	if (is_header) {
+	if (!is_header && !is_footer) {
+		size = flv_packet_frames_header(packet, stream->video_codec[idx], stream->start_dts_offset, header,
+						idx);
+		ret = send_tag_vectored(stream, header, size, packet);
+
+		stream->total_bytes_sent += size + packet->size + FLV_PREV_TAG_SIZE;
+		obs_encoder_packet_release(packet);
+		return ret;
+	}
+
+	if (is_header)
 		flv_packet_start(packet, stream->video_codec[idx], &data, &size, idx);
-	} else if (is_footer) {
+	else
 		flv_packet_end(packet, stream->video_codec[idx], &data, &size, idx);
-	} else {
-		flv_packet_frames(packet, stream->video_codec[idx], stream->start_dts_offset, &data, &size, idx);
-	}
 
 #ifdef TEST_FRAMEDROPS
 	droptest_cap_data_rate(stream, size);
@@ -448,10 +499,8 @@ static int send_packet_ex(struct rtmp_stream *stream, struct encoder_packet *pac
 	ret = RTMP_Write(&stream->rtmp, (char *)data, (int)size, 0);
 	bfree(data);
 
-	if (is_header || is_footer) // manually created packets
-		bfree(packet->data);
-	else
-		obs_encoder_packet_release(packet);
+	// manually created packets
+	bfree(packet->data);
 
 	stream->total_bytes_sent += size;
 	return ret;
@@ -459,6 +508,7 @@ static int send_packet_ex(struct rtmp_stream *stream, struct encoder_packet *pac
 
 static int send_audio_packet_ex(struct rtmp_stream *stream, struct encoder_packet *packet, bool is_header, size_t idx)
 {
+	uint8_t header[FLV_TAG_HEADER_MAX];
 	uint8_t *data;
 	size_t size = 0;
 	int ret = 0;
@@ -466,19 +516,20 @@ static int send_audio_packet_ex(struct rtmp_stream *stream, struct encoder_packe
 	if (handle_socket_read(stream))
 		return -1;
 
-	if (is_header) {
-		flv_packet_audio_start(packet, stream->audio_codec[idx], &data, &size, idx);
-	} else {
-		flv_packet_audio_frames(packet, stream->audio_codec[idx], stream->start_dts_offset, &data, &size, idx);
+	if (!is_header) {
+		size = flv_packet_audio_frames_header(packet, stream->audio_codec[idx], stream->start_dts_offset,
+						      header, idx);
+		ret = send_tag_vectored(stream, header, size, packet);
+
+		obs_encoder_packet_release(packet);
+		return ret;
 	}
 
+	flv_packet_audio_start(packet, stream->audio_codec[idx], &data, &size, idx);
+
 	ret = RTMP_Write(&stream->rtmp, (char *)data, (int)size, 0);
 	bfree(data);
-
-	if (is_header)
-		bfree(packet->data);
-	else
-		obs_encoder_packet_release(packet);
+	bfree(packet->data);
 
 	return ret;
 }
@@ -582,38 +633,12 @@ static void set_output_error(struct rtmp_stream *stream)
 		obs_output_set_last_error(stream->output, msg);
 }
 
-static void dbr_add_frame(struct rtmp_stream *stream, struct dbr_frame *back)
-{
-	struct dbr_frame front;
-	uint64_t dur;
-
-	deque_push_back(&stream->dbr_frames, back, sizeof(*back));
-	deque_peek_front(&stream->dbr_frames, &front, sizeof(front));
-
-	stream->dbr_data_size += back->size;
-
-	dur = (back->send_end - front.send_beg) / 1000000;
-
-	if (dur >= MAX_ESTIMATE_DURATION_MS) {
-		stream->dbr_data_size -= front.size;
-		deque_pop_front(&stream->dbr_frames, NULL, sizeof(front));
-	}
-
-	stream->dbr_est_bitrate = (dur >= MIN_ESTIMATE_DURATION_MS) ? (long)(stream->dbr_data_size * 1000 / dur) : 0;
-	stream->dbr_est_bitrate *= 8;
-	stream->dbr_est_bitrate /= 1000;
-
-	if (stream->dbr_est_bitrate) {
-		stream->dbr_est_bitrate -= stream->audio_bitrate;
-		if (stream->dbr_est_bitrate < 50)
-			stream->dbr_est_bitrate = 50;
-	}
-}
-
 static void dbr_set_bitrate(struct rtmp_stream *stream);
 
+#if defined(_WIN32) || defined(__linux__)
 #ifdef _WIN32
 #define socklen_t int
+#endif
 
 static void log_sndbuf_size(struct rtmp_stream *stream)
 {
@@ -631,14 +656,15 @@ static void *send_thread(void *data)
 	struct rtmp_stream *stream = data;
 
 	os_set_thread_name("rtmp-stream: send_thread");
+	obs_apply_thread_config(OBS_THREAD_ROLE_OUTPUT_SEND);
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(__linux__)
 	log_sndbuf_size(stream);
 #endif
 
 	while (os_sem_wait(stream->send_sem) == 0) {
 		struct encoder_packet packet;
-		struct dbr_frame dbr_frame;
+		struct obs_bitrate_sample dbr_sample;
 
 		if (stopping(stream) && stream->stop_ts == 0) {
 			break;
@@ -662,8 +688,8 @@ static void *send_thread(void *data)
 		}
 
 		if (stream->dbr_enabled) {
-			dbr_frame.send_beg = os_gettime_ns();
-			dbr_frame.size = packet.size;
+			dbr_sample.send_beg_ns = os_gettime_ns();
+			dbr_sample.size = packet.size;
 		}
 
 		int sent;
@@ -683,11 +709,8 @@ static void *send_thread(void *data)
 		}
 
 		if (stream->dbr_enabled) {
-			dbr_frame.send_end = os_gettime_ns();
-
-			pthread_mutex_lock(&stream->dbr_mutex);
-			dbr_add_frame(stream, &dbr_frame);
-			pthread_mutex_unlock(&stream->dbr_mutex);
+			dbr_sample.send_end_ns = os_gettime_ns();
+			obs_bitrate_controller_frame_sent(stream->dbr, &dbr_sample);
 		}
 	}
 
@@ -703,13 +726,13 @@ static void *send_thread(void *data)
 		send_footers(stream); // Y2023 spec
 	}
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(__linux__)
 	log_sndbuf_size(stream);
 #endif
 
 	if (stream->new_socket_loop) {
 		os_event_signal(stream->send_thread_signaled_exit);
-		os_event_signal(stream->buffer_has_data_event);
+		wake_socket_thread(stream);
 		pthread_join(stream->socket_thread, NULL);
 		stream->socket_thread_active = false;
 		stream->rtmp.m_bCustomSend = false;
@@ -721,10 +744,10 @@ static void *send_thread(void *data)
 
 	/* reset bitrate on stop */
 	if (stream->dbr_enabled) {
-		if (stream->dbr_cur_bitrate != stream->dbr_orig_bitrate) {
-			stream->dbr_cur_bitrate = stream->dbr_orig_bitrate;
+		long cur_bitrate = obs_bitrate_controller_get_bitrate(stream->dbr);
+		obs_bitrate_controller_reset(stream->dbr);
+		if (cur_bitrate != obs_bitrate_controller_get_bitrate(stream->dbr))
 			dbr_set_bitrate(stream);
-		}
 	}
 
 	if (!stopping(stream)) {
@@ -824,11 +847,13 @@ static bool send_video_header(struct rtmp_stream *stream, size_t idx)
 	return false;
 }
 
-// only returns false if there's an error, not if no metadata needs to be sent
-static bool send_video_metadata(struct rtmp_stream *stream, size_t idx)
+// only returns false if there's an error, *size is 0 if no metadata needs to be sent
+bool rtmp_video_metadata_tag(obs_encoder_t *encoder, enum video_id_t codec, uint8_t **data, size_t *size, size_t idx)
 {
+	*data = NULL;
+	*size = 0;
+
 	// send metadata only if HDR
-	obs_encoder_t *encoder = obs_output_get_video_encoder2(stream->output, idx);
 	if (!encoder)
 		return false;
 
@@ -841,80 +866,92 @@ static bool send_video_metadata(struct rtmp_stream *stream, size_t idx)
 	if (!(colorspace == VIDEO_CS_2100_PQ || colorspace == VIDEO_CS_2100_HLG))
 		return true;
 
-	if (handle_socket_read(stream))
-		return false;
+	// legacy
+	if (codec == CODEC_H264)
+		return true;
 
 	// Y2023 spec
-	if (stream->video_codec[idx] != CODEC_H264) {
-		uint8_t *data;
-		size_t size;
-
-		video_t *video = obs_get_video();
-		const struct video_output_info *info = video_output_get_info(video);
-		enum video_format format = info->format;
-		enum video_colorspace colorspace = info->colorspace;
-
-		int bits_per_raw_sample;
-		switch (format) {
-		case VIDEO_FORMAT_I010:
-		case VIDEO_FORMAT_P010:
-		case VIDEO_FORMAT_I210:
-			bits_per_raw_sample = 10;
-			break;
-		case VIDEO_FORMAT_I412:
-		case VIDEO_FORMAT_YA2L:
-			bits_per_raw_sample = 12;
-			break;
-		default:
-			bits_per_raw_sample = 8;
-		}
+	video = obs_get_video();
+	info = video_output_get_info(video);
+	enum video_format format = info->format;
+	colorspace = info->colorspace;
+
+	int bits_per_raw_sample;
+	switch (format) {
+	case VIDEO_FORMAT_I010:
+	case VIDEO_FORMAT_P010:
+	case VIDEO_FORMAT_I210:
+		bits_per_raw_sample = 10;
+		break;
+	case VIDEO_FORMAT_I412:
+	case VIDEO_FORMAT_YA2L:
+		bits_per_raw_sample = 12;
+		break;
+	default:
+		bits_per_raw_sample = 8;
+	}
 
-		int pri = 0, trc = 0, spc = 0;
-		switch (colorspace) {
-		case VIDEO_CS_601:
-			pri = OBSCOL_PRI_SMPTE170M;
-			trc = OBSCOL_PRI_SMPTE170M;
-			spc = OBSCOL_PRI_SMPTE170M;
-			break;
-		case VIDEO_CS_DEFAULT:
-		case VIDEO_CS_709:
-			pri = OBSCOL_PRI_BT709;
-			trc = OBSCOL_PRI_BT709;
-			spc = OBSCOL_PRI_BT709;
-			break;
-		case VIDEO_CS_SRGB:
-			pri = OBSCOL_PRI_BT709;
-			trc = OBSCOL_TRC_IEC61966_2_1;
-			spc = OBSCOL_PRI_BT709;
-			break;
-		case VIDEO_CS_2100_PQ:
-			pri = OBSCOL_PRI_BT2020;
-			trc = OBSCOL_TRC_SMPTE2084;
-			spc = OBSCOL_SPC_BT2020_NCL;
-			break;
-		case VIDEO_CS_2100_HLG:
-			pri = OBSCOL_PRI_BT2020;
-			trc = OBSCOL_TRC_ARIB_STD_B67;
-			spc = OBSCOL_SPC_BT2020_NCL;
-		}
+	int pri = 0, trc = 0, spc = 0;
+	switch (colorspace) {
+	case VIDEO_CS_601:
+		pri = OBSCOL_PRI_SMPTE170M;
+		trc = OBSCOL_PRI_SMPTE170M;
+		spc = OBSCOL_PRI_SMPTE170M;
+		break;
+	case VIDEO_CS_DEFAULT:
+	case VIDEO_CS_709:
+		pri = OBSCOL_PRI_BT709;
+		trc = OBSCOL_PRI_BT709;
+		spc = OBSCOL_PRI_BT709;
+		break;
+	case VIDEO_CS_SRGB:
+		pri = OBSCOL_PRI_BT709;
+		trc = OBSCOL_TRC_IEC61966_2_1;
+		spc = OBSCOL_PRI_BT709;
+		break;
+	case VIDEO_CS_2100_PQ:
+		pri = OBSCOL_PRI_BT2020;
+		trc = OBSCOL_TRC_SMPTE2084;
+		spc = OBSCOL_SPC_BT2020_NCL;
+		break;
+	case VIDEO_CS_2100_HLG:
+		pri = OBSCOL_PRI_BT2020;
+		trc = OBSCOL_TRC_ARIB_STD_B67;
+		spc = OBSCOL_SPC_BT2020_NCL;
+	}
 
-		int max_luminance = 0;
-		if (trc == OBSCOL_TRC_ARIB_STD_B67)
-			max_luminance = 1000;
-		else if (trc == OBSCOL_TRC_SMPTE2084)
-			max_luminance = (int)obs_get_video_hdr_nominal_peak_level();
+	int max_luminance = 0;
+	if (trc == OBSCOL_TRC_ARIB_STD_B67)
+		max_luminance = 1000;
+	else if (trc == OBSCOL_TRC_SMPTE2084)
+		max_luminance = (int)obs_get_video_hdr_nominal_peak_level();
 
-		flv_packet_metadata(stream->video_codec[idx], &data, &size, bits_per_raw_sample, pri, trc, spc, 0,
-				    max_luminance, idx);
+	flv_packet_metadata(codec, data, size, bits_per_raw_sample, pri, trc, spc, 0, max_luminance, idx);
+	return true;
+}
 
-		int ret = RTMP_Write(&stream->rtmp, (char *)data, (int)size, 0);
-		bfree(data);
+// only returns false if there's an error, not if no metadata needs to be sent
+static bool send_video_metadata(struct rtmp_stream *stream, size_t idx)
+{
+	obs_encoder_t *encoder = obs_output_get_video_encoder2(stream->output, idx);
+	uint8_t *data;
+	size_t size;
 
-		stream->total_bytes_sent += size;
-		return ret >= 0;
+	if (!rtmp_video_metadata_tag(encoder, stream->video_codec[idx], &data, &size, idx))
+		return false;
+	if (!size)
+		return true;
+
+	if (handle_socket_read(stream)) {
+		bfree(data);
+		return false;
 	}
-	// legacy
-	return true;
+
+	int ret = RTMP_Write(&stream->rtmp, (char *)data, (int)size, 0);
+	bfree(data);
+
+	stream->total_bytes_sent += size;
+	return ret >= 0;
 }
 
 static bool send_video_footer(struct rtmp_stream *stream, size_t idx)
@@ -1057,11 +1094,15 @@ static int init_send(struct rtmp_stream *stream)
 		stream->write_buf_size = ideal_buffer_size;
 		stream->write_buf = bmalloc(ideal_buffer_size);
 
-#ifndef _WIN32
+#if !defined(_WIN32) && !defined(__linux__)
 		warn("New socket loop not supported on this platform");
 		return OBS_OUTPUT_ERROR;
 #else
+#ifdef _WIN32
 		ret = pthread_create(&stream->socket_thread, NULL, socket_thread_windows, stream);
+#else
+		ret = pthread_create(&stream->socket_thread, NULL, socket_thread_linux, stream);
+#endif
 
 		if (ret != 0) {
 			RTMP_Close(&stream->rtmp);
@@ -1287,14 +1328,8 @@ static bool init_connect(struct rtmp_stream *stream)
 		}
 	}
 
-	deque_free(&stream->dbr_frames);
-	stream->audio_bitrate = (long)obs_data_get_int(asettings, "bitrate");
-	stream->dbr_data_size = 0;
-	stream->dbr_orig_bitrate = (long)obs_data_get_int(vsettings, "bitrate");
-	stream->dbr_cur_bitrate = stream->dbr_orig_bitrate;
-	stream->dbr_est_bitrate = 0;
-	stream->dbr_inc_bitrate = stream->dbr_orig_bitrate / 10;
-	stream->dbr_inc_timeout = 0;
+	obs_bitrate_controller_destroy(stream->dbr);
+	stream->dbr = NULL;
 	stream->dbr_enabled = obs_data_get_bool(settings, OPT_DYN_BITRATE);
 
 	caps = obs_encoder_get_caps(venc);
@@ -1308,6 +1343,15 @@ static bool init_connect(struct rtmp_stream *stream)
 		stream->dbr_enabled = false;
 	}
 
+	if (stream->dbr_enabled) {
+		const char *policy = obs_data_get_string(settings, OPT_DYN_BITRATE_POLICY);
+
+		stream->dbr = obs_bitrate_controller_create(policy, (long)obs_data_get_int(vsettings, "bitrate"),
+							    (long)obs_data_get_int(asettings, "bitrate"));
+		if (!stream->dbr)
+			stream->dbr_enabled = false;
+	}
+
 	if (stream->dbr_enabled) {
 		info("Dynamic bitrate enabled.  Dropped frames begone!");
 	}
@@ -1336,7 +1380,7 @@ static bool init_connect(struct rtmp_stream *stream)
 		stream->addrlen_hint = len;
 	}
 
-#ifdef _WIN32
+#if defined(_WIN32) || defined(__linux__)
 	stream->new_socket_loop = obs_data_get_bool(settings, OPT_NEWSOCKETLOOP_ENABLED);
 	stream->low_latency_mode = obs_data_get_bool(settings, OPT_LOWLATENCY_ENABLED);
 
@@ -1410,6 +1454,7 @@ static bool rtmp_stream_start(void *data)
 static inline bool add_packet(struct rtmp_stream *stream, struct encoder_packet *packet)
 {
 	deque_push_back(&stream->packets, packet, sizeof(struct encoder_packet));
+	stream->buffered_size += packet->size;
 	return true;
 }
 
@@ -1418,48 +1463,90 @@ static inline size_t num_buffered_packets(struct rtmp_stream *stream)
 	return stream->packets.size / sizeof(struct encoder_packet);
 }
 
-static void drop_frames(struct rtmp_stream *stream, const char *name, int highest_priority, bool pframes)
+/* drops the frames picked by plan_frame_drops(), see frame-drop.c */
+static void drop_frames(struct rtmp_stream *stream, int64_t buffer_duration_usec, int64_t drop_threshold,
+			int max_level)
 {
-	UNUSED_PARAMETER(pframes);
+	size_t count = num_buffered_packets(stream);
+	struct encoder_packet **video = bmalloc(count * sizeof(*video));
+	bool *drop = bzalloc(count * sizeof(*drop));
+	size_t num_video = 0;
+	struct drop_plan plan;
+	int64_t goal;
 
-	struct deque new_buf = {0};
-	int num_frames_dropped = 0;
+	for (size_t i = 0; i < count; i++) {
+		struct encoder_packet *packet = deque_data(&stream->packets, i * sizeof(*packet));
+		if (packet->type == OBS_ENCODER_VIDEO)
+			video[num_video++] = packet;
+	}
 
-#ifdef _DEBUG
-	int start_packets = (int)num_buffered_packets(stream);
-#else
-	UNUSED_PARAMETER(name);
-#endif
+	goal = drop_goal(stream->buffered_size, stream->dropped_size, buffer_duration_usec, drop_threshold);
+	bool dropping = plan_frame_drops(video, num_video, goal, max_level, drop, &plan);
+	bfree(video);
 
-	deque_reserve(&new_buf, sizeof(struct encoder_packet) * 8);
+	if (stream->min_priority < plan.until_next)
+		stream->min_priority = plan.until_next;
+	if (!dropping) {
+		bfree(drop);
+		return;
+	}
+
+	struct deque new_buf = {0};
+	size_t video_idx = 0;
+
+	deque_reserve(&new_buf, stream->packets.size);
 
 	while (stream->packets.size) {
 		struct encoder_packet packet;
 		deque_pop_front(&stream->packets, &packet, sizeof(packet));
 
-		/* do not drop audio data or video keyframes */
-		if (packet.type == OBS_ENCODER_AUDIO || packet.drop_priority >= highest_priority) {
-			deque_push_back(&new_buf, &packet, sizeof(packet));
-
-		} else {
-			num_frames_dropped++;
+		if (packet.type == OBS_ENCODER_VIDEO && drop[video_idx++]) {
+			struct dropped_frame frame = {packet.dts_usec, packet.size};
+			deque_push_back(&stream->dropped, &frame, sizeof(frame));
+			stream->dropped_size += packet.size;
+			stream->buffered_size -= packet.size;
 			obs_encoder_packet_release(&packet);
+		} else {
+			deque_push_back(&new_buf, &packet, sizeof(packet));
 		}
 	}
 
+	bfree(drop);
 	deque_free(&stream->packets);
 	stream->packets = new_buf;
 
-	if (stream->min_priority < highest_priority)
-		stream->min_priority = highest_priority;
-	if (!num_frames_dropped)
-		return;
+	stream->dropped_frames += plan.frames;
+	debug("Dropped %d frames (%s, %" PRId64 " bytes), new packet count: %d", plan.frames,
+	      drop_level_name(plan.level), plan.size, (int)num_buffered_packets(stream));
 
-	stream->dropped_frames += num_frames_dropped;
-#ifdef _DEBUG
-	debug("Dropped %s, prev packet count: %d, new packet count: %d", name, start_packets,
-	      (int)num_buffered_packets(stream));
-#endif
+	if (stream->num_drop_decisions < OBS_COUNTOF(stream->drop_decisions)) {
+		struct drop_decision *decision = &stream->drop_decisions[stream->num_drop_decisions++];
+		decision->level = plan.level;
+		decision->frames = plan.frames;
+		decision->size = (size_t)plan.size;
+		decision->buffer_duration_usec = buffer_duration_usec;
+		decision->until_next = plan.until_next != 0;
+	}
+}
+
+static void signal_drop_decisions(struct rtmp_stream *stream)
+{
+	signal_handler_t *sh = obs_output_get_signal_handler(stream->output);
+
+	for (size_t i = 0; i < stream->num_drop_decisions; i++) {
+		struct drop_decision *decision = &stream->drop_decisions[i];
+		calldata_t cd = {0};
+
+		calldata_set_string(&cd, "level", drop_level_name(decision->level));
+		calldata_set_int(&cd, "frames", decision->frames);
+		calldata_set_int(&cd, "size", (long long)decision->size);
+		calldata_set_int(&cd, "buffer_ms", decision->buffer_duration_usec / 1000);
+		calldata_set_bool(&cd, "until_next", decision->until_next);
+		signal_handler_signal(sh, "frames_dropped", &cd);
+		calldata_free(&cd);
+	}
+
+	stream->num_drop_decisions = 0;
 }
 
 static bool find_first_video_packet(struct rtmp_stream *stream, struct encoder_packet *first)
@@ -1477,128 +1564,35 @@ static bool find_first_video_packet(struct rtmp_stream *stream, struct encoder_p
 	return false;
 }
 
-static bool dbr_bitrate_lowered(struct rtmp_stream *stream)
-{
-	long prev_bitrate = stream->dbr_prev_bitrate;
-	long est_bitrate = 0;
-	long new_bitrate;
-
-	if (stream->dbr_est_bitrate && stream->dbr_est_bitrate < stream->dbr_cur_bitrate) {
-		stream->dbr_data_size = 0;
-		deque_pop_front(&stream->dbr_frames, NULL, stream->dbr_frames.size);
-		est_bitrate = stream->dbr_est_bitrate / 100 * 100;
-		if (est_bitrate < 50) {
-			est_bitrate = 50;
-		}
-	}
-
-#if 0
-	if (prev_bitrate && est_bitrate) {
-		if (prev_bitrate < est_bitrate) {
-			blog(LOG_INFO, "going back to prev bitrate: "
-					"prev_bitrate (%d) < est_bitrate (%d)",
-					prev_bitrate,
-					est_bitrate);
-			new_bitrate = prev_bitrate;
-		} else {
-			new_bitrate = est_bitrate;
-		}
-		new_bitrate = est_bitrate;
-	} else if (prev_bitrate) {
-		new_bitrate = prev_bitrate;
-		info("going back to prev bitrate");
-
-	} else if (est_bitrate) {
-		new_bitrate = est_bitrate;
-
-	} else {
-		return false;
-	}
-#else
-	if (est_bitrate) {
-		new_bitrate = est_bitrate;
-
-	} else if (prev_bitrate) {
-		new_bitrate = prev_bitrate;
-		info("going back to prev bitrate");
-
-	} else {
-		return false;
-	}
-
-	if (new_bitrate == stream->dbr_cur_bitrate) {
-		return false;
-	}
-#endif
-
-	stream->dbr_prev_bitrate = 0;
-	stream->dbr_cur_bitrate = new_bitrate;
-	stream->dbr_inc_timeout = os_gettime_ns() + DBR_INC_TIMER;
-	info("bitrate decreased to: %ld", stream->dbr_cur_bitrate);
-	return true;
-}
-
 static void dbr_set_bitrate(struct rtmp_stream *stream)
 {
 	obs_encoder_t *vencoder = obs_output_get_video_encoder(stream->output);
-	obs_data_t *settings = obs_encoder_get_settings(vencoder);
-
-	obs_data_set_int(settings, "bitrate", stream->dbr_cur_bitrate);
-	obs_encoder_update(vencoder, settings);
-
-	obs_data_release(settings);
-}
-
-static void dbr_inc_bitrate(struct rtmp_stream *stream)
-{
-	stream->dbr_prev_bitrate = stream->dbr_cur_bitrate;
-	stream->dbr_cur_bitrate += stream->dbr_inc_bitrate;
-
-	if (stream->dbr_cur_bitrate >= stream->dbr_orig_bitrate) {
-		stream->dbr_cur_bitrate = stream->dbr_orig_bitrate;
-		info("bitrate increased to: %ld, done", stream->dbr_cur_bitrate);
-	} else if (stream->dbr_cur_bitrate < stream->dbr_orig_bitrate) {
-		stream->dbr_inc_timeout = os_gettime_ns() + DBR_INC_TIMER;
-		info("bitrate increased to: %ld, waiting", stream->dbr_cur_bitrate);
-	}
+	obs_bitrate_controller_apply(stream->dbr, vencoder);
 }
 
 static void check_to_drop_frames(struct rtmp_stream *stream, bool pframes)
 {
 	struct encoder_packet first;
 	int64_t buffer_duration_usec;
+	int64_t effective_duration_usec;
 	size_t num_packets = num_buffered_packets(stream);
-	const char *name = pframes ? "p-frames" : "b-frames";
-	int priority = pframes ? OBS_NAL_PRIORITY_HIGHEST : OBS_NAL_PRIORITY_HIGH;
+	int max_level = pframes ? OBS_NAL_PRIORITY_HIGHEST : OBS_NAL_PRIORITY_HIGH;
 	int64_t drop_threshold = pframes ? stream->pframe_drop_threshold_usec : stream->drop_threshold_usec;
 
-	if (!pframes && stream->dbr_enabled) {
-		if (stream->dbr_inc_timeout) {
-			uint64_t t = os_gettime_ns();
-
-			if (t >= stream->dbr_inc_timeout) {
-				stream->dbr_inc_timeout = 0;
-				dbr_inc_bitrate(stream);
-				dbr_set_bitrate(stream);
-			}
-		}
-	}
-
-	if (num_packets < 5) {
-		if (!pframes)
-			stream->congestion = 0.0f;
-		return;
+	if (num_packets < 5 || !find_first_video_packet(stream, &first)) {
+		buffer_duration_usec = 0;
+		effective_duration_usec = 0;
+	} else {
+		/* if the amount of time stored in the buffered packets waiting
+		 * to be sent is higher than threshold, drop frames */
+		buffer_duration_usec = stream->last_dts_usec - first.dts_usec;
+		effective_duration_usec = effective_buffer_duration(&stream->dropped, &stream->dropped_size,
+								    stream->buffered_size, first.dts_usec,
+								    buffer_duration_usec);
 	}
 
-	if (!find_first_video_packet(stream, &first))
-		return;
-
-	/* if the amount of time stored in the buffered packets waiting to be
-	 * sent is higher than threshold, drop frames */
-	buffer_duration_usec = stream->last_dts_usec - first.dts_usec;
-
 	if (!pframes) {
-		stream->congestion = (float)buffer_duration_usec / (float)drop_threshold;
+		stream->congestion = (float)effective_duration_usec / (float)drop_threshold;
 	}
 
 	/* alternatively, drop only pframes:
@@ -1606,28 +1600,16 @@ static void check_to_drop_frames(struct rtmp_stream *stream, bool pframes)
 	 * but let's test without dropping frames
 	 * at all first */
 	if (stream->dbr_enabled) {
-		bool bitrate_changed = false;
-
-		if (pframes) {
-			return;
-		}
-
-		if ((uint64_t)buffer_duration_usec >= DBR_TRIGGER_USEC) {
-			pthread_mutex_lock(&stream->dbr_mutex);
-			bitrate_changed = dbr_bitrate_lowered(stream);
-			pthread_mutex_unlock(&stream->dbr_mutex);
-		}
-
-		if (bitrate_changed) {
-			debug("buffer_duration_msec: %" PRId64, buffer_duration_usec / 1000);
+		if (!pframes && obs_bitrate_controller_update(stream->dbr, os_gettime_ns(), effective_duration_usec)) {
+			debug("buffer_duration_msec: %" PRId64, effective_duration_usec / 1000);
 			dbr_set_bitrate(stream);
 		}
 		return;
 	}
 
-	if (buffer_duration_usec > drop_threshold) {
-		debug("buffer_duration_usec: %" PRId64, buffer_duration_usec);
-		drop_frames(stream, name, priority, pframes);
+	if (effective_duration_usec > drop_threshold) {
+		debug("buffer_duration_usec: %" PRId64, effective_duration_usec);
+		drop_frames(stream, buffer_duration_usec, drop_threshold, max_level);
 	}
 }
 
@@ -1654,6 +1636,7 @@ static void rtmp_stream_data(void *data, struct encoder_packet *packet)
 	struct rtmp_stream *stream = data;
 	struct encoder_packet new_packet;
 	bool added_packet = false;
+	int temporal_id = 0;
 
 	if (disconnected(stream) || !active(stream))
 		return;
@@ -1678,18 +1661,26 @@ static void rtmp_stream_data(void *data, struct encoder_packet *packet)
 
 		case CODEC_H264:
 			obs_parse_avc_packet(&new_packet, packet);
+			temporal_id = obs_avc_temporal_id(packet->data, packet->size);
 			break;
 		case CODEC_HEVC:
 #ifdef ENABLE_HEVC
 			obs_parse_hevc_packet(&new_packet, packet);
+			temporal_id = obs_hevc_temporal_id(packet->data, packet->size);
 			break;
 #else
 			return;
 #endif
 		case CODEC_AV1:
 			obs_parse_av1_packet(&new_packet, packet);
+			temporal_id = obs_av1_temporal_id(packet->data, packet->size);
 			break;
 		}
+
+		/* frames of enhancement layers are only referenced by their own
+		 * layers, the base layer decodes fine without them */
+		if (temporal_id > 0 && new_packet.drop_priority > OBS_NAL_PRIORITY_LOW)
+			new_packet.drop_priority = OBS_NAL_PRIORITY_LOW;
 	} else {
 		if (!stream->got_first_packet) {
 			stream->start_dts_offset = get_ms_time(packet, packet->dts);
@@ -1708,6 +1699,9 @@ static void rtmp_stream_data(void *data, struct encoder_packet *packet)
 
 	pthread_mutex_unlock(&stream->packets_mutex);
 
+	if (stream->num_drop_decisions)
+		signal_drop_decisions(stream);
+
 	if (added_packet)
 		os_sem_post(stream->send_sem);
 	else
@@ -1717,6 +1711,7 @@ static void rtmp_stream_data(void *data, struct encoder_packet *packet)
 static void rtmp_stream_defaults(obs_data_t *defaults)
 {
 	obs_data_set_default_int(defaults, OPT_DROP_THRESHOLD, 700);
+	obs_data_set_default_string(defaults, OPT_DYN_BITRATE_POLICY, OBS_BITRATE_POLICY_AIMD);
 	obs_data_set_default_int(defaults, OPT_PFRAME_DROP_THRESHOLD, 900);
 	obs_data_set_default_int(defaults, OPT_MAX_SHUTDOWN_TIME_SEC, 30);
 	obs_data_set_default_string(defaults, OPT_BIND_IP, "default");
@@ -1781,10 +1776,23 @@ static float rtmp_stream_congestion(void *data)
 {
 	struct rtmp_stream *stream = data;
 
-	if (stream->new_socket_loop)
-		return (float)stream->write_buf_len / (float)stream->write_buf_size;
-	else
+	if (stream->new_socket_loop) {
+		float congestion = (float)stream->write_buf_len / (float)stream->write_buf_size;
+
+		/* the linux socket thread also tracks how long writes take to
+		 * be accepted by the kernel, scaled like the buffered duration
+		 * used by the regular send loop */
+		long latency_usec = os_atomic_load_long(&stream->write_latency_usec);
+		if (latency_usec && stream->drop_threshold_usec > 0) {
+			float latency = (float)latency_usec / (float)stream->drop_threshold_usec;
+			if (latency > congestion)
+				congestion = latency > 1.0f ? 1.0f : latency;
+		}
+
+		return congestion;
+	} else {
 		return stream->min_priority > 0 ? 1.0f : stream->congestion;
+	}
 }
 
 static int rtmp_stream_connect_time(void *data)
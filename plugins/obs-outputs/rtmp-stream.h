@@ -8,6 +8,7 @@
 #include "librtmp/log.h"
 #include "flv-mux.h"
 #include "net-if.h"
+#include "frame-drop.h"
 
 #ifdef _WIN32
 #include <Iphlpapi.h>
@@ -15,6 +16,11 @@
 #include <sys/ioctl.h>
 #endif
 
+#ifdef __linux__
+#include <sys/eventfd.h>
+#include <unistd.h>
+#endif
+
 #define do_log(level, format, ...) \
 	blog(level, "[rtmp stream: '%s'] " format, obs_output_get_name(stream->output), ##__VA_ARGS__)
 
@@ -23,6 +29,7 @@
 #define debug(format, ...) do_log(LOG_DEBUG, format, ##__VA_ARGS__)
 
 #define OPT_DYN_BITRATE "dyn_bitrate"
+#define OPT_DYN_BITRATE_POLICY "dyn_bitrate_policy"
 #define OPT_DROP_THRESHOLD "drop_threshold_ms"
 #define OPT_PFRAME_DROP_THRESHOLD "pframe_drop_threshold_ms"
 #define OPT_MAX_SHUTDOWN_TIME_SEC "max_shutdown_time_sec"
@@ -32,6 +39,15 @@
 #define OPT_LOWLATENCY_ENABLED "low_latency_mode_enabled"
 #define OPT_METADATA_MULTITRACK "metadata_multitrack"
 
+/* a frame drop decision, reported through the "frames_dropped" signal */
+struct drop_decision {
+	int level;
+	int frames;
+	size_t size;
+	int64_t buffer_duration_usec;
+	bool until_next;
+};
+
 //#define TEST_FRAMEDROPS
 //#define TEST_FRAMEDROPS_WITH_BITRATE_SHORTCUTS
 
@@ -46,12 +62,6 @@ struct droptest_info {
 };
 #endif
 
-struct dbr_frame {
-	uint64_t send_beg;
-	uint64_t send_end;
-	size_t size;
-};
-
 struct rtmp_stream {
 	obs_output_t *output;
 
@@ -89,6 +99,12 @@ struct rtmp_stream {
 	int min_priority;
 	float congestion;
 
+	size_t buffered_size;
+	struct deque dropped;
+	size_t dropped_size;
+	struct drop_decision drop_decisions[2];
+	size_t num_drop_decisions;
+
 	int64_t last_dts_usec;
 
 	uint64_t total_bytes_sent;
@@ -101,16 +117,7 @@ struct rtmp_stream {
 	size_t droptest_size;
 #endif
 
-	pthread_mutex_t dbr_mutex;
-	struct deque dbr_frames;
-	size_t dbr_data_size;
-	uint64_t dbr_inc_timeout;
-	long audio_bitrate;
-	long dbr_est_bitrate;
-	long dbr_orig_bitrate;
-	long dbr_prev_bitrate;
-	long dbr_cur_bitrate;
-	long dbr_inc_bitrate;
+	obs_bitrate_controller_t *dbr;
 	bool dbr_enabled;
 
 	enum audio_id_t audio_codec[MAX_OUTPUT_AUDIO_ENCODERS];
@@ -131,12 +138,20 @@ struct rtmp_stream {
 	os_event_t *buffer_has_data_event;
 	os_event_t *socket_available_event;
 	os_event_t *send_thread_signaled_exit;
+	volatile long write_latency_usec;
+#ifdef __linux__
+	int socket_wake_fd;
+#endif
 };
 
 #ifdef _WIN32
 void *socket_thread_windows(void *data);
+#elif defined(__linux__)
+void *socket_thread_linux(void *data);
 #endif
 
+bool rtmp_video_metadata_tag(obs_encoder_t *encoder, enum video_id_t codec, uint8_t **data, size_t *size, size_t idx);
+
 /* Adapted from FFmpeg's libavutil/pixfmt.h
  *
  * Renamed to make it apparent that these are not imported as this module does
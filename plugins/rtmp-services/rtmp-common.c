@@ -25,6 +25,7 @@ struct rtmp_common {
 	char **audio_codecs;
 
 	bool supports_additional_audio_track;
+	bool supports_cmaf_hls;
 };
 
 static const char *rtmp_common_getname(void *unused)
@@ -153,6 +154,7 @@ static void rtmp_common_update(void *data, obs_data_t *settings)
 	service->server = bstrdup(obs_data_get_string(settings, "server"));
 	service->key = bstrdup(obs_data_get_string(settings, "key"));
 	service->supports_additional_audio_track = false;
+	service->supports_cmaf_hls = false;
 	service->video_codecs = NULL;
 	service->audio_codecs = NULL;
 	service->supported_resolutions = NULL;
@@ -184,6 +186,7 @@ static void rtmp_common_update(void *data, obs_data_t *settings)
 
 			service->supports_additional_audio_track =
 				get_bool_val(serv, "supports_additional_audio_track");
+			service->supports_cmaf_hls = get_bool_val(serv, "supports_cmaf_hls");
 			ensure_valid_url(service, serv, settings);
 		}
 	}
@@ -1116,6 +1119,18 @@ static const char *rtmp_common_get_protocol(void *data)
 	return service->protocol ? service->protocol : "RTMP";
 }
 
+/* the fMP4 HLS output is only used for ingests known to accept CMAF segments,
+ * the others keep the MPEG-TS segments of the FFmpeg HLS muxer */
+static const char *rtmp_common_get_output_type(void *data)
+{
+	struct rtmp_common *service = data;
+
+	if (service->supports_cmaf_hls && strcmp(rtmp_common_get_protocol(data), "HLS") == 0)
+		return "hls_output";
+
+	return NULL;
+}
+
 static const char *rtmp_common_get_connect_info(void *data, uint32_t type)
 {
 	switch ((enum obs_service_connect_info)type) {
@@ -1165,6 +1180,7 @@ struct obs_service_info rtmp_common_service = {
 	.update = rtmp_common_update,
 	.get_properties = rtmp_common_properties,
 	.get_protocol = rtmp_common_get_protocol,
+	.get_output_type = rtmp_common_get_output_type,
 	.get_url = rtmp_common_url,
 	.get_key = rtmp_common_key,
 	.get_username = rtmp_common_username,
@@ -2212,6 +2212,7 @@ static obs_properties_t *game_capture_properties(void *data)
 			const char *mode = any ? SETTING_MODE_ANY : SETTING_MODE_WINDOW;
 
 			obs_data_set_string(settings, SETTING_MODE, mode);
+			obs_source_mark_changed(gc->source);
 		}
 		obs_data_release(settings);
 	}
@@ -1055,6 +1055,7 @@ void DShowInput::SetActive(bool active_)
 	obs_data_t *settings = obs_source_get_settings(source);
 	QueueAction(active_ ? Action::Activate : Action::Deactivate);
 	obs_data_set_bool(settings, "active", active_);
+	obs_source_mark_changed(source);
 	active = active_;
 	obs_data_release(settings);
 }
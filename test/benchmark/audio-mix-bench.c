@@ -0,0 +1,105 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <media-io/audio-io.h>
+#include <media-io/audio-mix.h>
+
+/*
+ * Mixes N stereo sources into every output mix at 48 kHz, the same work
+ * audio_callback() does on each audio tick, and compares the plain C loops
+ * with the kernels libobs selects for this CPU.  The clamp pass that the
+ * audio output thread runs afterwards is timed as well.
+ */
+
+#define SAMPLE_RATE 48000
+#define CHANNELS 2
+#define TICKS 2000
+
+static const size_t source_counts[] = {8, 40, 100};
+
+static float *alloc_samples(size_t count)
+{
+	float *samples = bmalloc(count * sizeof(float));
+	for (size_t i = 0; i < count; i++)
+		samples[i] = (float)rand() / (float)RAND_MAX - 0.5f;
+	return samples;
+}
+
+static void mix_plain(float *dst, const float *src, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		dst[i] += src[i];
+}
+
+static void clamp_plain(float *data, size_t count)
+{
+	for (size_t i = 0; i < count; i++) {
+		float val = data[i];
+		val = (val == val) ? val : 0.0f;
+		val = (val > 1.0f) ? 1.0f : val;
+		val = (val < -1.0f) ? -1.0f : val;
+		data[i] = val;
+	}
+}
+
+typedef void (*mix_func_t)(float *dst, const float *src, size_t count);
+typedef void (*clamp_func_t)(float *data, size_t count);
+
+static uint64_t run_ticks(size_t num_sources, float **sources, float **mixes, mix_func_t mix, clamp_func_t clamp)
+{
+	uint64_t start = os_gettime_ns();
+
+	for (int tick = 0; tick < TICKS; tick++) {
+		for (size_t m = 0; m < MAX_AUDIO_MIXES * CHANNELS; m++)
+			memset(mixes[m], 0, AUDIO_OUTPUT_FRAMES * sizeof(float));
+
+		for (size_t s = 0; s < num_sources; s++)
+			for (size_t m = 0; m < MAX_AUDIO_MIXES * CHANNELS; m++)
+				mix(mixes[m], sources[s] + (m % CHANNELS) * AUDIO_OUTPUT_FRAMES,
+				    AUDIO_OUTPUT_FRAMES);
+
+		for (size_t m = 0; m < MAX_AUDIO_MIXES * CHANNELS; m++)
+			clamp(mixes[m], AUDIO_OUTPUT_FRAMES);
+	}
+
+	return os_gettime_ns() - start;
+}
+
+static void report(const char *name, size_t num_sources, uint64_t elapsed_ns)
+{
+	double tick_us = (double)elapsed_ns / TICKS / 1000.0;
+	double budget_us = (double)AUDIO_OUTPUT_FRAMES * 1000000.0 / SAMPLE_RATE;
+
+	printf("%-8s %4zu sources %9.2f us/tick %6.2f%% of tick budget\n", name, num_sources, tick_us,
+	       tick_us * 100.0 / budget_us);
+}
+
+int main(void)
+{
+	float *mixes[MAX_AUDIO_MIXES * CHANNELS];
+
+	for (size_t m = 0; m < MAX_AUDIO_MIXES * CHANNELS; m++)
+		mixes[m] = alloc_samples(AUDIO_OUTPUT_FRAMES);
+
+	for (size_t i = 0; i < sizeof(source_counts) / sizeof(source_counts[0]); i++) {
+		size_t num_sources = source_counts[i];
+		float **sources = bmalloc(num_sources * sizeof(float *));
+
+		for (size_t s = 0; s < num_sources; s++)
+			sources[s] = alloc_samples(AUDIO_OUTPUT_FRAMES * CHANNELS);
+
+		report("plain", num_sources, run_ticks(num_sources, sources, mixes, mix_plain, clamp_plain));
+		report("libobs", num_sources, run_ticks(num_sources, sources, mixes, audio_mix_add, audio_mix_clamp));
+
+		for (size_t s = 0; s < num_sources; s++)
+			bfree(sources[s]);
+		bfree(sources);
+	}
+
+	for (size_t m = 0; m < MAX_AUDIO_MIXES * CHANNELS; m++)
+		bfree(mixes[m]);
+
+	return 0;
+}
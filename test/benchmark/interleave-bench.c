@@ -0,0 +1,182 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <util/bmem.h>
+#include <util/darray.h>
+#include <util/platform.h>
+#include <obs-interleave.h>
+
+/*
+ * Feeds synthetic encoder output through the output interleaver: 60 fps
+ * video on a number of encoder group tracks plus 48 kHz AAC on up to six
+ * audio tracks, each track delivered with its own encoder delay and a bit
+ * of jitter.  Packets are held back until a given amount is buffered, the
+ * way they pile up during startup and reconnects, then taken out one per
+ * packet added.  The sorted-array insertion outputs used before is timed
+ * against the per-track queues.
+ */
+
+#define VIDEO_FRAME_USEC 16667
+#define AUDIO_FRAME_USEC 21333
+#define SECONDS 120
+
+struct config {
+	size_t video_tracks;
+	size_t audio_tracks;
+	int64_t buffered_usec;
+};
+
+static const struct config configs[] = {
+	{1, 1, 500000},
+	{1, 6, 500000},
+	{3, 6, 500000},
+	{3, 6, 5000000},
+	{10, 6, 5000000},
+};
+
+/* generates every track's packets in the order encoders would hand them
+ * to the output */
+static void generate_packets(const struct config *cfg, struct encoder_packet **packets_out, size_t *count_out)
+{
+	DARRAY(struct encoder_packet) packets = {0};
+	int64_t arrival[OBS_INTERLEAVE_MAX_TRACKS];
+	int64_t next_dts[OBS_INTERLEAVE_MAX_TRACKS] = {0};
+	size_t num_tracks = cfg->video_tracks + cfg->audio_tracks;
+
+	for (size_t t = 0; t < num_tracks; t++)
+		arrival[t] = (int64_t)(rand() % 30000);
+
+	for (;;) {
+		size_t track = 0;
+
+		for (size_t t = 1; t < num_tracks; t++)
+			if (arrival[t] + next_dts[t] < arrival[track] + next_dts[track])
+				track = t;
+
+		if (next_dts[track] > SECONDS * 1000000LL)
+			break;
+
+		struct encoder_packet *packet = da_push_back_new(packets);
+		bool video = track < cfg->video_tracks;
+
+		packet->type = video ? OBS_ENCODER_VIDEO : OBS_ENCODER_AUDIO;
+		packet->track_idx = video ? track : track - cfg->video_tracks;
+		packet->dts_usec = next_dts[track];
+		packet->keyframe = video && next_dts[track] % 2000000 < VIDEO_FRAME_USEC;
+
+		next_dts[track] += video ? VIDEO_FRAME_USEC : AUDIO_FRAME_USEC;
+		arrival[track] += (int64_t)(rand() % 2000) - 1000;
+	}
+
+	*packets_out = packets.array;
+	*count_out = packets.num;
+}
+
+/* the sorted array outputs used to keep */
+struct plain_interleaver {
+	DARRAY(struct encoder_packet) packets;
+};
+
+static void plain_push(struct plain_interleaver *il, struct encoder_packet *out)
+{
+	size_t idx;
+	for (idx = 0; idx < il->packets.num; idx++) {
+		struct encoder_packet *cur_packet = il->packets.array + idx;
+
+		if (out->dts_usec == cur_packet->dts_usec && out->type == OBS_ENCODER_VIDEO &&
+		    cur_packet->type == OBS_ENCODER_VIDEO && out->track_idx > cur_packet->track_idx)
+			continue;
+
+		if (out->dts_usec == cur_packet->dts_usec && out->type == OBS_ENCODER_VIDEO) {
+			break;
+		} else if (out->dts_usec < cur_packet->dts_usec) {
+			break;
+		}
+	}
+
+	da_insert(il->packets, idx, out);
+}
+
+static inline void add_checksum(uint64_t *checksum, const struct encoder_packet *packet)
+{
+	*checksum = *checksum * 31 + (uint64_t)packet->dts_usec;
+}
+
+static void plain_pop(struct plain_interleaver *il, uint64_t *checksum)
+{
+	add_checksum(checksum, &il->packets.array[0]);
+	da_erase(il->packets, 0);
+}
+
+static uint64_t run_plain(struct encoder_packet *packets, size_t count, int64_t buffered_usec, uint64_t *checksum)
+{
+	struct plain_interleaver il = {0};
+	uint64_t start = os_gettime_ns();
+
+	for (size_t i = 0; i < count; i++) {
+		plain_push(&il, &packets[i]);
+
+		if (il.packets.array[il.packets.num - 1].dts_usec - il.packets.array[0].dts_usec > buffered_usec)
+			plain_pop(&il, checksum);
+	}
+	while (il.packets.num)
+		plain_pop(&il, checksum);
+
+	uint64_t elapsed = os_gettime_ns() - start;
+	da_free(il.packets);
+	return elapsed;
+}
+
+static uint64_t run_heap(struct encoder_packet *packets, size_t count, int64_t buffered_usec, uint64_t *checksum)
+{
+	struct obs_interleaver il = {0};
+	struct encoder_packet out;
+	int64_t newest = INT64_MIN;
+	uint64_t start = os_gettime_ns();
+
+	for (size_t i = 0; i < count; i++) {
+		obs_interleaver_push(&il, &packets[i]);
+
+		if (packets[i].dts_usec > newest)
+			newest = packets[i].dts_usec;
+
+		if (newest - obs_interleaver_peek(&il)->dts_usec > buffered_usec) {
+			obs_interleaver_pop(&il, &out);
+			add_checksum(checksum, &out);
+		}
+	}
+	while (obs_interleaver_pop(&il, &out))
+		add_checksum(checksum, &out);
+
+	uint64_t elapsed = os_gettime_ns() - start;
+	obs_interleaver_free(&il);
+	return elapsed;
+}
+
+static void report(const char *name, const struct config *cfg, size_t count, uint64_t elapsed_ns)
+{
+	printf("%-6s %2zu video %zu audio tracks, %5.1f s buffered: %9.1f ns/packet\n", name, cfg->video_tracks,
+	       cfg->audio_tracks, (double)cfg->buffered_usec / 1000000.0, (double)elapsed_ns / (double)count);
+}
+
+int main(void)
+{
+	for (size_t i = 0; i < sizeof(configs) / sizeof(configs[0]); i++) {
+		const struct config *cfg = &configs[i];
+		struct encoder_packet *packets;
+		size_t count;
+		uint64_t plain_sum = 0;
+		uint64_t heap_sum = 0;
+
+		generate_packets(cfg, &packets, &count);
+
+		report("plain", cfg, count, run_plain(packets, count, cfg->buffered_usec, &plain_sum));
+		report("heap", cfg, count, run_heap(packets, count, cfg->buffered_usec, &heap_sum));
+
+		if (plain_sum != heap_sum)
+			printf("interleaving order mismatch\n");
+
+		bfree(packets);
+	}
+
+	return 0;
+}
@@ -0,0 +1,211 @@
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/threading.h>
+#include <ffmpeg-mux.h>
+#include <ffmpeg-mux-shm.h>
+
+/*
+ * Sends the packet stream of a high bitrate recording to a reader thread
+ * the way obs-ffmpeg-mux.c hands it to the ffmpeg-mux helper: a
+ * ffm_packet_info header followed by the packet data for every packet,
+ * 60 fps video with a large keyframe every two seconds and two AAC tracks.
+ * The reader takes it apart with the same header-then-data reads the
+ * helper does.  The stdin pipe used before is timed against the shared
+ * memory ring.
+ */
+
+#define SECONDS 60
+#define FPS 60
+#define KEYINT (FPS * 2)
+#define AUDIO_TRACKS 2
+#define AUDIO_PACKETS_PER_SEC 47
+#define AUDIO_PACKET_SIZE 768
+#define RUNS 3
+
+static const size_t bitrates_mbps[] = {20, 100, 400};
+
+struct transport {
+	FILE *pipe_in;
+	FILE *pipe_out;
+	struct ffm_shm *shm_in;
+	struct ffm_shm *shm_out;
+};
+
+static uint8_t *packet_data;
+static size_t max_packet_size;
+
+static bool transport_write(struct transport *t, const void *data, size_t size)
+{
+	if (t->shm_in)
+		return ffm_shm_write(t->shm_in, data, size);
+	return fwrite(data, 1, size, t->pipe_in) == size;
+}
+
+static size_t transport_read(struct transport *t, void *vdata, size_t size)
+{
+	uint8_t *data = vdata;
+	size_t total = size;
+
+	if (t->shm_out)
+		return ffm_shm_read(t->shm_out, vdata, size);
+
+	while (size > 0) {
+		size_t in_size = fread(data, 1, size, t->pipe_out);
+		if (in_size == 0)
+			return 0;
+
+		size -= in_size;
+		data += in_size;
+	}
+
+	return total;
+}
+
+static void send_packet(struct transport *t, enum ffm_packet_type type, uint32_t index, uint32_t size, int64_t ts)
+{
+	struct ffm_packet_info info = {.pts = ts, .dts = ts, .size = size, .index = index, .type = type};
+
+	transport_write(t, &info, sizeof(info));
+	transport_write(t, packet_data, size);
+}
+
+static void *reader_thread(void *data)
+{
+	struct transport *t = data;
+	struct ffm_packet_info info;
+	uint8_t *buf = bmalloc(max_packet_size);
+
+	while (transport_read(t, &info, sizeof(info)) == sizeof(info)) {
+		if (transport_read(t, buf, info.size) != info.size)
+			break;
+	}
+
+	bfree(buf);
+	return NULL;
+}
+
+static uint64_t run(struct transport *t, size_t bitrate_mbps, size_t *packets, size_t *bytes)
+{
+	size_t frame_size = bitrate_mbps * 1000000 / 8 / FPS;
+	pthread_t reader;
+	uint64_t start;
+	int64_t audio_ts = 0;
+
+	*packets = 0;
+	*bytes = 0;
+
+	pthread_create(&reader, NULL, reader_thread, t);
+	start = os_gettime_ns();
+
+	for (int64_t frame = 0; frame < SECONDS * FPS; frame++) {
+		uint32_t size = (uint32_t)(frame % KEYINT == 0 ? frame_size * 8 : frame_size * 9 / 10);
+
+		send_packet(t, FFM_PACKET_VIDEO, 0, size, frame);
+		*packets += 1;
+		*bytes += size;
+
+		while (audio_ts < (frame + 1) * AUDIO_PACKETS_PER_SEC / FPS) {
+			for (uint32_t track = 0; track < AUDIO_TRACKS; track++) {
+				send_packet(t, FFM_PACKET_AUDIO, track, AUDIO_PACKET_SIZE, audio_ts);
+				*packets += 1;
+				*bytes += AUDIO_PACKET_SIZE;
+			}
+			audio_ts++;
+		}
+	}
+
+	/* end of input, then wait for the reader to drain it */
+	if (t->shm_in) {
+		ffm_shm_destroy(t->shm_in);
+		t->shm_in = NULL;
+	} else {
+		fclose(t->pipe_in);
+		t->pipe_in = NULL;
+	}
+	pthread_join(reader, NULL);
+
+	return os_gettime_ns() - start;
+}
+
+static bool open_pipe(struct transport *t)
+{
+	int fds[2];
+
+	if (pipe(fds) != 0)
+		return false;
+
+	t->pipe_out = fdopen(fds[0], "rb");
+	t->pipe_in = fdopen(fds[1], "wb");
+	return true;
+}
+
+static bool open_shm(struct transport *t)
+{
+	t->shm_in = ffm_shm_create();
+	if (!t->shm_in)
+		return false;
+
+	t->shm_out = ffm_shm_open(ffm_shm_path(t->shm_in));
+	return t->shm_out != NULL;
+}
+
+static void close_transport(struct transport *t)
+{
+	if (t->pipe_out)
+		fclose(t->pipe_out);
+	ffm_shm_destroy(t->shm_out);
+	memset(t, 0, sizeof(*t));
+}
+
+static void report(const char *name, size_t bitrate, size_t packets, size_t bytes, uint64_t elapsed_ns)
+{
+	double seconds = (double)elapsed_ns / 1000000000.0;
+
+	printf("%-5s %3zu Mbps: %8.1f MB/s, %7.1f ns/packet\n", name, bitrate, (double)bytes / 1048576.0 / seconds,
+	       (double)elapsed_ns / (double)packets);
+}
+
+int main(void)
+{
+	for (size_t i = 0; i < sizeof(bitrates_mbps) / sizeof(bitrates_mbps[0]); i++) {
+		size_t bitrate = bitrates_mbps[i];
+		uint64_t best_pipe = UINT64_MAX;
+		uint64_t best_shm = UINT64_MAX;
+		size_t packets, bytes;
+
+		max_packet_size = bitrate * 1000000 / 8 / FPS * 8;
+		packet_data = bzalloc(max_packet_size);
+
+		for (int r = 0; r < RUNS; r++) {
+			struct transport t = {0};
+			uint64_t elapsed;
+
+			if (open_pipe(&t)) {
+				elapsed = run(&t, bitrate, &packets, &bytes);
+				if (elapsed < best_pipe)
+					best_pipe = elapsed;
+			}
+			close_transport(&t);
+
+			if (open_shm(&t)) {
+				elapsed = run(&t, bitrate, &packets, &bytes);
+				if (elapsed < best_shm)
+					best_shm = elapsed;
+			} else {
+				printf("shared memory transport not available\n");
+			}
+			close_transport(&t);
+		}
+
+		report("pipe", bitrate, packets, bytes, best_pipe);
+		if (best_shm != UINT64_MAX)
+			report("shm", bitrate, packets, bytes, best_shm);
+
+		bfree(packet_data);
+	}
+
+	return 0;
+}
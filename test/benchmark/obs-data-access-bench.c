@@ -0,0 +1,162 @@
+#include <stdio.h>
+#include <string.h>
+#include <util/bmem.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <obs-data.h>
+
+/*
+ * Settings shaped like those of a text source: defaults for every property
+ * plus user values for some, with a nested font object.  An update callback
+ * reads all of them, an animation driven by a script or websocket sets a
+ * few values every frame, with the text changing length.  Both are timed
+ * for settings of different sizes, padded with extra properties the way
+ * larger plugins have them.
+ */
+
+#define ITERATIONS 200000
+#define RUNS 5
+
+static const size_t extra_counts[] = {0, 40, 200};
+
+static volatile long long sink;
+
+static obs_data_t *create_settings(size_t extra)
+{
+	obs_data_t *settings = obs_data_create();
+	obs_data_t *font = obs_data_create();
+	struct dstr name = {0};
+
+	obs_data_set_string(font, "face", "Arial");
+	obs_data_set_string(font, "style", "Regular");
+	obs_data_set_int(font, "size", 256);
+	obs_data_set_int(font, "flags", 0);
+	obs_data_set_default_obj(settings, "font", font);
+	obs_data_release(font);
+
+	obs_data_set_default_string(settings, "text", "");
+	obs_data_set_default_bool(settings, "read_from_file", false);
+	obs_data_set_default_string(settings, "file", "");
+	obs_data_set_default_bool(settings, "antialiasing", true);
+	obs_data_set_default_int(settings, "transform", 0);
+	obs_data_set_default_bool(settings, "vertical", false);
+	obs_data_set_default_int(settings, "color", 0xFFFFFFFF);
+	obs_data_set_default_double(settings, "opacity", 100.0);
+	obs_data_set_default_bool(settings, "gradient", false);
+	obs_data_set_default_int(settings, "gradient_color", 0xFFFFFFFF);
+	obs_data_set_default_double(settings, "gradient_dir", 90.0);
+	obs_data_set_default_int(settings, "bk_color", 0);
+	obs_data_set_default_int(settings, "bk_opacity", 0);
+	obs_data_set_default_string(settings, "align", "left");
+	obs_data_set_default_string(settings, "valign", "top");
+	obs_data_set_default_bool(settings, "outline", false);
+	obs_data_set_default_int(settings, "outline_size", 2);
+	obs_data_set_default_int(settings, "outline_color", 0xFF000000);
+	obs_data_set_default_bool(settings, "extents", false);
+	obs_data_set_default_int(settings, "extents_cx", 100);
+	obs_data_set_default_int(settings, "extents_cy", 100);
+
+	obs_data_set_string(settings, "text", "Now playing");
+	obs_data_set_int(settings, "color", 0xFF00FFFF);
+	obs_data_set_bool(settings, "outline", true);
+	obs_data_set_string(settings, "align", "center");
+
+	for (size_t i = 0; i < extra; i++) {
+		dstr_printf(&name, "extra_property_%zu", i);
+		obs_data_set_default_int(settings, name.array, (long long)i);
+		if (i % 3 == 0)
+			obs_data_set_int(settings, name.array, (long long)i * 2);
+	}
+
+	dstr_free(&name);
+	return settings;
+}
+
+/* what a typical update callback reads */
+static void update(obs_data_t *settings)
+{
+	obs_data_t *font = obs_data_get_obj(settings, "font");
+	long long val = 0;
+
+	val += (long long)strlen(obs_data_get_string(font, "face"));
+	val += obs_data_get_int(font, "size");
+	obs_data_release(font);
+
+	val += (long long)strlen(obs_data_get_string(settings, "text"));
+	val += obs_data_get_bool(settings, "read_from_file");
+	val += obs_data_get_bool(settings, "antialiasing");
+	val += obs_data_get_int(settings, "transform");
+	val += obs_data_get_bool(settings, "vertical");
+	val += obs_data_get_int(settings, "color");
+	val += (long long)obs_data_get_double(settings, "opacity");
+	val += obs_data_get_bool(settings, "gradient");
+	val += obs_data_get_int(settings, "gradient_color");
+	val += (long long)obs_data_get_double(settings, "gradient_dir");
+	val += obs_data_get_int(settings, "bk_color");
+	val += obs_data_get_int(settings, "bk_opacity");
+	val += (long long)strlen(obs_data_get_string(settings, "align"));
+	val += (long long)strlen(obs_data_get_string(settings, "valign"));
+	val += obs_data_get_bool(settings, "outline");
+	val += obs_data_get_int(settings, "outline_size");
+	val += obs_data_get_int(settings, "outline_color");
+	val += obs_data_get_bool(settings, "extents");
+	val += obs_data_get_int(settings, "extents_cx");
+	val += obs_data_get_int(settings, "extents_cy");
+
+	sink += val;
+}
+
+static const char *texts[] = {
+	"Now playing",
+	"Now playing: a song with a much longer title than the last one",
+	"Up next",
+	"Now playing: another track by another artist, live",
+};
+
+static void animate(obs_data_t *settings, size_t frame)
+{
+	obs_data_set_string(settings, "text", texts[frame % 4]);
+	obs_data_set_int(settings, "color", 0xFF000000 | (long long)(frame & 0xFFFFFF));
+	obs_data_set_double(settings, "opacity", (double)(frame % 100));
+	obs_data_set_int(settings, "extents_cx", (long long)(frame % 1920));
+}
+
+static uint64_t time_loop(obs_data_t *settings, void (*func)(obs_data_t *, size_t))
+{
+	uint64_t best = UINT64_MAX;
+
+	for (int r = 0; r < RUNS; r++) {
+		uint64_t start = os_gettime_ns();
+		for (size_t i = 0; i < ITERATIONS; i++)
+			func(settings, i);
+
+		uint64_t elapsed = os_gettime_ns() - start;
+		if (elapsed < best)
+			best = elapsed;
+	}
+
+	return best;
+}
+
+static void update_loop(obs_data_t *settings, size_t i)
+{
+	(void)i;
+	update(settings);
+}
+
+int main(void)
+{
+	for (size_t i = 0; i < sizeof(extra_counts) / sizeof(extra_counts[0]); i++) {
+		obs_data_t *settings = create_settings(extra_counts[i]);
+		uint64_t get_ns = time_loop(settings, update_loop);
+		uint64_t set_ns = time_loop(settings, animate);
+
+		printf("%3zu extra properties: update %7.1f ns (%5.1f ns/get), animate %7.1f ns (%5.1f ns/set)\n",
+		       extra_counts[i], (double)get_ns / ITERATIONS, (double)get_ns / ITERATIONS / 23.0,
+		       (double)set_ns / ITERATIONS, (double)set_ns / ITERATIONS / 4.0);
+
+		obs_data_release(settings);
+	}
+
+	return 0;
+}
@@ -0,0 +1,370 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <util/bmem.h>
+#include <util/dstr.h>
+#include <util/platform.h>
+#include <obs-data.h>
+
+#include <jansson.h>
+
+/*
+ * Builds scene collections the way the frontend saves them: a sources
+ * array with settings, filters and hotkeys per source, plus scenes with one
+ * item per source.  Loading and saving them through obs_data's streaming
+ * reader and writer is timed against the jansson tree round trip used
+ * before, which is reimplemented here with the public obs_data API.
+ */
+
+#define RUNS 5
+
+static const size_t source_counts[] = {100, 600, 2000};
+
+static void add_source(obs_data_array_t *sources, size_t idx)
+{
+	obs_data_t *source = obs_data_create();
+	obs_data_t *settings = obs_data_create();
+	obs_data_t *hotkeys = obs_data_create();
+	obs_data_array_t *filters = obs_data_array_create();
+	struct dstr str = {0};
+
+	dstr_printf(&str, "Source %zu", idx);
+	obs_data_set_string(source, "name", str.array);
+	dstr_printf(&str, "6f1c7a2e-0000-4000-8000-%012zu", idx);
+	obs_data_set_string(source, "uuid", str.array);
+	obs_data_set_string(source, "id", idx % 2 ? "image_source" : "ffmpeg_source");
+	obs_data_set_string(source, "versioned_id", idx % 2 ? "image_source" : "ffmpeg_source");
+	obs_data_set_int(source, "mixers", 255);
+	obs_data_set_int(source, "sync", 0);
+	obs_data_set_int(source, "flags", 0);
+	obs_data_set_double(source, "volume", 1.0);
+	obs_data_set_double(source, "balance", 0.5);
+	obs_data_set_bool(source, "enabled", true);
+	obs_data_set_bool(source, "muted", false);
+	obs_data_set_int(source, "monitoring_type", 0);
+	obs_data_set_obj(source, "private_settings", NULL);
+
+	dstr_printf(&str, "C:/Users/streamer/Videos/Overlays/clip_%zu.mp4", idx);
+	obs_data_set_string(settings, "local_file", str.array);
+	obs_data_set_bool(settings, "looping", true);
+	obs_data_set_bool(settings, "restart_on_activate", false);
+	obs_data_set_int(settings, "speed_percent", 100);
+	obs_data_set_double(settings, "opacity", 0.85);
+	obs_data_set_obj(source, "settings", settings);
+
+	for (size_t i = 0; i < 2; i++) {
+		obs_data_t *filter = obs_data_create();
+		obs_data_t *filter_settings = obs_data_create();
+
+		obs_data_set_string(filter, "name", i ? "Color Correction" : "Chroma Key");
+		obs_data_set_string(filter, "id", i ? "color_filter_v2" : "chroma_key_filter_v2");
+		obs_data_set_bool(filter, "enabled", true);
+		obs_data_set_double(filter_settings, "gamma", 0.12);
+		obs_data_set_double(filter_settings, "contrast", -0.05);
+		obs_data_set_int(filter_settings, "similarity", 420);
+		obs_data_set_obj(filter, "settings", filter_settings);
+		obs_data_array_push_back(filters, filter);
+
+		obs_data_release(filter_settings);
+		obs_data_release(filter);
+	}
+	obs_data_set_array(source, "filters", filters);
+
+	obs_data_t *hotkey = obs_data_create();
+	obs_data_array_t *bindings = obs_data_array_create();
+	obs_data_set_string(hotkey, "key", "OBS_KEY_F1");
+	obs_data_set_bool(hotkey, "control", true);
+	obs_data_array_push_back(bindings, hotkey);
+	obs_data_set_array(hotkeys, "libobs.mute", bindings);
+	obs_data_set_array(hotkeys, "libobs.unmute", bindings);
+	obs_data_set_obj(source, "hotkeys", hotkeys);
+
+	obs_data_array_push_back(sources, source);
+
+	obs_data_array_release(bindings);
+	obs_data_release(hotkey);
+	obs_data_array_release(filters);
+	obs_data_release(hotkeys);
+	obs_data_release(settings);
+	obs_data_release(source);
+	dstr_free(&str);
+}
+
+static void add_scene(obs_data_array_t *sources, size_t idx, size_t first, size_t count)
+{
+	obs_data_t *scene = obs_data_create();
+	obs_data_t *settings = obs_data_create();
+	obs_data_array_t *items = obs_data_array_create();
+	struct dstr str = {0};
+
+	for (size_t i = first; i < first + count; i++) {
+		obs_data_t *item = obs_data_create();
+		obs_data_t *pos = obs_data_create();
+
+		dstr_printf(&str, "Source %zu", i);
+		obs_data_set_string(item, "name", str.array);
+		dstr_printf(&str, "6f1c7a2e-0000-4000-8000-%012zu", i);
+		obs_data_set_string(item, "source_uuid", str.array);
+		obs_data_set_bool(item, "visible", true);
+		obs_data_set_bool(item, "locked", false);
+		obs_data_set_double(item, "rot", 0.0);
+		obs_data_set_double(pos, "x", (double)(i * 37 % 1920));
+		obs_data_set_double(pos, "y", (double)(i * 53 % 1080) + 0.5);
+		obs_data_set_obj(item, "pos", pos);
+		obs_data_set_obj(item, "scale", pos);
+		obs_data_set_int(item, "align", 5);
+		obs_data_set_int(item, "bounds_type", 0);
+		obs_data_set_int(item, "id", (long long)i + 1);
+		obs_data_array_push_back(items, item);
+
+		obs_data_release(pos);
+		obs_data_release(item);
+	}
+
+	dstr_printf(&str, "Scene %zu", idx);
+	obs_data_set_string(scene, "name", str.array);
+	obs_data_set_string(scene, "id", "scene");
+	obs_data_set_array(settings, "items", items);
+	obs_data_set_bool(settings, "custom_size", false);
+	obs_data_set_obj(scene, "settings", settings);
+	obs_data_array_push_back(sources, scene);
+
+	obs_data_array_release(items);
+	obs_data_release(settings);
+	obs_data_release(scene);
+	dstr_free(&str);
+}
+
+static obs_data_t *create_collection(size_t num_sources)
+{
+	obs_data_t *collection = obs_data_create();
+	obs_data_array_t *sources = obs_data_array_create();
+
+	for (size_t i = 0; i < num_sources; i++)
+		add_source(sources, i);
+	for (size_t i = 0; i < num_sources; i += 20)
+		add_scene(sources, i / 20, i, num_sources - i < 20 ? num_sources - i : 20);
+
+	obs_data_set_string(collection, "name", "Benchmark");
+	obs_data_set_string(collection, "current_scene", "Scene 0");
+	obs_data_set_array(collection, "sources", sources);
+	obs_data_array_release(sources);
+	return collection;
+}
+
+/* ------------------------------------------------------------------------- */
+/* jansson tree round trip */
+
+static void tree_add_item(obs_data_t *data, const char *key, json_t *json);
+
+static void tree_add_object_data(obs_data_t *data, json_t *jobj)
+{
+	const char *key;
+	json_t *jitem;
+
+	json_object_foreach (jobj, key, jitem) {
+		tree_add_item(data, key, jitem);
+	}
+}
+
+static void tree_add_item(obs_data_t *data, const char *key, json_t *json)
+{
+	if (json_is_object(json)) {
+		obs_data_t *obj = obs_data_create();
+		tree_add_object_data(obj, json);
+		obs_data_set_obj(data, key, obj);
+		obs_data_release(obj);
+
+	} else if (json_is_array(json)) {
+		obs_data_array_t *array = obs_data_array_create();
+		size_t idx;
+		json_t *jitem;
+
+		json_array_foreach (json, idx, jitem) {
+			if (!json_is_object(jitem))
+				continue;
+
+			obs_data_t *obj = obs_data_create();
+			tree_add_object_data(obj, jitem);
+			obs_data_array_push_back(array, obj);
+			obs_data_release(obj);
+		}
+
+		obs_data_set_array(data, key, array);
+		obs_data_array_release(array);
+
+	} else if (json_is_string(json)) {
+		obs_data_set_string(data, key, json_string_value(json));
+	} else if (json_is_integer(json)) {
+		obs_data_set_int(data, key, json_integer_value(json));
+	} else if (json_is_real(json)) {
+		obs_data_set_double(data, key, json_real_value(json));
+	} else if (json_is_boolean(json)) {
+		obs_data_set_bool(data, key, json_is_true(json));
+	} else if (json_is_null(json)) {
+		obs_data_set_obj(data, key, NULL);
+	}
+}
+
+static obs_data_t *tree_load(const char *text)
+{
+	json_t *root = json_loads(text, JSON_REJECT_DUPLICATES, NULL);
+	obs_data_t *data = obs_data_create();
+
+	tree_add_object_data(data, root);
+	json_decref(root);
+	return data;
+}
+
+static json_t *tree_from_data(obs_data_t *data)
+{
+	json_t *json;
+
+	if (!data)
+		return json_null();
+
+	json = json_object();
+
+	for (obs_data_item_t *item = obs_data_first(data); item; obs_data_item_next(&item)) {
+		const char *name = obs_data_item_get_name(item);
+		json_t *value = NULL;
+
+		if (!obs_data_item_has_user_value(item))
+			continue;
+
+		switch (obs_data_item_gettype(item)) {
+		case OBS_DATA_STRING:
+			value = json_string(obs_data_item_get_string(item));
+			break;
+		case OBS_DATA_NUMBER:
+			if (obs_data_item_numtype(item) == OBS_DATA_NUM_INT)
+				value = json_integer(obs_data_item_get_int(item));
+			else
+				value = json_real(obs_data_item_get_double(item));
+			break;
+		case OBS_DATA_BOOLEAN:
+			value = json_boolean(obs_data_item_get_bool(item));
+			break;
+		case OBS_DATA_OBJECT: {
+			obs_data_t *obj = obs_data_item_get_obj(item);
+			value = tree_from_data(obj);
+			obs_data_release(obj);
+			break;
+		}
+		case OBS_DATA_ARRAY: {
+			obs_data_array_t *array = obs_data_item_get_array(item);
+			value = json_array();
+			for (size_t i = 0; i < obs_data_array_count(array); i++) {
+				obs_data_t *obj = obs_data_array_item(array, i);
+				json_array_append_new(value, tree_from_data(obj));
+				obs_data_release(obj);
+			}
+			obs_data_array_release(array);
+			break;
+		}
+		case OBS_DATA_NULL:
+			break;
+		}
+
+		if (value)
+			json_object_set_new(json, name, value);
+	}
+
+	return json;
+}
+
+static size_t tree_save(obs_data_t *data, bool pretty)
+{
+	json_t *root = tree_from_data(data);
+	char *text = json_dumps(root, JSON_PRESERVE_ORDER | (pretty ? JSON_INDENT(4) : JSON_COMPACT));
+	size_t len = strlen(text);
+
+	free(text);
+	json_decref(root);
+	return len;
+}
+
+/* ------------------------------------------------------------------------- */
+
+struct timings {
+	uint64_t load;
+	uint64_t save;
+	uint64_t save_pretty;
+};
+
+static inline void keep_best(uint64_t *best, uint64_t start)
+{
+	uint64_t elapsed = os_gettime_ns() - start;
+	if (!*best || elapsed < *best)
+		*best = elapsed;
+}
+
+static void run_streaming(const char *text, struct timings *t)
+{
+	for (int r = 0; r < RUNS; r++) {
+		uint64_t start = os_gettime_ns();
+		obs_data_t *data = obs_data_create_from_json(text);
+		keep_best(&t->load, start);
+
+		start = os_gettime_ns();
+		obs_data_get_json(data);
+		keep_best(&t->save, start);
+
+		start = os_gettime_ns();
+		obs_data_get_json_pretty(data);
+		keep_best(&t->save_pretty, start);
+
+		obs_data_release(data);
+	}
+}
+
+static void run_tree(const char *text, struct timings *t)
+{
+	for (int r = 0; r < RUNS; r++) {
+		uint64_t start = os_gettime_ns();
+		obs_data_t *data = tree_load(text);
+		keep_best(&t->load, start);
+
+		start = os_gettime_ns();
+		tree_save(data, false);
+		keep_best(&t->save, start);
+
+		start = os_gettime_ns();
+		tree_save(data, true);
+		keep_best(&t->save_pretty, start);
+
+		obs_data_release(data);
+	}
+}
+
+static void report(const char *name, size_t bytes, const struct timings *t)
+{
+	double mb = (double)bytes / 1048576.0;
+
+	printf("%-9s load %8.2f ms (%6.1f MB/s), save %8.2f ms, save pretty %8.2f ms\n", name,
+	       (double)t->load / 1000000.0, mb / ((double)t->load / 1000000000.0), (double)t->save / 1000000.0,
+	       (double)t->save_pretty / 1000000.0);
+}
+
+int main(void)
+{
+	for (size_t i = 0; i < sizeof(source_counts) / sizeof(source_counts[0]); i++) {
+		obs_data_t *collection = create_collection(source_counts[i]);
+		char *text = bstrdup(obs_data_get_json_pretty(collection));
+		size_t bytes = strlen(text);
+		struct timings streaming = {0};
+		struct timings tree = {0};
+
+		obs_data_release(collection);
+
+		run_tree(text, &tree);
+		run_streaming(text, &streaming);
+
+		printf("%zu sources, %.1f KB:\n", source_counts[i], (double)bytes / 1024.0);
+		report("jansson", bytes, &tree);
+		report("streaming", bytes, &streaming);
+
+		bfree(text);
+	}
+
+	return 0;
+}
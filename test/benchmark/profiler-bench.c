@@ -0,0 +1,114 @@
+#include <stdio.h>
+#include <math.h>
+#include <util/bmem.h>
+#include <util/platform.h>
+#include <util/profiler.h>
+
+/*
+ * Runs a synthetic render loop shaped like obs_video_thread(): a root scope
+ * per frame with a tick and a render pass that each open a scope per source
+ * around a small amount of work.  The loop is timed once without profiler
+ * calls and once with them while the profiler is recording, and the
+ * difference is reported as the profiler's overhead.  Exits with an error if
+ * the overhead exceeds MAX_OVERHEAD_PERCENT of the frame time.
+ */
+
+#define FRAMES 2000
+#define SOURCES 24
+#define WORK_ITERATIONS 1000
+#define RUNS 5
+#define MAX_OVERHEAD_PERCENT 1.0
+
+static const char *frame_name = "obs_video_thread(bench)";
+static const char *tick_name = "tick_sources";
+static const char *render_name = "render_video";
+static const char *source_tick_name = "source_tick";
+static const char *source_render_name = "source_render";
+
+static volatile float sink;
+
+static void do_work(size_t source)
+{
+	float val = (float)source;
+	for (int i = 0; i < WORK_ITERATIONS; i++)
+		val = sqrtf(val * 1.0001f + (float)i);
+	sink = val;
+}
+
+static void frame_plain(void)
+{
+	for (size_t s = 0; s < SOURCES; s++)
+		do_work(s);
+	for (size_t s = 0; s < SOURCES; s++)
+		do_work(s);
+}
+
+static void frame_profiled(void)
+{
+	profile_start(frame_name);
+
+	profile_start(tick_name);
+	for (size_t s = 0; s < SOURCES; s++) {
+		profile_start(source_tick_name);
+		do_work(s);
+		profile_end(source_tick_name);
+	}
+	profile_end(tick_name);
+
+	profile_start(render_name);
+	for (size_t s = 0; s < SOURCES; s++) {
+		profile_start(source_render_name);
+		do_work(s);
+		profile_end(source_render_name);
+	}
+	profile_end(render_name);
+
+	profile_end(frame_name);
+}
+
+static void run_frames(void (*frame)(void), uint64_t *best)
+{
+	uint64_t start = os_gettime_ns();
+	for (int i = 0; i < FRAMES; i++)
+		frame();
+
+	uint64_t elapsed = os_gettime_ns() - start;
+	if (elapsed < *best)
+		*best = elapsed;
+}
+
+int main(void)
+{
+	const size_t scopes = 3 + SOURCES * 2;
+
+	profiler_start();
+	profile_register_root(frame_name, 0);
+
+	/* alternate the two loops so clock or load changes affect both */
+	uint64_t plain = UINT64_MAX;
+	uint64_t profiled = UINT64_MAX;
+	for (int run = 0; run < RUNS; run++) {
+		run_frames(frame_plain, &plain);
+		run_frames(frame_profiled, &profiled);
+	}
+
+	profiler_stop();
+
+	double frame_us = (double)plain / FRAMES / 1000.0;
+	double overhead = (double)profiled - (double)plain;
+	double overhead_percent = overhead * 100.0 / (double)plain;
+
+	printf("plain    %9.2f us/frame\n", frame_us);
+	printf("profiled %9.2f us/frame (%zu scopes)\n", (double)profiled / FRAMES / 1000.0, scopes);
+	printf("overhead %8.2f%% %9.1f ns/scope\n", overhead_percent, overhead / FRAMES / (double)scopes);
+
+	profiler_print(NULL);
+	profiler_free();
+
+	if (overhead_percent > MAX_OVERHEAD_PERCENT) {
+		fprintf(stderr, "profiler overhead %.2f%% exceeds %.2f%%\n", overhead_percent, MAX_OVERHEAD_PERCENT);
+		return 1;
+	}
+
+	return 0;
+}
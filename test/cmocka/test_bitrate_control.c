@@ -0,0 +1,171 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <obs.h>
+#include <util/darray.h>
+
+/*
+ * Drives a bitrate controller against a simulated link: an encoder produces
+ * 30 fps of video at the controller's bitrate plus a fixed amount of audio,
+ * the frames queue up in front of a shaper that drains them at the link's
+ * capacity, and the controller is fed the same send samples and queue
+ * durations an output would give it.  Runs in virtual time so the results
+ * don't depend on the machine.
+ */
+
+#define FPS 30
+#define STEP_NS 1000000ULL
+#define FRAME_NS (1000000000ULL / FPS)
+#define MAX_BITRATE 6000
+#define AUDIO_BITRATE 160
+
+struct sim_frame {
+	uint64_t dts;
+	size_t size;
+	size_t remaining;
+};
+
+struct sim_link {
+	DARRAY(struct sim_frame) queue;
+	uint64_t head_start;
+
+	/* stats for the last run */
+	uint64_t max_queue_ns;
+	long long bitrate_sum;
+	long frames;
+};
+
+static void link_drain(struct sim_link *link, obs_bitrate_controller_t *ctrl, uint64_t now, long capacity)
+{
+	size_t budget = (size_t)capacity * 1000 / 8 * STEP_NS / 1000000000ULL;
+
+	while (budget && link->queue.num) {
+		struct sim_frame *frame = &link->queue.array[0];
+		size_t sent = budget < frame->remaining ? budget : frame->remaining;
+
+		frame->remaining -= sent;
+		budget -= sent;
+
+		if (!frame->remaining) {
+			struct obs_bitrate_sample sample = {
+				.send_beg_ns = link->head_start,
+				.send_end_ns = now,
+				.size = frame->size,
+			};
+			obs_bitrate_controller_frame_sent(ctrl, &sample);
+
+			da_erase(link->queue, 0);
+			link->head_start = now;
+		}
+	}
+
+	if (!link->queue.num)
+		link->head_start = now;
+}
+
+static int64_t link_queue_usec(struct sim_link *link)
+{
+	/* outputs only start measuring once a few frames are waiting */
+	if (link->queue.num < 5)
+		return 0;
+
+	return (int64_t)(link->queue.array[link->queue.num - 1].dts - link->queue.array[0].dts) / 1000;
+}
+
+/* runs the link at the given capacity (kbps) for a number of seconds and
+ * returns the average video bitrate */
+static long run_link(struct sim_link *link, obs_bitrate_controller_t *ctrl, uint64_t *now, long capacity,
+		     int seconds)
+{
+	uint64_t end = *now + (uint64_t)seconds * 1000000000ULL;
+
+	link->max_queue_ns = 0;
+	link->bitrate_sum = 0;
+	link->frames = 0;
+
+	for (; *now < end; *now += STEP_NS) {
+		if (*now % FRAME_NS < STEP_NS) {
+			long bitrate = obs_bitrate_controller_get_bitrate(ctrl);
+			struct sim_frame *frame = da_push_back_new(link->queue);
+
+			frame->dts = *now;
+			frame->size = (size_t)(bitrate + AUDIO_BITRATE) * 1000 / 8 / FPS;
+			frame->remaining = frame->size;
+
+			obs_bitrate_controller_update(ctrl, *now, link_queue_usec(link));
+
+			link->bitrate_sum += bitrate;
+			link->frames++;
+		}
+
+		link_drain(link, ctrl, *now, capacity);
+
+		if (link->queue.num) {
+			uint64_t queued = *now - link->queue.array[0].dts;
+			if (queued > link->max_queue_ns)
+				link->max_queue_ns = queued;
+		}
+	}
+
+	return (long)(link->bitrate_sum / link->frames);
+}
+
+static void run_policy(const char *policy)
+{
+	obs_bitrate_controller_t *ctrl = obs_bitrate_controller_create(policy, MAX_BITRATE, AUDIO_BITRATE);
+	struct sim_link link = {0};
+	uint64_t now = 1000000000ULL;
+	long bitrate;
+
+	assert_non_null(ctrl);
+
+	/* plenty of headroom, nothing should change */
+	bitrate = run_link(&link, ctrl, &now, 8000, 10);
+	assert_int_equal(bitrate, MAX_BITRATE);
+
+	/* the link drops below the configured bitrate: once settled the
+	 * stream has to fit the link without giving up too much of it */
+	run_link(&link, ctrl, &now, 3000, 15);
+	bitrate = run_link(&link, ctrl, &now, 3000, 30);
+	assert_true(bitrate + AUDIO_BITRATE <= 3000);
+	assert_true(bitrate + AUDIO_BITRATE >= 3000 * 2 / 3);
+	assert_true(link.max_queue_ns < 2000000000ULL);
+
+	/* and recovers */
+	run_link(&link, ctrl, &now, 8000, 60);
+	assert_int_equal(obs_bitrate_controller_get_bitrate(ctrl), MAX_BITRATE);
+
+	da_free(link.queue);
+	obs_bitrate_controller_destroy(ctrl);
+}
+
+static void aimd_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+	run_policy(OBS_BITRATE_POLICY_AIMD);
+}
+
+static void delay_gradient_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+	run_policy(OBS_BITRATE_POLICY_DELAY_GRADIENT);
+}
+
+static void unknown_policy_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+	assert_null(obs_bitrate_controller_create("does_not_exist", MAX_BITRATE, AUDIO_BITRATE));
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(aimd_test),
+		cmocka_unit_test(delay_gradient_test),
+		cmocka_unit_test(unknown_policy_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
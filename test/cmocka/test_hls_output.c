@@ -0,0 +1,727 @@
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+/*
+ * Runs the HLS output and the CMAF muxer against a local HTTP server that
+ * stands in for an ingest.  Both sources are built into the test, with the
+ * calls they make into outputs, encoders and the video pipeline redirected to
+ * the stand-ins below, so no obs core is needed.  The output is fed a
+ * synthetic 30 fps H.264 stream with a keyframe every second.
+ */
+
+#define obs_output_get_name test_output_get_name
+#define obs_output_get_video_encoder test_output_get_video_encoder
+#define obs_output_get_video_encoder2 test_output_get_video_encoder2
+#define obs_output_get_audio_encoder test_output_get_audio_encoder
+#define obs_output_get_service test_output_get_service
+#define obs_output_get_settings test_output_get_settings
+#define obs_output_can_begin_data_capture test_output_can_begin_data_capture
+#define obs_output_initialize_encoders test_output_initialize_encoders
+#define obs_output_begin_data_capture test_output_begin_data_capture
+#define obs_output_end_data_capture test_output_end_data_capture
+#define obs_output_signal_stop test_output_signal_stop
+#define obs_service_get_connect_info test_service_get_connect_info
+#define obs_encoder_get_type test_encoder_get_type
+#define obs_encoder_get_ref test_encoder_get_ref
+#define obs_encoder_release test_encoder_release
+#define obs_encoder_get_codec test_encoder_get_codec
+#define obs_encoder_get_id test_encoder_get_id
+#define obs_encoder_get_name test_encoder_get_name
+#define obs_encoder_get_width test_encoder_get_width
+#define obs_encoder_get_height test_encoder_get_height
+#define obs_encoder_get_extra_data test_encoder_get_extra_data
+#define obs_encoder_get_settings test_encoder_get_settings
+#define obs_encoder_video test_encoder_video
+#define video_output_get_info test_video_output_get_info
+#define obs_queue_task test_queue_task
+
+#include "mp4-mux.c"
+#undef do_log
+#undef warn
+#undef info
+#include "hls-output.c"
+
+#ifdef _WIN32
+typedef SOCKET test_socket_t;
+#define close_socket closesocket
+#else
+typedef int test_socket_t;
+#define INVALID_SOCKET -1
+#define close_socket close
+#endif
+
+#define FPS 30
+#define FRAMES_PER_SEGMENT FPS
+#define WAIT_MS 10000
+
+/* ------------------------------------------------------------------------- */
+/* Output, service and encoder stand-ins                                     */
+
+static int dummy_output, dummy_service, dummy_encoder, dummy_video;
+
+#define TEST_OUTPUT ((obs_output_t *)&dummy_output)
+#define TEST_SERVICE ((obs_service_t *)&dummy_service)
+#define TEST_ENCODER ((obs_encoder_t *)&dummy_encoder)
+#define TEST_VIDEO ((video_t *)&dummy_video)
+
+static struct {
+	char url[128];
+	os_event_t *ended;
+	os_event_t *stopped;
+	volatile long stop_code;
+} test;
+
+/* SPS and PPS of a 720p High profile stream */
+static uint8_t avc_header[] = {0x00, 0x00, 0x00, 0x01, 0x67, 0x64, 0x00, 0x1f, 0xac, 0xd9, 0x40, 0x50, 0x05, 0xbb,
+			       0x01, 0x10, 0x00, 0x00, 0x03, 0x00, 0x10, 0x00, 0x00, 0x03, 0x03, 0xc0, 0xf1, 0x83,
+			       0x19, 0x60, 0x00, 0x00, 0x00, 0x01, 0x68, 0xeb, 0xe3, 0xcb, 0x22, 0xc0};
+static uint8_t idr_frame[] = {0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x84, 0x00, 0x33, 0xff, 0xfe, 0xf6, 0xf0, 0xfe};
+static uint8_t p_frame[] = {0x00, 0x00, 0x00, 0x01, 0x41, 0x9a, 0x24, 0x6c, 0x41, 0x0f, 0xfe};
+
+const char *obs_module_text(const char *val)
+{
+	return val;
+}
+
+const char *test_output_get_name(const obs_output_t *output)
+{
+	UNUSED_PARAMETER(output);
+	return "test";
+}
+
+obs_encoder_t *test_output_get_video_encoder(const obs_output_t *output)
+{
+	UNUSED_PARAMETER(output);
+	return TEST_ENCODER;
+}
+
+obs_encoder_t *test_output_get_video_encoder2(const obs_output_t *output, size_t idx)
+{
+	UNUSED_PARAMETER(output);
+	return idx == 0 ? TEST_ENCODER : NULL;
+}
+
+obs_encoder_t *test_output_get_audio_encoder(const obs_output_t *output, size_t idx)
+{
+	UNUSED_PARAMETER(output);
+	UNUSED_PARAMETER(idx);
+	return NULL;
+}
+
+obs_service_t *test_output_get_service(const obs_output_t *output)
+{
+	UNUSED_PARAMETER(output);
+	return TEST_SERVICE;
+}
+
+obs_data_t *test_output_get_settings(const obs_output_t *output)
+{
+	obs_data_t *settings = obs_data_create();
+	hls_output_defaults(settings);
+	UNUSED_PARAMETER(output);
+	return settings;
+}
+
+bool test_output_can_begin_data_capture(const obs_output_t *output, uint32_t flags)
+{
+	UNUSED_PARAMETER(output);
+	UNUSED_PARAMETER(flags);
+	return true;
+}
+
+bool test_output_initialize_encoders(obs_output_t *output, uint32_t flags)
+{
+	UNUSED_PARAMETER(output);
+	UNUSED_PARAMETER(flags);
+	return true;
+}
+
+bool test_output_begin_data_capture(obs_output_t *output, uint32_t flags)
+{
+	UNUSED_PARAMETER(output);
+	UNUSED_PARAMETER(flags);
+	return true;
+}
+
+void test_output_end_data_capture(obs_output_t *output)
+{
+	UNUSED_PARAMETER(output);
+	os_event_signal(test.ended);
+}
+
+void test_output_signal_stop(obs_output_t *output, int code)
+{
+	UNUSED_PARAMETER(output);
+	os_atomic_set_long(&test.stop_code, code);
+	os_event_signal(test.stopped);
+}
+
+const char *test_service_get_connect_info(const obs_service_t *service, uint32_t type)
+{
+	UNUSED_PARAMETER(service);
+	return type == OBS_SERVICE_CONNECT_INFO_SERVER_URL ? test.url : NULL;
+}
+
+enum obs_encoder_type test_encoder_get_type(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return OBS_ENCODER_VIDEO;
+}
+
+obs_encoder_t *test_encoder_get_ref(obs_encoder_t *encoder)
+{
+	return encoder;
+}
+
+void test_encoder_release(obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+}
+
+const char *test_encoder_get_codec(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return "h264";
+}
+
+const char *test_encoder_get_id(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return "test_h264";
+}
+
+const char *test_encoder_get_name(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return "test";
+}
+
+uint32_t test_encoder_get_width(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return 1280;
+}
+
+uint32_t test_encoder_get_height(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return 720;
+}
+
+bool test_encoder_get_extra_data(const obs_encoder_t *encoder, uint8_t **extra_data, size_t *size)
+{
+	UNUSED_PARAMETER(encoder);
+	*extra_data = avc_header;
+	*size = sizeof(avc_header);
+	return true;
+}
+
+obs_data_t *test_encoder_get_settings(const obs_encoder_t *encoder)
+{
+	obs_data_t *settings = obs_data_create();
+	obs_data_set_int(settings, "keyint_sec", FRAMES_PER_SEGMENT / FPS);
+	UNUSED_PARAMETER(encoder);
+	return settings;
+}
+
+video_t *test_encoder_video(const obs_encoder_t *encoder)
+{
+	UNUSED_PARAMETER(encoder);
+	return TEST_VIDEO;
+}
+
+const struct video_output_info *test_video_output_get_info(const video_t *video)
+{
+	static const struct video_output_info info = {
+		.name = "test",
+		.format = VIDEO_FORMAT_NV12,
+		.fps_num = FPS,
+		.fps_den = 1,
+		.width = 1280,
+		.height = 720,
+		.colorspace = VIDEO_CS_709,
+		.range = VIDEO_RANGE_PARTIAL,
+	};
+
+	UNUSED_PARAMETER(video);
+	return &info;
+}
+
+void test_queue_task(enum obs_task_type type, obs_task_t task, void *param, bool wait)
+{
+	UNUSED_PARAMETER(type);
+	UNUSED_PARAMETER(wait);
+	task(param);
+}
+
+/* ------------------------------------------------------------------------- */
+/* HTTP server standing in for the ingest                                    */
+
+struct http_request {
+	struct dstr method;
+	struct dstr path;
+	struct dstr content_type;
+	DARRAY(uint8_t) body;
+};
+
+struct http_server {
+	test_socket_t sock;
+	int port;
+	pthread_t thread;
+	volatile bool stop;
+
+	pthread_mutex_t mutex;
+	DARRAY(struct http_request) requests;
+	/* the next fail_next requests are answered with an error, every request
+	 * is while fail_all is set */
+	int fail_next;
+	bool fail_all;
+};
+
+static bool wait_readable(test_socket_t sock)
+{
+	struct timeval timeout = {0, 50000};
+	fd_set set;
+
+	FD_ZERO(&set);
+	FD_SET(sock, &set);
+	return select((int)sock + 1, &set, NULL, NULL, &timeout) > 0;
+}
+
+/* appends whatever arrived, returns false once the connection is closed */
+static bool receive(struct http_server *server, test_socket_t conn, struct darray *buf)
+{
+	char data[4096];
+	int len;
+
+	while (!wait_readable(conn)) {
+		if (os_atomic_load_bool(&server->stop))
+			return false;
+	}
+
+	len = (int)recv(conn, data, sizeof(data), 0);
+	if (len <= 0)
+		return false;
+
+	darray_push_back_array(sizeof(char), buf, data, (size_t)len);
+	return true;
+}
+
+static const char *find_header_end(const char *data, size_t size)
+{
+	for (size_t i = 0; i + 4 <= size; i++) {
+		if (memcmp(data + i, "\r\n\r\n", 4) == 0)
+			return data + i + 4;
+	}
+	return NULL;
+}
+
+static bool get_header(const char *headers, const char *name, struct dstr *value)
+{
+	size_t name_len = strlen(name);
+
+	for (const char *line = strstr(headers, "\r\n"); line; line = strstr(line, "\r\n")) {
+		line += 2;
+		if (astrcmpi_n(line, name, name_len) == 0 && line[name_len] == ':') {
+			const char *start = line + name_len + 1;
+			const char *end = strstr(start, "\r\n");
+
+			dstr_ncopy(value, start, end ? (size_t)(end - start) : strlen(start));
+			dstr_depad(value);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+static void send_text(test_socket_t conn, const char *text)
+{
+	send(conn, text, (int)strlen(text), 0);
+}
+
+static void serve_connection(struct http_server *server, test_socket_t conn)
+{
+	DARRAY(char) buf = {0};
+
+	for (;;) {
+		const char *body;
+
+		while (!(body = find_header_end(buf.array, buf.num))) {
+			if (!receive(server, conn, &buf.da))
+				goto done;
+		}
+
+		struct http_request request = {0};
+		struct dstr headers = {0};
+		struct dstr value = {0};
+		size_t header_size = (size_t)(body - buf.array);
+		size_t content_length = 0;
+		bool fail;
+
+		dstr_ncat(&headers, buf.array, header_size);
+		char *space = strchr(headers.array, ' ');
+		char *path_end = space ? strchr(space + 1, ' ') : NULL;
+		if (space && path_end) {
+			dstr_ncopy(&request.method, headers.array, space - headers.array);
+			dstr_ncopy(&request.path, space + 1, path_end - space - 1);
+		}
+		if (get_header(headers.array, "Content-Length", &value))
+			content_length = (size_t)strtoull(value.array, NULL, 10);
+		get_header(headers.array, "Content-Type", &request.content_type);
+
+		if (get_header(headers.array, "Expect", &value) && astrcmpi(value.array, "100-continue") == 0)
+			send_text(conn, "HTTP/1.1 100 Continue\r\n\r\n");
+
+		dstr_free(&headers);
+		dstr_free(&value);
+
+		while (buf.num < header_size + content_length) {
+			if (!receive(server, conn, &buf.da)) {
+				dstr_free(&request.method);
+				dstr_free(&request.path);
+				dstr_free(&request.content_type);
+				goto done;
+			}
+		}
+
+		da_push_back_array(request.body, (uint8_t *)buf.array + header_size, content_length);
+		da_erase_range(buf, 0, header_size + content_length);
+
+		pthread_mutex_lock(&server->mutex);
+		fail = server->fail_all || server->fail_next > 0;
+		if (server->fail_next > 0)
+			server->fail_next--;
+		da_push_back(server->requests, &request);
+		pthread_mutex_unlock(&server->mutex);
+
+		send_text(conn, fail ? "HTTP/1.1 503 Service Unavailable\r\nContent-Length: 0\r\n\r\n"
+				     : "HTTP/1.1 201 Created\r\nContent-Length: 0\r\n\r\n");
+	}
+
+done:
+	da_free(buf);
+	close_socket(conn);
+}
+
+static void *server_thread(void *data)
+{
+	struct http_server *server = data;
+
+	while (!os_atomic_load_bool(&server->stop)) {
+		if (!wait_readable(server->sock))
+			continue;
+
+		test_socket_t conn = accept(server->sock, NULL, NULL);
+		if (conn != INVALID_SOCKET)
+			serve_connection(server, conn);
+	}
+
+	return NULL;
+}
+
+static void server_start(struct http_server *server)
+{
+	struct sockaddr_in addr = {0};
+	socklen_t addr_len = sizeof(addr);
+
+	memset(server, 0, sizeof(*server));
+	pthread_mutex_init(&server->mutex, NULL);
+
+	server->sock = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+	assert_true(server->sock != INVALID_SOCKET);
+
+	addr.sin_family = AF_INET;
+	addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+	assert_int_equal(bind(server->sock, (struct sockaddr *)&addr, sizeof(addr)), 0);
+	assert_int_equal(listen(server->sock, 4), 0);
+	assert_int_equal(getsockname(server->sock, (struct sockaddr *)&addr, &addr_len), 0);
+	server->port = ntohs(addr.sin_port);
+
+	assert_int_equal(pthread_create(&server->thread, NULL, server_thread, server), 0);
+}
+
+static void server_stop(struct http_server *server)
+{
+	os_atomic_set_bool(&server->stop, true);
+	pthread_join(server->thread, NULL);
+	close_socket(server->sock);
+
+	for (size_t i = 0; i < server->requests.num; i++) {
+		struct http_request *request = &server->requests.array[i];
+		dstr_free(&request->method);
+		dstr_free(&request->path);
+		dstr_free(&request->content_type);
+		da_free(request->body);
+	}
+	da_free(server->requests);
+	pthread_mutex_destroy(&server->mutex);
+}
+
+static void server_set_failures(struct http_server *server, int fail_next, bool fail_all)
+{
+	pthread_mutex_lock(&server->mutex);
+	server->fail_next = fail_next;
+	server->fail_all = fail_all;
+	pthread_mutex_unlock(&server->mutex);
+}
+
+static size_t server_num_requests(struct http_server *server)
+{
+	pthread_mutex_lock(&server->mutex);
+	size_t num = server->requests.num;
+	pthread_mutex_unlock(&server->mutex);
+	return num;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Test helpers                                                              */
+
+static void test_init(struct http_server *server)
+{
+	server_start(server);
+	snprintf(test.url, sizeof(test.url), "http://127.0.0.1:%d/live/stream.m3u8", server->port);
+	os_event_init(&test.ended, OS_EVENT_TYPE_MANUAL);
+	os_event_init(&test.stopped, OS_EVENT_TYPE_MANUAL);
+	test.stop_code = 0;
+}
+
+static void test_free(struct http_server *server)
+{
+	server_stop(server);
+	os_event_destroy(test.ended);
+	os_event_destroy(test.stopped);
+}
+
+static void output_start(void *out)
+{
+	os_event_reset(test.ended);
+	os_event_reset(test.stopped);
+	os_atomic_set_long(&test.stop_code, 0);
+	assert_true(hls_output_info.start(out));
+}
+
+static void send_frame(void *out, int frame)
+{
+	struct encoder_packet packet = {0};
+	bool keyframe = frame % FRAMES_PER_SEGMENT == 0;
+
+	packet.type = OBS_ENCODER_VIDEO;
+	packet.encoder = TEST_ENCODER;
+	packet.timebase_num = 1;
+	packet.timebase_den = FPS;
+	packet.pts = frame;
+	packet.dts = frame;
+	packet.dts_usec = (int64_t)frame * 1000000 / FPS;
+	packet.sys_dts_usec = packet.dts_usec;
+	packet.keyframe = keyframe;
+	packet.data = keyframe ? idr_frame : p_frame;
+	packet.size = keyframe ? sizeof(idr_frame) : sizeof(p_frame);
+
+	hls_output_info.encoded_packet(out, &packet);
+}
+
+/* sends the frames before stop_frame and stops at it, the output ends data
+ * capture once everything has been uploaded */
+static void run_stream(void *out, int stop_frame)
+{
+	for (int frame = 0; frame < stop_frame; frame++)
+		send_frame(out, frame);
+
+	hls_output_info.stop(out, (uint64_t)stop_frame * 1000000000 / FPS);
+	send_frame(out, stop_frame);
+
+	assert_int_equal(os_event_timedwait(test.ended, WAIT_MS), 0);
+	assert_int_equal(os_event_try(test.stopped), EAGAIN);
+}
+
+static bool has_box(const struct http_request *request, const char *type)
+{
+	for (size_t i = 0; i + 8 <= request->body.num; i++) {
+		if (memcmp(request->body.array + i + 4, type, 4) == 0)
+			return true;
+	}
+	return false;
+}
+
+static bool body_contains(const struct http_request *request, const char *text)
+{
+	struct dstr body = {0};
+	dstr_ncat(&body, (const char *)request->body.array, request->body.num);
+	bool found = body.array && strstr(body.array, text) != NULL;
+	dstr_free(&body);
+	return found;
+}
+
+/* checks the requests of one stream from first on and returns the index
+ * after its final playlist */
+static size_t check_stream(struct http_server *server, size_t first, size_t segments)
+{
+	struct http_request *requests = server->requests.array;
+	size_t idx = first;
+	struct dstr path = {0};
+
+	assert_true(server->requests.num >= first + 1 + segments * 2);
+
+	/* the init segment comes first */
+	assert_string_equal(requests[idx].method.array, "PUT");
+	assert_string_equal(requests[idx].path.array, "/live/stream_init.mp4");
+	assert_string_equal(requests[idx].content_type.array, "video/mp4");
+	assert_true(memcmp(requests[idx].body.array + 4, "ftyp", 4) == 0);
+	assert_true(has_box(&requests[idx], "moov"));
+	assert_false(has_box(&requests[idx], "moof"));
+	idx++;
+
+	/* every segment is followed by the playlist that lists it */
+	for (size_t i = 0; i < segments; i++, idx += 2) {
+		dstr_printf(&path, "/live/stream_%zu.m4s", i);
+		assert_string_equal(requests[idx].path.array, path.array);
+		assert_string_equal(requests[idx].content_type.array, "video/mp4");
+		assert_true(memcmp(requests[idx].body.array + 4, "moof", 4) == 0);
+		assert_true(has_box(&requests[idx], "mdat"));
+
+		dstr_printf(&path, "stream_%zu.m4s\n", i);
+		assert_string_equal(requests[idx + 1].path.array, "/live/stream.m3u8");
+		assert_string_equal(requests[idx + 1].content_type.array, "application/vnd.apple.mpegurl");
+		assert_true(body_contains(&requests[idx + 1], "#EXT-X-MAP:URI=\"stream_init.mp4\"\n"));
+		assert_true(body_contains(&requests[idx + 1], "#EXT-X-MEDIA-SEQUENCE:0\n"));
+		assert_true(body_contains(&requests[idx + 1], path.array));
+		assert_true(body_contains(&requests[idx + 1], "#EXT-X-ENDLIST") == (i + 1 == segments));
+	}
+
+	dstr_free(&path);
+	return idx;
+}
+
+/* ------------------------------------------------------------------------- */
+/* Tests                                                                     */
+
+static void upload_test(void **state)
+{
+	struct http_server server;
+	void *out;
+
+	test_init(&server);
+	out = hls_output_info.create(NULL, TEST_OUTPUT);
+
+	output_start(out);
+	run_stream(out, FRAMES_PER_SEGMENT * 3);
+	assert_int_equal(check_stream(&server, 0, 3), server.requests.num);
+
+	hls_output_info.destroy(out);
+	test_free(&server);
+	UNUSED_PARAMETER(state);
+}
+
+static void retry_test(void **state)
+{
+	struct http_server server;
+	void *out;
+
+	test_init(&server);
+	out = hls_output_info.create(NULL, TEST_OUTPUT);
+
+	/* a failed upload is tried again rather than lost */
+	server_set_failures(&server, UPLOAD_ATTEMPTS - 1, false);
+	output_start(out);
+	run_stream(out, FRAMES_PER_SEGMENT * 2);
+
+	for (size_t i = 0; i < UPLOAD_ATTEMPTS; i++)
+		assert_string_equal(server.requests.array[i].path.array, "/live/stream_init.mp4");
+	assert_int_equal(check_stream(&server, UPLOAD_ATTEMPTS - 1, 2), server.requests.num);
+
+	hls_output_info.destroy(out);
+	test_free(&server);
+	UNUSED_PARAMETER(state);
+}
+
+static void restart_test(void **state)
+{
+	struct http_server server;
+	size_t idx;
+	void *out;
+
+	test_init(&server);
+	out = hls_output_info.create(NULL, TEST_OUTPUT);
+
+	/* a new run starts over with a new init segment and sequence 0 */
+	output_start(out);
+	run_stream(out, FRAMES_PER_SEGMENT * 2);
+	idx = check_stream(&server, 0, 2);
+
+	output_start(out);
+	run_stream(out, FRAMES_PER_SEGMENT * 2);
+	assert_int_equal(check_stream(&server, idx, 2), server.requests.num);
+
+	hls_output_info.destroy(out);
+	test_free(&server);
+	UNUSED_PARAMETER(state);
+}
+
+static void failure_test(void **state)
+{
+	struct http_server server;
+	size_t idx;
+	void *out;
+
+	test_init(&server);
+	out = hls_output_info.create(NULL, TEST_OUTPUT);
+
+	/* uploads that keep failing stop the output as disconnected */
+	server_set_failures(&server, 0, true);
+	output_start(out);
+	for (int frame = 0; frame < FRAMES_PER_SEGMENT * 3; frame++)
+		send_frame(out, frame);
+
+	assert_int_equal(os_event_timedwait(test.stopped, WAIT_MS), 0);
+	assert_int_equal(os_atomic_load_long(&test.stop_code), OBS_OUTPUT_DISCONNECTED);
+	assert_int_equal(server_num_requests(&server), UPLOAD_ATTEMPTS * MAX_UPLOAD_FAILURES);
+	assert_int_equal(os_event_try(test.ended), EAGAIN);
+
+	/* and the output can be started again once the ingest is back */
+	server_set_failures(&server, 0, false);
+	idx = server_num_requests(&server);
+
+	output_start(out);
+	run_stream(out, FRAMES_PER_SEGMENT * 2);
+	assert_int_equal(check_stream(&server, idx, 2), server.requests.num);
+
+	hls_output_info.destroy(out);
+	test_free(&server);
+	UNUSED_PARAMETER(state);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(upload_test),
+		cmocka_unit_test(retry_test),
+		cmocka_unit_test(restart_test),
+		cmocka_unit_test(failure_test),
+	};
+
+#ifdef _WIN32
+	WSADATA wsa_data;
+	WSAStartup(MAKEWORD(2, 2), &wsa_data);
+#endif
+
+	int ret = cmocka_run_group_tests(tests, NULL, NULL);
+
+#ifdef _WIN32
+	WSACleanup();
+#endif
+	return ret;
+}
@@ -0,0 +1,225 @@
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <math.h>
+#include <obs.h>
+
+static void assert_round_trip(const char *json)
+{
+	obs_data_t *data = obs_data_create_from_json(json);
+	assert_non_null(data);
+	assert_string_equal(obs_data_get_json(data), json);
+	obs_data_release(data);
+}
+
+static void read_types_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	obs_data_t *data = obs_data_create_from_json(" {\"str\": \"a\\\"b\\u00e9\\ud83d\\ude00\", \"int\": -42, "
+						     "\"real\": 2.5e3, \"yes\": true, \"no\": false, \"none\": null,\n"
+						     "\"obj\": {\"x\": 1}, \"arr\": [{\"y\": 2}, 3, [], {}]} ");
+	assert_non_null(data);
+
+	assert_string_equal(obs_data_get_string(data, "str"), "a\"b\xc3\xa9\xf0\x9f\x98\x80");
+	assert_int_equal(obs_data_get_int(data, "int"), -42);
+	assert_true(obs_data_get_double(data, "real") == 2500.0);
+	assert_true(obs_data_get_bool(data, "yes"));
+	assert_false(obs_data_get_bool(data, "no"));
+	assert_true(obs_data_has_user_value(data, "none"));
+	assert_null(obs_data_get_obj(data, "none"));
+
+	obs_data_t *obj = obs_data_get_obj(data, "obj");
+	assert_int_equal(obs_data_get_int(obj, "x"), 1);
+	obs_data_release(obj);
+
+	/* items that aren't objects can't be represented and are skipped */
+	obs_data_array_t *array = obs_data_get_array(data, "arr");
+	assert_int_equal(obs_data_array_count(array), 2);
+	obj = obs_data_array_item(array, 0);
+	assert_int_equal(obs_data_get_int(obj, "y"), 2);
+	obs_data_release(obj);
+	obs_data_array_release(array);
+
+	obs_data_release(data);
+}
+
+static void write_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	assert_round_trip("{}");
+	assert_round_trip("{\"b\":1,\"a\":[],\"c\":{\"d\":null}}");
+	assert_round_trip("{\"s\":\"q\\\"\\\\/\\b\\f\\n\\r\\t\\u0001\\u001F\xc3\xa9\"}");
+	assert_round_trip("{\"min\":-9223372036854775808,\"max\":9223372036854775807}");
+	assert_round_trip("{\"a\":1.0,\"b\":-0.5,\"c\":1e20,\"d\":0.25}");
+
+	obs_data_t *data = obs_data_create();
+	obs_data_t *obj = obs_data_create();
+	obs_data_array_t *array = obs_data_array_create();
+
+	obs_data_set_int(obj, "x", 1);
+	obs_data_array_push_back(array, obj);
+	obs_data_array_push_back(array, obj);
+	obs_data_set_string(data, "name", "test");
+	obs_data_set_array(data, "items", array);
+	obs_data_set_obj(data, "empty", NULL);
+	obs_data_set_default_int(data, "default", 5);
+
+	assert_string_equal(obs_data_get_json_pretty(data), "{\n"
+							    "    \"name\": \"test\",\n"
+							    "    \"items\": [\n"
+							    "        {\n"
+							    "            \"x\": 1\n"
+							    "        },\n"
+							    "        {\n"
+							    "            \"x\": 1\n"
+							    "        }\n"
+							    "    ],\n"
+							    "    \"empty\": null\n"
+							    "}");
+	assert_string_equal(obs_data_get_json_with_defaults(data),
+			    "{\"name\":\"test\",\"items\":[{\"x\":1},{\"x\":1}],\"empty\":null,\"default\":5}");
+
+	/* like with jansson, values that aren't valid json are left out */
+	obs_data_set_string(data, "name", "\xff");
+	obs_data_set_double(data, "nan", NAN);
+	assert_string_equal(obs_data_get_json(data), "{\"items\":[{\"x\":1},{\"x\":1}],\"empty\":null}");
+
+	obs_data_array_release(array);
+	obs_data_release(obj);
+	obs_data_release(data);
+}
+
+static void values_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	obs_data_t *data = obs_data_create();
+	obs_data_t *obj = obs_data_create();
+
+	obs_data_set_string(data, "a", "short");
+	obs_data_set_int(data, "b", 1);
+
+	/* values changing size don't move the item */
+	obs_data_item_t *item = obs_data_item_byname(data, "a");
+	obs_data_set_string(data, "a", "a string that's too long to be stored in the item itself");
+	obs_data_set_string(data, "a", obs_data_get_string(data, "a"));
+	assert_ptr_equal(obs_data_item_byname(data, "a"), item);
+	obs_data_item_release(&item);
+	obs_data_item_release(&item);
+	assert_string_equal(obs_data_get_json(data),
+			    "{\"a\":\"a string that's too long to be stored in the item itself\",\"b\":1}");
+
+	/* defaults are used without a user value */
+	obs_data_set_default_string(data, "c", "default");
+	obs_data_set_autoselect_string(data, "c", "autoselect");
+	assert_string_equal(obs_data_get_string(data, "c"), "default");
+	obs_data_set_string(data, "c", "user");
+	obs_data_unset_default_value(data, "c");
+	assert_string_equal(obs_data_get_string(data, "c"), "user");
+	assert_string_equal(obs_data_get_autoselect_string(data, "c"), "autoselect");
+
+	/* objects set as default on an existing item keep a reference */
+	obs_data_set_default_obj(data, "d", NULL);
+	obs_data_set_default_obj(data, "d", obj);
+	obs_data_set_default_obj(data, "d", obj);
+	obs_data_release(data);
+
+	obs_data_set_int(obj, "x", 1);
+	assert_int_equal(obs_data_get_int(obj, "x"), 1);
+	obs_data_release(obj);
+}
+
+static void reject_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	static const char *invalid[] = {
+		"",
+		"1",
+		"{\"a\":1,}",
+		"{\"a\" 1}",
+		"{\"a\":01}",
+		"{\"a\":1.}",
+		"{\"a\":NaN}",
+		"{\"a\":tru}",
+		"{\"a\":1,\"a\":2}",
+		"{\"a\":\"\\u0000\"}",
+		"{\"a\":\"\\ud800\"}",
+		"{\"a\":\"\t\"}",
+		"{\"a\":\"\xc0\xaf\"}",
+		"{\"a\":99999999999999999999}",
+		"{\"a\":1e400}",
+		"{\"a\":[1,2}",
+		"{\"a\":\"b\"",
+		"{} {}",
+	};
+
+	for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++)
+		assert_null(obs_data_create_from_json(invalid[i]));
+}
+
+static void binary_test(void **state)
+{
+	UNUSED_PARAMETER(state);
+
+	const char *json = "{\"name\":\"test\",\"int\":-9223372036854775808,\"real\":0.5,\"yes\":true,"
+			   "\"none\":null,\"items\":[{\"name\":\"a\"},{\"name\":\"b\",\"sub\":{}}],\"empty\":[]}";
+	obs_data_t *data = obs_data_create_from_json(json);
+	size_t size;
+
+	obs_data_set_default_int(data, "default", 5);
+
+	uint8_t *bin = obs_data_get_binary(data, &size);
+	assert_non_null(bin);
+	assert_int_equal(bin[0], 0x89);
+
+	obs_data_t *copy = obs_data_create_from_binary(bin, size);
+	assert_non_null(copy);
+	assert_string_equal(obs_data_get_json(copy), json);
+	assert_false(obs_data_has_user_value(copy, "default"));
+	obs_data_release(copy);
+
+	/* a string is never read as binary, it has no known size */
+	assert_null(obs_data_create_from_json("\x89OBD"));
+
+	/* unlike JSON, any string and double survives */
+	obs_data_set_string(data, "name", "\xff");
+	obs_data_set_double(data, "real", INFINITY);
+	bfree(bin);
+	bin = obs_data_get_binary(data, &size);
+	copy = obs_data_create_from_binary(bin, size);
+	assert_string_equal(obs_data_get_string(copy, "name"), "\xff");
+	assert_true(isinf(obs_data_get_double(copy, "real")));
+	obs_data_release(copy);
+
+	/* truncated or corrupted data is rejected */
+	for (size_t i = 0; i < size; i++)
+		assert_null(obs_data_create_from_binary(bin, i));
+	for (size_t i = 0; i < size; i++) {
+		bin[i] ^= 0xff;
+		copy = obs_data_create_from_binary(bin, size);
+		if (copy)
+			obs_data_release(copy);
+		bin[i] ^= 0xff;
+	}
+
+	bfree(bin);
+	obs_data_release(data);
+}
+
+int main()
+{
+	const struct CMUnitTest tests[] = {
+		cmocka_unit_test(read_types_test),
+		cmocka_unit_test(write_test),
+		cmocka_unit_test(values_test),
+		cmocka_unit_test(reject_test),
+		cmocka_unit_test(binary_test),
+	};
+
+	return cmocka_run_group_tests(tests, NULL, NULL);
+}
@@ -0,0 +1,127 @@
+/******************************************************************************
+    Copyright (C) 2026 Uniflow, Inc.
+    Author: Kim Taehyung <gaiaengine@gmail.com>
+
+    This program is free software: you can redistribute it and/or modify
+    it under the terms of the GNU General Public License as published by
+    the Free Software Foundation, either version 2 of the License, or
+    (at your option) any later version.
+
+    This program is distributed in the hope that it will be useful,
+    but WITHOUT ANY WARRANTY; without even the implied warranty of
+    MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+    GNU General Public License for more details.
+
+    You should have received a copy of the GNU General Public License
+    along with this program.  If not, see <http://www.gnu.org/licenses/>.
+******************************************************************************/
+
+#include <utility/SavedSourceCache.hpp>
+
+#include <stdio.h>
+
+static bool expect(bool condition, const char *message)
+{
+	if (!condition)
+		fprintf(stderr, "saved-source-cache-test: %s\n", message);
+
+	return condition;
+}
+
+static obs_data_t *createSource(const char *name, long long value)
+{
+	obs_data_t *source = obs_data_create();
+	obs_data_t *settings = obs_data_create();
+
+	obs_data_set_string(source, "name", name);
+	obs_data_set_int(settings, "value", value);
+	obs_data_set_obj(source, "settings", settings);
+
+	obs_data_release(settings);
+	return source;
+}
+
+int main()
+{
+	bool ok = true;
+	OBS::SavedSourceCache cache;
+	int saves = 0;
+
+	auto saveA = [&saves]() {
+		saves++;
+		return createSource("a", 1);
+	};
+	auto saveB = [&saves]() {
+		saves++;
+		return createSource("b", 2);
+	};
+
+	cache.BeginSave();
+	const std::string *a = &cache.Get("a", {1}, saveA);
+	const std::string *b = &cache.Get("b", {1, 5}, saveB);
+	cache.EndSave();
+	ok &= expect(saves == 2, "first save must format every source");
+
+	std::string first = OBS::SavedSourceCache::MakeArray({a, b});
+
+	cache.BeginSave();
+	a = &cache.Get("a", {1}, saveA);
+	b = &cache.Get("b", {1, 5}, saveB);
+	cache.EndSave();
+	ok &= expect(saves == 2, "unchanged sources must not be formatted again");
+	ok &= expect(OBS::SavedSourceCache::MakeArray({a, b}) == first, "reused JSON must match");
+
+	cache.BeginSave();
+	cache.Get("a", {1}, saveA);
+	cache.Get("b", {2, 5}, saveB);
+	cache.EndSave();
+	ok &= expect(saves == 3, "only the changed source must be formatted again");
+
+	cache.BeginSave();
+	cache.Get("a", {1}, saveA);
+	cache.EndSave();
+	cache.BeginSave();
+	cache.Get("b", {2, 5}, saveB);
+	cache.EndSave();
+	ok &= expect(saves == 4, "sources left out of a save must be dropped");
+
+	// The composed document must match formatting the whole tree
+	obs_data_t *document = obs_data_create();
+	obs_data_array_t *sources = obs_data_array_create();
+	obs_data_array_t *groups = obs_data_array_create();
+	obs_data_t *sourceA = createSource("a", 1);
+	obs_data_t *sourceB = createSource("b", 2);
+
+	obs_data_set_string(document, "name", "collection");
+	std::string json = obs_data_get_json_pretty(document);
+
+	obs_data_array_push_back(sources, sourceA);
+	obs_data_array_push_back(sources, sourceB);
+	obs_data_set_array(document, "sources", sources);
+	obs_data_set_array(document, "groups", groups);
+
+	cache.Clear();
+	a = &cache.Get("a", {1}, saveA);
+	b = &cache.Get("b", {1}, saveB);
+
+	ok &= expect(OBS::SavedSourceCache::AppendMember(json, "sources", OBS::SavedSourceCache::MakeArray({a, b})),
+		     "sources must be added");
+	ok &= expect(OBS::SavedSourceCache::AppendMember(json, "groups", OBS::SavedSourceCache::MakeArray({})),
+		     "groups must be added");
+	ok &= expect(json == obs_data_get_json_pretty(document), "composed document must match obs_data output");
+
+	std::string empty = "{}";
+	ok &= expect(OBS::SavedSourceCache::AppendMember(empty, "groups", "[]"), "empty object must be extended");
+	ok &= expect(empty == "{\n    \"groups\": []\n}", "empty object must be formatted like obs_data");
+
+	std::string invalid = "{\"name\":1}";
+	ok &= expect(!OBS::SavedSourceCache::AppendMember(invalid, "groups", "[]"), "compact JSON must be rejected");
+
+	obs_data_release(sourceA);
+	obs_data_release(sourceB);
+	obs_data_array_release(sources);
+	obs_data_array_release(groups);
+	obs_data_release(document);
+
+	return ok ? 0 : 1;
+}
@@ -67,9 +67,36 @@ int main()
 	model.SetStage(OBS::StartupProgressStage::ServiceInitialized);
 	ok &= expect(model.Percent() == 90, "ServiceInitialized should map to 90%");
 
+	model.SetSourceProgress(OBS::StartupSourcePhase::Create, 0, 10, 0);
+	ok &= expect(model.Stage() == OBS::StartupProgressStage::SceneCollectionLoading,
+		     "source progress should enter SceneCollectionLoading");
+	ok &= expect(model.Percent() == 90, "SceneCollectionLoading should start at 90%");
+
+	model.SetSourceProgress(OBS::StartupSourcePhase::Create, 10, 10, 2000000);
+	ok &= expect(model.PercentPrecise() == 93.5, "created sources should complete half of the scene slice");
+	ok &= expect(model.SourcePhaseDurationNs(OBS::StartupSourcePhase::Create) == 2000000,
+		     "create phase duration should be recorded");
+
+	model.SetSourceProgress(OBS::StartupSourcePhase::Load, 5, 10, 1000000);
+	ok &= expect(model.PercentPrecise() > 93.5 && model.PercentPrecise() < 97.0,
+		     "load phase should advance the second half of the scene slice");
+	ok &= expect(model.ProcessedSources() == 5 && model.TotalSources() == 10, "source counts should update");
+	ok &= expect(model.SourcePhaseDurationNs(OBS::StartupSourcePhase::Load) == 1000000,
+		     "load phase duration should be recorded");
+	ok &= expect(model.SourcePhaseDurationNs(OBS::StartupSourcePhase::Create) == 2000000,
+		     "load progress must not overwrite create phase duration");
+
+	model.SetSourceProgress(OBS::StartupSourcePhase::Load, 10, 10, 3000000);
+	ok &= expect(model.Percent() == 97, "loaded sources should complete the scene slice");
+
 	model.SetStage(OBS::StartupProgressStage::SceneCollectionLoaded);
 	ok &= expect(model.Percent() == 97, "SceneCollectionLoaded should map to 97%");
 
+	model.SetSourceProgress(OBS::StartupSourcePhase::Create, 0, 10, 0);
+	ok &= expect(model.Stage() == OBS::StartupProgressStage::SceneCollectionLoaded,
+		     "source progress must not move the stage backwards");
+	ok &= expect(model.Percent() == 97, "source progress after loading must not lower progress");
+
 	model.SetStage(OBS::StartupProgressStage::UiReady);
 	ok &= expect(model.Percent() == 99, "UiReady should map to 99%");
 